@@ -23,13 +23,12 @@
 #include "nrp_grpc_engine_protocol/device_interfaces/grpc_device_serializer.h"
 
 
+
 template<>
 GRPCDevice DeviceSerializerMethods<GRPCDevice>::serializeID<GRPCDevice>(const DeviceIdentifier &devID)
 {
 	EngineGrpc::DeviceMessage msg;
-	msg.mutable_deviceid()->set_devicename(devID.Name);
-	msg.mutable_deviceid()->set_enginename(devID.EngineName);
-	msg.mutable_deviceid()->set_devicetype(devID.Type);
+	serializeIDInto(devID, &msg);
 	return msg;
 }
 
@@ -37,12 +36,17 @@ template<>
 EngineGrpc::DeviceMessage DeviceSerializerMethods<GRPCDevice>::serializeID<EngineGrpc::DeviceMessage>(const DeviceIdentifier &devID)
 {
 	EngineGrpc::DeviceMessage msg;
-	msg.mutable_deviceid()->set_devicename(devID.Name);
-	msg.mutable_deviceid()->set_enginename(devID.EngineName);
-	msg.mutable_deviceid()->set_devicetype(devID.Type);
+	serializeIDInto(devID, &msg);
 	return msg;
 }
 
+void DeviceSerializerMethods<GRPCDevice>::serializeIDInto(const DeviceIdentifier &devID, EngineGrpc::DeviceMessage *target)
+{
+	target->mutable_deviceid()->set_devicename(devID.Name);
+	target->mutable_deviceid()->set_enginename(devID.EngineName);
+	target->mutable_deviceid()->set_devicetype(devID.Type);
+}
+
 DeviceIdentifier DeviceSerializerMethods<GRPCDevice>::deserializeID(DeviceSerializerMethods<GRPCDevice>::deserialization_t data)
 {
 	const auto &devID = data->deviceid();
@@ -64,15 +64,43 @@ class DeviceSerializerMethods<GRPCDevice>
 		using prop_deserialization_t = const EngineGrpc::DeviceMessage*;
 		using deserialization_t = const EngineGrpc::DeviceMessage*;
 
+		/*!
+		 * \brief Serialize a device into a new message. Calls serializeInto()
+		 */
 		template<DEVICE_C DEVICE>
-		static GRPCDevice serialize(const DEVICE &dev);
+		static GRPCDevice serialize(const DEVICE &dev)
+		{
+			GRPCDevice data;
+			serializeInto<DEVICE>(dev, &(data.dev()));
+			return data;
+		}
+
+		/*!
+		 * \brief Serialize a device directly into a caller-provided message, e.g. an element of a repeated request field.
+		 * Must be specialized for each device type
+		 */
+		template<DEVICE_C DEVICE>
+		static void serializeInto(const DEVICE &dev, EngineGrpc::DeviceMessage *target);
 
 		template<class SERIALIZER_T = GRPCDevice>
 		static SERIALIZER_T serializeID(const DeviceIdentifier &devID);
 
+		/*!
+		 * \brief Write a device ID into a caller-provided message
+		 */
+		static void serializeIDInto(const DeviceIdentifier &devID, EngineGrpc::DeviceMessage *target);
+
 		template<DEVICE_C DEVICE>
 		static DEVICE deserialize(DeviceIdentifier &&devID, deserialization_t data);
 
+		/*!
+		 * \brief Deserialize data into an existing device. The default implementation builds a temporary device and assigns it,
+		 * specialize it to write the message fields directly into the device
+		 */
+		template<DEVICE_C DEVICE>
+		static void update(DEVICE &dev, deserialization_t data)
+		{	dev = deserialize<DEVICE>(DeviceIdentifier(dev.id()), data);	}
+
 		static DeviceIdentifier deserializeID(deserialization_t data);
 };
 
@@ -29,7 +29,9 @@
 #include <nlohmann/json.hpp>
 
 #include "nrp_general_library/config/engine_config.h"
+#include "nrp_general_library/device_interface/device_type_dispatch.h"
 #include "nrp_general_library/engine_interfaces/engine_interface.h"
+#include "nrp_general_library/utils/nrp_metrics.h"
 #include "nrp_grpc_engine_protocol/device_interfaces/grpc_device_serializer.h"
 #include "nrp_grpc_engine_protocol/grpc_server/engine_grpc.grpc.pb.h"
 
@@ -156,6 +158,58 @@ class EngineGrpcClient
             return engineTime;
         }
 
+        void sendSaveSnapshotCommand(const nlohmann::json & data)
+        {
+            EngineGrpc::SaveSnapshotRequest request;
+            EngineGrpc::SaveSnapshotReply   reply;
+            grpc::ClientContext             context;
+
+            prepareRpcContext(&context);
+
+            request.set_json(data.dump());
+
+            grpc::Status status = _stub->saveSnapshot(&context, request, &reply);
+
+            if(!status.ok())
+            {
+                const auto errMsg = "Engine server saveSnapshot failed: " + status.error_message() + " (" + std::to_string(status.error_code()) + ")";
+                throw std::runtime_error(errMsg);
+            }
+        }
+
+        SimulationTime sendRestoreSnapshotCommand(const nlohmann::json & data)
+        {
+            EngineGrpc::RestoreSnapshotRequest request;
+            EngineGrpc::RestoreSnapshotReply   reply;
+            grpc::ClientContext                context;
+
+            prepareRpcContext(&context);
+
+            request.set_json(data.dump());
+
+            grpc::Status status = _stub->restoreSnapshot(&context, request, &reply);
+
+            if(!status.ok())
+            {
+                const auto errMsg = "Engine server restoreSnapshot failed: " + status.error_message() + " (" + std::to_string(status.error_code()) + ")";
+                throw std::runtime_error(errMsg);
+            }
+
+            const SimulationTime engineTime(reply.enginetime());
+
+            if(engineTime < SimulationTime::zero())
+            {
+               const auto errMsg = "Invalid engine time (should be greater than 0): " + std::to_string(engineTime.count());
+               throw std::runtime_error(errMsg);
+            }
+
+            // The engine time may move backwards after a restore
+            this->_prevEngineTime = engineTime;
+            this->_engineTime     = engineTime;
+
+            return engineTime;
+        }
+
         SimulationTime getEngineTime() const override
         {
             return this->_engineTime;
@@ -163,7 +217,11 @@ class EngineGrpcClient
 
         virtual void runLoopStep(SimulationTime timeStep) override
         {
-            this->_loopStepThread = std::async(std::launch::async, std::bind(&EngineGrpcClient::sendRunLoopStepCommand, this, timeStep));
+            this->_loopStepThread = std::async(std::launch::async, [this, timeStep]() {
+                const auto engineTime = this->sendRunLoopStepCommand(timeStep);
+                this->_stepCompletionTime = std::chrono::steady_clock::now();
+                return engineTime;
+            });
         }
 
         virtual void waitForStepCompletion(float timeOut) override
@@ -186,6 +244,11 @@ class EngineGrpcClient
             this->_engineTime = this->_loopStepThread.get();
         }
 
+        std::chrono::steady_clock::time_point stepCompletionTime() const override
+        {
+            return this->_stepCompletionTime;
+        }
+
 		virtual void handleInputDevices(const typename EngineInterface::device_inputs_t &inputDevices) override
         {
             EngineGrpc::SetDeviceRequest request;
@@ -199,10 +262,12 @@ class EngineGrpcClient
                 if(device->engineName().compare(this->engineName()) == 0)
                 {
                     auto r = request.add_request();
-                    this->getProtoFromSingleDeviceInterface<DEVICES...>(*device, r);
+                    this->getProtoFromSingleDeviceInterface(*device, r);
                 }
             }
 
+            this->_sentDeviceBytes->increment(request.ByteSizeLong());
+
             grpc::Status status = _stub->setDevice(&context, request, &reply);
 
             if(!status.ok())
@@ -212,26 +277,16 @@ class EngineGrpcClient
             }
         }
 
-        template<class DEVICE, class ...REMAINING_DEVICES>
 		inline void getProtoFromSingleDeviceInterface(const DeviceInterface &device, EngineGrpc::DeviceMessage * request) const
         {
-            if(DEVICE::TypeName.compare(device.type()) == 0)
-            {
-				*request = GRPCDeviceSerializerMethods::template serialize<DEVICE>(dynamic_cast<const DEVICE&>(device));
-
-                return;
-            }
-
-            // If device classess are left to check, go through them. If all device classes have been checked without proper result, throw an error
-
-            if constexpr (sizeof...(REMAINING_DEVICES) > 0)
+            dispatch_t::dispatchType(device.type(), [&]<class DEVICE>()
             {
-                this->getProtoFromSingleDeviceInterface<REMAINING_DEVICES...>(device, request);
-            }
-            else
+				GRPCDeviceSerializerMethods::template serializeInto<DEVICE>(dynamic_cast<const DEVICE&>(device), request);
+            },
+            [&]()
             {
 				throw std::logic_error("Could not serialize given device of type \"" + device.type() + "\"");
-            }
+            });
         }
 
         typename EngineInterface::device_outputs_set_t getDeviceInterfacesFromProto(const EngineGrpc::GetDeviceReply & reply)
@@ -242,33 +297,37 @@ class EngineGrpcClient
             {
                 // Check whether the requested device has new data
 				if(reply.reply(i).has_deviceid())
-					interfaces.insert(this->getSingleDeviceInterfaceFromProto<DEVICES...>(reply.reply(i)));
+					interfaces.insert(this->getSingleDeviceInterfaceFromProto(reply.reply(i)));
             }
 
             return interfaces;
         }
 
-        template<class DEVICE, class ...REMAINING_DEVICES>
-        inline DeviceInterfaceConstSharedPtr getSingleDeviceInterfaceFromProto(const EngineGrpc::DeviceMessage &deviceData) const
+        inline DeviceInterfaceConstSharedPtr getSingleDeviceInterfaceFromProto(const EngineGrpc::DeviceMessage &deviceData)
         {
-            if(DEVICE::TypeName.compare(deviceData.deviceid().devicetype()) == 0)
+            const auto createDevice = [&]<class DEVICE>() -> DeviceInterfaceConstSharedPtr
             {
                 DeviceIdentifier devId(deviceData.deviceid().devicename(),
 				                       this->engineName(),
                                        deviceData.deviceid().devicetype());
 
-				return DeviceInterfaceConstSharedPtr(new DEVICE(DeviceSerializerMethods<GRPCDevice>::template deserialize<DEVICE>(std::move(devId), &deviceData)));
-            }
+                // Deserialize into cached device if it isn't used anywhere else
+                auto cachedDevice = this->template getReusableCachedDevice<DEVICE>(devId);
+                if(cachedDevice != nullptr)
+                {
+                    DeviceSerializerMethods<GRPCDevice>::template update<DEVICE>(*cachedDevice, &deviceData);
+                    return cachedDevice;
+                }
 
-            // If device classess are left to check, go through them. If all device classes have been checked without proper result, throw an error
-            if constexpr (sizeof...(REMAINING_DEVICES) > 0)
-            {
-                return this->getSingleDeviceInterfaceFromProto<REMAINING_DEVICES...>(deviceData);
-            }
-            else
+				return std::make_shared<DEVICE>(DeviceSerializerMethods<GRPCDevice>::template deserialize<DEVICE>(std::move(devId), &deviceData));
+            };
+
+            const auto notFound = [&]() -> DeviceInterfaceConstSharedPtr
             {
 				throw std::logic_error("Could not deserialize given device of type \"" + deviceData.deviceid().devicetype() + "\"");
-            }
+            };
+
+            return dispatch_t::dispatchType(deviceData.deviceid().devicetype(), createDevice, notFound);
         }
 
 	protected:
@@ -290,6 +349,8 @@ class EngineGrpcClient
 				}
 			}
 
+			this->_sentDeviceBytes->increment(request.ByteSizeLong());
+
 			grpc::Status status = _stub->getDevice(&context, request, &reply);
 
 			if(!status.ok())
@@ -298,11 +359,31 @@ class EngineGrpcClient
 				throw std::runtime_error(errMsg);
 			}
 
+			this->_receivedDeviceBytes->increment(reply.ByteSizeLong());
+
 			return this->getDeviceInterfacesFromProto(reply);
 		}
 
+		virtual bool supportsSnapshots() const override
+		{	return this->engineConfig()->engineSnapshots();	}
+
+		virtual void saveSnapshotCallback() override
+		{
+			this->sendSaveSnapshotCommand(nlohmann::json());
+		}
+
+		virtual void restoreSnapshotCallback() override
+		{
+			// Finish any running loop step before changing the engine state
+			this->waitForStepCompletion(0);
+
+			this->sendRestoreSnapshotCommand(nlohmann::json());
+		}
+
     private:
 
+        using dispatch_t = DeviceTypeDispatch<DEVICES...>;
+
         std::shared_ptr<grpc::Channel>                       _channel;
         std::unique_ptr<EngineGrpc::EngineGrpcService::Stub> _stub;
 
@@ -310,6 +391,13 @@ class EngineGrpcClient
         SimulationTime _prevEngineTime = SimulationTime::zero();
         SimulationTime _engineTime     = SimulationTime::zero();
         SimulationTime _rpcTimeout     = SimulationTime::zero();
+
+        std::chrono::steady_clock::time_point _stepCompletionTime;
+
+        MetricCounter *_sentDeviceBytes     = &NRPMetrics::instance().counter("nrp_engine_device_bytes_total", "Serialized device data exchanged with engines, in bytes",
+                                                                               {{"engine", this->engineName()}, {"direction", "sent"}});
+        MetricCounter *_receivedDeviceBytes = &NRPMetrics::instance().counter("nrp_engine_device_bytes_total", "Serialized device data exchanged with engines, in bytes",
+                                                                               {{"engine", this->engineName()}, {"direction", "received"}});
 };
 
 /*! \defgroup GRPC Engine Protocol
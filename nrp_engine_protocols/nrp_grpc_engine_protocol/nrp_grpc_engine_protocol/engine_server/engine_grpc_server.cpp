@@ -127,6 +127,54 @@ grpc::Status EngineGrpcServer::getDevice(grpc::ServerContext * , const EngineGrp
     return grpc::Status::OK;
 }
 
+grpc::Status EngineGrpcServer::saveSnapshot(grpc::ServerContext * , const EngineGrpc::SaveSnapshotRequest * request, EngineGrpc::SaveSnapshotReply *)
+{
+    try
+    {
+        EngineGrpcServer::lock_t lock(this->_deviceLock);
+
+        nlohmann::json requestJson = nlohmann::json::parse(request->json());
+
+        this->saveSnapshot(requestJson);
+    }
+    catch(const std::exception &e)
+    {
+        return handleGrpcError("Error while executing saveSnapshot", e.what());
+    }
+
+    return grpc::Status::OK;
+}
+
+grpc::Status EngineGrpcServer::restoreSnapshot(grpc::ServerContext * , const EngineGrpc::RestoreSnapshotRequest * request, EngineGrpc::RestoreSnapshotReply * reply)
+{
+    try
+    {
+        EngineGrpcServer::lock_t lock(this->_deviceLock);
+
+        nlohmann::json requestJson = nlohmann::json::parse(request->json());
+
+        int64_t engineTime = (this->restoreSnapshot(requestJson, lock)).count();
+
+        reply->set_enginetime(engineTime);
+    }
+    catch(const std::exception &e)
+    {
+        return handleGrpcError("Error while executing restoreSnapshot", e.what());
+    }
+
+    return grpc::Status::OK;
+}
+
+void EngineGrpcServer::saveSnapshot(const nlohmann::json &)
+{
+    throw std::logic_error("Engine " + this->_engineName + " does not support snapshots");
+}
+
+SimulationTime EngineGrpcServer::restoreSnapshot(const nlohmann::json &, EngineGrpcServer::lock_t &)
+{
+    throw std::logic_error("Engine " + this->_engineName + " does not support snapshots");
+}
+
 EngineGrpcServer::EngineGrpcServer()
 {
 	this->_serverAddress   = EngineGRPCConfigConst::DefEngineServerAddress;
@@ -222,7 +270,7 @@ void EngineGrpcServer::setDeviceData(const EngineGrpc::SetDeviceRequest & data)
 
     for(int i = 0; i < numDevices; i++)
     {
-        const auto r = data.request(i);
+        const auto &r = data.request(i);
 		const auto &devInterface = this->_devicesControllers.find(r.deviceid().devicename());
 
         if(devInterface != _devicesControllers.end())
@@ -249,8 +297,9 @@ void EngineGrpcServer::getDeviceData(const EngineGrpc::GetDeviceRequest & reques
 
         if(devInterface != _devicesControllers.end())
         {
-			auto r = reply->add_reply();
-			*r = devInterface->second->getDeviceInformation();
+			// Swap serialized data into the reply instead of copying it
+			auto devData = devInterface->second->getDeviceInformation();
+			reply->add_reply()->Swap(&(devData.dev()));
         }
         else
         {
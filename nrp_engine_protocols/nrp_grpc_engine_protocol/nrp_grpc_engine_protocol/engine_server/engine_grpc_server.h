@@ -161,6 +161,28 @@ class EngineGrpcServer : public EngineGrpcService::Service
          */
         virtual SimulationTime runLoopStep(const SimulationTime timeStep) = 0;
 
+        /*!
+         * \brief Stores the current simulation state
+         *
+         * Only a single snapshot must be kept, saving again overwrites it.
+         * The default implementation throws, as not all engines support snapshots.
+         *
+         * \param[in] data Additional data
+         */
+        virtual void saveSnapshot(const nlohmann::json &data);
+
+        /*!
+         * \brief Returns to the simulation state stored by saveSnapshot
+         *
+         * The default implementation throws, as not all engines support snapshots.
+         *
+         * \param[in] data       Additional data
+         * \param[in] deviceLock Device lock. Prevents access to _devicesControllers
+         *
+         * \return Engine time after restoring the state
+         */
+        virtual SimulationTime restoreSnapshot(const nlohmann::json &data, EngineGrpcServer::lock_t &deviceLock);
+
         /*!
          * \brief Initializes the simulation
          *
@@ -236,6 +258,36 @@ class EngineGrpcServer : public EngineGrpcService::Service
          */
         grpc::Status getDevice(grpc::ServerContext * context, const EngineGrpc::GetDeviceRequest * request, EngineGrpc::GetDeviceReply * reply) override;
 
+        /*!
+         * \brief Stores the simulation state
+         *
+         * The function implements the saveSnapshot method of the EngineGrpcService.
+         * It acts as a wrapper around the virtual saveSnapshot method, which should store the simulation state.
+         * On error, it will return a status object with error message and grpc::StatusCode::CANCELLED error code.
+         *
+         * \param      context Pointer to gRPC server context structure
+         * \param[in]  request Pointer to protobuf saveSnapshot request message. Contains snapshot parameters in JSON format.
+         * \param[out] reply   Pointer to protobuf saveSnapshot reply message. Currently no data is returned.
+         *
+         * \return gRPC request status
+         */
+        grpc::Status saveSnapshot(grpc::ServerContext * context, const EngineGrpc::SaveSnapshotRequest * request, EngineGrpc::SaveSnapshotReply * reply) override;
+
+        /*!
+         * \brief Returns to the stored simulation state
+         *
+         * The function implements the restoreSnapshot method of the EngineGrpcService.
+         * It acts as a wrapper around the virtual restoreSnapshot method, which should return to the stored simulation state.
+         * On error, it will return a status object with error message and grpc::StatusCode::CANCELLED error code.
+         *
+         * \param      context Pointer to gRPC server context structure
+         * \param[in]  request Pointer to protobuf restoreSnapshot request message. Contains restore parameters in JSON format.
+         * \param[out] reply   Pointer to protobuf restoreSnapshot reply message. Contains engine time.
+         *
+         * \return gRPC request status
+         */
+        grpc::Status restoreSnapshot(grpc::ServerContext * context, const EngineGrpc::RestoreSnapshotRequest * request, EngineGrpc::RestoreSnapshotReply * reply) override;
+
         virtual void setDeviceData(const EngineGrpc::SetDeviceRequest & data);
         virtual void getDeviceData(const EngineGrpc::GetDeviceRequest & request, EngineGrpc::GetDeviceReply * reply);
 
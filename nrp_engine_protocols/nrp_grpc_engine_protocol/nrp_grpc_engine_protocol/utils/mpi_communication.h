@@ -23,6 +23,7 @@
 #define MPI_COMMUNICATION_H
 
 #include "nrp_general_library/device_interface/device.h"
+#include "nrp_general_library/device_interface/device_type_dispatch.h"
 #include "nrp_general_library/utils/serializers/mpi_property_serializer.h"
 
 #include <mpi.h>
@@ -84,10 +85,9 @@ class MPICommunication
 		template<bool SEND_ID, DEVICE_C ...DEVICES>
 		static void sendDeviceByType(MPI_Comm comm, int tag, DeviceInterface &devInterface)
 		{
-			if constexpr (sizeof... (DEVICES) == 0)
-			{	throwNoDevError(devInterface.id());	}
-			else
-			{	return sendDeviceByTypeInternal<SEND_ID, DEVICES...>(comm, tag, devInterface);	}
+			DeviceTypeDispatch<DEVICES...>::dispatchType(devInterface.type(),
+			            [&]<class DEVICE>() {	MPICommunication::sendDevice<DEVICE, SEND_ID>(comm, tag, dynamic_cast<DEVICE&>(devInterface));	},
+			            [&]() {	throwNoDevError(devInterface.id());	});
 		}
 
 		template<DEVICE_C DEVICE, bool RECV_ID = true>
@@ -109,10 +109,18 @@ class MPICommunication
 		template<bool RECV_ID, DEVICE_C ...DEVICES>
 		static DeviceInterface::unique_ptr recvDeviceByType(MPI_Comm comm, int tag, MPIDeviceData &devData)
 		{
-			if constexpr (sizeof... (DEVICES) == 0)
-			{	throwNoDevError(devData.DeviceID);	}
-			else
-			{	return recvDeviceByTypeInternal<RECV_ID, DEVICES...>(comm, tag, devData);	}
+			return DeviceTypeDispatch<DEVICES...>::dispatchType(devData.DeviceID.Type, [&]<class DEVICE>() -> DeviceInterface::unique_ptr
+			{
+				typename PtrTemplates<DEVICE>::unique_ptr retVal(new DEVICE(devData.DeviceID));
+				MPICommunication::recvDevice<DEVICE, RECV_ID>(comm, tag, *retVal);
+
+				return retVal;
+			},
+			[&]() -> DeviceInterface::unique_ptr
+			{
+				throwNoDevError(devData.DeviceID);
+				return nullptr;		// Silence compiler no-return warning
+			});
 		}
 
 		static void sendDeviceID(MPI_Comm comm, int tag, const DeviceIdentifier &id);
@@ -133,38 +141,6 @@ class MPICommunication
 		}
 
 	private:
-		template<bool SEND_ID, DEVICE_C DEVICE, class ...REM_DEVICES>
-		static inline void sendDeviceByTypeInternal(MPI_Comm comm, int tag, DeviceInterface &devInterface)
-		{
-			if(devInterface.type() == DEVICE::TypeName)
-			{	MPICommunication::sendDevice<DEVICE, SEND_ID>(comm, tag, dynamic_cast<DEVICE&>(devInterface));	}
-
-			if constexpr (sizeof...(REM_DEVICES) > 0)
-			{	return sendDeviceByTypeInternal<SEND_ID, REM_DEVICES...>(comm, tag, devInterface);	}
-			else
-			{	throwNoDevError(devInterface.id());	}
-		}
-
-		template<bool RECV_ID, DEVICE_C DEVICE, class ...REM_DEVICES>
-		static inline DeviceInterface::unique_ptr recvDeviceByTypeInternal(MPI_Comm comm, int tag, MPIDeviceData &devData)
-		{
-			if(devData.DeviceID.Type == DEVICE::TypeName)
-			{
-				typename PtrTemplates<DEVICE>::unique_ptr retVal(new DEVICE(devData.DeviceID));
-				MPICommunication::recvDevice<DEVICE, RECV_ID>(comm, tag, *retVal);
-
-				return retVal;
-			}
-
-			if constexpr (sizeof... (REM_DEVICES) > 0)
-			{	return recvDeviceByTypeInternal<RECV_ID, REM_DEVICES...>(comm, tag, devData);	}
-			else
-			{
-				throwNoDevError(devData.DeviceID);
-				return nullptr;		// Silence compiler no-return warning
-			}
-		}
-
 		static inline void throwNoDevError(const DeviceIdentifier &devID)
 		{	throw std::domain_error("No device available for type \"" + devID.Type + "\"");	}
 };
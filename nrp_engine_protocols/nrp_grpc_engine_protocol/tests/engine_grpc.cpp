@@ -81,11 +81,9 @@ class TestEngineGRPCConfig
 
 
 template<>
-GRPCDevice DeviceSerializerMethods<GRPCDevice>::serialize<TestGrpcDeviceInterface1>(const TestGrpcDeviceInterface1 &dev)
+void DeviceSerializerMethods<GRPCDevice>::serializeInto<TestGrpcDeviceInterface1>(const TestGrpcDeviceInterface1 &dev, EngineGrpc::DeviceMessage *target)
 {
-	GRPCDevice data = serializeID<GRPCDevice>(dev.id());
-
-	return data;
+	serializeIDInto(dev.id(), target);
 }
 
 template<>
@@ -109,11 +107,9 @@ class TestGrpcDeviceInterface2
 };
 
 template<>
-GRPCDevice DeviceSerializerMethods<GRPCDevice>::serialize<TestGrpcDeviceInterface2>(const TestGrpcDeviceInterface2 &dev)
+void DeviceSerializerMethods<GRPCDevice>::serializeInto<TestGrpcDeviceInterface2>(const TestGrpcDeviceInterface2 &dev, EngineGrpc::DeviceMessage *target)
 {
-	GRPCDevice data = serializeID<GRPCDevice>(dev.id());
-
-	return data;
+	serializeIDInto(dev.id(), target);
 }
 
 template<>
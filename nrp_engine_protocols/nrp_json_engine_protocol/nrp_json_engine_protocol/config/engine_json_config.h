@@ -85,6 +85,16 @@ struct EngineJSONConfigConst
 		 */
 		static constexpr std::string_view EngineServerShutdownRoute = "/shutdown";
 
+		/*!
+		 * \brief REST Server Route to store the current engine state
+		 */
+		static constexpr std::string_view EngineServerSaveSnapshotRoute = "/save_snapshot";
+
+		/*!
+		 * \brief REST Server Route to return to the stored engine state
+		 */
+		static constexpr std::string_view EngineServerRestoreSnapshotRoute = "/restore_snapshot";
+
 		/*!
 		 * \brief JSON name under which the runLoopStep timeStep is saved
 		 */
@@ -53,6 +53,20 @@ struct DeviceConversionMechanism<nlohmann::json, nlohmann::json::const_iterator,
 		return data;
 	}
 
+	/*!
+	 * \brief Serialize a device directly into a caller-provided JSON object. The device data is stored under the device name
+	 * \param device Device to serialize
+	 * \param target JSON object to write into
+	 */
+	template<DEVICE_C DEVICE>
+	static void serializeInto(const DEVICE &device, nlohmann::json &target)
+	{
+		const auto &id = device.id();
+		nlohmann::json &data = target[id.Name];
+		data = nlohmann::json({{ JSONTypeID.data(), id.Type }, { JSONEngineNameID.data(), id.EngineName }});
+		data = JSONPropertySerializer<DEVICE>::serializeProperties(device, std::move(data));
+	}
+
 	template<DEVICE_C DEVICE>
 	static constexpr bool IsSerializable = std::is_invocable_v<decltype(serialize<DEVICE>), const DEVICE&>;
 
@@ -63,6 +77,15 @@ struct DeviceConversionMechanism<nlohmann::json, nlohmann::json::const_iterator,
 	template<DEVICE_C DEVICE>
 	static constexpr bool IsDeserializable = std::is_invocable_v<decltype(deserialize<DEVICE>), const nlohmann::json::const_iterator&>;
 
+	/*!
+	 * \brief Deserialize data into an existing device. Each property is read directly into the device's storage
+	 * \param device Device to update
+	 * \param data Device data
+	 */
+	template<DEVICE_C DEVICE>
+	static void update(DEVICE &device, const nlohmann::json::const_iterator &data)
+	{	JSONPropertySerializer<DEVICE>::updateProperties(device, data.value());	}
+
 	static nlohmann::json serializeID(const DeviceIdentifier &id)
 	{	return nlohmann::json({{ id.Name, {{ JSONTypeID.data(), id.Type }, { JSONEngineNameID.data(), id.EngineName }} }});	}
 
@@ -166,6 +166,16 @@ void EngineJSONServer::clearRegisteredDevices()
 	this->_devicesControllers.clear();
 }
 
+nlohmann::json EngineJSONServer::saveSnapshot(const nlohmann::json &)
+{
+	throw NRPException::logCreate("Engine server at \"" + this->_serverAddress + "\" does not support snapshots");
+}
+
+SimulationTime EngineJSONServer::restoreSnapshot(const nlohmann::json &, EngineJSONServer::lock_t &)
+{
+	throw NRPException::logCreate("Engine server at \"" + this->_serverAddress + "\" does not support snapshots");
+}
+
 nlohmann::json EngineJSONServer::getDeviceData(const nlohmann::json &reqData)
 {
 	// Prevent other device reading/setting calls as well as loop execution
@@ -177,9 +187,13 @@ nlohmann::json EngineJSONServer::getDeviceData(const nlohmann::json &reqData)
 		const auto &devName = EngineJSONServer::getIteratorKey(curRequest);
 		const auto devInterface = this->_devicesControllers.find(devName);
 
-		// If device not found, return empty string, else get device information
+		// If device not found, return empty string, else move device information into the response
 		if(devInterface != this->_devicesControllers.end())
-			jres.update(devInterface->second->getDeviceInformation());
+		{
+			auto devData = devInterface->second->getDeviceInformation();
+			for(auto devIt = devData.begin(); devIt != devData.end(); ++devIt)
+				jres[devIt.key()] = std::move(devIt.value());
+		}
 		else
 			jres[devName] = nlohmann::json();
 	}
@@ -221,6 +235,8 @@ Pistache::Rest::Router EngineJSONServer::setRoutes(EngineJSONServer *server)
 	Pistache::Rest::Routes::Post(router, EngineJSONServer::RunLoopStepRoute.data(),          Pistache::Rest::Routes::bind(&EngineJSONServer::runLoopStepHandler, server));
 	Pistache::Rest::Routes::Post(router, EngineJSONServer::InitializeRoute.data(),           Pistache::Rest::Routes::bind(&EngineJSONServer::initializeHandler, server));
 	Pistache::Rest::Routes::Post(router, EngineJSONServer::ShutdownRoute.data(),             Pistache::Rest::Routes::bind(&EngineJSONServer::shutdownHandler, server));
+	Pistache::Rest::Routes::Post(router, EngineJSONServer::SaveSnapshotRoute.data(),         Pistache::Rest::Routes::bind(&EngineJSONServer::saveSnapshotHandler, server));
+	Pistache::Rest::Routes::Post(router, EngineJSONServer::RestoreSnapshotRoute.data(),      Pistache::Rest::Routes::bind(&EngineJSONServer::restoreSnapshotHandler, server));
 
 	return router;
 }
@@ -373,6 +389,51 @@ void EngineJSONServer::shutdownHandler(const Pistache::Rest::Request &req, Pista
 	res.send(Pistache::Http::Code::Ok, jresp.dump());
 }
 
+void EngineJSONServer::saveSnapshotHandler(const Pistache::Rest::Request &req, Pistache::Http::ResponseWriter res)
+{
+	const json jrequest = this->parseRequest(req, res);
+
+	json jresp;
+	try
+	{
+		// Prevent other device reading/setting calls as well as loop execution
+		EngineJSONServer::lock_t lock(this->_deviceLock);
+
+		// Store engine state
+		jresp = this->saveSnapshot(jrequest);
+	}
+	catch(std::exception &e)
+	{
+		const auto err = NRPException::logCreate(std::string("Error while saving snapshot: ") + e.what());
+
+		res.send(Pistache::Http::Code::Internal_Server_Error);
+		throw err;
+	}
+
+	res.send(Pistache::Http::Code::Ok, jresp.dump());
+}
+
+void EngineJSONServer::restoreSnapshotHandler(const Pistache::Rest::Request &req, Pistache::Http::ResponseWriter res)
+{
+	const json jrequest = this->parseRequest(req, res);
+
+	try
+	{
+		// Prevent other device reading/setting calls as well as loop execution
+		EngineJSONServer::lock_t lock(this->_deviceLock);
+
+		const auto retJson(nlohmann::json({{EngineJSONConfigConst::EngineTimeName.data(), (this->restoreSnapshot(jrequest, lock)).count()}}));
+		res.send(Pistache::Http::Code::Ok, retJson.dump());
+	}
+	catch(std::exception &e)
+	{
+		const auto err = NRPException::logCreate(std::string("Error while restoring snapshot: ") + e.what());
+
+		res.send(Pistache::Http::Code::Internal_Server_Error);
+		throw err;
+	}
+}
+
 Pistache::Http::Endpoint EngineJSONServer::createEndpoint(std::string *engineAddress, const std::string &engineName)
 {
 
@@ -67,6 +67,8 @@ class EngineJSONServer
 		static constexpr std::string_view RunLoopStepRoute = EngineJSONConfigConst::EngineServerRunLoopStepRoute;
 		static constexpr std::string_view InitializeRoute = EngineJSONConfigConst::EngineServerInitializeRoute;
 		static constexpr std::string_view ShutdownRoute = EngineJSONConfigConst::EngineServerShutdownRoute;
+		static constexpr std::string_view SaveSnapshotRoute = EngineJSONConfigConst::EngineServerSaveSnapshotRoute;
+		static constexpr std::string_view RestoreSnapshotRoute = EngineJSONConfigConst::EngineServerRestoreSnapshotRoute;
 
 		using dcm_t = DeviceConversionMechanism<nlohmann::json, nlohmann::json::const_iterator>;
 
@@ -166,6 +168,21 @@ class EngineJSONServer
 		 */
 		virtual nlohmann::json shutdown(const nlohmann::json &data) = 0;
 
+		/*!
+		 * \brief Store the current engine state. Only a single snapshot must be kept. Default implementation throws
+		 * \param data Snapshot data
+		 * \return Returns data about snapshot status
+		 */
+		virtual nlohmann::json saveSnapshot(const nlohmann::json &data);
+
+		/*!
+		 * \brief Return to the engine state stored by saveSnapshot(). Default implementation throws
+		 * \param data Restore data
+		 * \param deviceLock Device Lock. Prevents access to _devicesControllers
+		 * \return Returns the engine time after restoring the state
+		 */
+		virtual SimulationTime restoreSnapshot(const nlohmann::json &data, EngineJSONServer::lock_t &deviceLock);
+
 	protected:
 		/*!
 		 * \brief Lock access to _devices to make execution thread-safe
@@ -275,6 +292,20 @@ class EngineJSONServer
 		 */
 		void shutdownHandler(const Pistache::Rest::Request &req, Pistache::Http::ResponseWriter res);
 
+		/*!
+		 * \brief Callback function to store the engine state
+		 * \param req Snapshot Data
+		 * \param res Response writer. Contains snapshot status
+		 */
+		void saveSnapshotHandler(const Pistache::Rest::Request &req, Pistache::Http::ResponseWriter res);
+
+		/*!
+		 * \brief Callback function to return to the stored engine state
+		 * \param req Restore Data
+		 * \param res Response writer. Contains the engine time after restoring
+		 */
+		void restoreSnapshotHandler(const Pistache::Rest::Request &req, Pistache::Http::ResponseWriter res);
+
 		/*!
 		 * \brief Creates a REST server. Tries to bind to a port and register itself with clientAddress
 		 * \param engineAddress Server Address. If it contains a port, will try to bind to said port. If that fails, will increment port number and try again. This will continue for at most EngineJSONConfigConst::MaxAddrBindTries times
@@ -23,11 +23,13 @@
 #define ENGINE_JSON_NRP_CLIENT_H
 
 #include "nrp_general_library/device_interface/device.h"
+#include "nrp_general_library/device_interface/device_type_dispatch.h"
 #include "nrp_general_library/engine_interfaces/engine_interface.h"
 #include "nrp_json_engine_protocol/config/engine_json_config.h"
 #include "nrp_json_engine_protocol/device_interfaces/json_device_conversion_mechanism.h"
 #include "nrp_json_engine_protocol/nrp_client/engine_json_registration_server.h"
 #include "nrp_general_library/utils/nrp_exceptions.h"
+#include "nrp_general_library/utils/nrp_metrics.h"
 #include "nrp_general_library/utils/restclient_setup.h"
 
 #include <nlohmann/json.hpp>
@@ -103,12 +105,15 @@ class EngineJSONNRPClient
 			for(const auto &curDevice : inputDevices)
 			{
 				if(curDevice->engineName().compare(this->engineName()) == 0)
-					request.update(this->getJSONFromSingleDeviceInterface<DEVICES...>(*curDevice));
+					this->getJSONFromSingleDeviceInterface(*curDevice, request);
 			}
 
 			// Send updated devices to Engine JSON server
+			const auto requestBody = request.dump();
+			this->_sentDeviceBytes->increment(requestBody.size());
+
 			EngineJSONNRPClient::sendRequest(this->_serverAddress + "/" + EngineJSONConfigConst::EngineServerSetDevicesRoute.data(),
-			                                 EngineJSONConfigConst::EngineServerContentType.data(), request.dump(),
+			                                 EngineJSONConfigConst::EngineServerContentType.data(), requestBody,
 			                                 "Engine server \"" + this->engineName() + "\" failed during device handling");
 
 			// TODO: Check if engine has processed all sent devices
@@ -119,7 +124,11 @@ class EngineJSONNRPClient
 
 		virtual void runLoopStep(SimulationTime timeStep) override
 		{
-			this->_loopStepThread = std::async(std::launch::async, std::bind(&EngineJSONNRPClient::loopFcn, this, timeStep));
+			this->_loopStepThread = std::async(std::launch::async, [this, timeStep]() {
+				const auto engineTime = this->loopFcn(timeStep);
+				this->_stepCompletionTime = std::chrono::steady_clock::now();
+				return engineTime;
+			});
 		}
 
 		virtual void waitForStepCompletion(float timeOut) override
@@ -140,6 +149,9 @@ class EngineJSONNRPClient
 			this->_engineTime = this->_loopStepThread.get();
 		}
 
+		std::chrono::steady_clock::time_point stepCompletionTime() const override
+		{	return this->_stepCompletionTime;	}
+
 	protected:
 		virtual typename EngineInterface::device_outputs_set_t requestOutputDeviceCallback(const typename EngineInterface::device_identifiers_t &deviceIdentifiers) override
 		{
@@ -151,13 +163,46 @@ class EngineJSONNRPClient
 			}
 
 			// Post request to Engine JSON server
+			const auto requestBody = request.dump();
+			this->_sentDeviceBytes->increment(requestBody.size());
+
 			const auto resp(EngineJSONNRPClient::sendRequest(this->_serverAddress + "/" + EngineJSONConfigConst::EngineServerGetDevicesRoute.data(),
-			                                                 EngineJSONConfigConst::EngineServerContentType.data(), request.dump(),
-			                                                 "Engine server \"" + this->engineName() + "\" failed during device retrieval"));
+			                                                 EngineJSONConfigConst::EngineServerContentType.data(), requestBody,
+			                                                 "Engine server \"" + this->engineName() + "\" failed during device retrieval",
+			                                                 this->_receivedDeviceBytes));
 
 			return this->getDeviceInterfacesFromJSON(resp);
 		}
 
+		virtual bool supportsSnapshots() const override
+		{	return this->engineConfig()->engineSnapshots();	}
+
+		virtual void saveSnapshotCallback() override
+		{
+			sendRequest(this->_serverAddress + "/" + EngineJSONConfigConst::EngineServerSaveSnapshotRoute.data(),
+			            EngineJSONConfigConst::EngineServerContentType.data(), nlohmann::json().dump(),
+			            "Engine server \"" + this->engineName() + "\" failed to save snapshot");
+		}
+
+		virtual void restoreSnapshotCallback() override
+		{
+			// Finish any running loop step before changing the engine state
+			this->waitForStepCompletion(0);
+
+			const auto resp(sendRequest(this->_serverAddress + "/" + EngineJSONConfigConst::EngineServerRestoreSnapshotRoute.data(),
+			                            EngineJSONConfigConst::EngineServerContentType.data(), nlohmann::json().dump(),
+			                            "Engine server \"" + this->engineName() + "\" failed to restore snapshot"));
+
+			try
+			{
+				this->_engineTime = SimulationTime(resp.at(EngineJSONConfigConst::EngineTimeName.data()));
+			}
+			catch(std::exception &e)
+			{
+				throw NRPException::logCreate(e, "Error while parsing the return value of the snapshot restore of \"" + this->engineName() + "\"");
+			}
+		}
+
 		/*!
 		 * \brief Send an initialization command
 		 * \param data Data that should be passed to the engine
@@ -220,6 +265,8 @@ class EngineJSONNRPClient
 		using dcm_t = DeviceConversionMechanism<nlohmann::json, nlohmann::json::const_iterator, DEVICES...>;
 		dcm_t _dcm;
 
+		using dispatch_t = DeviceTypeDispatch<DEVICES...>;
+
 	private:
 		/*!
 		 * \brief Future of thread running a single loop. Used by runLoopStep and waitForStepCompletion to execute the thread
@@ -236,15 +283,34 @@ class EngineJSONNRPClient
 		 */
 		SimulationTime _engineTime;
 
+		/*!
+		 * \brief Time at which the last loop step completed. Set by the loop thread, read after joining it
+		 */
+		std::chrono::steady_clock::time_point _stepCompletionTime;
+
+		/*!
+		 * \brief Number of device bytes sent to the engine server
+		 */
+		MetricCounter *_sentDeviceBytes = &NRPMetrics::instance().counter("nrp_engine_device_bytes_total", "Serialized device data exchanged with engines, in bytes",
+		                                                                  {{"engine", this->engineName()}, {"direction", "sent"}});
+
+		/*!
+		 * \brief Number of device bytes received from the engine server
+		 */
+		MetricCounter *_receivedDeviceBytes = &NRPMetrics::instance().counter("nrp_engine_device_bytes_total", "Serialized device data exchanged with engines, in bytes",
+		                                                                      {{"engine", this->engineName()}, {"direction", "received"}});
+
 		/*!
 		 * \brief Send a request to the Server
 		 * \param serverName Name of the server
 		 * \param contentType Content Type
 		 * \param request Body of request
 		 * \param exceptionMessage Message to put into exception output
+		 * \param receivedBytes If set, the size of the response body is added to this counter
 		 * \return Returns body of response, parsed as JSON
 		 */
-		static nlohmann::json sendRequest(const std::string &serverName, const std::string &contentType, const std::string &request, const std::string_view &exceptionMessage)
+		static nlohmann::json sendRequest(const std::string &serverName, const std::string &contentType, const std::string &request, const std::string_view &exceptionMessage,
+		                                  MetricCounter *receivedBytes = nullptr)
 		{
 			// Post request to Engine JSON server
 			try
@@ -255,6 +321,9 @@ class EngineJSONNRPClient
 					throw std::domain_error(exceptionMessage.data());
 				}
 
+				if(receivedBytes != nullptr)
+					receivedBytes->increment(resp.body.size());
+
 				return nlohmann::json::parse(resp.body);
 			}
 			catch(std::exception &e)
@@ -300,7 +369,7 @@ class EngineJSONNRPClient
 		 * \param devices JSON data of devices
 		 * \return Returns list of devices
 		 */
-		typename EngineInterface::device_outputs_set_t getDeviceInterfacesFromJSON(const nlohmann::json &devices) const
+		typename EngineInterface::device_outputs_set_t getDeviceInterfacesFromJSON(const nlohmann::json &devices)
 		{
 			typename EngineInterface::device_outputs_set_t interfaces;
 
@@ -316,7 +385,7 @@ class EngineJSONNRPClient
 				{
 					auto deviceID = this->_dcm.getID(curDeviceIterator);
 					deviceID.EngineName = this->engineName();
-					interfaces.insert(this->getSingleDeviceInterfaceFromJSON<DEVICES...>(curDeviceIterator, deviceID));
+					interfaces.insert(this->getSingleDeviceInterfaceFromJSON(curDeviceIterator, deviceID));
 				}
 				catch(std::exception &e)
 				{
@@ -329,57 +398,55 @@ class EngineJSONNRPClient
 		}
 
 		/*!
-		 * \brief Go through given DEVICES and try to create a DeviceInterface from the JSON object
-		 * \tparam DEVICE DeviceInterface Class to check
-		 * \tparam REMAINING_DEVICES Remaining DeviceInterface Classes to check
+		 * \brief Find the device type matching the JSON object's type in DEVICES and create a DeviceInterface from it.
+		 * If a matching device is already cached and not used elsewhere, it is updated in place instead
 		 * \param deviceData Device data as JSON object
 		 * \param deviceID ID of device
 		 * \return Returns pointer to created device
 		 */
-		template<class DEVICE, class ...REMAINING_DEVICES>
-		inline DeviceInterfaceConstSharedPtr getSingleDeviceInterfaceFromJSON(const nlohmann::json::const_iterator &deviceData, const DeviceIdentifier &deviceID) const
+		inline DeviceInterfaceConstSharedPtr getSingleDeviceInterfaceFromJSON(const nlohmann::json::const_iterator &deviceData, const DeviceIdentifier &deviceID)
 		{
-			// Only check DEVICE classes with an existing conversion function
-			if constexpr (dcm_t::template IsDeserializable<DEVICE>)
+			return dispatch_t::dispatchType(deviceID.Type, [&]<class DEVICE>() -> DeviceInterfaceConstSharedPtr
 			{
-				if(DEVICE::TypeName.compare(deviceID.Type) == 0)
+				// Only check DEVICE classes with an existing conversion function
+				if constexpr (dcm_t::template IsDeserializable<DEVICE>)
 				{
-					DeviceInterfaceSharedPtr newDevice(new DEVICE(this->_dcm.template deserialize<DEVICE>(deviceData)));
+					auto cachedDevice = this->template getReusableCachedDevice<DEVICE>(deviceID);
+					if(cachedDevice != nullptr)
+					{
+						this->_dcm.template update<DEVICE>(*cachedDevice, deviceData);
+						return cachedDevice;
+					}
+
+					auto newDevice = std::make_shared<DEVICE>(this->_dcm.template deserialize<DEVICE>(deviceData));
 					newDevice->setEngineName(this->engineName());
 
 					return newDevice;
 				}
-			}
-
-			// If device classess are left to check, go through them. If all device classes have been checked without proper result, throw an error
-			if constexpr (sizeof...(REMAINING_DEVICES) > 0)
-			{	return this->getSingleDeviceInterfaceFromJSON<REMAINING_DEVICES...>(deviceData, deviceID);	}
-			else
-			{	throw NRPException::logCreate("Could not deserialize given device of type \"" + deviceID.Type + "\"");	}
+				else
+				{	throw NRPException::logCreate("Could not deserialize given device of type \"" + deviceID.Type + "\"");	}
+			},
+			[&]() -> DeviceInterfaceConstSharedPtr
+			{	throw NRPException::logCreate("Could not deserialize given device of type \"" + deviceID.Type + "\"");	});
 		}
 
 		/*!
-		 * \brief Go through given DEVICES and try to create a JSON object from the device interface
-		 * \tparam DEVICE DeviceInterface Class to check
-		 * \tparam REMAINING_DEVICES Remaining DeviceInterface Classes to check
+		 * \brief Find the device type matching the device interface in DEVICES and write it into a JSON object
 		 * \param device Device data
-		 * \return Returns JSON object with device data
+		 * \param request JSON object to which the device data is added under the device name
 		 */
-		template<class DEVICE, class ...REMAINING_DEVICES>
-		inline nlohmann::json getJSONFromSingleDeviceInterface(const DeviceInterface &device) const
+		inline void getJSONFromSingleDeviceInterface(const DeviceInterface &device, nlohmann::json &request) const
 		{
-			// Only check DEVICE classes with an existing conversion function
-			if constexpr (dcm_t::template IsSerializable<DEVICE>)
+			dispatch_t::dispatchType(device.type(), [&]<class DEVICE>()
 			{
-				if(DEVICE::TypeName.compare(device.type()) == 0)
-					return this->_dcm.template serialize<DEVICE>(dynamic_cast<const DEVICE&>(device));
-			}
-
-			// If device classess are left to check, go through them. If all device classes have been checked without proper result, throw an error
-			if constexpr (sizeof...(REMAINING_DEVICES) > 0)
-			{	return this->getJSONFromSingleDeviceInterface<REMAINING_DEVICES...>(device);	}
-			else
-			{	throw NRPException::logCreate("Could not serialize given device of type \"" + device.type() + "\"");	}
+				// Only check DEVICE classes with an existing conversion function
+				if constexpr (dcm_t::template IsSerializable<DEVICE>)
+				{	this->_dcm.template serializeInto<DEVICE>(dynamic_cast<const DEVICE&>(device), request);	}
+				else
+				{	throw NRPException::logCreate("Could not serialize given device of type \"" + device.type() + "\"");	}
+			},
+			[&]()
+			{	throw NRPException::logCreate("Could not serialize given device of type \"" + device.type() + "\"");	});
 		}
 };
 
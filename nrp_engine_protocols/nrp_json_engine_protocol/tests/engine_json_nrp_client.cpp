@@ -208,4 +208,15 @@ TEST(EngineJSONNRPClientTest, ServerCalls)
 
 	ASSERT_EQ(inputDev1.data(), dev1Ctrl.data().data());
 	ASSERT_EQ(inputDev2.data(), dev2Ctrl.data().data());
+
+	// Devices only referenced by the engine cache should be updated in place
+	devices.clear();
+	std::vector<const DeviceInterface*> cachedDevices;
+	for(const auto &cachedDevice : client.getOutputDevices())
+		cachedDevices.push_back(cachedDevice.get());
+
+	devices = client.requestOutputDevices(devIDs);
+	ASSERT_EQ(devices.size(), cachedDevices.size());
+	for(size_t i = 0; i < devices.size(); ++i)
+		ASSERT_EQ(devices[i].get(), cachedDevices[i]);
 }
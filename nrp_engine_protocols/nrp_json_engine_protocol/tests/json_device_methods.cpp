@@ -85,4 +85,11 @@ TEST(JSONDeviceMethodsTest, ConversionFunctions)
 	ASSERT_EQ(dev1.id(), deserializedDev.id());
 	ASSERT_EQ((dev1.getPropertyByName<"int">()), (deserializedDev.getPropertyByName<"int">()));
 	ASSERT_STREQ((dev1.getPropertyByName<"string">().data()), (deserializedDev.getPropertyByName<"string">().data()));
+
+	// Test serialization into an existing object
+	nlohmann::json request({{"otherDev", 1}});
+	dcm_t::serializeInto(dev1, request);
+	ASSERT_EQ(request.size(), 2);
+	ASSERT_EQ(request["otherDev"].get<int>(), 1);
+	ASSERT_EQ(request[dev1.name()], serializedData.front());
 }
@@ -25,56 +25,111 @@
 #include "nrp_general_library/engine_interfaces/engine_device_controller.h"
 
 #include "nrp_gazebo_devices/physics_camera.h"
+#include "nrp_gazebo_devices/engine_server/step_synced_device_controller.h"
 
 #include <gazebo/gazebo.hh>
 #include <gazebo/sensors/CameraSensor.hh>
 #include <gazebo/rendering/Camera.hh>
 
+#include <atomic>
+
 namespace gazebo
 {
+	/*!
+	 * \brief Interface for cameras. Frames are written into a ring of buffers by the rendering thread. The latest complete frame is published at step boundaries.
+	 * Frames are only copied while the camera has been requested since the last published frame. Once a newer frame was skipped,
+	 * the published frame is outdated and no longer reported as new
+	 */
 	template<class SERIALIZER>
 	class CameraDeviceController
-	        : public EngineDeviceController<SERIALIZER, PhysicsCamera>
+	        : public EngineDeviceController<SERIALIZER, PhysicsCamera>,
+	          public StepSyncedDeviceController
 	{
+			/*!
+			 * \brief Number of frame buffers. One is published, one holds the latest complete frame, one is being written
+			 */
+			static constexpr size_t NumFrames = 3;
+
+			static constexpr size_t NoFrame = NumFrames;
+
 		public:
 			CameraDeviceController(const std::string &devName, const rendering::CameraPtr &camera, const sensors::SensorPtr &parent)
 			    : EngineDeviceController<SERIALIZER, PhysicsCamera>(PhysicsCamera::createID(devName, "")),
 			      _parentSensor(parent),
-			      _data(DeviceIdentifier(*this))
+			      _frames{PhysicsCamera(DeviceIdentifier(*this)), PhysicsCamera(DeviceIdentifier(*this)), PhysicsCamera(DeviceIdentifier(*this))}
 			{}
 
-			virtual void handleDeviceDataCallback(PhysicsCamera &&data) override
+			virtual void handleDeviceDataCallback(PhysicsCamera &&) override
 			{}
+
 			virtual const PhysicsCamera *getDeviceInformationCallback() override
 			{
-				if(this->_newDataAvailable)
+				// Copy rendered frames until the next one has been published
+				this->_requested = true;
+
+				if(this->_newDataAvailable && !this->_frontOutdated)
 				{
 					this->_newDataAvailable = false;
-					return &this->_data;
+					return &this->_frames[this->_front];
 				}
 
 				return nullptr;
 			}
 
+			virtual void swapBuffers() override
+			{
+				std::scoped_lock lock(this->_frameLock);
+				if(this->_pending != NoFrame)
+				{
+					this->_front = this->_pending;
+					this->_pending = NoFrame;
+
+					this->_newDataAvailable = true;
+					this->_frontOutdated = false;
+
+					// Stop copying frames until the camera is read again
+					this->_requested = false;
+				}
+			}
+
 			void updateCamData(const unsigned char *image, unsigned int width, unsigned int height, unsigned int depth)
 			{
 				const common::Time sensorUpdateTime = this->_parentSensor->LastMeasurementTime();
 
 				if(sensorUpdateTime > this->_lastSensorUpdateTime)
 				{
-					//std::cout << "Updating camera data\n";
 					this->_lastSensorUpdateTime = sensorUpdateTime;
 
-					// Set headers
-					this->_data.setImageHeight(height);
-					this->_data.setImageWidth(width);
-					this->_data.setImagePixelSize(depth);
+					// Skip frames nobody will read. While requested, keep copying, so that the latest frame gets published
+					if(!this->_requested)
+					{
+						// The published frame is older than this one. Don't report it as new data anymore
+						this->_frontOutdated = true;
+						return;
+					}
+
+					// Select a buffer that is neither published nor pending. Only the rendering thread writes frames
+					size_t writeFrame;
+					{
+						std::scoped_lock lock(this->_frameLock);
+						writeFrame = 0;
+						while(writeFrame == this->_front || writeFrame == this->_pending)
+							++writeFrame;
+					}
+
+					// Copy frame without holding the lock, so that swapBuffers() never waits for it
+					auto &data = this->_frames[writeFrame];
+
+					data.setImageHeight(height);
+					data.setImageWidth(width);
+					data.setImagePixelSize(depth);
 
 					const auto imageSize = width*height*depth;
-					this->_data.imageData().resize(imageSize);
-					memcpy(this->_data.imageData().data(), image, imageSize);
+					data.imageData().resize(imageSize);
+					memcpy(data.imageData().data(), image, imageSize);
 
-					this->_newDataAvailable = true;
+					std::scoped_lock lock(this->_frameLock);
+					this->_pending = writeFrame;
 				}
 			}
 
@@ -83,7 +138,35 @@ namespace gazebo
 
 			common::Time _lastSensorUpdateTime = 0;
 
-			PhysicsCamera _data;
+			/*!
+			 * \brief Frame buffers
+			 */
+			std::array<PhysicsCamera, NumFrames> _frames;
+
+			/*!
+			 * \brief Published frame. Only accessed while the engine server's device lock is held
+			 */
+			size_t _front = 0;
+
+			/*!
+			 * \brief Latest complete frame that has not been published yet. NoFrame if none
+			 */
+			size_t _pending = NoFrame;
+
+			/*!
+			 * \brief Lock for _front and _pending. Frames arrive from the rendering thread
+			 */
+			std::mutex _frameLock;
+
+			/*!
+			 * \brief Has the camera been requested since the last published frame
+			 */
+			std::atomic<bool> _requested = true;
+
+			/*!
+			 * \brief Has a newer frame than the published one been skipped
+			 */
+			std::atomic<bool> _frontOutdated = false;
 
 			bool _newDataAvailable = true;
 	};
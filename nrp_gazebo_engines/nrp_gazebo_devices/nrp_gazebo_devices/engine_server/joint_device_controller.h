@@ -23,6 +23,7 @@
 #define JOINT_DEVICE_CONTROLLER_H
 
 #include "nrp_gazebo_devices/physics_joint.h"
+#include "nrp_gazebo_devices/engine_server/step_synced_device_controller.h"
 #include "nrp_general_library/engine_interfaces/engine_device_controller.h"
 
 #include <gazebo/gazebo.hh>
@@ -32,11 +33,12 @@
 namespace gazebo
 {
 	/*!
-	 * \brief Interface for a single joint
+	 * \brief Interface for a single joint. Received commands are applied before the next step, joint state is captured after each step
 	 */
 	template<class SERIALIZATION>
 	class JointDeviceController
-	        : public EngineDeviceController<SERIALIZATION, PhysicsJoint>
+	        : public EngineDeviceController<SERIALIZATION, PhysicsJoint>,
+	          public StepSyncedDeviceController
 	{
 			using fcn_ptr_t = void(physics::JointPtr, double, int);
 
@@ -45,37 +47,54 @@ namespace gazebo
 			    : EngineDeviceController<SERIALIZATION, PhysicsJoint>(PhysicsJoint::createID(jointName, "")),
 			      _joint(joint),
 			      _jointController(jointController),
-			      _jointData(DeviceIdentifier(*this))
-			{}
+			      _jointData(DeviceIdentifier(*this)),
+			      _command(DeviceIdentifier(*this))
+			{
+				// Make initial state available before the first step
+				this->captureState();
+				this->swapBuffers();
+			}
 
 			virtual void handleDeviceDataCallback(PhysicsJoint &&data) override
 			{
-				this->_jointData = std::move(data);
+				// Physics may be running. Store command until the next step starts
+				this->_command = std::move(data);
+				this->_newCommand = true;
+			}
+
+			virtual const PhysicsJoint *getDeviceInformationCallback() override
+			{	return &(this->_jointData.front());	}
+
+			virtual void applyCommands() override
+			{
+				if(!this->_newCommand)
+					return;
 
-				//std::cout << std::to_string(this->_jointData.position()) << std::endl;
-				//std::cout << std::to_string(this->_jointData.velocity()) << std::endl;
-				//std::cout << std::to_string(this->_jointData.effort()) << std::endl;
+				this->_newCommand = false;
 
-				const auto &jointName = this->_jointData.name();
-				if(!std::isnan(this->_jointData.position()))
-					this->_jointController->SetPositionTarget(jointName, this->_jointData.position());
+				const auto &jointName = this->_command.name();
+				if(!std::isnan(this->_command.position()))
+					this->_jointController->SetPositionTarget(jointName, this->_command.position());
 
-				if(!std::isnan(this->_jointData.velocity()))
-					this->_jointController->SetVelocityTarget(jointName, this->_jointData.velocity());
+				if(!std::isnan(this->_command.velocity()))
+					this->_jointController->SetVelocityTarget(jointName, this->_command.velocity());
 
-				if(!std::isnan(this->_jointData.effort()))
-					this->_joint->SetForce(0, this->_jointData.effort());
+				if(!std::isnan(this->_command.effort()))
+					this->_joint->SetForce(0, this->_command.effort());
 			}
 
-			virtual const PhysicsJoint *getDeviceInformationCallback() override
+			virtual void captureState() override
 			{
-				this->_jointData.setPosition(this->_joint->Position(0));
-				this->_jointData.setVelocity(this->_joint->GetVelocity(0));
-				this->_jointData.setEffort(this->_joint->GetForce(0));
+				auto &data = this->_jointData.back();
 
-				return &(this->_jointData);
+				data.setPosition(this->_joint->Position(0));
+				data.setVelocity(this->_joint->GetVelocity(0));
+				data.setEffort(this->_joint->GetForce(0));
 			}
 
+			virtual void swapBuffers() override
+			{	this->_jointData.swap();	}
+
 		private:
 			/*!
 			 * \brief Pointer to joint
@@ -88,9 +107,19 @@ namespace gazebo
 			physics::JointControllerPtr _jointController = nullptr;
 
 			/*!
-			 * \brief Data of link
+			 * \brief Data of joint
+			 */
+			DoubleBufferedDevice<PhysicsJoint> _jointData;
+
+			/*!
+			 * \brief Last received command. Protected by the engine server's device lock
+			 */
+			PhysicsJoint _command;
+
+			/*!
+			 * \brief Has a command been received since the last step
 			 */
-			PhysicsJoint _jointData;
+			bool _newCommand = false;
 	};
 }
 
@@ -23,6 +23,7 @@
 #define LINK_DEVICE_CONTROLLER_H
 
 #include "nrp_gazebo_devices/physics_link.h"
+#include "nrp_gazebo_devices/engine_server/step_synced_device_controller.h"
 #include "nrp_general_library/engine_interfaces/engine_device_controller.h"
 
 #include <gazebo/gazebo.hh>
@@ -31,11 +32,12 @@
 namespace gazebo
 {
 	/*!
-	 * \brief Interface for links
+	 * \brief Interface for links. Link state is captured after each step, reads are served from the previous capture
 	 */
 	template<class SERIALIZATION>
 	class LinkDeviceController
-	        : public EngineDeviceController<SERIALIZATION, PhysicsLink>
+	        : public EngineDeviceController<SERIALIZATION, PhysicsLink>,
+	          public StepSyncedDeviceController
 	{
 			template<class T>
 			constexpr static float ToFloat(const T &val)
@@ -46,31 +48,41 @@ namespace gazebo
 			    : EngineDeviceController<SERIALIZATION, PhysicsLink>(PhysicsLink::createID(linkName, "")),
 			      _data(DeviceIdentifier(*this)),
 			      _link(link)
-			{}
+			{
+				// Make initial state available before the first step
+				this->captureState();
+				this->swapBuffers();
+			}
 
-			virtual void handleDeviceDataCallback(PhysicsLink &&data) override
+			virtual void handleDeviceDataCallback(PhysicsLink &&) override
 			{}
 
 			virtual const PhysicsLink *getDeviceInformationCallback() override
+			{	return &(this->_data.front());	}
+
+			virtual void captureState() override
 			{
+				auto &data = this->_data.back();
+
 				const auto &pose = this->_link->WorldCoGPose();
-				this->_data.setPosition({ ToFloat(pose.Pos().X()), ToFloat(pose.Pos().Y()), ToFloat(pose.Pos().Z())	});
-				this->_data.setRotation({ ToFloat(pose.Rot().X()), ToFloat(pose.Rot().Y()), ToFloat(pose.Rot().Z())	});
+				data.setPosition({ ToFloat(pose.Pos().X()), ToFloat(pose.Pos().Y()), ToFloat(pose.Pos().Z())	});
+				data.setRotation({ ToFloat(pose.Rot().X()), ToFloat(pose.Rot().Y()), ToFloat(pose.Rot().Z())	});
 
 				const auto &linVel = this->_link->WorldLinearVel();
-				this->_data.setLinVel({ ToFloat(linVel.X()), ToFloat(linVel.Y()), ToFloat(linVel.Z())	});
+				data.setLinVel({ ToFloat(linVel.X()), ToFloat(linVel.Y()), ToFloat(linVel.Z())	});
 
 				const auto &angVel = this->_link->WorldAngularVel();
-				this->_data.setAngVel({ ToFloat(angVel.X()), ToFloat(angVel.Y()), ToFloat(angVel.Z())	});
-
-				return &(this->_data);
+				data.setAngVel({ ToFloat(angVel.X()), ToFloat(angVel.Y()), ToFloat(angVel.Z())	});
 			}
 
+			virtual void swapBuffers() override
+			{	this->_data.swap();	}
+
 		private:
 			/*!
 			 * \brief Link Data
 			 */
-			PhysicsLink _data;
+			DoubleBufferedDevice<PhysicsLink> _data;
 
 			/*!
 			 * \brief Pointer to link
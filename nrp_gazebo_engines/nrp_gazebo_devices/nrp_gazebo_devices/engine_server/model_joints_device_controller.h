@@ -0,0 +1,228 @@
+/* * NRP Core - Backend infrastructure to synchronize simulations
+ *
+ * Copyright 2020 Michael Zechmair
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This project has received funding from the European Union’s Horizon 2020
+ * Framework Programme for Research and Innovation under the Specific Grant
+ * Agreement No. 945539 (Human Brain Project SGA3).
+ */
+
+#ifndef MODEL_JOINTS_DEVICE_CONTROLLER_H
+#define MODEL_JOINTS_DEVICE_CONTROLLER_H
+
+#include "nrp_gazebo_devices/physics_joints.h"
+#include "nrp_gazebo_devices/engine_server/step_synced_device_controller.h"
+#include "nrp_general_library/engine_interfaces/engine_device_controller.h"
+#include "nrp_general_library/utils/nrp_exceptions.h"
+
+#include <gazebo/gazebo.hh>
+#include <gazebo/physics/JointController.hh>
+#include <gazebo/physics/Joint.hh>
+
+#include <limits>
+#include <unordered_map>
+
+namespace gazebo
+{
+	/*!
+	 * \brief Interface for all joints of a model. Commands for all joints are applied in a single pass before the next step,
+	 * the state of all joints is captured after each step
+	 */
+	template<class SERIALIZATION>
+	class ModelJointsDeviceController
+	        : public EngineDeviceController<SERIALIZATION, PhysicsJoints>,
+	          public StepSyncedDeviceController
+	{
+			static constexpr size_t NoJoint = std::numeric_limits<size_t>::max();
+
+		public:
+			/*!
+			 * \param joints Joints to control. Device arrays use the same order
+			 * \param jointController Joint controller of the joints' model
+			 * \param deviceName Name of device
+			 */
+			ModelJointsDeviceController(const physics::Joint_V &joints, const physics::JointControllerPtr &jointController, const std::string &deviceName)
+			    : EngineDeviceController<SERIALIZATION, PhysicsJoints>(PhysicsJoints::createID(deviceName, "")),
+			      _joints(joints),
+			      _jointController(jointController),
+			      _jointData(DeviceIdentifier(*this)),
+			      _command(DeviceIdentifier(*this))
+			{
+				this->_scopedNames.reserve(this->_joints.size());
+				for(size_t i = 0; i < this->_joints.size(); ++i)
+				{
+					this->_scopedNames.push_back(this->_joints[i]->GetScopedName());
+
+					this->_jointIndices.emplace(this->_joints[i]->GetName(), i);
+					this->_jointIndices.emplace(this->_scopedNames.back(), i);
+				}
+
+				// Joint names don't change, set them once in both buffers
+				for(unsigned int i = 0; i < 2; ++i)
+				{
+					auto &data = this->_jointData.back();
+					data.resize(this->_joints.size());
+					for(size_t j = 0; j < this->_joints.size(); ++j)
+						data.names()[j] = this->_joints[j]->GetName();
+
+					this->_jointData.swap();
+				}
+
+				// Make initial state available before the first step
+				this->captureState();
+				this->swapBuffers();
+			}
+
+			virtual void handleDeviceDataCallback(PhysicsJoints &&data) override
+			{
+				// Physics may be running. Validate the command now, apply it when the next step starts
+				const size_t numValues = data.names().empty() ? this->_joints.size() : data.numJoints();
+				if(data.positions().size() > numValues || data.velocities().size() > numValues || data.efforts().size() > numValues)
+					throw NRPException::logCreate("Device \"" + this->Name + "\" received more joint values than joints");
+
+				this->updateCommandIndices(data.names());
+
+				this->_command = std::move(data);
+				this->_newCommand = true;
+			}
+
+			virtual const PhysicsJoints *getDeviceInformationCallback() override
+			{	return &(this->_jointData.front());	}
+
+			virtual void applyCommands() override
+			{
+				if(!this->_newCommand)
+					return;
+
+				this->_newCommand = false;
+
+				const auto &positions = this->_command.positions();
+				const auto &velocities = this->_command.velocities();
+				const auto &efforts = this->_command.efforts();
+
+				for(size_t i = 0; i < this->_commandIndices.size(); ++i)
+				{
+					const size_t jointIndex = this->_commandIndices[i];
+					const auto &scopedName = this->_scopedNames[jointIndex];
+
+					if(i < positions.size() && !std::isnan(positions[i]))
+						this->_jointController->SetPositionTarget(scopedName, positions[i]);
+
+					if(i < velocities.size() && !std::isnan(velocities[i]))
+						this->_jointController->SetVelocityTarget(scopedName, velocities[i]);
+
+					if(i < efforts.size() && !std::isnan(efforts[i]))
+						this->_joints[jointIndex]->SetForce(0, efforts[i]);
+				}
+			}
+
+			virtual void captureState() override
+			{
+				auto &data = this->_jointData.back();
+				auto &positions = data.positions();
+				auto &velocities = data.velocities();
+				auto &efforts = data.efforts();
+
+				for(size_t i = 0; i < this->_joints.size(); ++i)
+				{
+					const auto &joint = this->_joints[i];
+
+					positions[i] = joint->Position(0);
+					velocities[i] = joint->GetVelocity(0);
+					efforts[i] = joint->GetForce(0);
+				}
+			}
+
+			virtual void swapBuffers() override
+			{	this->_jointData.swap();	}
+
+		private:
+			/*!
+			 * \brief Controlled joints
+			 */
+			physics::Joint_V _joints;
+
+			/*!
+			 * \brief Scoped names of _joints, as required by the joint controller
+			 */
+			std::vector<std::string> _scopedNames;
+
+			/*!
+			 * \brief Maps joint names and scoped joint names to their index in _joints
+			 */
+			std::unordered_map<std::string, size_t> _jointIndices;
+
+			/*!
+			 * \brief Pointer to joint controller of the joints' model
+			 */
+			physics::JointControllerPtr _jointController = nullptr;
+
+			/*!
+			 * \brief Data of all joints
+			 */
+			DoubleBufferedDevice<PhysicsJoints> _jointData;
+
+			/*!
+			 * \brief Last received command. Protected by the engine server's device lock
+			 */
+			PhysicsJoints _command;
+
+			/*!
+			 * \brief Index in _joints of every entry in the last command
+			 */
+			std::vector<size_t> _commandIndices;
+
+			/*!
+			 * \brief Has a command been received since the last step
+			 */
+			bool _newCommand = false;
+
+			/*!
+			 * \brief Map command entries to joints. The mapping is only recomputed if the command's joint names differ from
+			 * those of the previous command. Must be called before the new command replaces _command
+			 * \param names Joint names of command. If empty, command values are in joint order
+			 */
+			void updateCommandIndices(const PhysicsJoints::joint_names_t &names)
+			{
+				const auto &prevNames = this->_command.names();
+
+				if(names.empty())
+				{
+					if(prevNames.empty() && this->_commandIndices.size() == this->_joints.size())
+						return;
+
+					this->_commandIndices.resize(this->_joints.size());
+					for(size_t i = 0; i < this->_joints.size(); ++i)
+						this->_commandIndices[i] = i;
+				}
+				else if(names.size() != prevNames.size() || names != prevNames)
+				{
+					std::vector<size_t> indices(names.size(), NoJoint);
+					for(size_t i = 0; i < names.size(); ++i)
+					{
+						const auto jointIt = this->_jointIndices.find(names[i]);
+						if(jointIt == this->_jointIndices.end())
+							throw NRPException::logCreate("Device \"" + this->Name + "\" has no joint named \"" + names[i] + "\"");
+
+						indices[i] = jointIt->second;
+					}
+
+					this->_commandIndices = std::move(indices);
+				}
+			}
+	};
+}
+
+#endif // MODEL_JOINTS_DEVICE_CONTROLLER_H
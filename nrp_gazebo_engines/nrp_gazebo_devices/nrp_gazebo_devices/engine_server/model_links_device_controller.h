@@ -0,0 +1,209 @@
+/* * NRP Core - Backend infrastructure to synchronize simulations
+ *
+ * Copyright 2020 Michael Zechmair
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This project has received funding from the European Union’s Horizon 2020
+ * Framework Programme for Research and Innovation under the Specific Grant
+ * Agreement No. 945539 (Human Brain Project SGA3).
+ */
+
+#ifndef MODEL_LINKS_DEVICE_CONTROLLER_H
+#define MODEL_LINKS_DEVICE_CONTROLLER_H
+
+#include "nrp_gazebo_devices/physics_links.h"
+#include "nrp_gazebo_devices/engine_server/step_synced_device_controller.h"
+#include "nrp_general_library/engine_interfaces/engine_device_controller.h"
+#include "nrp_general_library/utils/nrp_exceptions.h"
+
+#include <gazebo/gazebo.hh>
+#include <gazebo/physics/Link.hh>
+
+#include <unordered_map>
+
+namespace gazebo
+{
+	/*!
+	 * \brief Interface for multiple links of a model. The state of all selected links is captured in a single pass after each step.
+	 * Receiving a PhysicsLinks device changes the selected links, starting with the next step
+	 */
+	template<class SERIALIZATION>
+	class ModelLinksDeviceController
+	        : public EngineDeviceController<SERIALIZATION, PhysicsLinks>,
+	          public StepSyncedDeviceController
+	{
+			template<class T>
+			constexpr static float ToFloat(const T &val)
+			{	return static_cast<float>(val);	}
+
+		public:
+			/*!
+			 * \param links Links that can be selected. Initially, all of them are selected
+			 * \param deviceName Name of device
+			 */
+			ModelLinksDeviceController(const physics::Link_V &links, const std::string &deviceName)
+			    : EngineDeviceController<SERIALIZATION, PhysicsLinks>(PhysicsLinks::createID(deviceName, "")),
+			      _links(links),
+			      _data(DeviceIdentifier(*this))
+			{
+				for(size_t i = 0; i < this->_links.size(); ++i)
+				{
+					this->_linkIndices.emplace(this->_links[i]->GetName(), i);
+					this->_linkIndices.emplace(this->_links[i]->GetScopedName(), i);
+				}
+
+				this->selectLinks(PhysicsLinks::link_names_t());
+				this->applyCommands();
+
+				// Make initial state available before the first step
+				this->captureState();
+				this->swapBuffers();
+			}
+
+			virtual void handleDeviceDataCallback(PhysicsLinks &&data) override
+			{	this->selectLinks(data.names());	}
+
+			virtual const PhysicsLinks *getDeviceInformationCallback() override
+			{	return &(this->_data.front());	}
+
+			virtual void applyCommands() override
+			{
+				if(!this->_newSelection)
+					return;
+
+				this->_newSelection = false;
+
+				this->_selection = std::move(this->_pendingSelection);
+				this->_pendingSelection.clear();
+
+				// Both buffers must receive the new names
+				this->_outdatedBuffers = 2;
+			}
+
+			virtual void captureState() override
+			{
+				auto &data = this->_data.back();
+
+				if(this->_outdatedBuffers > 0)
+				{
+					--this->_outdatedBuffers;
+
+					data.resize(this->_selection.size());
+					for(size_t i = 0; i < this->_selection.size(); ++i)
+						data.names()[i] = this->_links[this->_selection[i]]->GetName();
+				}
+
+				float *pos = data.positions().data();
+				float *rot = data.rotations().data();
+				float *linVel = data.linVels().data();
+				float *angVel = data.angVels().data();
+
+				for(const size_t linkIndex : this->_selection)
+				{
+					const auto &link = this->_links[linkIndex];
+
+					const auto &pose = link->WorldCoGPose();
+					*(pos++) = ToFloat(pose.Pos().X());
+					*(pos++) = ToFloat(pose.Pos().Y());
+					*(pos++) = ToFloat(pose.Pos().Z());
+
+					*(rot++) = ToFloat(pose.Rot().X());
+					*(rot++) = ToFloat(pose.Rot().Y());
+					*(rot++) = ToFloat(pose.Rot().Z());
+					*(rot++) = ToFloat(pose.Rot().W());
+
+					const auto &lin = link->WorldLinearVel();
+					*(linVel++) = ToFloat(lin.X());
+					*(linVel++) = ToFloat(lin.Y());
+					*(linVel++) = ToFloat(lin.Z());
+
+					const auto &ang = link->WorldAngularVel();
+					*(angVel++) = ToFloat(ang.X());
+					*(angVel++) = ToFloat(ang.Y());
+					*(angVel++) = ToFloat(ang.Z());
+				}
+			}
+
+			virtual void swapBuffers() override
+			{	this->_data.swap();	}
+
+		private:
+			/*!
+			 * \brief Links that can be selected
+			 */
+			physics::Link_V _links;
+
+			/*!
+			 * \brief Maps link names and scoped link names to their index in _links
+			 */
+			std::unordered_map<std::string, size_t> _linkIndices;
+
+			/*!
+			 * \brief Indices in _links of the links that are currently reported
+			 */
+			std::vector<size_t> _selection;
+
+			/*!
+			 * \brief Selection received from the client. Applied before the next step. Protected by the engine server's device lock
+			 */
+			std::vector<size_t> _pendingSelection;
+
+			/*!
+			 * \brief Has a new selection been received since the last step
+			 */
+			bool _newSelection = false;
+
+			/*!
+			 * \brief Number of buffers whose names and array sizes don't match _selection yet
+			 */
+			unsigned int _outdatedBuffers = 0;
+
+			/*!
+			 * \brief Link Data
+			 */
+			DoubleBufferedDevice<PhysicsLinks> _data;
+
+			/*!
+			 * \brief Store a new selection of links
+			 * \param names Names of selected links. If empty, all links are selected
+			 */
+			void selectLinks(const PhysicsLinks::link_names_t &names)
+			{
+				std::vector<size_t> selection;
+				if(names.empty())
+				{
+					selection.resize(this->_links.size());
+					for(size_t i = 0; i < this->_links.size(); ++i)
+						selection[i] = i;
+				}
+				else
+				{
+					selection.reserve(names.size());
+					for(const auto &name : names)
+					{
+						const auto linkIt = this->_linkIndices.find(name);
+						if(linkIt == this->_linkIndices.end())
+							throw NRPException::logCreate("Device \"" + this->Name + "\" has no link named \"" + name + "\"");
+
+						selection.push_back(linkIt->second);
+					}
+				}
+
+				this->_pendingSelection = std::move(selection);
+				this->_newSelection = true;
+			}
+	};
+}
+
+#endif // MODEL_LINKS_DEVICE_CONTROLLER_H
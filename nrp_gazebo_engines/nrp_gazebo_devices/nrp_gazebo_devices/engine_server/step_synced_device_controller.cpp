@@ -0,0 +1,70 @@
+//
+// NRP Core - Backend infrastructure to synchronize simulations
+//
+// Copyright 2020 Michael Zechmair
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This project has received funding from the European Union’s Horizon 2020
+// Framework Programme for Research and Innovation under the Specific Grant
+// Agreement No. 945539 (Human Brain Project SGA3).
+//
+
+
+#include "nrp_gazebo_devices/engine_server/step_synced_device_controller.h"
+
+std::mutex gazebo::StepSyncedDeviceController::_controllersLock;
+std::set<gazebo::StepSyncedDeviceController*> gazebo::StepSyncedDeviceController::_controllers;
+
+gazebo::StepSyncedDeviceController::StepSyncedDeviceController()
+{
+	std::scoped_lock lock(StepSyncedDeviceController::_controllersLock);
+	StepSyncedDeviceController::_controllers.insert(this);
+}
+
+gazebo::StepSyncedDeviceController::StepSyncedDeviceController(const StepSyncedDeviceController &)
+    : StepSyncedDeviceController()
+{}
+
+gazebo::StepSyncedDeviceController::~StepSyncedDeviceController()
+{
+	std::scoped_lock lock(StepSyncedDeviceController::_controllersLock);
+	StepSyncedDeviceController::_controllers.erase(this);
+}
+
+void gazebo::StepSyncedDeviceController::applyCommands()
+{}
+
+void gazebo::StepSyncedDeviceController::captureState()
+{}
+
+void gazebo::StepSyncedDeviceController::applyAllCommands()
+{
+	std::scoped_lock lock(StepSyncedDeviceController::_controllersLock);
+	for(auto *const controller : StepSyncedDeviceController::_controllers)
+		controller->applyCommands();
+}
+
+void gazebo::StepSyncedDeviceController::captureAllStates()
+{
+	std::scoped_lock lock(StepSyncedDeviceController::_controllersLock);
+	for(auto *const controller : StepSyncedDeviceController::_controllers)
+		controller->captureState();
+}
+
+void gazebo::StepSyncedDeviceController::swapAllBuffers()
+{
+	std::scoped_lock lock(StepSyncedDeviceController::_controllersLock);
+	for(auto *const controller : StepSyncedDeviceController::_controllers)
+		controller->swapBuffers();
+}
@@ -0,0 +1,127 @@
+/* * NRP Core - Backend infrastructure to synchronize simulations
+ *
+ * Copyright 2020 Michael Zechmair
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This project has received funding from the European Union’s Horizon 2020
+ * Framework Programme for Research and Innovation under the Specific Grant
+ * Agreement No. 945539 (Human Brain Project SGA3).
+ */
+
+
+#ifndef STEP_SYNCED_DEVICE_CONTROLLER_H
+#define STEP_SYNCED_DEVICE_CONTROLLER_H
+
+#include "nrp_general_library/device_interface/device_interface.h"
+
+#include <array>
+#include <mutex>
+#include <set>
+
+namespace gazebo
+{
+	/*!
+	 * \brief Device controller whose data is exchanged with Gazebo only at step boundaries.
+	 * While the world is being stepped, device reads are served from a front buffer and received commands are held back,
+	 * so neither has to wait for physics to finish. All constructed controllers are registered automatically
+	 */
+	class StepSyncedDeviceController
+	{
+		public:
+			StepSyncedDeviceController();
+			StepSyncedDeviceController(const StepSyncedDeviceController &);
+			virtual ~StepSyncedDeviceController();
+
+			StepSyncedDeviceController &operator=(const StepSyncedDeviceController &) = default;
+
+			/*!
+			 * \brief Apply commands received since the last step. Called before stepping, while device access is locked
+			 */
+			virtual void applyCommands();
+
+			/*!
+			 * \brief Write the current world state into the back buffer. Called after stepping, while device access is NOT locked.
+			 * Must not touch the front buffer
+			 */
+			virtual void captureState();
+
+			/*!
+			 * \brief Make the back buffer available to device reads. Called after captureState(), while device access is locked
+			 */
+			virtual void swapBuffers() = 0;
+
+			/*!
+			 * \brief Call applyCommands() on all registered controllers
+			 */
+			static void applyAllCommands();
+
+			/*!
+			 * \brief Call captureState() on all registered controllers
+			 */
+			static void captureAllStates();
+
+			/*!
+			 * \brief Call swapBuffers() on all registered controllers
+			 */
+			static void swapAllBuffers();
+
+		private:
+			/*!
+			 * \brief Lock for _controllers
+			 */
+			static std::mutex _controllersLock;
+
+			/*!
+			 * \brief All constructed controllers
+			 */
+			static std::set<StepSyncedDeviceController*> _controllers;
+	};
+
+	/*!
+	 * \brief Front and back buffer of a device
+	 * \tparam DEVICE Device type
+	 */
+	template<DEVICE_C DEVICE>
+	class DoubleBufferedDevice
+	{
+		public:
+			DoubleBufferedDevice(const DeviceIdentifier &id)
+			    : _buffers{DEVICE(DeviceIdentifier(id)), DEVICE(DeviceIdentifier(id))}
+			{}
+
+			/*!
+			 * \brief Buffer served to device reads
+			 */
+			const DEVICE &front() const
+			{	return this->_buffers[this->_front];	}
+
+			/*!
+			 * \brief Buffer written with the latest world state
+			 */
+			DEVICE &back()
+			{	return this->_buffers[1 - this->_front];	}
+
+			/*!
+			 * \brief Exchange front and back buffer
+			 */
+			void swap()
+			{	this->_front = 1 - this->_front;	}
+
+		private:
+			std::array<DEVICE, 2> _buffers;
+			unsigned int _front = 0;
+	};
+}
+
+#endif // STEP_SYNCED_DEVICE_CONTROLLER_H
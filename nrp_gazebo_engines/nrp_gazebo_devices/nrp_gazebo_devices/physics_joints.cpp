@@ -0,0 +1,127 @@
+//
+// NRP Core - Backend infrastructure to synchronize simulations
+//
+// Copyright 2020 Michael Zechmair
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This project has received funding from the European Union’s Horizon 2020
+// Framework Programme for Research and Innovation under the Specific Grant
+// Agreement No. 945539 (Human Brain Project SGA3).
+//
+
+#include "nrp_gazebo_devices/physics_joints.h"
+
+#include "nrp_general_library/utils/nrp_exceptions.h"
+
+size_t PhysicsJoints::numJoints() const
+{
+	return this->names().size();
+}
+
+void PhysicsJoints::resize(size_t numJoints)
+{
+	this->names().resize(numJoints);
+	this->positions().resize(numJoints, NAN);
+	this->velocities().resize(numJoints, NAN);
+	this->efforts().resize(numJoints, NAN);
+}
+
+const PhysicsJointsConst::joint_names_t &PhysicsJoints::names() const
+{
+	return this->getPropertyByName<Names>();
+}
+
+PhysicsJointsConst::joint_names_t &PhysicsJoints::names()
+{
+	return this->getPropertyByName<Names>();
+}
+
+void PhysicsJoints::setNames(const joint_names_t &names)
+{
+	this->getPropertyByName<Names>() = names;
+}
+
+const PhysicsJointsConst::joint_values_t &PhysicsJoints::positions() const
+{
+	return this->getPropertyByName<Positions>();
+}
+
+PhysicsJointsConst::joint_values_t &PhysicsJoints::positions()
+{
+	return this->getPropertyByName<Positions>();
+}
+
+void PhysicsJoints::setPositions(const joint_values_t &positions)
+{
+	this->getPropertyByName<Positions>() = positions;
+}
+
+const PhysicsJointsConst::joint_values_t &PhysicsJoints::velocities() const
+{
+	return this->getPropertyByName<Velocities>();
+}
+
+PhysicsJointsConst::joint_values_t &PhysicsJoints::velocities()
+{
+	return this->getPropertyByName<Velocities>();
+}
+
+void PhysicsJoints::setVelocities(const joint_values_t &velocities)
+{
+	this->getPropertyByName<Velocities>() = velocities;
+}
+
+const PhysicsJointsConst::joint_values_t &PhysicsJoints::efforts() const
+{
+	return this->getPropertyByName<Efforts>();
+}
+
+PhysicsJointsConst::joint_values_t &PhysicsJoints::efforts()
+{
+	return this->getPropertyByName<Efforts>();
+}
+
+void PhysicsJoints::setEfforts(const joint_values_t &efforts)
+{
+	this->getPropertyByName<Efforts>() = efforts;
+}
+
+template<>
+nlohmann::json JSONPropertySerializerMethods::serializeSingleProperty(const PhysicsJointsConst::joint_values_t &property)
+{
+	// NaN values are stored as null
+	nlohmann::json data = nlohmann::json::array();
+	for(const auto &val : property)
+		data.push_back(static_cast<float>(val));
+
+	return data;
+}
+
+template<>
+PhysicsJointsConst::joint_values_t JSONPropertySerializerMethods::deserializeSingleProperty(const nlohmann::json &data, const std::string_view &name)
+{
+	const auto dataIterator(data.find(name.data()));
+	if(dataIterator == data.end())
+		throw NRPExceptionMissingProperty(std::string("Couldn't find JSON attribute \"") + name.data() + "\" during deserialization");
+
+	PhysicsJointsConst::joint_values_t values;
+	if(!dataIterator->is_array())
+		return values;
+
+	values.reserve(dataIterator->size());
+	for(const auto &val : *dataIterator)
+		values.emplace_back(val.is_number() ? val.get<float>() : NAN);
+
+	return values;
+}
@@ -0,0 +1,123 @@
+/* * NRP Core - Backend infrastructure to synchronize simulations
+ *
+ * Copyright 2020 Michael Zechmair
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This project has received funding from the European Union’s Horizon 2020
+ * Framework Programme for Research and Innovation under the Specific Grant
+ * Agreement No. 945539 (Human Brain Project SGA3).
+ */
+
+#ifndef PHYSICS_JOINTS_H
+#define PHYSICS_JOINTS_H
+
+#include "nrp_gazebo_devices/physics_joint.h"
+
+#include <string>
+#include <vector>
+
+class PhysicsJoints;
+
+struct PhysicsJointsConst
+{
+	using joint_names_t = std::vector<std::string>;
+	using joint_values_t = std::vector<PhysicsJointConst::FloatNan>;
+
+	/*!
+	 * \brief Joint names. Determines the order of all value arrays
+	 */
+	static constexpr FixedString Names = "names";
+
+	/*!
+	 * \brief Joint positions (in rad). NaN entries are ignored when setting data
+	 */
+	static constexpr FixedString Positions = "positions";
+
+	/*!
+	 * \brief Joint velocities (in rad/s). NaN entries are ignored when setting data
+	 */
+	static constexpr FixedString Velocities = "velocities";
+
+	/*!
+	 * \brief Joint efforts (in N). NaN entries are ignored when setting data
+	 */
+	static constexpr FixedString Efforts = "efforts";
+
+	using JPropNames = PropNames<Names, Positions, Velocities, Efforts>;
+};
+
+/*!
+ * \brief Joint data of all joints of a single model. Allows reading and commanding an entire model with a single device
+ */
+class PhysicsJoints
+        : public PhysicsJointsConst,
+          public Device<PhysicsJoints, "PhysicsJoints", PhysicsJointsConst::JPropNames, PhysicsJointsConst::joint_names_t, PhysicsJointsConst::joint_values_t, PhysicsJointsConst::joint_values_t, PhysicsJointsConst::joint_values_t>
+{
+	public:
+		PhysicsJoints(DeviceIdentifier &&devID, property_template_t &&props = property_template_t(joint_names_t(), joint_values_t(), joint_values_t(), joint_values_t()))
+		    : Device(std::move(devID), std::move(props))
+		{}
+
+		template<class DESERIALIZE_T>
+		static auto deserializeProperties(DESERIALIZE_T &&data)
+		{	return Device::deserializeProperties(std::forward<DESERIALIZE_T>(data), joint_names_t(), joint_values_t(), joint_values_t(), joint_values_t());	}
+
+		/*!
+		 * \brief Number of joints stored in this device
+		 */
+		size_t numJoints() const;
+
+		/*!
+		 * \brief Resize all arrays to numJoints. New values are set to NaN
+		 */
+		void resize(size_t numJoints);
+
+		const joint_names_t &names() const;
+		joint_names_t &names();
+		void setNames(const joint_names_t &names);
+
+		const joint_values_t &positions() const;
+		joint_values_t &positions();
+		void setPositions(const joint_values_t &positions);
+
+		const joint_values_t &velocities() const;
+		joint_values_t &velocities();
+		void setVelocities(const joint_values_t &velocities);
+
+		const joint_values_t &efforts() const;
+		joint_values_t &efforts();
+		void setEfforts(const joint_values_t &efforts);
+};
+
+template<>
+nlohmann::json JSONPropertySerializerMethods::serializeSingleProperty(const PhysicsJointsConst::joint_values_t &property);
+
+template<>
+PhysicsJointsConst::joint_values_t JSONPropertySerializerMethods::deserializeSingleProperty(const nlohmann::json &data, const std::string_view &name);
+
+
+/*! \addtogroup gazebo_devices
+ * The PhysicsJoints Device consists of the following attributes. All arrays have the same length. When sending data,
+ * the names array selects which joints are commanded. If it is empty, values are applied in the order in which the engine reports its joints:
+ * <table>
+ * <caption id="physics_joints_attributes_table">Physics Joints Attributes</caption>
+ * <tr><th>Attribute   <th>Description                          <th>Python Type    <th>C type
+ * <tr><td>names       <td>Joint names                          <td>list of str    <td>std::vector<std::string>
+ * <tr><td>positions   <td>Joint angle positions (in rad)       <td>list of float  <td>std::vector<float>
+ * <tr><td>velocities  <td>Joint angle velocities (in rad/s)    <td>list of float  <td>std::vector<float>
+ * <tr><td>efforts     <td>Joint angle efforts (in N)           <td>list of float  <td>std::vector<float>
+ * </table>
+ */
+
+#endif // PHYSICS_JOINTS_H
@@ -0,0 +1,93 @@
+//
+// NRP Core - Backend infrastructure to synchronize simulations
+//
+// Copyright 2020 Michael Zechmair
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This project has received funding from the European Union’s Horizon 2020
+// Framework Programme for Research and Innovation under the Specific Grant
+// Agreement No. 945539 (Human Brain Project SGA3).
+//
+
+#include "nrp_gazebo_devices/physics_links.h"
+
+
+size_t PhysicsLinks::numLinks() const
+{
+	return this->names().size();
+}
+
+void PhysicsLinks::resize(size_t numLinks)
+{
+	this->names().resize(numLinks);
+	this->positions().resize(numLinks*Vec3Size);
+	this->rotations().resize(numLinks*QuatSize);
+	this->linVels().resize(numLinks*Vec3Size);
+	this->angVels().resize(numLinks*Vec3Size);
+}
+
+const PhysicsLinksConst::link_names_t &PhysicsLinks::names() const
+{
+	return this->getPropertyByName<Names>();
+}
+
+PhysicsLinksConst::link_names_t &PhysicsLinks::names()
+{
+	return this->getPropertyByName<Names>();
+}
+
+void PhysicsLinks::setNames(const link_names_t &names)
+{
+	this->getPropertyByName<Names>() = names;
+}
+
+const PhysicsLinksConst::link_data_t &PhysicsLinks::positions() const
+{
+	return this->getPropertyByName<Positions>();
+}
+
+PhysicsLinksConst::link_data_t &PhysicsLinks::positions()
+{
+	return this->getPropertyByName<Positions>();
+}
+
+const PhysicsLinksConst::link_data_t &PhysicsLinks::rotations() const
+{
+	return this->getPropertyByName<Rotations>();
+}
+
+PhysicsLinksConst::link_data_t &PhysicsLinks::rotations()
+{
+	return this->getPropertyByName<Rotations>();
+}
+
+const PhysicsLinksConst::link_data_t &PhysicsLinks::linVels() const
+{
+	return this->getPropertyByName<LinearVelocities>();
+}
+
+PhysicsLinksConst::link_data_t &PhysicsLinks::linVels()
+{
+	return this->getPropertyByName<LinearVelocities>();
+}
+
+const PhysicsLinksConst::link_data_t &PhysicsLinks::angVels() const
+{
+	return this->getPropertyByName<AngularVelocities>();
+}
+
+PhysicsLinksConst::link_data_t &PhysicsLinks::angVels()
+{
+	return this->getPropertyByName<AngularVelocities>();
+}
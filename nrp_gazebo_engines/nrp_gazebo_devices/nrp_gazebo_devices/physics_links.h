@@ -0,0 +1,133 @@
+/* * NRP Core - Backend infrastructure to synchronize simulations
+ *
+ * Copyright 2020 Michael Zechmair
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This project has received funding from the European Union’s Horizon 2020
+ * Framework Programme for Research and Innovation under the Specific Grant
+ * Agreement No. 945539 (Human Brain Project SGA3).
+ */
+
+#ifndef PHYSICS_LINKS_H
+#define PHYSICS_LINKS_H
+
+#include "nrp_general_library/device_interface/device.h"
+#include "nrp_general_library/utils/serializers/json_property_serializer.h"
+
+#include <string>
+#include <vector>
+
+class PhysicsLinks;
+
+struct PhysicsLinksConst
+{
+	using link_names_t = std::vector<std::string>;
+	using link_data_t = std::vector<float>;
+
+	/*!
+	 * \brief Number of values per link in position, linear and angular velocity arrays
+	 */
+	static constexpr size_t Vec3Size = 3;
+
+	/*!
+	 * \brief Number of values per link in rotation array
+	 */
+	static constexpr size_t QuatSize = 4;
+
+	/*!
+	 * \brief Link names. Determines the order of all data arrays
+	 */
+	static constexpr FixedString Names = "names";
+
+	/*!
+	 * \brief Link positions, Vec3Size values per link
+	 */
+	static constexpr FixedString Positions = "pos";
+
+	/*!
+	 * \brief Link rotations as quaternions (x, y, z, w), QuatSize values per link
+	 */
+	static constexpr FixedString Rotations = "rot";
+
+	/*!
+	 * \brief Link linear velocities, Vec3Size values per link
+	 */
+	static constexpr FixedString LinearVelocities = "lin_vel";
+
+	/*!
+	 * \brief Link angular velocities, Vec3Size values per link
+	 */
+	static constexpr FixedString AngularVelocities = "ang_vel";
+
+	using JPropNames = PropNames<Names, Positions, Rotations, LinearVelocities, AngularVelocities>;
+};
+
+/*!
+ * \brief State of multiple links of a single model. Data of all links is stored in contiguous arrays, ordered by names
+ */
+class PhysicsLinks
+        : public PhysicsLinksConst,
+          public Device<PhysicsLinks, "PhysicsLinks", PhysicsLinksConst::JPropNames, PhysicsLinksConst::link_names_t, PhysicsLinksConst::link_data_t, PhysicsLinksConst::link_data_t, PhysicsLinksConst::link_data_t, PhysicsLinksConst::link_data_t>
+{
+	public:
+		PhysicsLinks(DeviceIdentifier &&devID, property_template_t &&props = property_template_t(link_names_t(), link_data_t(), link_data_t(), link_data_t(), link_data_t()))
+		    : Device(std::move(devID), std::move(props))
+		{}
+
+		template<class DESERIALIZE_T>
+		static auto deserializeProperties(DESERIALIZE_T &&data)
+		{	return Device::deserializeProperties(std::forward<DESERIALIZE_T>(data), link_names_t(), link_data_t(), link_data_t(), link_data_t(), link_data_t());	}
+
+		/*!
+		 * \brief Number of links stored in this device
+		 */
+		size_t numLinks() const;
+
+		/*!
+		 * \brief Resize all data arrays to hold numLinks links. Names are resized as well
+		 */
+		void resize(size_t numLinks);
+
+		const link_names_t &names() const;
+		link_names_t &names();
+		void setNames(const link_names_t &names);
+
+		const link_data_t &positions() const;
+		link_data_t &positions();
+
+		const link_data_t &rotations() const;
+		link_data_t &rotations();
+
+		const link_data_t &linVels() const;
+		link_data_t &linVels();
+
+		const link_data_t &angVels() const;
+		link_data_t &angVels();
+};
+
+/*! \addtogroup gazebo_devices
+ * The PhysicsLinks Device consists of the following attributes. Link i's data starts at index i*3 (i*4 for rot).
+ * Sending a PhysicsLinks device with a list of names to the engine selects which links are reported from the next step onwards. An empty list selects all links of the model:
+ * <table>
+ * <caption id="physics_links_attributes_table">Physics Links Attributes</caption>
+ * <tr><th>Attribute  <th>Description                                    <th>Python Type     <th>C type
+ * <tr><td>names      <td>Link names                                     <td>list of str     <td>std::vector<std::string>
+ * <tr><td>pos        <td>Link positions                                 <td>list of float   <td>std::vector<float>
+ * <tr><td>rot        <td>Link rotations as quaternions (x, y, z, w)     <td>list of float   <td>std::vector<float>
+ * <tr><td>lin_vel    <td>Link linear velocities                         <td>list of float   <td>std::vector<float>
+ * <tr><td>ang_vel    <td>Link angular velocities                        <td>list of float   <td>std::vector<float>
+ * </table>
+ */
+
+#endif // PHYSICS_LINKS_H
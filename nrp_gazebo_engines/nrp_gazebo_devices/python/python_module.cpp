@@ -23,7 +23,9 @@
 #include "nrp_gazebo_devices/config/cmake_constants.h"
 #include "nrp_gazebo_devices/physics_camera.h"
 #include "nrp_gazebo_devices/physics_joint.h"
+#include "nrp_gazebo_devices/physics_joints.h"
 #include "nrp_gazebo_devices/physics_link.h"
+#include "nrp_gazebo_devices/physics_links.h"
 
 #include "nrp_general_library/device_interface/device.h"
 #include "nrp_general_library/device_interface/python_device.h"
@@ -71,11 +73,25 @@ BOOST_PYTHON_MODULE(GAZEBO_PYTHON_MODULE_NAME)
 	implicitly_convertible<typename PhysicsJoint::FloatNan, float>();
 	implicitly_convertible<float, typename PhysicsJoint::FloatNan>();
 
+	class_<typename PhysicsJoints::joint_names_t>("__JointNamesVec", no_init)
+	        .def(vector_indexing_suite<typename PhysicsJoints::joint_names_t>());
+
+	class_<typename PhysicsJoints::joint_values_t>("__JointValuesVec", no_init)
+	        .def(vector_indexing_suite<typename PhysicsJoints::joint_values_t, true>());
+
+	// PhysicsLinks::link_names_t is the same type as PhysicsJoints::joint_names_t and already registered
+	class_<typename PhysicsLinks::link_data_t>("__LinkDataVec", no_init)
+	        .def(vector_indexing_suite<typename PhysicsLinks::link_data_t>());
+
 	python_property_device_class<PhysicsCamera>::create();
 
 	python_property_device_class<PhysicsJoint>::create();
 
+	python_property_device_class<PhysicsJoints>::create();
+
 	python_property_device_class<PhysicsLink>::create();
+
+	python_property_device_class<PhysicsLinks>::create();
 }
 
 
@@ -83,5 +99,7 @@ BOOST_PYTHON_MODULE(GAZEBO_PYTHON_MODULE_NAME)
  * Gazebo engines use the following devices:
  * - PhysicsCamera: Get camera image
  * - PhysicsJoint: Get/Set joint data
+ * - PhysicsJoints: Get/Set data of all joints of a model
  * - PhysicsLink: Get link data
+ * - PhysicsLinks: Get data of multiple links of a model
  */
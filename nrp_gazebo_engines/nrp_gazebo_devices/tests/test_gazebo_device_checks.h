@@ -0,0 +1,174 @@
+/* * NRP Core - Backend infrastructure to synchronize simulations
+ *
+ * Copyright 2020 Michael Zechmair
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This project has received funding from the European Union’s Horizon 2020
+ * Framework Programme for Research and Innovation under the Specific Grant
+ * Agreement No. 945539 (Human Brain Project SGA3).
+ */
+
+#ifndef TEST_GAZEBO_DEVICE_CHECKS_H
+#define TEST_GAZEBO_DEVICE_CHECKS_H
+
+#include "nrp_gazebo_devices/physics_joint.h"
+#include "nrp_gazebo_devices/physics_joints.h"
+#include "nrp_gazebo_devices/physics_link.h"
+#include "nrp_gazebo_devices/physics_links.h"
+#include "nrp_general_library/engine_interfaces/engine_interface.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+/*!
+ * \brief Device checks shared by the tests of all Gazebo engines. Call them with ASSERT_NO_FATAL_FAILURE
+ */
+namespace gazebo_device_checks
+{
+	/*!
+	 * \brief Run a single step of one second
+	 */
+	inline void stepEngine(EngineInterface &engine)
+	{
+		ASSERT_NO_THROW(engine.runLoopStep(SimulationTime(1000000)));
+		ASSERT_NO_THROW(engine.waitForStepCompletion(5.0f));
+	}
+
+	/*!
+	 * \brief Get the position of a joint from a PhysicsJoints device
+	 */
+	inline float jointPosition(const PhysicsJoints &joints, const std::string &jointName)
+	{
+		const auto nameIt = std::find(joints.names().begin(), joints.names().end(), jointName);
+		EXPECT_NE(nameIt, joints.names().end()) << "Joint \"" << jointName << "\" not found";
+
+		return nameIt != joints.names().end() ? static_cast<float>(joints.positions()[nameIt - joints.names().begin()]) : NAN;
+	}
+
+	/*!
+	 * \brief Command youbot joints of test_joint_plugin.sdf with a PhysicsJoint and a PhysicsJoints device, step the engine
+	 * and check the joint positions read back from both device types
+	 */
+	inline void checkJointDevices(EngineInterface &engine)
+	{
+		const DeviceIdentifier jointID("youbot::arm_joint_1", engine.engineName(), PhysicsJoint::TypeName.data());
+		const DeviceIdentifier jointsID("youbot::youbot", engine.engineName(), PhysicsJoints::TypeName.data());
+
+		// Initial state
+		auto devices = engine.requestOutputDevices({jointID});
+		ASSERT_EQ(devices.size(), 1);
+
+		const auto *pJointDev = dynamic_cast<const PhysicsJoint*>(devices[0].get());
+		ASSERT_NE(pJointDev, nullptr);
+		ASSERT_EQ(pJointDev->position(), 0);
+
+		devices = engine.requestOutputDevices({jointsID});
+		ASSERT_EQ(devices.size(), 1);
+
+		const auto *pJointsDev = dynamic_cast<const PhysicsJoints*>(devices[0].get());
+		ASSERT_NE(pJointsDev, nullptr);
+		ASSERT_GT(pJointsDev->numJoints(), 0);
+		ASSERT_EQ(pJointsDev->positions().size(), pJointsDev->numJoints());
+		ASSERT_EQ(jointPosition(*pJointsDev, "arm_joint_1"), 0);
+		ASSERT_EQ(jointPosition(*pJointsDev, "arm_joint_5"), 0);
+
+		const auto numJoints = pJointsDev->numJoints();
+
+		// Command arm_joint_1 with the single joint device and arm_joint_5 with the model joints device. Both have a position PID
+		PhysicsJoint newJointDev((DeviceIdentifier(jointID)));
+		newJointDev.setEffort(NAN);
+		newJointDev.setVelocity(NAN);
+		newJointDev.setPosition(1.0f);
+
+		PhysicsJoints newJointsDev((DeviceIdentifier(jointsID)));
+		newJointsDev.setNames({"arm_joint_5"});
+		newJointsDev.setPositions({1.0f});
+
+		ASSERT_NO_THROW(engine.handleInputDevices({&newJointDev, &newJointsDev}));
+		ASSERT_NO_FATAL_FAILURE(stepEngine(engine));
+
+		// Both joints must have moved towards their targets
+		devices = engine.requestOutputDevices({jointsID});
+		ASSERT_EQ(devices.size(), 1);
+
+		pJointsDev = dynamic_cast<const PhysicsJoints*>(devices[0].get());
+		ASSERT_NE(pJointsDev, nullptr);
+		ASSERT_EQ(pJointsDev->numJoints(), numJoints);
+
+		const float armJoint1Pos = jointPosition(*pJointsDev, "arm_joint_1");
+		EXPECT_GT(armJoint1Pos, 0);
+		EXPECT_GT(jointPosition(*pJointsDev, "arm_joint_5"), 0);
+
+		// Both device types report the same state
+		devices = engine.requestOutputDevices({jointID});
+		ASSERT_EQ(devices.size(), 1);
+
+		pJointDev = dynamic_cast<const PhysicsJoint*>(devices[0].get());
+		ASSERT_NE(pJointDev, nullptr);
+		EXPECT_FLOAT_EQ(pJointDev->position(), armJoint1Pos);
+	}
+
+	/*!
+	 * \brief Select a single youbot link of test_link_plugin.sdf with a PhysicsLinks device, step the engine and check
+	 * that only the selected link is read back, with the same state as its PhysicsLink device
+	 */
+	inline void checkLinkDevices(EngineInterface &engine)
+	{
+		const DeviceIdentifier linkID("link_youbot::base_footprint", engine.engineName(), PhysicsLink::TypeName.data());
+		const DeviceIdentifier linksID("link_youbot::youbot", engine.engineName(), PhysicsLinks::TypeName.data());
+
+		// Initially, all links are reported
+		auto devices = engine.requestOutputDevices({linksID});
+		ASSERT_EQ(devices.size(), 1);
+
+		const auto *pLinksDev = dynamic_cast<const PhysicsLinks*>(devices[0].get());
+		ASSERT_NE(pLinksDev, nullptr);
+		ASSERT_GT(pLinksDev->numLinks(), 1);
+		ASSERT_EQ(pLinksDev->positions().size(), pLinksDev->numLinks()*PhysicsLinks::Vec3Size);
+		ASSERT_EQ(pLinksDev->rotations().size(), pLinksDev->numLinks()*PhysicsLinks::QuatSize);
+
+		// Select a single link. The selection is applied at the next step
+		PhysicsLinks linkSelection((DeviceIdentifier(linksID)));
+		linkSelection.setNames({"base_footprint"});
+
+		ASSERT_NO_THROW(engine.handleInputDevices({&linkSelection}));
+		ASSERT_NO_FATAL_FAILURE(stepEngine(engine));
+
+		devices = engine.requestOutputDevices({linksID});
+		ASSERT_EQ(devices.size(), 1);
+
+		pLinksDev = dynamic_cast<const PhysicsLinks*>(devices[0].get());
+		ASSERT_NE(pLinksDev, nullptr);
+		ASSERT_EQ(pLinksDev->numLinks(), 1);
+		ASSERT_EQ(pLinksDev->names()[0], "base_footprint");
+		ASSERT_EQ(pLinksDev->positions().size(), PhysicsLinks::Vec3Size);
+		ASSERT_EQ(pLinksDev->rotations().size(), PhysicsLinks::QuatSize);
+		ASSERT_EQ(pLinksDev->linVels().size(), PhysicsLinks::Vec3Size);
+		ASSERT_EQ(pLinksDev->angVels().size(), PhysicsLinks::Vec3Size);
+
+		// The selected link's state matches its single link device
+		devices = engine.requestOutputDevices({linkID});
+		ASSERT_EQ(devices.size(), 1);
+
+		const auto *pLinkDev = dynamic_cast<const PhysicsLink*>(devices[0].get());
+		ASSERT_NE(pLinkDev, nullptr);
+
+		for(size_t i = 0; i < PhysicsLinks::Vec3Size; ++i)
+			EXPECT_FLOAT_EQ(pLinksDev->positions()[i], pLinkDev->position()[i]);
+	}
+}
+
+#endif // TEST_GAZEBO_DEVICE_CHECKS_H
@@ -22,6 +22,8 @@
 
 #include "nrp_communication_controller/nrp_communication_controller.h"
 
+#include "nrp_gazebo_devices/engine_server/step_synced_device_controller.h"
+
 #include <nlohmann/json.hpp>
 
 using namespace nlohmann;
@@ -30,7 +32,16 @@ std::unique_ptr<NRPCommunicationController> NRPCommunicationController::_instanc
 
 NRPCommunicationController::~NRPCommunicationController()
 {
-	this->_stepController = nullptr;
+	// Let a running step finish before the server shuts down. Afterwards, new steps are rejected
+	{
+		EngineGrpcServer::lock_t lock(this->_deviceLock);
+		if(!this->_stepFinished.wait_for(lock, NRPCommunicationController::ShutdownWaitTime, [this] { return !this->_stepRunning; }))
+			std::cerr << "Gazebo step still running during shutdown\n";
+
+		this->_stepController = nullptr;
+	}
+
+	this->shutdownServer();
 }
 
 NRPCommunicationController &NRPCommunicationController::getInstance()
@@ -67,10 +78,47 @@ SimulationTime NRPCommunicationController::runLoopStep(SimulationTime timeStep)
 		throw err;
 	}
 
+	// Device access is unlocked while stepping, so steps must not overlap
+	if(this->_stepRunning)
+	{
+		auto err = std::logic_error("Tried to run loop while the previous step is still in progress");
+		std::cerr << err.what();
+
+		throw err;
+	}
+
 	try
 	{
-		// Execute loop step (Note: The _deviceLock mutex has already been set by EngineJSONServer::runLoopStepHandler, so no calls to reading/writing from/to devices is possible at this moment)
-		return this->_stepController->runLoopStep(timeStep);
+		// The _deviceLock mutex has already been set by EngineGrpcServer::runLoopStep. Apply commands received since the last step
+		gazebo::StepSyncedDeviceController::applyAllCommands();
+
+		// Device controllers are double-buffered. Let devices be read and set while physics is running
+		this->_stepRunning = true;
+		this->_deviceLock.unlock();
+
+		SimulationTime simTime;
+		try
+		{
+			simTime = this->_stepController->runLoopStep(timeStep);
+			gazebo::StepSyncedDeviceController::captureAllStates();
+		}
+		catch(...)
+		{
+			this->_deviceLock.lock();
+			this->_stepRunning = false;
+			this->_stepFinished.notify_all();
+
+			throw;
+		}
+
+		this->_deviceLock.lock();
+		this->_stepRunning = false;
+		this->_stepFinished.notify_all();
+
+		// No device reads are in progress anymore. Publish the captured state
+		gazebo::StepSyncedDeviceController::swapAllBuffers();
+
+		return simTime;
 	}
 	catch(const std::exception &e)
 	{
@@ -81,8 +129,36 @@ SimulationTime NRPCommunicationController::runLoopStep(SimulationTime timeStep)
 	}
 }
 
+void NRPCommunicationController::saveSnapshot(const json &)
+{
+	this->waitForStepCompletion();
+
+	if(this->_stepController == nullptr)
+		throw std::out_of_range("Tried to save a snapshot while the controller has not yet been initialized");
+
+	this->_stepController->saveSnapshot();
+}
+
+SimulationTime NRPCommunicationController::restoreSnapshot(const json &, EngineGrpcServer::lock_t &)
+{
+	this->waitForStepCompletion();
+
+	if(this->_stepController == nullptr)
+		throw std::out_of_range("Tried to restore a snapshot while the controller has not yet been initialized");
+
+	const auto simTime = this->_stepController->restoreSnapshot();
+
+	// Serve the restored state to device reads
+	gazebo::StepSyncedDeviceController::captureAllStates();
+	gazebo::StepSyncedDeviceController::swapAllBuffers();
+
+	return simTime;
+}
+
 void NRPCommunicationController::initialize(const json &data, EngineGrpcServer::lock_t &lock)
 {
+	this->waitForStepCompletion();
+
 	ConfigStorage confDat(data);
 	GazeboGrpcConfig conf(confDat);
 
@@ -110,11 +186,22 @@ void NRPCommunicationController::initialize(const json &data, EngineGrpcServer::
 	}
 
 	lock.lock();
+	this->waitForStepCompletion();
+
+	// Serve the loaded world's state to device reads
+	gazebo::StepSyncedDeviceController::captureAllStates();
+	gazebo::StepSyncedDeviceController::swapAllBuffers();
 }
 
 void NRPCommunicationController::shutdown(const json&)
 {
-	// Do nothing
+	this->waitForStepCompletion();
+}
+
+void NRPCommunicationController::waitForStepCompletion()
+{
+	// Waiting on the mutex itself also works for the handlers' locks, which remain owned afterwards
+	this->_stepFinished.wait(this->_deviceLock, [this] { return !this->_stepRunning; });
 }
 
 NRPCommunicationController::NRPCommunicationController(const std::string &address)
@@ -32,6 +32,7 @@
 #include <pistache/endpoint.h>
 
 #include <gazebo/common/Plugin.hh>
+#include <condition_variable>
 #include <map>
 #include <memory>
 
@@ -108,8 +109,33 @@ class NRPCommunicationController
 		 */
 		GazeboStepController *_stepController = nullptr;
 
+		/*!
+		 * \brief True while the world is being stepped. Protected by _deviceLock.
+		 * _deviceLock is released during a step, so handlers that access the world must wait until this is false again
+		 */
+		bool _stepRunning = false;
+
+		/*!
+		 * \brief Notified when a step has finished
+		 */
+		std::condition_variable_any _stepFinished;
+
+		/*!
+		 * \brief Max time to wait for a running step during shutdown
+		 */
+		static constexpr auto ShutdownWaitTime = std::chrono::milliseconds(10*1000);
+
+		/*!
+		 * \brief Wait until a running step has finished. The caller must hold _deviceLock, which is released while waiting
+		 */
+		void waitForStepCompletion();
+
 		virtual SimulationTime runLoopStep(SimulationTime timeStep) override;
 
+		virtual void saveSnapshot(const nlohmann::json &data) override;
+
+		virtual SimulationTime restoreSnapshot(const nlohmann::json &data, EngineGrpcServer::lock_t &deviceLock) override;
+
 		virtual void initialize(const nlohmann::json &data, EngineGrpcServer::lock_t &deviceLock) override;
 
 		virtual void shutdown(const nlohmann::json &data) override;
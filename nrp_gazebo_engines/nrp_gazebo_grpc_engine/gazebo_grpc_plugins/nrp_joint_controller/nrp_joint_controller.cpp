@@ -124,7 +124,14 @@ void gazebo::NRPJointController::Load(gazebo::physics::ModelPtr model, sdf::Elem
 		const auto deviceName = NRPCommunicationController::createDeviceName(*this, joint->GetName());
 
 		std::cout << "Registering joint controller for joint \"" << jointName << "\"\n";
-		this->_jointDeviceControllers.push_back(GrpcDeviceControlSerializer<JointDeviceController>(joint, jointControllerPtr, jointName));
+		this->_jointDeviceControllers.emplace_back(joint, jointControllerPtr, jointName);
 		NRPCommunicationController::getInstance().registerDevice(deviceName, &(this->_jointDeviceControllers.back()));
 	}
+
+	// Create device for all joints of the model. Allows setting and getting every joint with a single device
+	const auto modelDeviceName = NRPCommunicationController::createDeviceName(*this, model->GetName());
+
+	std::cout << "Registering joint controller for all joints of model \"" << model->GetScopedName() << "\"\n";
+	this->_modelJointsDeviceController.reset(new GrpcDeviceControlSerializer<ModelJointsDeviceController>(joints, jointControllerPtr, modelDeviceName));
+	NRPCommunicationController::getInstance().registerDevice(modelDeviceName, this->_modelJointsDeviceController.get());
 }
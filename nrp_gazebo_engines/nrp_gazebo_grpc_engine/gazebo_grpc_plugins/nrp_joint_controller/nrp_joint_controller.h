@@ -23,7 +23,9 @@
 #define NRP_JOINT_CONTROLLER_H
 
 #include "nrp_gazebo_devices/engine_server/joint_device_controller.h"
+#include "nrp_gazebo_devices/engine_server/model_joints_device_controller.h"
 #include "nrp_gazebo_grpc_engine/devices/grpc_physics_joint.h"
+#include "nrp_gazebo_grpc_engine/devices/grpc_physics_joints.h"
 #include "nrp_grpc_engine_protocol/engine_server/engine_grpc_device_controller.h"
 
 
@@ -56,6 +58,11 @@ namespace gazebo
 			 */
 			std::list<GrpcDeviceControlSerializer<JointDeviceController> > _jointDeviceControllers;
 
+			/*!
+			 * \brief Interface for all joints of the model, registered under the model's name
+			 */
+			std::unique_ptr<GrpcDeviceControlSerializer<ModelJointsDeviceController> > _modelJointsDeviceController;
+
 			/*!
 			 * \brief Joint PID Configuration
 			 */
@@ -41,7 +41,15 @@ void gazebo::NRPLinkControllerPlugin::Load(gazebo::physics::ModelPtr model, sdf:
 
 		std::cout << "Registering link controller for link \"" << deviceName << "\"\n";
 
-		this->_linkInterfaces.push_back(GrpcDeviceControlSerializer<LinkDeviceController>(deviceName, link));
+		this->_linkInterfaces.emplace_back(deviceName, link);
 		commControl.registerDevice(deviceName, &(this->_linkInterfaces.back()));
 	}
+
+	// Register a device for all links of the model. Transmits the state of every link as a single device
+	const auto modelDeviceName = NRPCommunicationController::createDeviceName(*this, model->GetName());
+
+	std::cout << "Registering link controller for all links of model \"" << model->GetScopedName() << "\"\n";
+
+	this->_modelLinksInterface.reset(new GrpcDeviceControlSerializer<ModelLinksDeviceController>(links, modelDeviceName));
+	commControl.registerDevice(modelDeviceName, this->_modelLinksInterface.get());
 }
@@ -23,7 +23,9 @@
 #define NRP_LINK_CONTROLLER_PLUGIN_H
 
 #include "nrp_gazebo_devices/engine_server/link_device_controller.h"
+#include "nrp_gazebo_devices/engine_server/model_links_device_controller.h"
 #include "nrp_gazebo_grpc_engine/devices/grpc_physics_link.h"
+#include "nrp_gazebo_grpc_engine/devices/grpc_physics_links.h"
 #include "nrp_grpc_engine_protocol/engine_server/engine_grpc_device_controller.h"
 
 #include <gazebo/gazebo.hh>
@@ -39,6 +41,11 @@ namespace gazebo
 		private:
 
 			std::list<GrpcDeviceControlSerializer<LinkDeviceController> > _linkInterfaces;
+
+			/*!
+			 * \brief Interface for all links of the model, registered under the model's name
+			 */
+			std::unique_ptr<GrpcDeviceControlSerializer<ModelLinksDeviceController> > _modelLinksInterface;
 	};
 
 	GZ_REGISTER_MODEL_PLUGIN(NRPLinkControllerPlugin)
@@ -24,16 +24,14 @@
 
 
 template<>
-GRPCDevice DeviceSerializerMethods<GRPCDevice>::serialize<PhysicsCamera>(const PhysicsCamera &dev)
+void DeviceSerializerMethods<GRPCDevice>::serializeInto<PhysicsCamera>(const PhysicsCamera &dev, EngineGrpc::DeviceMessage *target)
 {
-	GRPCDevice msg = serializeID<GRPCDevice>(dev.id());
-	msg.dev().mutable_camera()->InitAsDefaultInstance();
-	msg.dev().mutable_camera()->set_imagedata(dev.imageData().data(), dev.imageData().size());
-	msg.dev().mutable_camera()->set_imagedepth(dev.imagePixelSize());
-	msg.dev().mutable_camera()->set_imageheight(dev.imageHeight());
-	msg.dev().mutable_camera()->set_imagewidth(dev.imageWidth());
-
-	return msg;
+	serializeIDInto(dev.id(), target);
+	target->mutable_camera()->InitAsDefaultInstance();
+	target->mutable_camera()->set_imagedata(dev.imageData().data(), dev.imageData().size());
+	target->mutable_camera()->set_imagedepth(dev.imagePixelSize());
+	target->mutable_camera()->set_imageheight(dev.imageHeight());
+	target->mutable_camera()->set_imagewidth(dev.imageWidth());
 }
 
 template<>
@@ -45,3 +43,14 @@ PhysicsCamera DeviceSerializerMethods<GRPCDevice>::deserialize<PhysicsCamera>(De
 	                                                                          PhysicsCamera::cam_data_t(data->camera().imagedata().begin(),
 	                                                                                                    data->camera().imagedata().end())));
 }
+
+template<>
+void DeviceSerializerMethods<GRPCDevice>::update<PhysicsCamera>(PhysicsCamera &dev, deserialization_t data)
+{
+	dev.setImageHeight(data->camera().imageheight());
+	dev.setImageWidth(data->camera().imagewidth());
+	dev.setImagePixelSize(data->camera().imagedepth());
+
+	// assign() keeps the existing buffer if the image size did not change
+	dev.imageData().assign(data->camera().imagedata().begin(), data->camera().imagedata().end());
+}
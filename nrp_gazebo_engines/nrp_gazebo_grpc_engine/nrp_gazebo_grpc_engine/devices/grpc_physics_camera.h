@@ -27,9 +27,12 @@
 
 
 template<>
-GRPCDevice DeviceSerializerMethods<GRPCDevice>::serialize<PhysicsCamera>(const PhysicsCamera &dev);
+void DeviceSerializerMethods<GRPCDevice>::serializeInto<PhysicsCamera>(const PhysicsCamera &dev, EngineGrpc::DeviceMessage *target);
 
 template<>
 PhysicsCamera DeviceSerializerMethods<GRPCDevice>::deserialize<PhysicsCamera>(DeviceIdentifier &&devID, deserialization_t data);
 
+template<>
+void DeviceSerializerMethods<GRPCDevice>::update<PhysicsCamera>(PhysicsCamera &dev, deserialization_t data);
+
 #endif // GRPC_PHYSICS_CAMERA_H
@@ -24,15 +24,13 @@
 
 
 template<>
-GRPCDevice DeviceSerializerMethods<GRPCDevice>::serialize<PhysicsJoint>(const PhysicsJoint &dev)
+void DeviceSerializerMethods<GRPCDevice>::serializeInto<PhysicsJoint>(const PhysicsJoint &dev, EngineGrpc::DeviceMessage *target)
 {
-	GRPCDevice data = serializeID<GRPCDevice>(dev.id());
-	data.dev().mutable_joint()->InitAsDefaultInstance();
-	data.dev().mutable_joint()->set_position(dev.position());
-	data.dev().mutable_joint()->set_velocity(dev.velocity());
-	data.dev().mutable_joint()->set_effort(dev.effort());
-
-	return data;
+	serializeIDInto(dev.id(), target);
+	target->mutable_joint()->InitAsDefaultInstance();
+	target->mutable_joint()->set_position(dev.position());
+	target->mutable_joint()->set_velocity(dev.velocity());
+	target->mutable_joint()->set_effort(dev.effort());
 }
 
 template<>
@@ -40,3 +38,11 @@ PhysicsJoint DeviceSerializerMethods<GRPCDevice>::deserialize<PhysicsJoint>(Devi
 {
 	return PhysicsJoint(std::move(devID), PhysicsJoint::property_template_t(data->joint().position(), data->joint().velocity(), data->joint().effort()));
 }
+
+template<>
+void DeviceSerializerMethods<GRPCDevice>::update<PhysicsJoint>(PhysicsJoint &dev, deserialization_t data)
+{
+	dev.setPosition(data->joint().position());
+	dev.setVelocity(data->joint().velocity());
+	dev.setEffort(data->joint().effort());
+}
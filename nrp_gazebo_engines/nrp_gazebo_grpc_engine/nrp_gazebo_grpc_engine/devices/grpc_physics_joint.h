@@ -27,10 +27,13 @@
 
 
 template<>
-GRPCDevice DeviceSerializerMethods<GRPCDevice>::serialize<PhysicsJoint>(const PhysicsJoint &dev);
+void DeviceSerializerMethods<GRPCDevice>::serializeInto<PhysicsJoint>(const PhysicsJoint &dev, EngineGrpc::DeviceMessage *target);
 
 template<>
 PhysicsJoint DeviceSerializerMethods<GRPCDevice>::deserialize<PhysicsJoint>(DeviceIdentifier &&devID, deserialization_t data);
 
+template<>
+void DeviceSerializerMethods<GRPCDevice>::update<PhysicsJoint>(PhysicsJoint &dev, deserialization_t data);
+
 
 #endif // GRPC_PHYSICS_JOINT_H
@@ -0,0 +1,68 @@
+//
+// NRP Core - Backend infrastructure to synchronize simulations
+//
+// Copyright 2020 Michael Zechmair
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This project has received funding from the European Union’s Horizon 2020
+// Framework Programme for Research and Innovation under the Specific Grant
+// Agreement No. 945539 (Human Brain Project SGA3).
+//
+
+#include "nrp_gazebo_grpc_engine/devices/grpc_physics_joints.h"
+
+
+template<>
+void DeviceSerializerMethods<GRPCDevice>::serializeInto<PhysicsJoints>(const PhysicsJoints &dev, EngineGrpc::DeviceMessage *target)
+{
+	serializeIDInto(dev.id(), target);
+	auto *joints = target->mutable_joints();
+
+	joints->mutable_names()->Reserve(static_cast<int>(dev.names().size()));
+	for(const auto &name : dev.names())
+		joints->add_names(name);
+
+	joints->mutable_positions()->Reserve(static_cast<int>(dev.positions().size()));
+	for(const float val : dev.positions())
+		joints->add_positions(val);
+
+	joints->mutable_velocities()->Reserve(static_cast<int>(dev.velocities().size()));
+	for(const float val : dev.velocities())
+		joints->add_velocities(val);
+
+	joints->mutable_efforts()->Reserve(static_cast<int>(dev.efforts().size()));
+	for(const float val : dev.efforts())
+		joints->add_efforts(val);
+}
+
+template<>
+PhysicsJoints DeviceSerializerMethods<GRPCDevice>::deserialize<PhysicsJoints>(DeviceIdentifier &&devID, deserialization_t data)
+{
+	PhysicsJoints dev(std::move(devID));
+	update(dev, data);
+
+	return dev;
+}
+
+template<>
+void DeviceSerializerMethods<GRPCDevice>::update<PhysicsJoints>(PhysicsJoints &dev, deserialization_t data)
+{
+	const auto &joints = data->joints();
+
+	// assign() keeps the existing buffers if the number of joints did not change
+	dev.names().assign(joints.names().begin(), joints.names().end());
+	dev.positions().assign(joints.positions().begin(), joints.positions().end());
+	dev.velocities().assign(joints.velocities().begin(), joints.velocities().end());
+	dev.efforts().assign(joints.efforts().begin(), joints.efforts().end());
+}
@@ -0,0 +1,38 @@
+/* * NRP Core - Backend infrastructure to synchronize simulations
+ *
+ * Copyright 2020 Michael Zechmair
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This project has received funding from the European Union’s Horizon 2020
+ * Framework Programme for Research and Innovation under the Specific Grant
+ * Agreement No. 945539 (Human Brain Project SGA3).
+ */
+
+#ifndef GRPC_PHYSICS_JOINTS_H
+#define GRPC_PHYSICS_JOINTS_H
+
+#include "nrp_gazebo_devices/physics_joints.h"
+#include "nrp_grpc_engine_protocol/device_interfaces/grpc_device_serializer.h"
+
+
+template<>
+void DeviceSerializerMethods<GRPCDevice>::serializeInto<PhysicsJoints>(const PhysicsJoints &dev, EngineGrpc::DeviceMessage *target);
+
+template<>
+PhysicsJoints DeviceSerializerMethods<GRPCDevice>::deserialize<PhysicsJoints>(DeviceIdentifier &&devID, deserialization_t data);
+
+template<>
+void DeviceSerializerMethods<GRPCDevice>::update<PhysicsJoints>(PhysicsJoints &dev, deserialization_t data);
+
+#endif // GRPC_PHYSICS_JOINTS_H
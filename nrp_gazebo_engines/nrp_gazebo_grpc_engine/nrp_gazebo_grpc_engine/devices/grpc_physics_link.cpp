@@ -24,29 +24,27 @@
 
 
 template<>
-GRPCDevice DeviceSerializerMethods<GRPCDevice>::serialize<PhysicsLink>(const PhysicsLink &dev)
+void DeviceSerializerMethods<GRPCDevice>::serializeInto<PhysicsLink>(const PhysicsLink &dev, EngineGrpc::DeviceMessage *target)
 {
-	GRPCDevice dat = serializeID(dev.id());
-	dat.dev().mutable_link()->InitAsDefaultInstance();
+	serializeIDInto(dev.id(), target);
+	target->mutable_link()->InitAsDefaultInstance();
 
-	dat.dev().mutable_link()->set_position(0, dev.position()[0]);
-	dat.dev().mutable_link()->set_position(1, dev.position()[1]);
-	dat.dev().mutable_link()->set_position(2, dev.position()[2]);
+	target->mutable_link()->set_position(0, dev.position()[0]);
+	target->mutable_link()->set_position(1, dev.position()[1]);
+	target->mutable_link()->set_position(2, dev.position()[2]);
 
-	dat.dev().mutable_link()->set_rotation(0, dev.rotation()[0]);
-	dat.dev().mutable_link()->set_rotation(1, dev.rotation()[1]);
-	dat.dev().mutable_link()->set_rotation(2, dev.rotation()[2]);
-	dat.dev().mutable_link()->set_rotation(3, dev.rotation()[3]);
+	target->mutable_link()->set_rotation(0, dev.rotation()[0]);
+	target->mutable_link()->set_rotation(1, dev.rotation()[1]);
+	target->mutable_link()->set_rotation(2, dev.rotation()[2]);
+	target->mutable_link()->set_rotation(3, dev.rotation()[3]);
 
-	dat.dev().mutable_link()->set_linearvelocity(0, dev.linVel()[0]);
-	dat.dev().mutable_link()->set_linearvelocity(1, dev.linVel()[1]);
-	dat.dev().mutable_link()->set_linearvelocity(2, dev.linVel()[2]);
+	target->mutable_link()->set_linearvelocity(0, dev.linVel()[0]);
+	target->mutable_link()->set_linearvelocity(1, dev.linVel()[1]);
+	target->mutable_link()->set_linearvelocity(2, dev.linVel()[2]);
 
-	dat.dev().mutable_link()->set_angularvelocity(0, dev.angVel()[0]);
-	dat.dev().mutable_link()->set_angularvelocity(1, dev.angVel()[1]);
-	dat.dev().mutable_link()->set_angularvelocity(2, dev.angVel()[2]);
-
-	return dat;
+	target->mutable_link()->set_angularvelocity(0, dev.angVel()[0]);
+	target->mutable_link()->set_angularvelocity(1, dev.angVel()[1]);
+	target->mutable_link()->set_angularvelocity(2, dev.angVel()[2]);
 }
 
 template<>
@@ -58,3 +56,14 @@ PhysicsLink DeviceSerializerMethods<GRPCDevice>::deserialize<PhysicsLink>(Device
 	                   PhysicsLink::vec3_t({data->link().linearvelocity(0), data->link().linearvelocity(1), data->link().linearvelocity(2)}),
 	                   PhysicsLink::vec3_t({data->link().angularvelocity(0), data->link().angularvelocity(1), data->link().angularvelocity(2)})));
 }
+
+template<>
+void DeviceSerializerMethods<GRPCDevice>::update<PhysicsLink>(PhysicsLink &dev, deserialization_t data)
+{
+	const auto &link = data->link();
+
+	dev.setPosition({link.position(0), link.position(1), link.position(2)});
+	dev.setRotation({link.rotation(0), link.rotation(1), link.rotation(2), link.rotation(3)});
+	dev.setLinVel({link.linearvelocity(0), link.linearvelocity(1), link.linearvelocity(2)});
+	dev.setAngVel({link.angularvelocity(0), link.angularvelocity(1), link.angularvelocity(2)});
+}
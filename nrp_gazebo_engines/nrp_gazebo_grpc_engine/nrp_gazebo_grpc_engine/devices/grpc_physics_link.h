@@ -27,10 +27,13 @@
 
 
 template<>
-GRPCDevice DeviceSerializerMethods<GRPCDevice>::serialize<PhysicsLink>(const PhysicsLink &dev);
+void DeviceSerializerMethods<GRPCDevice>::serializeInto<PhysicsLink>(const PhysicsLink &dev, EngineGrpc::DeviceMessage *target);
 
 template<>
 PhysicsLink DeviceSerializerMethods<GRPCDevice>::deserialize<PhysicsLink>(DeviceIdentifier &&devID, deserialization_t data);
 
+template<>
+void DeviceSerializerMethods<GRPCDevice>::update<PhysicsLink>(PhysicsLink &dev, deserialization_t data);
+
 
 #endif // GRPC_PHYSICS_LINK_H
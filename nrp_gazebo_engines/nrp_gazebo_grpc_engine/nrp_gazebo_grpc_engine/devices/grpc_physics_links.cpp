@@ -0,0 +1,73 @@
+//
+// NRP Core - Backend infrastructure to synchronize simulations
+//
+// Copyright 2020 Michael Zechmair
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This project has received funding from the European Union’s Horizon 2020
+// Framework Programme for Research and Innovation under the Specific Grant
+// Agreement No. 945539 (Human Brain Project SGA3).
+//
+
+#include "nrp_gazebo_grpc_engine/devices/grpc_physics_links.h"
+
+#include <cstring>
+
+/*!
+ * \brief Copy a contiguous float array into a protobuf field with a single memcpy
+ */
+static void setRepeatedFloats(google::protobuf::RepeatedField<float> *field, const PhysicsLinks::link_data_t &data)
+{
+	field->Resize(static_cast<int>(data.size()), 0.0f);
+	if(!data.empty())
+		std::memcpy(field->mutable_data(), data.data(), data.size()*sizeof(float));
+}
+
+template<>
+void DeviceSerializerMethods<GRPCDevice>::serializeInto<PhysicsLinks>(const PhysicsLinks &dev, EngineGrpc::DeviceMessage *target)
+{
+	serializeIDInto(dev.id(), target);
+	auto *links = target->mutable_links();
+
+	links->mutable_names()->Reserve(static_cast<int>(dev.names().size()));
+	for(const auto &name : dev.names())
+		links->add_names(name);
+
+	setRepeatedFloats(links->mutable_position(), dev.positions());
+	setRepeatedFloats(links->mutable_rotation(), dev.rotations());
+	setRepeatedFloats(links->mutable_linearvelocity(), dev.linVels());
+	setRepeatedFloats(links->mutable_angularvelocity(), dev.angVels());
+}
+
+template<>
+PhysicsLinks DeviceSerializerMethods<GRPCDevice>::deserialize<PhysicsLinks>(DeviceIdentifier &&devID, deserialization_t data)
+{
+	PhysicsLinks dev(std::move(devID));
+	update(dev, data);
+
+	return dev;
+}
+
+template<>
+void DeviceSerializerMethods<GRPCDevice>::update<PhysicsLinks>(PhysicsLinks &dev, deserialization_t data)
+{
+	const auto &links = data->links();
+
+	// assign() keeps the existing buffers if the number of links did not change
+	dev.names().assign(links.names().begin(), links.names().end());
+	dev.positions().assign(links.position().begin(), links.position().end());
+	dev.rotations().assign(links.rotation().begin(), links.rotation().end());
+	dev.linVels().assign(links.linearvelocity().begin(), links.linearvelocity().end());
+	dev.angVels().assign(links.angularvelocity().begin(), links.angularvelocity().end());
+}
@@ -35,6 +35,17 @@ class GazeboStepController
 
 		virtual SimulationTime runLoopStep(SimulationTime timeStep) = 0;
 
+		/*!
+		 * \brief Store the current world state, overwriting any previously stored state
+		 */
+		virtual void saveSnapshot() = 0;
+
+		/*!
+		 * \brief Return to the world state stored by saveSnapshot()
+		 * \return Returns the simulation time of the restored state
+		 */
+		virtual SimulationTime restoreSnapshot() = 0;
+
 		virtual bool finishWorldLoading() = 0;
 };
 
@@ -28,7 +28,9 @@
 
 #include "nrp_gazebo_grpc_engine/devices/grpc_physics_camera.h"
 #include "nrp_gazebo_grpc_engine/devices/grpc_physics_joint.h"
+#include "nrp_gazebo_grpc_engine/devices/grpc_physics_joints.h"
 #include "nrp_gazebo_grpc_engine/devices/grpc_physics_link.h"
+#include "nrp_gazebo_grpc_engine/devices/grpc_physics_links.h"
 
 #include "nrp_gazebo_grpc_engine/config/gazebo_grpc_config.h"
 
@@ -39,7 +41,7 @@
  *  \brief NRP - Gazebo Communicator on the NRP side. Converts DeviceInterface classes from/to JSON objects
  */
 class GazeboEngineGrpcNRPClient
-        : public EngineGrpcClient<GazeboEngineGrpcNRPClient, GazeboGrpcConfig, PhysicsCamera, PhysicsJoint, PhysicsLink>
+        : public EngineGrpcClient<GazeboEngineGrpcNRPClient, GazeboGrpcConfig, PhysicsCamera, PhysicsJoint, PhysicsJoints, PhysicsLink, PhysicsLinks>
 {
 	public:
 		GazeboEngineGrpcNRPClient(EngineConfigConst::config_storage_t &config, ProcessLauncherInterface::unique_ptr &&launcher);
@@ -90,6 +92,8 @@ Adds a PhysicsCamera device. The example below registers a device called 'camera
 
 \subsubsection NRPGazeboGrpcLinkPlugin
 Adds PhysicsLink devices for each link in the given model. The example below registers four devices under the name of their respective links names
+Additionally, a single PhysicsLinks device named '<plugin name>::<model name>' is registered. It contains the state of all links of the model
+in contiguous arrays. Sending it to the engine with a list of link names restricts it to those links.
 \code{.xml}
 <model>
 	...
@@ -108,6 +112,8 @@ Adds PhysicsJoint devices. The example below registers four devices under the na
 element names and set up target velocities and PID controllers. Currently, gazebo supports two target types, 'position' or 'velocity'. Note that
 only those joints that are explicitly named in the plugin will be registered and made available to the NRP. In addition, this is currently the onlz gazebo device
 that can be used to send data to the simulation.
+Additionally, a single PhysicsJoints device named '<plugin name>::<model name>' (e.g. 'husky::husky' for a model named 'husky') is registered. It contains
+the data of all joints of the model and can be used to get or set all of them with one device per step.
 \code{.xml}
 <model>
 	...
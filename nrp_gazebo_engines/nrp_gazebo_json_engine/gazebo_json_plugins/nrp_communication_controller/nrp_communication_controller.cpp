@@ -22,8 +22,11 @@
 
 #include "nrp_communication_controller/nrp_communication_controller.h"
 
+#include "nrp_gazebo_devices/engine_server/step_synced_device_controller.h"
+
 #include "nrp_general_library/utils/nrp_exceptions.h"
 
+#include <iostream>
 #include <nlohmann/json.hpp>
 
 using namespace nlohmann;
@@ -32,7 +35,16 @@ std::unique_ptr<NRPCommunicationController> NRPCommunicationController::_instanc
 
 NRPCommunicationController::~NRPCommunicationController()
 {
-	this->_stepController = nullptr;
+	// Let a running step finish before the server shuts down. Afterwards, new steps are rejected
+	{
+		EngineJSONServer::lock_t lock(this->_deviceLock);
+		if(!this->_stepFinished.wait_for(lock, EngineJSONServer::ShutdownWaitTime, [this] { return !this->_stepRunning; }))
+			std::cerr << "Gazebo step still running during shutdown\n";
+
+		this->_stepController = nullptr;
+	}
+
+	this->shutdownServer();
 }
 
 NRPCommunicationController &NRPCommunicationController::getInstance()
@@ -65,10 +77,42 @@ SimulationTime NRPCommunicationController::runLoopStep(SimulationTime timeStep)
 	if(this->_stepController == nullptr)
 		throw NRPException::logCreate("Tried to run loop while the controller has not yet been initialized");
 
+	// Device access is unlocked while stepping, so steps must not overlap
+	if(this->_stepRunning)
+		throw NRPException::logCreate("Tried to run loop while the previous step is still in progress");
+
 	try
 	{
-		// Execute loop step (Note: The _deviceLock mutex has already been set by EngineJSONServer::runLoopStepHandler, so no calls to reading/writing from/to devices is possible at this moment)
-		return this->_stepController->runLoopStep(timeStep);
+		// The _deviceLock mutex has already been set by EngineJSONServer::runLoopStepHandler. Apply commands received since the last step
+		gazebo::StepSyncedDeviceController::applyAllCommands();
+
+		// Device controllers are double-buffered. Let devices be read and set while physics is running
+		this->_stepRunning = true;
+		this->_deviceLock.unlock();
+
+		SimulationTime simTime;
+		try
+		{
+			simTime = this->_stepController->runLoopStep(timeStep);
+			gazebo::StepSyncedDeviceController::captureAllStates();
+		}
+		catch(...)
+		{
+			this->_deviceLock.lock();
+			this->_stepRunning = false;
+			this->_stepFinished.notify_all();
+
+			throw;
+		}
+
+		this->_deviceLock.lock();
+		this->_stepRunning = false;
+		this->_stepFinished.notify_all();
+
+		// No device reads are in progress anymore. Publish the captured state
+		gazebo::StepSyncedDeviceController::swapAllBuffers();
+
+		return simTime;
 	}
 	catch(std::exception &e)
 	{
@@ -76,8 +120,38 @@ SimulationTime NRPCommunicationController::runLoopStep(SimulationTime timeStep)
 	}
 }
 
+json NRPCommunicationController::saveSnapshot(const json &)
+{
+	this->waitForStepCompletion();
+
+	if(this->_stepController == nullptr)
+		throw NRPException::logCreate("Tried to save a snapshot while the controller has not yet been initialized");
+
+	this->_stepController->saveSnapshot();
+
+	return json();
+}
+
+SimulationTime NRPCommunicationController::restoreSnapshot(const json &, EngineJSONServer::lock_t &)
+{
+	this->waitForStepCompletion();
+
+	if(this->_stepController == nullptr)
+		throw NRPException::logCreate("Tried to restore a snapshot while the controller has not yet been initialized");
+
+	const auto simTime = this->_stepController->restoreSnapshot();
+
+	// Serve the restored state to device reads
+	gazebo::StepSyncedDeviceController::captureAllStates();
+	gazebo::StepSyncedDeviceController::swapAllBuffers();
+
+	return simTime;
+}
+
 json NRPCommunicationController::initialize(const json &data, EngineJSONServer::lock_t &lock)
 {
+	this->waitForStepCompletion();
+
 	ConfigStorage confDat(data);
 	GazeboJSONConfig conf(confDat);
 
@@ -103,15 +177,28 @@ json NRPCommunicationController::initialize(const json &data, EngineJSONServer::
 	}
 
 	lock.lock();
+	this->waitForStepCompletion();
+
+	// Serve the loaded world's state to device reads
+	gazebo::StepSyncedDeviceController::captureAllStates();
+	gazebo::StepSyncedDeviceController::swapAllBuffers();
 
 	return nlohmann::json({true});
 }
 
 json NRPCommunicationController::shutdown(const json&)
 {
+	this->waitForStepCompletion();
+
 	return nlohmann::json();
 }
 
+void NRPCommunicationController::waitForStepCompletion()
+{
+	// Waiting on the mutex itself also works for the handlers' locks, which remain owned afterwards
+	this->_stepFinished.wait(this->_deviceLock, [this] { return !this->_stepRunning; });
+}
+
 NRPCommunicationController::NRPCommunicationController(const std::string &address)
     : EngineJSONServer(address)
 {}
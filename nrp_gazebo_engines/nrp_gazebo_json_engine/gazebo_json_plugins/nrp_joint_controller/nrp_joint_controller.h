@@ -25,6 +25,7 @@
 #include "nrp_gazebo_json_engine/config/cmake_constants.h"
 #include "nrp_gazebo_devices/physics_joint.h"
 #include "nrp_gazebo_devices/engine_server/joint_device_controller.h"
+#include "nrp_gazebo_devices/engine_server/model_joints_device_controller.h"
 #include "nrp_json_engine_protocol/engine_server/engine_json_device_controller.h"
 #include "nrp_general_library/utils/nrp_exceptions.h"
 
@@ -61,6 +62,11 @@ namespace gazebo
 			 */
 			std::list<EngineJSONSerialization<JointDeviceController> > _jointDeviceControllers;
 
+			/*!
+			 * \brief Interface for all joints of the model, registered under the model's name
+			 */
+			std::unique_ptr<EngineJSONSerialization<ModelJointsDeviceController> > _modelJointsDeviceController;
+
 			template<class T>
 			static T getOptionalValue(const sdf::ElementPtr &pidConfig, const std::string &key, T defaultValue);
 	};
@@ -24,6 +24,7 @@
 
 #include "nrp_gazebo_devices/physics_link.h"
 #include "nrp_gazebo_devices/engine_server/link_device_controller.h"
+#include "nrp_gazebo_devices/engine_server/model_links_device_controller.h"
 #include "nrp_json_engine_protocol/engine_server/engine_json_device_controller.h"
 
 #include <gazebo/gazebo.hh>
@@ -38,6 +39,11 @@ namespace gazebo
 
 		private:
 			std::list<EngineJSONSerialization<LinkDeviceController> > _linkInterfaces;
+
+			/*!
+			 * \brief Interface for all links of the model, registered under the model's name
+			 */
+			std::unique_ptr<EngineJSONSerialization<ModelLinksDeviceController> > _modelLinksInterface;
 	};
 
 	GZ_REGISTER_MODEL_PLUGIN(NRPLinkControllerPlugin)
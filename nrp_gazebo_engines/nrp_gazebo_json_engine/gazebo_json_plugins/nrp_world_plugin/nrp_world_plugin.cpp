@@ -51,6 +51,7 @@ void gazebo::NRPWorldPlugin::Reset()
 
 	this->_world.reset();
 	this->_worldSDF.reset();
+	this->_snapshot.reset();
 }
 
 SimulationTime gazebo::NRPWorldPlugin::runLoopStep(SimulationTime timeStep)
@@ -74,9 +75,28 @@ SimulationTime gazebo::NRPWorldPlugin::runLoopStep(SimulationTime timeStep)
 
 	//std::cout << "NRPWorldPlugin: Finished loop step. Time:" <<  this->_world->SimTime().Double() << "\n";
 
-	const auto simTime = this->_world->SimTime();
+	return this->worldSimTime();
+}
 
-	return toSimulationTime<int32_t, std::ratio<1>>(simTime.sec) + toSimulationTime<int32_t, std::nano>(simTime.nsec);
+void gazebo::NRPWorldPlugin::saveSnapshot()
+{
+	std::scoped_lock lock(this->_lockLoop);
+
+	// WorldState stores sim time as well as the pose, velocity and wrench of every model, link and joint
+	this->_snapshot.reset(new physics::WorldState(this->_world));
+}
+
+SimulationTime gazebo::NRPWorldPlugin::restoreSnapshot()
+{
+	std::scoped_lock lock(this->_lockLoop);
+
+	if(this->_snapshot == nullptr)
+		throw NRPException::logCreate("No world snapshot has been saved");
+
+	this->_world->SetState(*this->_snapshot);
+	this->_world->SetPaused(true);
+
+	return this->worldSimTime();
 }
 
 bool gazebo::NRPWorldPlugin::finishWorldLoading()
@@ -94,6 +114,13 @@ bool gazebo::NRPWorldPlugin::finishWorldLoading()
 	return true;
 }
 
+SimulationTime gazebo::NRPWorldPlugin::worldSimTime() const
+{
+	const auto simTime = this->_world->SimTime();
+
+	return toSimulationTime<int32_t, std::ratio<1>>(simTime.sec) + toSimulationTime<int32_t, std::nano>(simTime.nsec);
+}
+
 void gazebo::NRPWorldPlugin::startLoop(unsigned int numIterations)
 {
 	//std::cout << "NRPWorldPlugin: Running " << numIterations << " iterations\n";
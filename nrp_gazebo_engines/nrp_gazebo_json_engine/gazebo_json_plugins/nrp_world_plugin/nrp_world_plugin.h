@@ -27,6 +27,7 @@
 #include <gazebo/gazebo.hh>
 #include <gazebo/physics/JointController.hh>
 #include <gazebo/physics/Joint.hh>
+#include <gazebo/physics/WorldState.hh>
 
 namespace gazebo
 {
@@ -45,6 +46,9 @@ namespace gazebo
 
 			virtual SimulationTime runLoopStep(SimulationTime timeStep) override;
 
+			virtual void saveSnapshot() override;
+			virtual SimulationTime restoreSnapshot() override;
+
 			bool finishWorldLoading() override;
 
 		private:
@@ -56,6 +60,16 @@ namespace gazebo
 			physics::WorldPtr _world;
 			sdf::ElementPtr _worldSDF;
 
+			/*!
+			 * \brief World state stored by saveSnapshot()
+			 */
+			std::unique_ptr<physics::WorldState> _snapshot;
+
+			/*!
+			 * \brief Get the current world simulation time
+			 */
+			SimulationTime worldSimTime() const;
+
 			/*!
 			 * \brief Start running the sim.
 			 * \param numIterations Number of iterations to run
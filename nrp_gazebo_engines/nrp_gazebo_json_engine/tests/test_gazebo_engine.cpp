@@ -26,11 +26,14 @@
 #include "nrp_gazebo_json_engine/config/cmake_constants.h"
 #include "nrp_gazebo_devices/physics_camera.h"
 #include "nrp_gazebo_devices/physics_joint.h"
+#include "nrp_gazebo_devices/physics_joints.h"
 #include "nrp_gazebo_devices/physics_link.h"
+#include "nrp_gazebo_devices/physics_links.h"
 #include "nrp_gazebo_json_engine/nrp_client/gazebo_engine_json_nrp_client.h"
 #include "nrp_general_library/process_launchers/process_launcher_basic.h"
 
 #include "tests/test_env_cmake.h"
+#include "tests/test_gazebo_device_checks.h"
 
 #include <fstream>
 
@@ -163,22 +166,7 @@ TEST(TestGazeboEngine, JointPlugin)
 
 	ASSERT_NO_THROW(engine->initialize());
 
-	// Test device data getting
-	auto devices = engine->requestOutputDevices({DeviceIdentifier("youbot::base_footprint_joint", conf.engineName(), PhysicsJoint::TypeName.data())});
-	ASSERT_EQ(devices.size(), 1);
-
-	const PhysicsJoint *pJointDev = dynamic_cast<const PhysicsJoint*>(devices[0].get());
-	ASSERT_EQ(pJointDev->position(), 0);
-
-	// Test device data setting
-	const auto newTargetPos = 2.0f;
-
-	PhysicsJoint newJointDev(DeviceIdentifier(pJointDev->id()));
-	newJointDev.setEffort(NAN);
-	newJointDev.setVelocity(NAN);
-	newJointDev.setPosition(newTargetPos);
-
-	ASSERT_NO_THROW(engine->handleInputDevices({&newJointDev}));
+	ASSERT_NO_FATAL_FAILURE(gazebo_device_checks::checkJointDevices(*engine));
 }
 
 TEST(TestGazeboEngine, LinkPlugin)
@@ -206,12 +194,5 @@ TEST(TestGazeboEngine, LinkPlugin)
 
 	ASSERT_NO_THROW(engine->initialize());
 
-	// Test device data getting
-	auto devices = engine->requestOutputDevices({DeviceIdentifier("link_youbot::base_footprint", conf.engineName(), PhysicsJoint::TypeName.data())});
-	ASSERT_EQ(devices.size(), 1);
-
-	const PhysicsLink *pLinkDev = dynamic_cast<const PhysicsLink*>(devices[0].get());
-	ASSERT_NE(pLinkDev, nullptr);
-
-	// TODO: Check that link state is correct
+	ASSERT_NO_FATAL_FAILURE(gazebo_device_checks::checkLinkDevices(*engine));
 }
@@ -24,6 +24,7 @@
 
 const EngineConfigConst::string_vector_t EngineConfigConst::DefEngineProcEnvParams = {};
 const EngineConfigConst::string_vector_t EngineConfigConst::DefEngineProcStartParams = {};
+const EngineConfigConst::cpu_list_t EngineConfigConst::DefEngineCPUAffinity = {};
 
 std::string &EngineConfigGeneral::engineName()
 {	return const_cast<std::string&>(const_cast<const EngineConfigGeneral*>(this)->engineName());	}
@@ -46,6 +47,15 @@ std::string &EngineConfigGeneral::engineProcCmd()
 EngineConfigConst::string_vector_t &EngineConfigGeneral::userProcStartParams()
 {	return const_cast<string_vector_t&>(const_cast<const EngineConfigGeneral*>(this)->userProcStartParams());	}
 
+EngineConfigConst::cpu_list_t &EngineConfigGeneral::engineCPUAffinity()
+{	return const_cast<cpu_list_t&>(const_cast<const EngineConfigGeneral*>(this)->engineCPUAffinity());	}
+
+int &EngineConfigGeneral::engineNUMANode()
+{	return const_cast<int&>(const_cast<const EngineConfigGeneral*>(this)->engineNUMANode());	}
+
+bool &EngineConfigGeneral::engineSnapshots()
+{	return const_cast<bool&>(const_cast<const EngineConfigGeneral*>(this)->engineSnapshots());	}
+
 EngineConfigConst::string_vector_t EngineConfigGeneral::allEngineProcEnvParams() const
 {	return this->userProcEnvParams();		}
 
@@ -36,6 +36,7 @@ struct EngineConfigConst
 {
 	using config_storage_t = SimulationConfigConst::config_storage_t;
 	using string_vector_t = std::vector<std::string>;
+	using cpu_list_t = std::vector<int>;
 
 	/*!
 	 * \brief Engine type. Used by EngineLauncherManager to select correct engine
@@ -85,12 +86,33 @@ struct EngineConfigConst
 	static constexpr FixedString EngineProcStartParams = "EngineProcStartParams";
 	static const string_vector_t DefEngineProcStartParams;
 
-	using ECfgPropNames = PropNames<EngineType, EngineName, EngineLaunchCmd, EngineTimestep, EngineCommandTimeout, EngineProcEnvParams, EngineProcStartParams, EngineProcCmd>;
+	/*!
+	 * \brief CPUs the engine process is restricted to. An empty list keeps the inherited affinity
+	 */
+	static constexpr FixedString EngineCPUAffinity = "EngineCPUAffinity";
+	static const cpu_list_t DefEngineCPUAffinity;
+
+	/*!
+	 * \brief NUMA node on which the engine process should allocate memory. If no EngineCPUAffinity is set, the process is also restricted to the node's CPUs.
+	 * Negative values disable NUMA placement
+	 */
+	static constexpr FixedString EngineNUMANode = "EngineNUMANode";
+	static constexpr int DefEngineNUMANode = -1;
+
+	/*!
+	 * \brief Store a snapshot of the engine after initialization, so that the simulation can be reset without relaunching the engine.
+	 * Only enable this for engine servers which implement snapshots
+	 */
+	static constexpr FixedString EngineSnapshots = "EngineSnapshots";
+	static constexpr bool DefEngineSnapshots = false;
+
+	using ECfgPropNames = PropNames<EngineType, EngineName, EngineLaunchCmd, EngineTimestep, EngineCommandTimeout, EngineProcEnvParams, EngineProcStartParams, EngineProcCmd,
+	                                EngineCPUAffinity, EngineNUMANode, EngineSnapshots>;
 
 	template<class CONFIG, class PROP_NAMES, class ...PROPERTIES>
 	using ECfgProps = JSONConfigProperties<CONFIG, MultiPropNames<EngineConfigConst::ECfgPropNames, PROP_NAMES>,
 	                                       std::string, std::string, std::string, float, float, EngineConfigConst::string_vector_t,
-	                                       EngineConfigConst::string_vector_t, std::string, PROPERTIES...>;
+	                                       EngineConfigConst::string_vector_t, std::string, EngineConfigConst::cpu_list_t, int, bool, PROPERTIES...>;
 };
 
 /*!
@@ -144,6 +166,24 @@ class EngineConfigGeneral
 		virtual const string_vector_t &userProcStartParams() const = 0;
 		string_vector_t &userProcStartParams();
 
+		/*!
+		 * \brief Get CPUs the engine process is restricted to. Empty if the affinity is inherited
+		 */
+		virtual const cpu_list_t &engineCPUAffinity() const = 0;
+		cpu_list_t &engineCPUAffinity();
+
+		/*!
+		 * \brief Get NUMA node of the engine process. Negative if no NUMA placement was requested
+		 */
+		virtual const int &engineNUMANode() const = 0;
+		int &engineNUMANode();
+
+		/*!
+		 * \brief Get whether the engine should store a snapshot after initialization
+		 */
+		virtual const bool &engineSnapshots() const = 0;
+		bool &engineSnapshots();
+
 		/*!
 		 * \brief Get all Engine Process Environment variables.
 		 *        May be overriden by engines if additional environment variables are required that are not stored in engineProcEnvParams.
@@ -181,6 +221,9 @@ class EngineConfig
 		                               CONFIG::DefEngineProcEnvParams,
 		                               CONFIG::DefEngineProcStartParams,
 		                               CONFIG::DefEngineProcCmd.data(),
+		                               CONFIG::DefEngineCPUAffinity,
+		                               CONFIG::DefEngineNUMANode,
+		                               CONFIG::DefEngineSnapshots,
 		                               std::forward<T>(properties)...)
 		{}
 
@@ -225,6 +268,24 @@ class EngineConfig
 
 		string_vector_t &userProcStartParams()
 		{	return this->EngineConfigGeneral::userProcStartParams();	}
+
+		const cpu_list_t &engineCPUAffinity() const override final
+		{	return this->template getPropertyByName<EngineCPUAffinity>();	}
+
+		cpu_list_t &engineCPUAffinity()
+		{	return this->EngineConfigGeneral::engineCPUAffinity();	}
+
+		const int &engineNUMANode() const override final
+		{	return this->template getPropertyByName<EngineNUMANode>();	}
+
+		int &engineNUMANode()
+		{	return this->EngineConfigGeneral::engineNUMANode();	}
+
+		const bool &engineSnapshots() const override final
+		{	return this->template getPropertyByName<EngineSnapshots>();	}
+
+		bool &engineSnapshots()
+		{	return this->EngineConfigGeneral::engineSnapshots();	}
 };
 
 template<class T>
@@ -28,12 +28,15 @@
 
 const SimulationConfig::tf_configs_t SimulationConfigConst::DefTFArrayConfig = {};
 const SimulationConfig::tf_configs_t SimulationConfigConst::DefEngineSimulatorsConfig = {};
+const SimulationConfig::cpu_list_t SimulationConfigConst::DefSimulationLoopCPUAffinity = {};
 
 SimulationConfig::SimulationConfig(const nlohmann::json &configuration)
     : JSONConfigProperties(configuration,
                            DefSimulationTimeout,
                            DefEngineSimulatorsConfig,
-						   DefTFArrayConfig)
+						   DefTFArrayConfig,
+                           DefSimulationLoopCPUAffinity,
+                           DefSimulationLoopNUMANode)
 {}
 
 const std::string &SimulationConfig::name() const
@@ -76,3 +79,23 @@ SimulationConfig::tf_configs_t &SimulationConfig::transceiverFunctionConfigs()
 	return this->getPropertyByName<SimulationConfig::TFArrayConfig>();
 }
 
+
+const SimulationConfig::cpu_list_t &SimulationConfig::simulationLoopCPUAffinity() const
+{
+	return this->getPropertyByName<SimulationConfig::SimulationLoopCPUAffinity>();
+}
+
+SimulationConfig::cpu_list_t &SimulationConfig::simulationLoopCPUAffinity()
+{
+	return this->getPropertyByName<SimulationConfig::SimulationLoopCPUAffinity>();
+}
+
+int SimulationConfig::simulationLoopNUMANode() const
+{
+	return this->getPropertyByName<SimulationConfig::SimulationLoopNUMANode, int>();
+}
+
+int &SimulationConfig::simulationLoopNUMANode()
+{
+	return this->getPropertyByName<SimulationConfig::SimulationLoopNUMANode, int>();
+}
@@ -34,6 +34,7 @@ struct SimulationConfigConst
 {
 	using config_storage_t = ConfigStorage<nlohmann::json>;
 	using tf_configs_t = std::vector<config_storage_t>;
+	using cpu_list_t = std::vector<int>;
 
 	/*!
 	 * \brief SimulationConfig Type
@@ -58,6 +59,18 @@ struct SimulationConfigConst
 	static constexpr FixedString TFArrayConfig = "TransceiverFunctions";
 	static const tf_configs_t DefTFArrayConfig;
 
+	/*!
+	 * \brief CPUs to which the simulation loop process is pinned. Applied after all engines have been launched. Empty means no pinning
+	 */
+	static constexpr FixedString SimulationLoopCPUAffinity = "SimulationLoopCPUAffinity";
+	static const cpu_list_t DefSimulationLoopCPUAffinity;
+
+	/*!
+	 * \brief NUMA node on which the simulation loop process should run and allocate memory. -1 means no preference
+	 */
+	static constexpr FixedString SimulationLoopNUMANode = "SimulationLoopNUMANode";
+	static constexpr int DefSimulationLoopNUMANode = -1;
+
 	/*!
 	 * \brief Name of simulation
 	 */
@@ -66,12 +79,16 @@ struct SimulationConfigConst
 	using SPropNames = PropNames<SimulationConfigConst::SimulationTimeout,
 	                             SimulationConfigConst::EngineSimulatorsConfig,
 								 SimulationConfigConst::TFArrayConfig,
+	                             SimulationConfigConst::SimulationLoopCPUAffinity,
+	                             SimulationConfigConst::SimulationLoopNUMANode,
 	                             SimName>;
 
 	using SProps = JSONConfigProperties<SimulationConfig, SimulationConfigConst::SPropNames,
 	                                    unsigned int,
 										std::vector<SimulationConfigConst::config_storage_t>,
 	                                    std::vector<SimulationConfigConst::config_storage_t>,
+	                                    SimulationConfigConst::cpu_list_t,
+	                                    int,
 										std::string >;
 };
 
@@ -97,6 +114,12 @@ class SimulationConfig
 		const tf_configs_t &transceiverFunctionConfigs() const;
 		tf_configs_t &transceiverFunctionConfigs();
 
+		const cpu_list_t &simulationLoopCPUAffinity() const;
+		cpu_list_t &simulationLoopCPUAffinity();
+
+		int simulationLoopNUMANode() const;
+		int &simulationLoopNUMANode();
+
 	private:
 };
 
@@ -35,7 +35,7 @@ TransceiverFunctionConfig::TransceiverFunctionConfig(SimulationConfig::config_st
 
 TransceiverFunctionConfig::TransceiverFunctionConfig(const nlohmann::json &config)
     : JSONConfigProperties(config,
-                           DefName.data(), DefFile.data(), DefIsActive)
+                           DefName.data(), DefFile.data(), DefIsActive, DefPeriod)
 {}
 
 const std::string &TransceiverFunctionConfig::fileName() const
@@ -67,3 +67,13 @@ void TransceiverFunctionConfig::setIsActive(bool active)
 {
 	this->getPropertyByName<TransceiverFunctionConfig::IsActive, bool>() = active;
 }
+
+float TransceiverFunctionConfig::period() const
+{
+	return this->getPropertyByName<TransceiverFunctionConfig::Period, float>();
+}
+
+void TransceiverFunctionConfig::setPeriod(float period)
+{
+	this->getPropertyByName<TransceiverFunctionConfig::Period, float>() = period;
+}
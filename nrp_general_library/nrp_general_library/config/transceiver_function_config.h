@@ -48,6 +48,12 @@ struct TransceiverFunctionConfigConst
 	static constexpr FixedString IsActive = "IsActive";
 	static constexpr bool DefIsActive = true;
 
+	/*!
+	 * \brief Minimal time (in seconds) between two executions of this TF. 0 executes it after every step of the linked engine
+	 */
+	static constexpr FixedString Period = "Period";
+	static constexpr float DefPeriod = 0.0f;
+
 	/*!
 	 * \brief TransceiverFunctionConfig Type
 	 */
@@ -60,8 +66,8 @@ struct TransceiverFunctionConfigConst
 class TransceiverFunctionConfig
         : public JSONConfigProperties<TransceiverFunctionConfig,
                                       PropNames<TransceiverFunctionConfigConst::Name, TransceiverFunctionConfigConst::File,
-                                                TransceiverFunctionConfigConst::IsActive>,
-                                      std::string, std::string, bool>,
+                                                TransceiverFunctionConfigConst::IsActive, TransceiverFunctionConfigConst::Period>,
+                                      std::string, std::string, bool, float>,
           public TransceiverFunctionConfigConst,
           public PtrTemplates<TransceiverFunctionConfig>
 {
@@ -80,6 +86,9 @@ class TransceiverFunctionConfig
 
 		bool isActive() const;
 		void setIsActive(bool active);
+
+		float period() const;
+		void setPeriod(float period);
 };
 
 using TransceiverFunctionConfigSharedPtr		= TransceiverFunctionConfig::shared_ptr;
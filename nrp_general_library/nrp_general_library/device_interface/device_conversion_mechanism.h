@@ -59,6 +59,7 @@ class DeviceConversionMechanism
 		        : public Conversions<REM...>
 		{
 			static const SERIALIZATION_TYPE &serialize(DEVICE &device);
+			static void serializeInto(const DEVICE &device, SERIALIZATION_TYPE &target);
 			static const DEVICE &deserialize(DESERIALIZATION_TYPE &data);
 		};
 
@@ -84,6 +85,16 @@ class DeviceConversionMechanism
 		static const SERIALIZATION_TYPE &serialize(DEVICE &device)
 		{	return Conversions<DEVICES...>::serialize(device);	}
 
+		/*!
+		 * \brief Device Serialization into a caller-provided buffer. Avoids materializing and copying an intermediate representation
+		 * \tparam DEVICE Device Type
+		 * \param device Device to serialize
+		 * \param target Buffer to write the serialized data into
+		 */
+		template<DEVICE_C DEVICE>
+		static void serializeInto(const DEVICE &device, SERIALIZATION_TYPE &target)
+		{	Conversions<DEVICES...>::serializeInto(device, target);	}
+
 		/*!
 		 * \brief Device Deserialization
 		 * \tparam DEVICE Device Type
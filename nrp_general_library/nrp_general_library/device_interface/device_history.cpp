@@ -0,0 +1,88 @@
+//
+// NRP Core - Backend infrastructure to synchronize simulations
+//
+// Copyright 2020 Michael Zechmair
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This project has received funding from the European Union’s Horizon 2020
+// Framework Programme for Research and Innovation under the Specific Grant
+// Agreement No. 945539 (Human Brain Project SGA3).
+//
+
+#include "nrp_general_library/device_interface/device_history.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+DeviceHistory::DeviceHistory(size_t capacity)
+    : _devices(capacity)
+{}
+
+size_t DeviceHistory::capacity() const
+{
+	return this->_devices.size();
+}
+
+size_t DeviceHistory::size() const
+{
+	return this->_size;
+}
+
+void DeviceHistory::setCapacity(size_t capacity)
+{
+	if(capacity == this->capacity())
+		return;
+
+	// Copy stored devices, from oldest to newest
+	const size_t newSize = std::min(this->_size, capacity);
+
+	std::vector<DeviceInterfaceConstSharedPtr> devices(capacity);
+	for(size_t i = 0; i < newSize; ++i)
+		devices[i] = std::move(this->_devices[(this->_newest + this->capacity() - (newSize-1-i)) % this->capacity()]);
+
+	this->_devices = std::move(devices);
+	this->_size = newSize;
+	this->_newest = newSize > 0 ? newSize-1 : 0;
+}
+
+void DeviceHistory::push(const DeviceInterfaceConstSharedPtr &device)
+{
+	if(this->_devices.empty())
+		return;
+
+	if(this->_size > 0)
+		this->_newest = (this->_newest + 1) % this->capacity();
+
+	this->_devices[this->_newest] = device;
+
+	if(this->_size < this->capacity())
+		++this->_size;
+}
+
+const DeviceInterfaceConstSharedPtr &DeviceHistory::at(size_t age) const
+{
+	if(age >= this->_size)
+		throw std::out_of_range("Device history index " + std::to_string(age) + " out of range (size " + std::to_string(this->_size) + ")");
+
+	return this->_devices[(this->_newest + this->capacity() - age) % this->capacity()];
+}
+
+void DeviceHistory::clear()
+{
+	for(auto &device : this->_devices)
+		device = nullptr;
+
+	this->_newest = 0;
+	this->_size = 0;
+}
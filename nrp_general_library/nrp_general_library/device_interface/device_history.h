@@ -0,0 +1,95 @@
+/* * NRP Core - Backend infrastructure to synchronize simulations
+ *
+ * Copyright 2020 Michael Zechmair
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This project has received funding from the European Union’s Horizon 2020
+ * Framework Programme for Research and Innovation under the Specific Grant
+ * Agreement No. 945539 (Human Brain Project SGA3).
+ */
+
+
+#ifndef DEVICE_HISTORY_H
+#define DEVICE_HISTORY_H
+
+#include "nrp_general_library/device_interface/device_interface.h"
+
+#include <vector>
+
+/*!
+ * \brief Fixed-capacity ring buffer storing the most recent versions of a single device.
+ * Only pointers are stored, device data is never copied
+ */
+class DeviceHistory
+{
+	public:
+		/*!
+		 * \brief Constructor
+		 * \param capacity Maximum number of stored devices
+		 */
+		explicit DeviceHistory(size_t capacity = 0);
+
+		/*!
+		 * \brief Maximum number of stored devices
+		 */
+		size_t capacity() const;
+
+		/*!
+		 * \brief Number of currently stored devices
+		 */
+		size_t size() const;
+
+		/*!
+		 * \brief Change capacity. If the capacity is reduced, the oldest devices are discarded
+		 * \param capacity New capacity
+		 */
+		void setCapacity(size_t capacity);
+
+		/*!
+		 * \brief Add newest device. If the history is full, the oldest device is overwritten
+		 * \param device Device to add
+		 */
+		void push(const DeviceInterfaceConstSharedPtr &device);
+
+		/*!
+		 * \brief Get stored device
+		 * \param age Age of device. 0 is the newest device, size()-1 the oldest one
+		 * \return Returns stored device
+		 * \throw Throws std::out_of_range if age >= size()
+		 */
+		const DeviceInterfaceConstSharedPtr &at(size_t age) const;
+
+		/*!
+		 * \brief Remove all stored devices. Capacity remains unchanged
+		 */
+		void clear();
+
+	private:
+		/*!
+		 * \brief Ring buffer
+		 */
+		std::vector<DeviceInterfaceConstSharedPtr> _devices;
+
+		/*!
+		 * \brief Position of newest device in _devices
+		 */
+		size_t _newest = 0;
+
+		/*!
+		 * \brief Number of stored devices
+		 */
+		size_t _size = 0;
+};
+
+#endif // DEVICE_HISTORY_H
@@ -0,0 +1,211 @@
+/* * NRP Core - Backend infrastructure to synchronize simulations
+ *
+ * Copyright 2020 Michael Zechmair
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This project has received funding from the European Union’s Horizon 2020
+ * Framework Programme for Research and Innovation under the Specific Grant
+ * Agreement No. 945539 (Human Brain Project SGA3).
+ */
+
+
+#ifndef DEVICE_TYPE_DISPATCH_H
+#define DEVICE_TYPE_DISPATCH_H
+
+#include "nrp_general_library/device_interface/device_interface.h"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+/*!
+ * \brief General functions of DeviceTypeDispatch that don't depend on the device types
+ */
+class DeviceTypeDispatchGeneral
+{
+	public:
+		/*!
+		 * \brief Hash of a device type name. Used as key of the DeviceTypeDispatch hash table
+		 */
+		using type_tag_t = uint32_t;
+
+		/*!
+		 * \brief Tag value that is never assigned to a device type
+		 */
+		static constexpr type_tag_t NoTypeTag = 0;
+
+		/*!
+		 * \brief Calculate the tag of a device type (32-bit FNV-1a hash of the type name)
+		 * \param typeName Device type name
+		 * \return Returns tag of the device type
+		 */
+		static constexpr type_tag_t typeTag(std::string_view typeName)
+		{
+			type_tag_t tag = 2166136261u;
+			for(const char c : typeName)
+			{
+				tag ^= static_cast<unsigned char>(c);
+				tag *= 16777619u;
+			}
+
+			return tag != NoTypeTag ? tag : 1;
+		}
+};
+
+/*!
+ * \brief Maps device type names or tags to one of the given DEVICES.
+ * A hash table over all DEVICES::TypeName is generated at compile time, so the lookup cost does not depend on the number of device types
+ * \tparam DEVICES Device types to dispatch to
+ */
+template<DEVICE_C ...DEVICES>
+class DeviceTypeDispatch
+        : public DeviceTypeDispatchGeneral
+{
+		/*!
+		 * \brief Hash table entry
+		 */
+		struct TableEntry
+		{
+			type_tag_t Tag = NoTypeTag;
+			std::size_t ID = sizeof...(DEVICES);
+		};
+
+		static constexpr std::size_t TableSize = std::bit_ceil(2*sizeof...(DEVICES) + 1);
+
+		static constexpr std::array<std::string_view, sizeof...(DEVICES)> TypeNames = { std::string_view(DEVICES::TypeName)... };
+
+		static constexpr std::array<type_tag_t, sizeof...(DEVICES)> TypeTags = { DeviceTypeDispatchGeneral::typeTag(std::string_view(DEVICES::TypeName))... };
+
+		/*!
+		 * \brief Create hash table with linear probing. Generated at compile time
+		 */
+		static constexpr std::array<TableEntry, TableSize> createTable()
+		{
+			std::array<TableEntry, TableSize> table;
+			for(std::size_t id = 0; id < sizeof...(DEVICES); ++id)
+			{
+				auto pos = TypeTags[id] & (TableSize-1);
+				while(table[pos].Tag != NoTypeTag)
+					pos = (pos+1) & (TableSize-1);
+
+				table[pos] = TableEntry{TypeTags[id], id};
+			}
+
+			return table;
+		}
+
+		static constexpr bool hasUniqueTags()
+		{
+			for(std::size_t i = 0; i < sizeof...(DEVICES); ++i)
+			{
+				for(std::size_t j = i+1; j < sizeof...(DEVICES); ++j)
+				{
+					if(TypeTags[i] == TypeTags[j])
+						return false;
+				}
+			}
+
+			return true;
+		}
+
+		static_assert(hasUniqueTags(), "DEVICES contains duplicate device types or type names with colliding type tags");
+
+		static constexpr std::array<TableEntry, TableSize> Table = createTable();
+
+	public:
+		/*!
+		 * \brief ID returned by findType() and findTag() if no device matches
+		 */
+		static constexpr std::size_t NotFound = sizeof...(DEVICES);
+
+		/*!
+		 * \brief Tag of DEVICE
+		 */
+		template<DEVICE_C DEVICE>
+		static constexpr type_tag_t DeviceTag = DeviceTypeDispatchGeneral::typeTag(std::string_view(DEVICE::TypeName));
+
+		/*!
+		 * \brief Find ID of device with the given tag
+		 * \param tag Device type tag
+		 * \return Returns position of the device in DEVICES, NotFound if no device type has the given tag
+		 */
+		static constexpr std::size_t findTag(type_tag_t tag)
+		{
+			auto pos = tag & (TableSize-1);
+			while(Table[pos].Tag != NoTypeTag)
+			{
+				if(Table[pos].Tag == tag)
+					return Table[pos].ID;
+
+				pos = (pos+1) & (TableSize-1);
+			}
+
+			return NotFound;
+		}
+
+		/*!
+		 * \brief Find ID of device with the given type name
+		 * \param typeName Device type name
+		 * \return Returns position of the device in DEVICES, NotFound if no device type has the given name
+		 */
+		static constexpr std::size_t findType(std::string_view typeName)
+		{
+			const auto id = findTag(DeviceTypeDispatchGeneral::typeTag(typeName));
+			if(id != NotFound && TypeNames[id] == typeName)
+				return id;
+
+			return NotFound;
+		}
+
+		/*!
+		 * \brief Call fcn.template operator()<DEVICE>() with the device type stored at position id of DEVICES
+		 * \tparam FCN Function type. Should be a lambda of the form []<class DEVICE>() {}. All DEVICE calls must have the same return type
+		 * \tparam NOT_FOUND_FCN Function type. Called without arguments if id is NotFound
+		 * \param id Device ID, as returned by findType()
+		 * \param fcn Function to call with the device type
+		 * \param notFoundFcn Function to call if no device was found
+		 * \return Returns result of fcn
+		 */
+		template<class FCN, class NOT_FOUND_FCN>
+		static decltype(auto) dispatchID(std::size_t id, FCN &&fcn, NOT_FOUND_FCN &&notFoundFcn)
+		{
+			if constexpr (sizeof...(DEVICES) > 0)
+			{
+				using ret_t = std::common_type_t<decltype(fcn.template operator()<DEVICES>())...>;
+				using fcn_ptr_t = ret_t(*)(FCN&);
+				static constexpr fcn_ptr_t DeviceFcns[] = { &DeviceTypeDispatch::callDeviceFcn<DEVICES, FCN, ret_t>... };
+
+				if(id < NotFound)
+					return DeviceFcns[id](fcn);
+			}
+
+			return std::forward<NOT_FOUND_FCN>(notFoundFcn)();
+		}
+
+		/*!
+		 * \brief Call fcn.template operator()<DEVICE>() with the device type matching typeName. See dispatchID()
+		 */
+		template<class FCN, class NOT_FOUND_FCN>
+		static decltype(auto) dispatchType(std::string_view typeName, FCN &&fcn, NOT_FOUND_FCN &&notFoundFcn)
+		{	return DeviceTypeDispatch::dispatchID(findType(typeName), std::forward<FCN>(fcn), std::forward<NOT_FOUND_FCN>(notFoundFcn));	}
+
+	private:
+		template<DEVICE_C DEVICE, class FCN, class RET_T>
+		static RET_T callDeviceFcn(FCN &fcn)
+		{	return fcn.template operator()<DEVICE>();	}
+};
+
+#endif // DEVICE_TYPE_DISPATCH_H
@@ -117,3 +117,10 @@ PyObjectDeviceConst::PyObjData JSONPropertySerializerMethods::deserializeSingleP
 	return PyObjectDeviceConst::PyObjData(data[name.data()].dump());
 }
 
+template<>
+void JSONPropertySerializerMethods::updateSingleProperty<PyObjectDeviceConst::PyObjData>(const nlohmann::json &data, const std::string_view &name, PyObjectDeviceConst::PyObjData &property)
+{
+	// Keep the device's JSON encoder and decoder
+	property.deserialize(data[name.data()].dump());
+}
+
@@ -81,4 +81,7 @@ nlohmann::json JSONPropertySerializerMethods::serializeSingleProperty(const PyOb
 template<>
 PyObjectDeviceConst::PyObjData JSONPropertySerializerMethods::deserializeSingleProperty<PyObjectDeviceConst::PyObjData>(const nlohmann::json &data, const std::string_view &name);
 
+template<>
+void JSONPropertySerializerMethods::updateSingleProperty<PyObjectDeviceConst::PyObjData>(const nlohmann::json &data, const std::string_view &name, PyObjectDeviceConst::PyObjData &property);
+
 #endif // PYOBJECT_DEVICE_H
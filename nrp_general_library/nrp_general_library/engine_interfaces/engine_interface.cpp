@@ -22,6 +22,8 @@
 
 #include "nrp_general_library/engine_interfaces/engine_interface.h"
 
+#include "nrp_general_library/utils/nrp_exceptions.h"
+
 EngineInterface::EngineInterface(std::unique_ptr<ProcessLauncherInterface> &&launcher)
     : _process(std::move(launcher))
 {}
@@ -44,6 +46,15 @@ pid_t EngineInterface::launchEngine()
 	return this->_process->launchEngineProcess(*this->engineConfigGeneral(), EngineConfigConst::string_vector_t(), EngineConfigConst::string_vector_t());
 }
 
+pid_t EngineInterface::stopEngineProcess(unsigned int killWait)
+{
+	// Engine was never launched
+	if(this->_process == nullptr || this->_process->launchCommand() == nullptr)
+		return 0;
+
+	return this->_process->stopEngineProcess(killWait);
+}
+
 const EngineInterface::device_outputs_t &EngineInterface::requestOutputDevices(const EngineInterface::device_identifiers_t &deviceIdentifiers)
 {
 	// Merge cached devices into new list
@@ -52,6 +63,85 @@ const EngineInterface::device_outputs_t &EngineInterface::requestOutputDevices(c
 	return this->_deviceCache;
 }
 
+std::chrono::steady_clock::time_point EngineInterface::stepCompletionTime() const
+{
+	return std::chrono::steady_clock::now();
+}
+
+bool EngineInterface::supportsSnapshots() const
+{
+	return false;
+}
+
+void EngineInterface::saveSnapshot()
+{
+	if(!this->supportsSnapshots())
+		throw NRPException::logCreate("Engine \"" + this->engineName() + "\" does not support snapshots");
+
+	this->saveSnapshotCallback();
+}
+
+void EngineInterface::restoreSnapshot()
+{
+	if(!this->supportsSnapshots())
+		throw NRPException::logCreate("Engine \"" + this->engineName() + "\" does not support snapshots");
+
+	this->restoreSnapshotCallback();
+
+	// Cached devices belong to the discarded state
+	this->_deviceCache.clear();
+	for(auto &history : this->_deviceHistories)
+		history.second.clear();
+}
+
+void EngineInterface::setDeviceHistoryCapacity(const std::string &deviceName, size_t capacity)
+{
+	if(capacity == 0)
+	{
+		this->_deviceHistories.erase(deviceName);
+		return;
+	}
+
+	auto historyIt = this->_deviceHistories.find(deviceName);
+	if(historyIt == this->_deviceHistories.end())
+		this->_deviceHistories.emplace(deviceName, DeviceHistory(capacity));
+	else
+		historyIt->second.setCapacity(capacity);
+}
+
+void EngineInterface::setDeviceHistoryCapacities(const EngineInterface::device_history_capacities_t &capacities)
+{
+	const auto &engineName = this->engineName();
+
+	// Remove histories that are no longer requested
+	for(auto historyIt = this->_deviceHistories.begin(); historyIt != this->_deviceHistories.end();)
+	{
+		const auto isRequested = std::any_of(capacities.begin(), capacities.end(), [&](const auto &capacity)
+		{	return capacity.first.EngineName == engineName && capacity.first.Name == historyIt->first;	});
+
+		if(isRequested)
+			++historyIt;
+		else
+			historyIt = this->_deviceHistories.erase(historyIt);
+	}
+
+	for(const auto &capacity : capacities)
+	{
+		if(capacity.first.EngineName == engineName)
+			this->setDeviceHistoryCapacity(capacity.first.Name, capacity.second);
+	}
+}
+
+void EngineInterface::saveSnapshotCallback()
+{
+	throw NRPException::logCreate("Engine \"" + this->engineName() + "\" does not support snapshots");
+}
+
+void EngineInterface::restoreSnapshotCallback()
+{
+	throw NRPException::logCreate("Engine \"" + this->engineName() + "\" does not support snapshots");
+}
+
 inline const int &setCmp(int &ref, int val)
 {	return ref=val;	}
 
@@ -69,6 +159,13 @@ void EngineInterface::insertSorted(EngineInterface::device_outputs_set_t &&devs)
 		else
 			this->_deviceCache.insert(this->_deviceCache.begin()+i, dev);
 
+		if(!this->_deviceHistories.empty())
+		{
+			auto historyIt = this->_deviceHistories.find(dev->name());
+			if(historyIt != this->_deviceHistories.end())
+				historyIt->second.push(dev);
+		}
+
 		++i;
 	}
 }
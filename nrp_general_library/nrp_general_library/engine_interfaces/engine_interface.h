@@ -24,12 +24,16 @@
 
 #include "nrp_general_library/config/engine_config.h"
 #include "nrp_general_library/device_interface/device.h"
+#include "nrp_general_library/device_interface/device_history.h"
 #include "nrp_general_library/process_launchers/process_launcher.h"
 #include "nrp_general_library/utils/fixed_string.h"
 #include "nrp_general_library/utils/ptr_templates.h"
 #include "nrp_general_library/utils/time_utils.h"
 
+#include <algorithm>
+#include <chrono>
 #include <concepts>
+#include <map>
 #include <set>
 #include <vector>
 
@@ -67,6 +71,8 @@ class EngineInterface
 		using device_outputs_t = std::vector<DeviceInterfaceConstSharedPtr>;
 		using device_outputs_set_t = std::set<DeviceInterfaceConstSharedPtr, CompareDevInt>;
 		using device_inputs_t = std::vector<DeviceInterface*>;
+		using device_histories_t = std::map<std::string, DeviceHistory>;
+		using device_history_capacities_t = std::map<DeviceIdentifier, size_t>;
 
 		explicit EngineInterface(ProcessLauncherInterface::unique_ptr &&launcher);
 		virtual ~EngineInterface();
@@ -94,6 +100,13 @@ class EngineInterface
 		 */
 		virtual pid_t launchEngine();
 
+		/*!
+		 * \brief Stop the engine process. Safe to call from a separate thread for each engine
+		 * \param killWait Time (in seconds) to wait for the process to quit by itself before force killing it. 0 means it will wait indefinitely
+		 * \return Returns 0 on success, negative value on error
+		 */
+		virtual pid_t stopEngineProcess(unsigned int killWait);
+
 		/*!
 		 * \brief Initialize engine
 		 * \return Returns SUCCESS if no error was encountered
@@ -137,9 +150,17 @@ class EngineInterface
 		 */
 		virtual void waitForStepCompletion(float timeOut) = 0;
 
+		/*!
+		 * \brief Get the time at which the last loop step completed. Only valid after waitForStepCompletion() returned.
+		 * Engines running their steps asynchronously should override this with the time the step actually finished.
+		 * Default implementation returns the current time
+		 */
+		virtual std::chrono::steady_clock::time_point stepCompletionTime() const;
+
 		/*!
 		 * \brief Gets requested output devices from physics simulator.
-		 * Uses requestOutputDeviceCallback override for actual communication and stores received data in _deviceCache
+		 * Uses requestOutputDeviceCallback override for actual communication and stores received data in _deviceCache.
+		 * Cached devices that are not referenced elsewhere may be updated in place by the engine client
 		 * \param deviceNames All requested names. NOTE: can also include IDs of other engines. A check must be added that only the corresponding IDs are retrieved
 		 * \return Returns all requested output devices
 		 */
@@ -151,6 +172,26 @@ class EngineInterface
 		constexpr const device_outputs_t &getOutputDevices() const
 		{	return this->_deviceCache;	}
 
+		/*!
+		 * \brief Keep a history of the last retrieved versions of a device.
+		 * Devices with a history are no longer updated in place, as older versions remain referenced
+		 * \param deviceName Name of device
+		 * \param capacity Number of stored versions. 0 disables the history
+		 */
+		void setDeviceHistoryCapacity(const std::string &deviceName, size_t capacity);
+
+		/*!
+		 * \brief Set history capacities of all devices. Histories of devices not contained in capacities are removed
+		 * \param capacities Requested history capacities. NOTE: can also include IDs of other engines, these are ignored
+		 */
+		void setDeviceHistoryCapacities(const device_history_capacities_t &capacities);
+
+		/*!
+		 * \brief Get device histories, mapped by device name
+		 */
+		constexpr const device_histories_t &getDeviceHistories() const
+		{	return this->_deviceHistories;	}
+
 		/*!
 		 * \brief Handles received input devices
 		 * \param inputDevices All input devices that the phyiscs simulation should process
@@ -159,6 +200,26 @@ class EngineInterface
 		 */
 		virtual void handleInputDevices(const device_inputs_t &inputDevices) = 0;
 
+		/*!
+		 * \brief Whether the engine can store and restore its state. Engines supporting snapshots must override this along with saveSnapshotCallback and restoreSnapshotCallback
+		 * \return Returns true if saveSnapshot() and restoreSnapshot() are available. Default implementation returns false
+		 */
+		virtual bool supportsSnapshots() const;
+
+		/*!
+		 * \brief Save the current engine state. Only a single snapshot is kept, saving again overwrites it.
+		 * Uses saveSnapshotCallback override for actual communication
+		 * \throw Throws if the engine does not support snapshots
+		 */
+		void saveSnapshot();
+
+		/*!
+		 * \brief Restore the engine state stored by the last call to saveSnapshot().
+		 * Uses restoreSnapshotCallback override for actual communication. Clears _deviceCache and _deviceHistories, as stored devices belong to the discarded state
+		 * \throw Throws if the engine does not support snapshots or no snapshot was saved
+		 */
+		void restoreSnapshot();
+
 	protected:
 
 		/*!
@@ -169,6 +230,18 @@ class EngineInterface
 		 */
 		virtual device_outputs_set_t requestOutputDeviceCallback(const device_identifiers_t &deviceIdentifiers) = 0;
 
+		/*!
+		 * \brief Tells the engine server to store its current state. Default implementation throws
+		 * \throw Throws on error
+		 */
+		virtual void saveSnapshotCallback();
+
+		/*!
+		 * \brief Tells the engine server to return to its stored state. Must also reset the engine time returned by getEngineTime(). Default implementation throws
+		 * \throw Throws on error
+		 */
+		virtual void restoreSnapshotCallback();
+
 		/*!
 		 * \brief Process Launcher. Will be used to stop process at end
 		 */
@@ -180,10 +253,34 @@ class EngineInterface
 		device_outputs_t _deviceCache;
 
 		/*!
-		 * \brief Insert sorted devices into _deviceCache
+		 * \brief Histories of cached devices. Only contains devices for which a history was requested
+		 */
+		device_histories_t _deviceHistories;
+
+		/*!
+		 * \brief Insert sorted devices into _deviceCache. Also adds them to _deviceHistories
 		 * \param devs Devices to insert
 		 */
 		void insertSorted(device_outputs_set_t &&devs);
+
+		/*!
+		 * \brief Find a cached device that can be updated in place instead of allocating a new one.
+		 * A device is only returned if its type matches and it is not referenced anywhere outside of _deviceCache
+		 * \tparam DEVICE Device type
+		 * \param deviceID ID of device to find
+		 * \return Returns pointer to cached device, nullptr if no reusable device was found
+		 */
+		template<DEVICE_C DEVICE>
+		typename DEVICE::shared_ptr getReusableCachedDevice(const DeviceIdentifier &deviceID)
+		{
+			const auto devIt = std::lower_bound(this->_deviceCache.begin(), this->_deviceCache.end(), deviceID.Name, CompareDevInt());
+			if(devIt == this->_deviceCache.end() || devIt->use_count() > 1 ||
+			        (*devIt)->name() != deviceID.Name || (*devIt)->type() != deviceID.Type)
+				return nullptr;
+
+			// Devices in _deviceCache were created by this engine, so it may modify them
+			return std::const_pointer_cast<DEVICE>(std::dynamic_pointer_cast<const DEVICE>(*devIt));
+		}
 };
 
 using EngineInterfaceSharedPtr = EngineInterface::shared_ptr;
@@ -313,6 +410,10 @@ client running inside the NRPSimulation. As such, all Engines must at least supp
 - HandleInputDevices: A function to handle incoming Device data
 - Shutdown: A function that gracefully stops the Engine
 
+Optionally, engines can support SaveSnapshot and RestoreSnapshot, which store the current engine state and later return to it. This allows
+an experiment to be reset without relaunching the engine processes. The JSON and GRPC protocols only take snapshots of engines whose configuration sets
+EngineSnapshots, as not every engine server implements them.
+
 The \ref index "Main Page" has a list of currently supported Engines.
 
 Creating new engines is a process that requires multiple components to work together. Should you be interested in implementing your own engine, a good starting point is
@@ -22,13 +22,16 @@
 
 #include "nrp_general_library/process_launchers/launch_commands/basic_fork.h"
 
+#include "nrp_general_library/utils/cpu_affinity.h"
 #include "nrp_general_library/utils/nrp_exceptions.h"
 
 #include <chrono>
 #include <exception>
 #include <iostream>
+#include <poll.h>
 #include <signal.h>
 #include <sys/prctl.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
@@ -51,24 +54,7 @@ pid_t BasicFork::launchEngineProcess(const EngineConfigGeneral &engineConfig, co
 	{
 		// Child process, setup environment, start Engine
 
-		// Setup signal that closes process if parent process quits
-		if(const auto prSig = prctl(PR_SET_PDEATHSIG, SIGHUP) < 0)
-		{
-			// Force quit if signal can't be created (Don't use the logger here, as this is a separate process)
-			std::cerr << "Couldn't create parent kill signal. Error Code: " << prSig << "\nExiting...\n";
-			std::cerr.flush();
-			exit(prSig);
-		}
-
-		// Force quit if parent pid has changed before PR_SET_PDEATHSIG signal could be setup, preventing race condition
-		if(getppid() != ppid)
-		{
-			// Don't use the logger here, as this is a separate process
-			std::cerr << "Parent process stopped unexpectedly.\nExiting...\n";
-			std::cerr.flush();
-			exit(-1);
-		}
-
+		BasicFork::setupChildProcess(engineConfig, ppid);
 
 		// Setup environment variables in a char* vector. See definition of execvpe() for details
 
@@ -120,8 +106,9 @@ pid_t BasicFork::launchEngineProcess(const EngineConfigGeneral &engineConfig, co
 		std::cerr << "Couldn't start Engine with cmd \"" << engineConfig.engineProcCmd().data() << "\"\n Error code: " << res << std::endl;
 		std::cerr.flush();
 
-		// If the exec call fails, exit the child process without any further processing. Prevents the child process from assuming it's the main proc
-		exit(res);
+		// If the exec call fails, exit the child process without any further processing. Prevents the child process from assuming it's the main proc.
+		// _exit skips atexit handlers and static destructors, which belong to the parent process
+		_exit(res);
 
 		return -1;		// Not executed, only here to prevent compiler warning
 	}
@@ -140,54 +127,128 @@ pid_t BasicFork::launchEngineProcess(const EngineConfigGeneral &engineConfig, co
 
 pid_t BasicFork::stopEngineProcess(unsigned int killWait)
 {
-	if(this->_enginePID > 0)
+	BasicFork::stopChildProcess(this->_enginePID, killWait);
+	return 0;
+}
+
+LaunchCommandInterface::ENGINE_RUNNING_STATUS BasicFork::getProcessStatus()
+{
+	return BasicFork::childProcessStatus(this->_enginePID);
+}
+
+void BasicFork::setupChildProcess(const EngineConfigGeneral &engineConfig, pid_t ppid)
+{
+	// Setup signal that closes process if parent process quits
+	if(const auto prSig = prctl(PR_SET_PDEATHSIG, SIGHUP) < 0)
+	{
+		// Force quit if signal can't be created (Don't use the logger here, as this is a separate process)
+		std::cerr << "Couldn't create parent kill signal. Error Code: " << prSig << "\nExiting...\n";
+		std::cerr.flush();
+		_exit(prSig);
+	}
+
+	// Force quit if parent pid has changed before PR_SET_PDEATHSIG signal could be setup, preventing race condition
+	if(getppid() != ppid)
+	{
+		// Don't use the logger here, as this is a separate process
+		std::cerr << "Parent process stopped unexpectedly.\nExiting...\n";
+		std::cerr.flush();
+		_exit(-1);
+	}
+
+	// Pin engine to configured CPUs/NUMA node before exec, so that the engine allocates its memory on the correct node.
+	// The forking thread may itself be pinned (e.g. the simulation loop), so first reset to the initial placement.
+	// A failed placement is not fatal, the engine simply runs with the inherited affinity
+	try
+	{
+		CPUAffinity::restoreInitialPlacement();
+		CPUAffinity::applyPlacement(engineConfig.engineCPUAffinity(), engineConfig.engineNUMANode());
+	}
+	catch(std::exception &e)
 	{
-		// Send SIGTERM to gracefully stop Nest process
-		kill(this->_enginePID, SIGTERM);
+		// Don't use the logger here, as this is a separate process
+		std::cerr << "Couldn't apply CPU placement for engine \"" << engineConfig.engineName() << "\": " << e.what() << "\nContinuing with inherited affinity\n";
+		std::cerr.flush();
+	}
+}
 
-		// Set to maximum wait time if time is set to 0
-		if(killWait == 0)
-			killWait = std::numeric_limits<unsigned int>::max();
+void BasicFork::stopChildProcess(pid_t &pid, unsigned int killWait)
+{
+	if(pid > 0)
+	{
+		// Open pidfd before sending any signal, so that the process can't be reaped and its PID reused in between
+		const int pidFD = BasicFork::openPidFD(pid);
 
-		// Check Nest status. After _killWait seconds, send SIGKILL to force a shutdown
-		const auto end = std::chrono::system_clock::now() + std::chrono::duration<size_t>(killWait);
+		// Send SIGTERM to gracefully stop engine process
+		kill(pid, SIGTERM);
 
-		bool pKilled = false;
-		do
+		// After killWait seconds, send SIGKILL to force a shutdown. A killWait of 0 waits indefinitely
+		if(!BasicFork::waitForChildExit(pid, pidFD, killWait > 0 ? static_cast<int>(std::min<unsigned int>(killWait, std::numeric_limits<int>::max()/1000))*1000 : -1))
 		{
-			// Check if engine process has stopped
-			if(this->getProcessStatus() == ENGINE_RUNNING_STATUS::STOPPED)
-			{
-				pKilled = true;
-				break;
-			}
-
-			// Sleep for 10ms between checks
-			usleep(10*1000);
+			kill(pid, SIGKILL);
+
+			// Reap the killed process, unless it is stuck in an uninterruptible state
+			BasicFork::waitForChildExit(pid, pidFD, 1000);
 		}
-		while(std::chrono::system_clock::now() < end);
 
-		// Force shutdown
-		if(!pKilled)
-			kill(this->_enginePID, SIGKILL);
+		if(pidFD >= 0)
+			close(pidFD);
 
-		this->_enginePID = -1;
+		pid = -1;
 	}
+}
 
-	return 0;
+int BasicFork::openPidFD(pid_t pid)
+{
+#ifdef SYS_pidfd_open
+	return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+#else
+	(void)pid;
+	return -1;
+#endif
 }
 
-LaunchCommandInterface::ENGINE_RUNNING_STATUS BasicFork::getProcessStatus()
+bool BasicFork::waitForChildExit(pid_t &pid, int pidFD, int timeoutMs)
+{
+	const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+	const auto remainingMs = [&]() {
+		return timeoutMs < 0 ? -1 : static_cast<int>(std::max<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(end - std::chrono::steady_clock::now()).count(), 0));
+	};
+
+	if(pidFD >= 0)
+	{
+		// pidfd becomes readable the moment the process exits
+		pollfd pidPoll = {pidFD, POLLIN, 0};
+		while(poll(&pidPoll, 1, remainingMs()) < 0 && errno == EINTR)
+		{}
+
+		return BasicFork::childProcessStatus(pid) == ENGINE_RUNNING_STATUS::STOPPED;
+	}
+
+	// Kernel without pidfd support, check process status every 10ms
+	do
+	{
+		if(BasicFork::childProcessStatus(pid) == ENGINE_RUNNING_STATUS::STOPPED)
+			return true;
+
+		usleep(10*1000);
+	}
+	while(timeoutMs < 0 || std::chrono::steady_clock::now() < end);
+
+	return BasicFork::childProcessStatus(pid) == ENGINE_RUNNING_STATUS::STOPPED;
+}
+
+LaunchCommandInterface::ENGINE_RUNNING_STATUS BasicFork::childProcessStatus(pid_t &pid)
 {
 	// Check if engine was already stopped before
-	if(this->_enginePID < 0)
+	if(pid < 0)
 		return ENGINE_RUNNING_STATUS::RUNNING;
 
 	// Check if this process received a stop notification for this child PID
 	int engineStatus;
-	if(waitpid(this->_enginePID, &engineStatus, WNOHANG | WUNTRACED) == this->_enginePID)
+	if(waitpid(pid, &engineStatus, WNOHANG | WUNTRACED) == pid)
 	{
-		this->_enginePID = -1;
+		pid = -1;
 		return ENGINE_RUNNING_STATUS::STOPPED;
 	}
 	else
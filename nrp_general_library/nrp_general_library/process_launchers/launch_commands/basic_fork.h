@@ -29,12 +29,12 @@
 class BasicFork
         : public LaunchCommand<EngineConfigConst::DefEngineLaunchCmd>
 {
+    public:
 		/*!
 		 *	\brief Command to set environment variables. More versatile than the C function setenv
 		 */
 		static constexpr std::string_view EnvCfgCmd = NRP_ENGINE_SET_ENV_CMD;
 
-    public:
 		~BasicFork() override;
 
 		pid_t launchEngineProcess(const EngineConfigGeneral &engineConfig, const EngineConfigConst::string_vector_t &additionalEnvParams,
@@ -44,6 +44,42 @@ class BasicFork
 
 		ENGINE_RUNNING_STATUS getProcessStatus() override;
 
+		/*!
+		 * \brief Prepare a freshly forked child process. Sets up the parent death signal and applies the engine's CPU placement.
+		 * Exits the child on failure
+		 * \param engineConfig Engine Configuration
+		 * \param ppid PID of parent process
+		 */
+		static void setupChildProcess(const EngineConfigGeneral &engineConfig, pid_t ppid);
+
+		/*!
+		 * \brief Stop a forked child process. Sends SIGTERM, then SIGKILL after killWait seconds
+		 * \param pid PID of process. Will be set to -1 once the process has been stopped
+		 * \param killWait Time (in seconds) to wait for process to quit by itself before force killing it. 0 means it will wait indefinetly
+		 */
+		static void stopChildProcess(pid_t &pid, unsigned int killWait);
+
+		/*!
+		 * \brief Open a pidfd for the given process
+		 * \return Returns file descriptor, or a negative value if pidfds are not supported
+		 */
+		static int openPidFD(pid_t pid);
+
+		/*!
+		 * \brief Wait for a forked child process to exit and reap it. Uses the pidfd if available, polls the process status otherwise
+		 * \param pid PID of process. Will be set to -1 once the process has been reaped
+		 * \param pidFD pidfd of process, or a negative value
+		 * \param timeoutMs Time (in milliseconds) to wait. A negative value waits indefinitely
+		 * \return Returns true if the process exited
+		 */
+		static bool waitForChildExit(pid_t &pid, int pidFD, int timeoutMs);
+
+		/*!
+		 * \brief Get status of a forked child process
+		 * \param pid PID of process. Will be set to -1 once the process has been reaped
+		 */
+		static ENGINE_RUNNING_STATUS childProcessStatus(pid_t &pid);
+
 	private:
 		/*!
 		 * \brief PID of child process running the engine
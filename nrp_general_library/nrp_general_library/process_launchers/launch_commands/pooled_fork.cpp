@@ -0,0 +1,377 @@
+//
+// NRP Core - Backend infrastructure to synchronize simulations
+//
+// Copyright 2020 Michael Zechmair
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This project has received funding from the European Union’s Horizon 2020
+// Framework Programme for Research and Innovation under the Specific Grant
+// Agreement No. 945539 (Human Brain Project SGA3).
+//
+
+#include "nrp_general_library/process_launchers/launch_commands/pooled_fork.h"
+
+#include "nrp_general_library/process_launchers/launch_commands/basic_fork.h"
+#include "nrp_general_library/utils/nrp_exceptions.h"
+
+#include <fcntl.h>
+#include <iostream>
+#include <signal.h>
+#include <sstream>
+#include <unistd.h>
+
+/*!
+ * \brief Maximum size of a single start parameter a warm process accepts
+ */
+static constexpr uint32_t MaxLaunchParamSize = 1 << 20;
+
+static bool writeAll(int fd, const void *data, size_t size)
+{
+	const char *pData = static_cast<const char*>(data);
+	while(size > 0)
+	{
+		const auto written = write(fd, pData, size);
+		if(written < 0)
+		{
+			if(errno == EINTR)
+				continue;
+
+			return false;
+		}
+
+		pData += written;
+		size -= static_cast<size_t>(written);
+	}
+
+	return true;
+}
+
+static bool readAll(int fd, void *data, size_t size)
+{
+	char *pData = static_cast<char*>(data);
+	while(size > 0)
+	{
+		const auto numRead = read(fd, pData, size);
+		if(numRead < 0 && errno == EINTR)
+			continue;
+		else if(numRead <= 0)
+			return false;
+
+		pData += numRead;
+		size -= static_cast<size_t>(numRead);
+	}
+
+	return true;
+}
+
+PooledFork::ProcessPool PooledFork::_pool;
+
+PooledFork::ProcessPool::~ProcessPool()
+{
+	this->clear();
+}
+
+void PooledFork::ProcessPool::clear()
+{
+	std::lock_guard poolLock(this->Lock);
+	for(auto &processes : this->Processes)
+	{
+		for(auto &process : processes.second)
+			PooledFork::discardWarmProcess(process);
+	}
+
+	this->Processes.clear();
+}
+
+PooledFork::~PooledFork()
+{
+	// Stop engine process if it's still running
+	this->stopEngineProcess(60);
+}
+
+pid_t PooledFork::launchEngineProcess(const EngineConfigGeneral &engineConfig, const EngineConfigConst::string_vector_t &additionalEnvParams,
+                                      const EngineConfigConst::string_vector_t &additionalStartParams, bool appendParentEnv)
+{
+	const auto envParams = PooledFork::engineEnvParams(engineConfig, additionalEnvParams);
+
+	// Same parameter order as BasicFork
+	EngineConfigConst::string_vector_t startParams = engineConfig.allEngineProcStartParams();
+	startParams.insert(startParams.end(), additionalStartParams.begin(), additionalStartParams.end());
+
+	const auto key = PooledFork::poolKey(engineConfig, envParams, appendParentEnv);
+
+	// Use a warm process if one is available. Fall back to starting a new one if none exists or it can't receive its parameters
+	auto process = PooledFork::takeWarmProcess(key);
+	if(process.PID < 0 || !PooledFork::sendLaunchParams(process, startParams))
+	{
+		PooledFork::discardWarmProcess(process);
+
+		process = PooledFork::startWarmProcess(engineConfig, envParams, appendParentEnv);
+		if(!PooledFork::sendLaunchParams(process, startParams))
+		{
+			PooledFork::discardWarmProcess(process);
+			throw NRPException::logCreate("Failed to send start parameters to engine \"" + engineConfig.engineName() + "\"");
+		}
+	}
+
+	close(process.LaunchFD);
+	this->_enginePID = process.PID;
+
+	return this->_enginePID;
+}
+
+pid_t PooledFork::stopEngineProcess(unsigned int killWait)
+{
+	BasicFork::stopChildProcess(this->_enginePID, killWait);
+	return 0;
+}
+
+LaunchCommandInterface::ENGINE_RUNNING_STATUS PooledFork::getProcessStatus()
+{
+	return BasicFork::childProcessStatus(this->_enginePID);
+}
+
+pid_t PooledFork::prestartProcess(const EngineConfigGeneral &engineConfig, const EngineConfigConst::string_vector_t &additionalEnvParams, bool appendParentEnv)
+{
+	const auto envParams = PooledFork::engineEnvParams(engineConfig, additionalEnvParams);
+	const auto process = PooledFork::startWarmProcess(engineConfig, envParams, appendParentEnv);
+
+	std::lock_guard poolLock(PooledFork::_pool.Lock);
+	PooledFork::_pool.Processes[PooledFork::poolKey(engineConfig, envParams, appendParentEnv)].push_back(process);
+
+	return process.PID;
+}
+
+size_t PooledFork::numWarmProcesses()
+{
+	std::lock_guard poolLock(PooledFork::_pool.Lock);
+
+	size_t numProcesses = 0;
+	for(const auto &processes : PooledFork::_pool.Processes)
+		numProcesses += processes.second.size();
+
+	return numProcesses;
+}
+
+void PooledFork::clearPool()
+{
+	PooledFork::_pool.clear();
+}
+
+std::vector<std::string> PooledFork::waitForLaunchParams(int argc, char *argv[], const std::function<void()> &warmUp)
+{
+	std::vector<std::string> params(argv, argv + argc);
+
+	// Regular launch, nothing to wait for
+	const char *const pLaunchFD = getenv(PooledFork::LaunchFDEnvVar.data());
+	if(pLaunchFD == nullptr)
+		return params;
+
+	const int launchFD = atoi(pLaunchFD);
+
+	// Don't pass the descriptor on to processes started by the engine
+	unsetenv(PooledFork::LaunchFDEnvVar.data());
+
+	if(warmUp)
+		warmUp();
+
+	// Block until the start parameters arrive. EOF means the pool was cleared before this process was used
+	uint32_t numParams = 0;
+	if(!readAll(launchFD, &numParams, sizeof(numParams)))
+		exit(0);
+
+	params.resize(std::min<size_t>(params.size(), 1));
+	for(uint32_t i = 0; i < numParams; ++i)
+	{
+		uint32_t paramSize = 0;
+		if(!readAll(launchFD, &paramSize, sizeof(paramSize)) || paramSize > MaxLaunchParamSize)
+			exit(-1);
+
+		std::string param(paramSize, '\0');
+		if(!readAll(launchFD, param.data(), paramSize))
+			exit(-1);
+
+		params.push_back(std::move(param));
+	}
+
+	close(launchFD);
+
+	return params;
+}
+
+std::vector<std::string> PooledFork::preloadModules()
+{
+	std::vector<std::string> modules;
+
+	const char *const pModules = getenv(PooledFork::PreloadModulesEnvVar.data());
+	if(pModules == nullptr)
+		return modules;
+
+	std::stringstream moduleStream(pModules);
+	std::string module;
+	while(std::getline(moduleStream, module, ','))
+	{
+		const auto start = module.find_first_not_of(" \t");
+		if(start == std::string::npos)
+			continue;
+
+		modules.push_back(module.substr(start, module.find_last_not_of(" \t") - start + 1));
+	}
+
+	return modules;
+}
+
+EngineConfigConst::string_vector_t PooledFork::engineEnvParams(const EngineConfigGeneral &engineConfig, const EngineConfigConst::string_vector_t &additionalEnvParams)
+{
+	EngineConfigConst::string_vector_t envParams(additionalEnvParams);
+	for(auto &envParam : engineConfig.allEngineProcEnvParams())
+		envParams.push_back(std::move(envParam));
+
+	return envParams;
+}
+
+std::string PooledFork::poolKey(const EngineConfigGeneral &engineConfig, const EngineConfigConst::string_vector_t &envParams, bool appendParentEnv)
+{
+	std::string key = engineConfig.engineProcCmd() + '\n' + (appendParentEnv ? "1" : "0") + '\n' + std::to_string(engineConfig.engineNUMANode()) + '\n';
+
+	for(const auto cpu : engineConfig.engineCPUAffinity())
+		key += std::to_string(cpu) + ',';
+
+	for(const auto &envParam : envParams)
+		key += '\n' + envParam;
+
+	return key;
+}
+
+PooledFork::WarmProcess PooledFork::takeWarmProcess(const std::string &key)
+{
+	std::lock_guard poolLock(PooledFork::_pool.Lock);
+
+	auto processesIt = PooledFork::_pool.Processes.find(key);
+	if(processesIt == PooledFork::_pool.Processes.end())
+		return WarmProcess();
+
+	auto &processes = processesIt->second;
+	while(!processes.empty())
+	{
+		auto process = processes.front();
+		processes.pop_front();
+
+		// Skip processes that quit while waiting
+		if(BasicFork::childProcessStatus(process.PID) == ENGINE_RUNNING_STATUS::RUNNING)
+			return process;
+
+		PooledFork::discardWarmProcess(process);
+	}
+
+	return WarmProcess();
+}
+
+PooledFork::WarmProcess PooledFork::startWarmProcess(const EngineConfigGeneral &engineConfig, const EngineConfigConst::string_vector_t &envParams, bool appendParentEnv)
+{
+	// Close both ends on exec, so that no other child keeps the pipe open. The read end is re-enabled in the warm process
+	int launchPipe[2];
+	if(pipe2(launchPipe, O_CLOEXEC) < 0)
+		throw NRPException::logCreate("Failed to create launch pipe for engine \"" + engineConfig.engineName() + "\"");
+
+	const auto ppid = getpid();
+
+	const auto pid = fork();
+	if(pid == 0)
+	{
+		// Child process, setup environment, start Engine without start parameters
+		BasicFork::setupChildProcess(engineConfig, ppid);
+
+		fcntl(launchPipe[0], F_SETFD, 0);
+
+		if(!appendParentEnv)
+			clearenv();
+
+		const std::string launchFDEnv = std::string(PooledFork::LaunchFDEnvVar) + "=" + std::to_string(launchPipe[0]);
+
+		std::vector<const char*> startParamPtrs;
+		startParamPtrs.reserve(envParams.size() + 4);
+
+		startParamPtrs.push_back(BasicFork::EnvCfgCmd.data());
+
+		for(const auto &curParam : envParams)
+			startParamPtrs.push_back(curParam.data());
+
+		startParamPtrs.push_back(launchFDEnv.data());
+		startParamPtrs.push_back(engineConfig.engineProcCmd().data());
+		startParamPtrs.push_back(nullptr);
+
+		auto res = execvp(BasicFork::EnvCfgCmd.data(), const_cast<char *const *>(startParamPtrs.data()));
+
+		// Don't use the logger here, as this is a separate process
+		std::cerr << "Couldn't start Engine with cmd \"" << engineConfig.engineProcCmd().data() << "\"\n Error code: " << res << std::endl;
+		std::cerr.flush();
+
+		_exit(res);
+	}
+	else if(pid > 0)
+	{
+		close(launchPipe[0]);
+		return WarmProcess({pid, launchPipe[1]});
+	}
+	else
+	{
+		close(launchPipe[0]);
+		close(launchPipe[1]);
+
+		throw NRPException::logCreate("Forking engine child process failed");
+	}
+}
+
+bool PooledFork::sendLaunchParams(const WarmProcess &process, const EngineConfigConst::string_vector_t &startParams)
+{
+	if(process.LaunchFD < 0)
+		return false;
+
+	// A warm process that quit would raise SIGPIPE. Block it for this thread and consume it if it occurs
+	sigset_t pipeSignal, prevSignals;
+	sigemptyset(&pipeSignal);
+	sigaddset(&pipeSignal, SIGPIPE);
+	pthread_sigmask(SIG_BLOCK, &pipeSignal, &prevSignals);
+
+	const uint32_t numParams = static_cast<uint32_t>(startParams.size());
+	bool res = writeAll(process.LaunchFD, &numParams, sizeof(numParams));
+	for(auto paramIt = startParams.begin(); res && paramIt != startParams.end(); ++paramIt)
+	{
+		const uint32_t paramSize = static_cast<uint32_t>(paramIt->size());
+		res = writeAll(process.LaunchFD, &paramSize, sizeof(paramSize)) &&
+		      writeAll(process.LaunchFD, paramIt->data(), paramSize);
+	}
+
+	if(!res && errno == EPIPE)
+	{
+		const timespec noWait = {0, 0};
+		sigtimedwait(&pipeSignal, nullptr, &noWait);
+	}
+
+	pthread_sigmask(SIG_SETMASK, &prevSignals, nullptr);
+
+	return res;
+}
+
+void PooledFork::discardWarmProcess(WarmProcess &process)
+{
+	if(process.LaunchFD >= 0)
+	{
+		close(process.LaunchFD);
+		process.LaunchFD = -1;
+	}
+
+	BasicFork::stopChildProcess(process.PID, 1);
+}
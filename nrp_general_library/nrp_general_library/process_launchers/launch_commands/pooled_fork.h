@@ -0,0 +1,162 @@
+/* * NRP Core - Backend infrastructure to synchronize simulations
+ *
+ * Copyright 2020 Michael Zechmair
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This project has received funding from the European Union’s Horizon 2020
+ * Framework Programme for Research and Innovation under the Specific Grant
+ * Agreement No. 945539 (Human Brain Project SGA3).
+ */
+
+#ifndef POOLED_FORK_H
+#define POOLED_FORK_H
+
+#include "nrp_general_library/config/engine_config.h"
+#include "nrp_general_library/process_launchers/launch_commands/launch_command.h"
+
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+
+/*!
+ * \brief Launch command that hands out pre-started engine processes.
+ *
+ * Warm processes are started with the engine's command and environment, but without start parameters. They perform any
+ * configuration independent initialization (e.g. python imports) and then block inside PooledFork::waitForLaunchParams()
+ * until a launch request sends them their start parameters. Processes that launch the same engine repeatedly add warm processes
+ * with prestartProcess() ahead of time. Launches without a matching warm process fork a new one.
+ * The pool is local to the launching process, warm processes are children of it.
+ * Only engines whose executable calls PooledFork::waitForLaunchParams() on startup can use this launch command
+ */
+class PooledFork
+        : public LaunchCommand<"PooledFork">
+{
+	public:
+		/*!
+		 * \brief Environment variable containing the file descriptor from which a warm process reads its start parameters
+		 */
+		static constexpr std::string_view LaunchFDEnvVar = "NRP_POOLED_LAUNCH_FD";
+
+		/*!
+		 * \brief Environment variable with a comma-separated list of modules engines should preload while waiting for a launch
+		 */
+		static constexpr std::string_view PreloadModulesEnvVar = "NRP_ENGINE_PRELOAD_MODULES";
+
+		~PooledFork() override;
+
+		pid_t launchEngineProcess(const EngineConfigGeneral &engineConfig, const EngineConfigConst::string_vector_t &additionalEnvParams,
+		                          const EngineConfigConst::string_vector_t &additionalStartParams, bool appendParentEnv = true) override;
+
+		pid_t stopEngineProcess(unsigned int killWait) override;
+
+		ENGINE_RUNNING_STATUS getProcessStatus() override;
+
+		/*!
+		 * \brief Start a warm process and add it to the pool. The next launch with the same configuration and environment uses it
+		 * \param engineConfig Engine configuration
+		 * \param additionalEnvParams Environment parameters the engine's launch will pass
+		 * \param appendParentEnv Should the parent env variables be appended to the engine's environment
+		 * \return Returns the PID of the warm process
+		 */
+		static pid_t prestartProcess(const EngineConfigGeneral &engineConfig, const EngineConfigConst::string_vector_t &additionalEnvParams, bool appendParentEnv = true);
+
+		/*!
+		 * \brief Get number of warm processes currently waiting in the pool
+		 */
+		static size_t numWarmProcesses();
+
+		/*!
+		 * \brief Stop all warm processes waiting in the pool
+		 */
+		static void clearPool();
+
+		/*!
+		 * \brief Called by engine executables on startup. If the process was started by a PooledFork, execute warmUp,
+		 * then block until the start parameters arrive. Otherwise, return the given parameters unchanged
+		 * \param argc Number of start parameters
+		 * \param argv Start parameters
+		 * \param warmUp Function to execute before blocking. Should only perform configuration independent initialization
+		 * \return Returns the start parameters with which the engine should continue, including the executable name
+		 */
+		static std::vector<std::string> waitForLaunchParams(int argc, char *argv[], const std::function<void()> &warmUp = nullptr);
+
+		/*!
+		 * \brief Get the modules listed in PreloadModulesEnvVar
+		 */
+		static std::vector<std::string> preloadModules();
+
+	private:
+		/*!
+		 * \brief Pre-started process waiting for its start parameters
+		 */
+		struct WarmProcess
+		{
+			pid_t PID = -1;
+			int LaunchFD = -1;
+		};
+
+		/*!
+		 * \brief Warm processes, sorted by launch configuration. Stops all remaining processes on destruction
+		 */
+		struct ProcessPool
+		{
+			~ProcessPool();
+
+			void clear();
+
+			std::mutex Lock;
+			std::map<std::string, std::list<WarmProcess> > Processes;
+		};
+
+		static ProcessPool _pool;
+
+		/*!
+		 * \brief PID of child process running the engine
+		 */
+		pid_t _enginePID = -1;
+
+		/*!
+		 * \brief Get the environment of an engine process. Same parameter order as BasicFork
+		 */
+		static EngineConfigConst::string_vector_t engineEnvParams(const EngineConfigGeneral &engineConfig, const EngineConfigConst::string_vector_t &additionalEnvParams);
+
+		/*!
+		 * \brief Get pool key. Processes can only be shared between launches with identical command, environment and CPU placement
+		 */
+		static std::string poolKey(const EngineConfigGeneral &engineConfig, const EngineConfigConst::string_vector_t &envParams, bool appendParentEnv);
+
+		/*!
+		 * \brief Take a running process from the pool. Returns a WarmProcess with a negative PID if none is available
+		 */
+		static WarmProcess takeWarmProcess(const std::string &key);
+
+		/*!
+		 * \brief Fork and exec a new warm process
+		 */
+		static WarmProcess startWarmProcess(const EngineConfigGeneral &engineConfig, const EngineConfigConst::string_vector_t &envParams, bool appendParentEnv);
+
+		/*!
+		 * \brief Send start parameters to a warm process
+		 * \return Returns false if the process could not receive them
+		 */
+		static bool sendLaunchParams(const WarmProcess &process, const EngineConfigConst::string_vector_t &startParams);
+
+		/*!
+		 * \brief Close launch pipe and stop a warm process
+		 */
+		static void discardWarmProcess(WarmProcess &process);
+};
+
+#endif // POOLED_FORK_H
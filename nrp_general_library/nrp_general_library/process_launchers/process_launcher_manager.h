@@ -24,6 +24,7 @@
 
 #include "nrp_general_library/process_launchers/process_launcher.h"
 #include "nrp_general_library/process_launchers/process_launcher_basic.h"
+#include "nrp_general_library/process_launchers/process_launcher_pool.h"
 #include "nrp_general_library/utils/nrp_exceptions.h"
 
 #include <iostream>
@@ -96,7 +97,7 @@ class ProcessLauncherManager
 /*!
  * \brief Type to manage all available process launchers
  */
-using MainProcessLauncherManager = ProcessLauncherManager<ProcessLauncherBasic>;
+using MainProcessLauncherManager = ProcessLauncherManager<ProcessLauncherBasic, ProcessLauncherPool>;
 
 using MainProcessLauncherManagerSharedPtr = MainProcessLauncherManager::shared_ptr;
 using MainProcessLauncherManagerConstSharedPtr = MainProcessLauncherManager::const_shared_ptr;
@@ -171,6 +172,17 @@ class NewLaunchCommand
 };
 \endcode
 
+\subsection Warm Process Pool
+
+Setting the ProcessLauncher parameter to "Pool" selects ProcessLauncherPool. Engines that set their EngineLaunchCommand to "PooledFork"
+are then handed an already started process if one with the same command, environment and CPU placement is waiting for its start parameters.
+Processes that launch the same engine repeatedly add such warm processes ahead of time with PooledFork::prestartProcess(). The pool belongs
+to the launching process. Engines that keep the default launch command are forked as usual.
+
+Engine executables opt into pooling by calling PooledFork::waitForLaunchParams() first thing in their main function. Any initialization
+passed to it as warmUp runs before the process blocks. The Python and NEST JSON engines use this to import the modules listed in the
+NRP_ENGINE_PRELOAD_MODULES environment variable. Set it via EngineEnvParams, e.g. "NRP_ENGINE_PRELOAD_MODULES=numpy,nest".
+
  */
 
 
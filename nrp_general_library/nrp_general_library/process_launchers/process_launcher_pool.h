@@ -0,0 +1,39 @@
+/* * NRP Core - Backend infrastructure to synchronize simulations
+ *
+ * Copyright 2020 Michael Zechmair
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This project has received funding from the European Union’s Horizon 2020
+ * Framework Programme for Research and Innovation under the Specific Grant
+ * Agreement No. 945539 (Human Brain Project SGA3).
+ */
+
+#ifndef PROCESS_LAUNCHER_POOL_H
+#define PROCESS_LAUNCHER_POOL_H
+
+#include "nrp_general_library/process_launchers/process_launcher.h"
+#include "nrp_general_library/process_launchers/launch_commands/basic_fork.h"
+#include "nrp_general_library/process_launchers/launch_commands/pooled_fork.h"
+
+/*!
+ * \brief Process Launcher that keeps warm engine processes for repeated launches.
+ * Engines that support it can select the pool by setting their EngineLaunchCommand to "PooledFork". All others are forked as usual
+ */
+class ProcessLauncherPool
+        : public ProcessLauncher<ProcessLauncherPool, "Pool", BasicFork, PooledFork>
+{
+	public:	~ProcessLauncherPool() override = default;
+};
+
+#endif // PROCESS_LAUNCHER_POOL_H
@@ -25,9 +25,10 @@
 #include "nrp_general_library/transceiver_function/transceiver_function_interpreter.h"
 #include "nrp_general_library/utils/nrp_exceptions.h"
 
-SingleTransceiverDevice::SingleTransceiverDevice(const std::string &keyword, const DeviceIdentifier &deviceID)
+SingleTransceiverDevice::SingleTransceiverDevice(const std::string &keyword, const DeviceIdentifier &deviceID, size_t historyCapacity)
     : _keyword(keyword),
-      _deviceID(deviceID)
+      _deviceID(deviceID),
+      _historyCapacity(historyCapacity)
 {}
 
 EngineInterface::device_identifiers_t SingleTransceiverDevice::getRequestedDeviceIDs() const
@@ -35,9 +36,38 @@ EngineInterface::device_identifiers_t SingleTransceiverDevice::getRequestedDevic
 	return EngineInterface::device_identifiers_t({this->_deviceID});
 }
 
+EngineInterface::device_history_capacities_t SingleTransceiverDevice::getRequestedDeviceHistories() const
+{
+	if(this->_historyCapacity == 0)
+		return EngineInterface::device_history_capacities_t();
+
+	return EngineInterface::device_history_capacities_t({{this->_deviceID, this->_historyCapacity}});
+}
+
 boost::python::object SingleTransceiverDevice::runTf(boost::python::tuple &args, boost::python::dict &kwargs)
 {
-	const auto engineDevs = TransceiverDeviceInterface::TFInterpreter->engineDevices();
+	if(this->_pyKeyword.is_none())
+		this->_pyKeyword = boost::python::str(this->_keyword);
+
+	if(this->_historyCapacity > 0)
+	{
+		const auto &engineHistories = TransceiverDeviceInterface::TFInterpreter->engineDeviceHistories();
+
+		auto engHistoriesIt = engineHistories.find(this->_deviceID.EngineName);
+		if(engHistoriesIt == engineHistories.end())
+			throw NRPException::logCreate("Couldn't find device history of engine \"" + this->_deviceID.EngineName + "\"");
+
+		auto historyIt = engHistoriesIt->second->find(this->_deviceID.Name);
+		if(historyIt == engHistoriesIt->second->end())
+			throw NRPException::logCreate("Couldn't find device history with ID name \"" + this->_deviceID.Name + "\"");
+
+		// Pass a reference to the history instead of converting it to a python copy. It is released after the TF has run
+		kwargs[this->_pyKeyword] = boost::python::ptr(&(historyIt->second));
+
+		return this->runTfAndReleaseDeviceArg(args, kwargs);
+	}
+
+	const auto &engineDevs = TransceiverDeviceInterface::TFInterpreter->engineDevices();
 
 	bool foundDevID = false;
 	auto engDevicesIt = engineDevs.find(this->_deviceID.EngineName);
@@ -47,7 +77,7 @@ boost::python::object SingleTransceiverDevice::runTf(boost::python::tuple &args,
 		{
 			if(curDevice->id().Name == this->_deviceID.Name)
 			{
-				kwargs[this->_keyword] = curDevice;
+				kwargs[this->_pyKeyword] = curDevice;
 
 				foundDevID = true;
 				break;
@@ -58,5 +88,28 @@ boost::python::object SingleTransceiverDevice::runTf(boost::python::tuple &args,
 	if(!foundDevID)
 		throw NRPException::logCreate("Couldn't find device with ID name \"" + this->_deviceID.Name + "\"");
 
-	return TransceiverDeviceInterface::runTf(args, kwargs);
+	return this->runTfAndReleaseDeviceArg(args, kwargs);
+}
+
+boost::python::object SingleTransceiverDevice::runTfAndReleaseDeviceArg(boost::python::tuple &args, boost::python::dict &kwargs)
+{
+	try
+	{
+		auto retVal = TransceiverDeviceInterface::runTf(args, kwargs);
+		this->releaseDeviceArg(kwargs);
+
+		return retVal;
+	}
+	catch(...)
+	{
+		this->releaseDeviceArg(kwargs);
+		throw;
+	}
+}
+
+void SingleTransceiverDevice::releaseDeviceArg(boost::python::dict &kwargs)
+{
+	// Keep the keyword in kwargs so that the keyword names used for the TF call remain unchanged
+	if(PyDict_SetItem(kwargs.ptr(), this->_pyKeyword.ptr(), Py_None) != 0)
+		PyErr_Clear();
 }
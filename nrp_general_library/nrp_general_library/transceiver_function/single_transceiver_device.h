@@ -28,17 +28,42 @@ class SingleTransceiverDevice
         : public TransceiverDeviceInterface
 {
 	public:
-		SingleTransceiverDevice(const std::string &keyword, const DeviceIdentifier &deviceID);
+		/*!
+		 * \brief Constructor
+		 * \param keyword Keyword under which the device is passed to the TF
+		 * \param deviceID ID of requested device
+		 * \param historyCapacity If larger than 0, the TF receives a DeviceHistory with the last historyCapacity versions of the device instead of only the newest one
+		 */
+		SingleTransceiverDevice(const std::string &keyword, const DeviceIdentifier &deviceID, size_t historyCapacity = 0);
 		virtual ~SingleTransceiverDevice() override = default;
 
 		EngineInterface::device_identifiers_t getRequestedDeviceIDs() const override;
 
+		EngineInterface::device_history_capacities_t getRequestedDeviceHistories() const override;
+
 		boost::python::object runTf(boost::python::tuple &args, boost::python::dict &kwargs) override;
 
 	private:
 
 		std::string _keyword;
 		DeviceIdentifier _deviceID;
+		size_t _historyCapacity;
+
+		/*!
+		 * \brief Python string of _keyword. Created on first execution and reused afterwards
+		 */
+		boost::python::object _pyKeyword;
+
+		/*!
+		 * \brief Execute the next decorator, then release the device argument
+		 */
+		boost::python::object runTfAndReleaseDeviceArg(boost::python::tuple &args, boost::python::dict &kwargs);
+
+		/*!
+		 * \brief Replace the device under _keyword in kwargs with None. Kwargs outlive a single execution,
+		 * a device still referenced there could not be updated in place by its engine
+		 */
+		void releaseDeviceArg(boost::python::dict &kwargs);
 };
 
 #endif // SINGLE_TRANSCEIVER_DEVICE_H
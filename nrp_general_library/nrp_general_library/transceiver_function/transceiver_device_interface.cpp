@@ -49,6 +49,23 @@ EngineInterface::device_identifiers_t TransceiverDeviceInterface::getRequestedDe
 	return EngineInterface::device_identifiers_t();
 }
 
+EngineInterface::device_history_capacities_t TransceiverDeviceInterface::updateRequestedDeviceHistories(EngineInterface::device_history_capacities_t &&capacities) const
+{
+	auto subCapacities = this->_function->updateRequestedDeviceHistories(std::move(capacities));
+	for(const auto &newCapacity : this->getRequestedDeviceHistories())
+	{
+		auto &curCapacity = subCapacities[newCapacity.first];
+		curCapacity = std::max(curCapacity, newCapacity.second);
+	}
+
+	return subCapacities;
+}
+
+EngineInterface::device_history_capacities_t TransceiverDeviceInterface::getRequestedDeviceHistories() const
+{
+	return EngineInterface::device_history_capacities_t();
+}
+
 void TransceiverDeviceInterface::setTFInterpreter(TransceiverFunctionInterpreter *interpreter)
 {
 	TransceiverDeviceInterface::TFInterpreter = interpreter;
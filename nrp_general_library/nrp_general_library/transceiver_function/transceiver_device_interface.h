@@ -95,6 +95,18 @@ class TransceiverDeviceInterface
 		 */
 		virtual EngineInterface::device_identifiers_t getRequestedDeviceIDs() const;
 
+		/*!
+		 *	\brief Appends its own device history requests onto capacities. Uses getRequestedDeviceHistories to check which histories are requested by this device
+		 *	\param capacities Container with history capacities that gets expanded. If a device is requested multiple times, the largest capacity is kept
+		 *	\return Returns capacities, with own requests appended
+		 */
+		virtual EngineInterface::device_history_capacities_t updateRequestedDeviceHistories(EngineInterface::device_history_capacities_t &&capacities = EngineInterface::device_history_capacities_t()) const;
+
+		/*!
+		 * \brief Returns history capacities of devices that should be stored by the engines
+		 */
+		virtual EngineInterface::device_history_capacities_t getRequestedDeviceHistories() const;
+
 		/*!
 		 * \brief Set global TF Interpreter. All Transceiver Functions will register themselves with it upon creation
 		 * \param interpreter Interpreter to use
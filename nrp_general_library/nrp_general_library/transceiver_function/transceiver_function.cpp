@@ -44,7 +44,36 @@ TransceiverDeviceInterface::shared_ptr TransceiverFunction::pySetup(boost::pytho
 
 boost::python::object TransceiverFunction::runTf(boost::python::tuple &args, boost::python::dict &kwargs)
 {
+#if PY_VERSION_HEX >= 0x03090000
+	const Py_ssize_t numArgs = PyTuple_GET_SIZE(args.ptr());
+	const Py_ssize_t numKwargs = PyDict_GET_SIZE(kwargs.ptr());
+
+	// Vectorcall expects positional arguments followed by keyword argument values
+	this->_callArgs.resize(1 + numArgs + numKwargs);
+	for(Py_ssize_t i = 0; i < numArgs; ++i)
+		this->_callArgs[1 + i] = PyTuple_GET_ITEM(args.ptr(), i);
+
+	bool kwNamesValid = !this->_kwNames.is_none() && PyTuple_GET_SIZE(this->_kwNames.ptr()) == numKwargs;
+
+	Py_ssize_t dictPos = 0, kwIndex = 0;
+	PyObject *key, *value;
+	while(PyDict_Next(kwargs.ptr(), &dictPos, &key, &value))
+	{
+		kwNamesValid = kwNamesValid && PyTuple_GET_ITEM(this->_kwNames.ptr(), kwIndex) == key;
+		this->_callArgs[1 + numArgs + kwIndex] = value;
+		++kwIndex;
+	}
+
+	if(!kwNamesValid)
+		this->_kwNames = boost::python::tuple(kwargs.keys());
+
+	PyObject *const retVal = PyObject_Vectorcall(this->_function.ptr(), this->_callArgs.data() + 1, static_cast<size_t>(numArgs) | PY_VECTORCALL_ARGUMENTS_OFFSET,
+	                                             numKwargs > 0 ? this->_kwNames.ptr() : nullptr);
+
+	return boost::python::object(boost::python::handle<>(retVal));
+#else
 	return this->_function(*args, **kwargs);
+#endif
 }
 
 EngineInterface::device_identifiers_t TransceiverFunction::getRequestedDeviceIDs() const
@@ -57,6 +86,11 @@ EngineInterface::device_identifiers_t TransceiverFunction::updateRequestedDevice
 	return std::move(deviceIDs);
 }
 
+EngineInterface::device_history_capacities_t TransceiverFunction::updateRequestedDeviceHistories(EngineInterface::device_history_capacities_t &&capacities) const
+{
+	return std::move(capacities);
+}
+
 TransceiverDeviceInterface::shared_ptr *TransceiverFunction::getTFInterpreterRegistry()
 {
 	return this->_tfInterpreterRegistryPtr;
@@ -29,6 +29,7 @@
 #include "nrp_general_library/engine_interfaces/engine_interface.h"
 
 #include <string>
+#include <vector>
 #include <boost/python.hpp>
 
 /*!
@@ -57,7 +58,7 @@ class TransceiverFunction
 		TransceiverDeviceInterface::shared_ptr pySetup(boost::python::object transceiverFunction);
 
 		/*!
-		 * \brief Execute the transfer function
+		 * \brief Execute the transfer function. Uses the vectorcall protocol where available, so no intermediate argument containers are created
 		 * \param args Python args
 		 * \param kwargs Python keywords
 		 * \return Returns result of TF
@@ -69,6 +70,8 @@ class TransceiverFunction
 
 		EngineInterface::device_identifiers_t updateRequestedDeviceIDs(EngineInterface::device_identifiers_t &&deviceIDs) const override;
 
+		EngineInterface::device_history_capacities_t updateRequestedDeviceHistories(EngineInterface::device_history_capacities_t &&capacities) const override;
+
 	private:
 		/*!
 		 * \brief Transfer function that should be executed
@@ -85,6 +88,16 @@ class TransceiverFunction
 		 */
 		TransceiverDeviceInterface::shared_ptr *_tfInterpreterRegistryPtr = nullptr;
 
+		/*!
+		 * \brief Keyword argument names of the last call. Reused as long as the keywords don't change
+		 */
+		boost::python::object _kwNames;
+
+		/*!
+		 * \brief Argument buffer for vectorcall. The first element is reserved for the callee
+		 */
+		std::vector<PyObject*> _callArgs;
+
 		/*!
 		 * \brief Gets pointer to location where this TF is stored
 		 * \return Returns _tfInterpreterRegistryPtr
@@ -157,8 +170,11 @@ arguments, a boost::python::tuple, and a boost::python dict, which correspond to
 manipulate these arguments as they please, the only requirement is that it must at one point call the runTf function of the proceeding decorator. This ensures that all
 decorators are executed, with the final one executing the actual TransceiverFunction.
 
-Currently, all TFs share the same PythonInterpreterState, meaning they share the same global and local python variable pool. Therefore, a function/variable defined in one
-TF is accessible in another. In the future, it might make sense to change this behavior.
+Each TF file is executed in its own namespace, which starts as a copy of the interpreter's global variables. Therefore, a function/variable defined in one
+TF is not accessible in another.
+
+The args tuple and kwargs dict are created once per TF by the TransceiverFunctionInterpreter and reused for every execution. Decorators overwrite their entries in place,
+and the TransceiverFunction passes them on to the python function via the vectorcall protocol.
  */
 
 #endif // TRANSCEIVER_FUNCTION_H
@@ -24,9 +24,16 @@
 
 #include "nrp_general_library/device_interface/device.h"
 #include "nrp_general_library/utils/nrp_exceptions.h"
+#include "nrp_general_library/utils/nrp_logger.h"
 #include "nrp_general_library/utils/python_error_handler.h"
 
+#include <fcntl.h>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 TransceiverFunctionInterpreter::TransceiverFunctionData::TransceiverFunctionData(const std::string &_name, const TransceiverDeviceInterface::shared_ptr &_transceiverFunction, const EngineInterface::device_identifiers_t &_deviceIDs, const boost::python::object &_localVariables)
     : Name(_name),
@@ -60,13 +67,11 @@ TransceiverFunctionInterpreter::TransceiverFunctionInterpreter(const boost::pyth
 
 TransceiverFunctionInterpreter::transceiver_function_datas_t::const_iterator TransceiverFunctionInterpreter::findTF(const std::string &name) const
 {
-	for(auto curTFIterator = this->_transceiverFunctions.begin(); curTFIterator != this->_transceiverFunctions.end(); ++curTFIterator)
-	{
-		if(curTFIterator->second.Name.compare(name) == 0)
-			return curTFIterator;
-	}
+	const auto tfIt = this->_tfNameIndex.find(name);
+	if(tfIt == this->_tfNameIndex.end())
+		return this->_transceiverFunctions.end();
 
-	return this->_transceiverFunctions.end();
+	return tfIt->second;
 }
 
 const TransceiverFunctionInterpreter::transceiver_function_datas_t &TransceiverFunctionInterpreter::loadedTFs() const
@@ -79,18 +84,31 @@ EngineInterface::device_identifiers_t TransceiverFunctionInterpreter::updateRequ
 	EngineInterface::device_identifiers_t devIDs;
 	for(const auto &curData : this->_transceiverFunctions)
 	{
-		auto newDevIDs = curData.second.TransceiverFunction->updateRequestedDeviceIDs();
-		devIDs.insert(newDevIDs.begin(), newDevIDs.end());
+		devIDs.insert(curData.second.DeviceIDs.begin(), curData.second.DeviceIDs.end());
 	}
 
 	return devIDs;
 }
 
+EngineInterface::device_history_capacities_t TransceiverFunctionInterpreter::updateRequestedDeviceHistories() const
+{
+	EngineInterface::device_history_capacities_t capacities;
+	for(const auto &curData : this->_transceiverFunctions)
+		capacities = curData.second.TransceiverFunction->updateRequestedDeviceHistories(std::move(capacities));
+
+	return capacities;
+}
+
 void TransceiverFunctionInterpreter::setEngineDevices(TransceiverFunctionInterpreter::engines_devices_t &&engineDevices)
 {
 	this->_engineDevices = std::move(engineDevices);
 }
 
+void TransceiverFunctionInterpreter::setEngineDeviceHistories(TransceiverFunctionInterpreter::engines_device_histories_t &&engineDeviceHistories)
+{
+	this->_engineDeviceHistories = std::move(engineDeviceHistories);
+}
+
 boost::python::object TransceiverFunctionInterpreter::runSingleTransceiverFunction(const std::string &tfName)
 {
 	// Find associated TF
@@ -107,11 +125,16 @@ boost::python::object TransceiverFunctionInterpreter::runSingleTransceiverFuncti
 {
 	try
 	{
-		boost::python::tuple args;
-		boost::python::dict kwargs;
+		boost::python::tuple args(tfData.Args);
+		boost::python::dict kwargs(tfData.Kwargs);
+
+		const auto startTime = std::chrono::steady_clock::now();
 
 		boost::python::object retVal = tfData.TransceiverFunction->runTf(args, kwargs);
 
+		if(tfData.ExecutionTime != nullptr)
+			tfData.ExecutionTime->observeDuration(std::chrono::steady_clock::now() - startTime);
+
 		// Make sure that tf returns a list. If not, return an empty list
 		if(!boost::python::extract<boost::python::list>(retVal).check())
 			return boost::python::list();
@@ -135,13 +158,14 @@ TransceiverFunctionInterpreter::transceiver_function_datas_t::iterator Transceiv
 	// Make sure no previously loaded TFs have not been handled
 	assert(this->_newTFIt == this->_transceiverFunctions.end());
 
-	// Create dict for new module
-	boost::python::dict localVars;
-
-	// Load TF code
+	// Load TF code. Each TF runs in its own namespace, so that names defined by one TF file can't clash with another
+	boost::python::dict tfNamespace;
 	try
 	{
-		boost::python::exec_file(transceiverFunction.fileName().data(), this->_globalDict, this->_globalDict);
+		const boost::python::object tfCode = this->compileTransceiverFunction(transceiverFunction.fileName());
+		tfNamespace = this->createTFNamespace(transceiverFunction.name(), transceiverFunction.fileName());
+
+		boost::python::handle<>(PyEval_EvalCode(tfCode.ptr(), tfNamespace.ptr(), tfNamespace.ptr()));
 	}
 	catch(boost::python::error_already_set &)
 	{
@@ -162,8 +186,11 @@ TransceiverFunctionInterpreter::transceiver_function_datas_t::iterator Transceiv
 
 	// Update transfer function params
 	this->_newTFIt->second.DeviceIDs      = this->_newTFIt->second.TransceiverFunction->updateRequestedDeviceIDs(EngineInterface::device_identifiers_t());
-	this->_newTFIt->second.LocalVariables = localVars;
+	this->_newTFIt->second.LocalVariables = tfNamespace;
 	this->_newTFIt->second.Name           = transceiverFunction.name();
+	this->_newTFIt->second.ExecutionTime  = TransceiverFunctionInterpreter::getExecutionTimeMetric(transceiverFunction.name());
+
+	this->_tfNameIndex[transceiverFunction.name()] = this->_newTFIt;
 
 	const auto retVal = this->_newTFIt;
 	this->_newTFIt = this->_transceiverFunctions.end();
@@ -173,26 +200,243 @@ TransceiverFunctionInterpreter::transceiver_function_datas_t::iterator Transceiv
 
 TransceiverFunctionInterpreter::transceiver_function_datas_t::iterator TransceiverFunctionInterpreter::loadTransceiverFunction(const std::string &tfName, const TransceiverDeviceInterfaceSharedPtr &transceiverFunction, boost::python::object &&localVars)
 {
-	return this->_transceiverFunctions.emplace(transceiverFunction->linkedEngineName(), TransceiverFunctionData(tfName, transceiverFunction, transceiverFunction->updateRequestedDeviceIDs(), std::move(localVars))).first;
+	auto newTFIt = this->_transceiverFunctions.emplace(transceiverFunction->linkedEngineName(), TransceiverFunctionData(tfName, transceiverFunction, transceiverFunction->updateRequestedDeviceIDs(), std::move(localVars)));
+	newTFIt->second.ExecutionTime = TransceiverFunctionInterpreter::getExecutionTimeMetric(tfName);
+	this->_tfNameIndex[tfName] = newTFIt;
+
+	return newTFIt;
 }
 
 TransceiverFunctionInterpreter::transceiver_function_datas_t::iterator TransceiverFunctionInterpreter::updateTransceiverFunction(const TransceiverFunctionConfig &transceiverFunction)
 {
 	// Erase existing TF if found
-	auto tfIterator = this->findTF(transceiverFunction.name());
-	if(tfIterator != this->_transceiverFunctions.end())
-		this->_transceiverFunctions.erase(tfIterator);
+	auto tfIterator = this->_tfNameIndex.find(transceiverFunction.name());
+	if(tfIterator != this->_tfNameIndex.end())
+	{
+		this->_transceiverFunctions.erase(tfIterator->second);
+		this->_tfNameIndex.erase(tfIterator);
+	}
 
 	// Create new one
 	return this->loadTransceiverFunction(transceiverFunction);
 }
 
+const std::filesystem::path &TransceiverFunctionInterpreter::bytecodeCacheDir() const
+{
+	return this->_bytecodeCacheDir;
+}
+
+void TransceiverFunctionInterpreter::setBytecodeCacheDir(const std::filesystem::path &cacheDir)
+{
+	this->_bytecodeCacheDir = cacheDir;
+	this->_bytecodeCacheDirChecked = false;
+}
+
+std::filesystem::path TransceiverFunctionInterpreter::defaultBytecodeCacheDir()
+{
+	// Per-user location. A shared directory such as /tmp would let other users plant bytecode
+	if(const char *cacheHome = getenv("XDG_CACHE_HOME"); cacheHome != nullptr && cacheHome[0] == '/')
+		return std::filesystem::path(cacheHome) / "nrp" / "tf_bytecode";
+
+	if(const char *home = getenv("HOME"); home != nullptr && home[0] == '/')
+		return std::filesystem::path(home) / ".cache" / "nrp" / "tf_bytecode";
+
+	return std::filesystem::path();
+}
+
+/*!
+ * \brief Check that a file was created by the current user and can't be modified by others. Cached bytecode is executed, so anything else must be ignored
+ * \param fileStat Result of fstat/lstat
+ */
+static bool isTrustedCacheEntry(const struct stat &fileStat)
+{
+	return fileStat.st_uid == geteuid() && (fileStat.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+
+/*!
+ * \brief Create the bytecode cache directory with mode 0700 if it doesn't exist yet, and check that it is trusted
+ * \param cacheDir Cache directory
+ * \return Returns true if the directory can be used
+ */
+static bool prepareBytecodeCacheDir(const std::filesystem::path &cacheDir)
+{
+	std::error_code ec;
+	std::filesystem::create_directories(cacheDir.parent_path(), ec);
+	if(mkdir(cacheDir.c_str(), S_IRWXU) != 0 && errno != EEXIST)
+		return false;
+
+	// Don't follow symlinks, another user could redirect them
+	struct stat dirStat;
+	if(lstat(cacheDir.c_str(), &dirStat) != 0 || !S_ISDIR(dirStat.st_mode) || !isTrustedCacheEntry(dirStat))
+	{
+		NRPLogger::SPDWarnLogDefault("Ignoring TF bytecode cache directory \"" + cacheDir.string() + "\", it must be a directory owned by the current user and not writable by others");
+		return false;
+	}
+
+	return true;
+}
+
+/*!
+ * \brief Read a cached bytecode file
+ * \param cacheFile File to read
+ * \param data Will be filled with file content
+ * \return Returns false if the file doesn't exist or isn't trusted
+ */
+static bool readBytecodeCacheFile(const std::filesystem::path &cacheFile, std::string &data)
+{
+	const int fd = open(cacheFile.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+	if(fd < 0)
+		return false;
+
+	// Check the opened file itself, so that it can't be replaced between checking and reading
+	struct stat fileStat;
+	bool res = fstat(fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode) && isTrustedCacheEntry(fileStat);
+	if(res)
+	{
+		data.resize(static_cast<size_t>(fileStat.st_size));
+		size_t readBytes = 0;
+		while(readBytes < data.size())
+		{
+			const auto n = read(fd, data.data() + readBytes, data.size() - readBytes);
+			if(n <= 0)
+			{
+				res = n < 0 && errno == EINTR;
+				if(!res)
+					break;
+
+				continue;
+			}
+
+			readBytes += static_cast<size_t>(n);
+		}
+	}
+	else
+		NRPLogger::SPDWarnLogDefault("Ignoring untrusted TF bytecode cache file \"" + cacheFile.string() + "\"");
+
+	close(fd);
+	return res;
+}
+
+/*!
+ * \brief Write a bytecode cache file. Writes to a temporary file first, so that concurrent processes never read a partial file
+ * \param cacheFile File to write
+ * \param data Data to write
+ * \param size Size of data
+ * \return Returns true on success
+ */
+static bool writeBytecodeCacheFile(const std::filesystem::path &cacheFile, const char *data, size_t size)
+{
+	std::filesystem::path tmpFile = cacheFile;
+	tmpFile += "." + std::to_string(getpid()) + ".tmp";
+
+	const int fd = open(tmpFile.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, S_IRUSR | S_IWUSR);
+	if(fd < 0)
+		return false;
+
+	size_t written = 0;
+	while(written < size)
+	{
+		const auto n = write(fd, data + written, size - written);
+		if(n < 0 && errno == EINTR)
+			continue;
+		else if(n <= 0)
+			break;
+
+		written += static_cast<size_t>(n);
+	}
+
+	const bool res = close(fd) == 0 && written == size && rename(tmpFile.c_str(), cacheFile.c_str()) == 0;
+	if(!res)
+		unlink(tmpFile.c_str());
+
+	return res;
+}
+
+boost::python::object TransceiverFunctionInterpreter::compileTransceiverFunction(const std::string &fileName)
+{
+	namespace python = boost::python;
+
+	std::ifstream tfFile(fileName, std::ios::binary);
+	if(!tfFile.good())
+		throw NRPException::logCreate("Could not open TransceiverFunction file \"" + fileName + "\"");
+
+	const std::string source((std::istreambuf_iterator<char>(tfFile)), std::istreambuf_iterator<char>());
+	const python::object pySource(python::handle<>(PyBytes_FromStringAndSize(source.data(), static_cast<Py_ssize_t>(source.size()))));
+
+	// Marshalled code is only valid for the running Python version, and it stores the file name for tracebacks.
+	// Both are part of the key
+	const python::object magicNumber = python::import("importlib.util").attr("MAGIC_NUMBER");
+	python::object hasher = python::import("hashlib").attr("sha256")(magicNumber);
+	hasher.attr("update")(python::str(fileName).attr("encode")("utf-8"));
+	hasher.attr("update")(pySource);
+	const std::string key = python::extract<std::string>(hasher.attr("hexdigest")());
+
+	auto codeIt = this->_codeCache.find(key);
+	if(codeIt != this->_codeCache.end())
+		return codeIt->second;
+
+	python::object marshal = python::import("marshal");
+	python::object code;
+
+	// Create and check the cache directory once, not for every TF
+	if(!this->_bytecodeCacheDirChecked)
+	{
+		this->_bytecodeCacheDirUsable = !this->_bytecodeCacheDir.empty() && prepareBytecodeCacheDir(this->_bytecodeCacheDir);
+		this->_bytecodeCacheDirChecked = true;
+	}
+
+	const std::filesystem::path cacheFile = this->_bytecodeCacheDirUsable ? this->_bytecodeCacheDir / (key + ".pyc") : std::filesystem::path();
+
+	// Try loading previously compiled code
+	if(std::string cached; !cacheFile.empty() && readBytecodeCacheFile(cacheFile, cached))
+	{
+		try
+		{
+			code = marshal.attr("loads")(python::object(python::handle<>(PyBytes_FromStringAndSize(cached.data(), static_cast<Py_ssize_t>(cached.size())))));
+		}
+		catch(python::error_already_set &)
+		{
+			NRPLogger::SPDWarnLogDefault("Discarding invalid TF bytecode cache file \"" + cacheFile.string() + "\": " + handle_pyerror());
+			code = python::object();
+		}
+	}
+
+	if(code.is_none())
+	{
+		code = python::import("builtins").attr("compile")(pySource, fileName, "exec", 0, true);
+
+		// Store compiled code
+		if(!cacheFile.empty())
+		{
+			const python::object data = marshal.attr("dumps")(code);
+			if(!writeBytecodeCacheFile(cacheFile, PyBytes_AS_STRING(data.ptr()), static_cast<size_t>(PyBytes_GET_SIZE(data.ptr()))))
+				NRPLogger::SPDWarnLogDefault("Failed to write TF bytecode cache file \"" + cacheFile.string() + "\": " + strerror(errno));
+		}
+	}
+
+	return this->_codeCache.emplace(key, code).first->second;
+}
+
+boost::python::dict TransceiverFunctionInterpreter::createTFNamespace(const std::string &tfName, const std::string &fileName) const
+{
+	boost::python::dict tfNamespace = boost::python::dict(this->_globalDict).copy();
+	tfNamespace["__name__"] = tfName;
+	tfNamespace["__file__"] = fileName;
+
+	return tfNamespace;
+}
+
+MetricHistogram *TransceiverFunctionInterpreter::getExecutionTimeMetric(const std::string &tfName)
+{
+	return &NRPMetrics::instance().histogram("nrp_tf_execution_duration_seconds", "Execution time of transceiver functions", {{"tf", tfName}});
+}
+
 TransceiverDeviceInterface::shared_ptr *TransceiverFunctionInterpreter::registerNewTF(const std::string &linkedEngine, const TransceiverDeviceInterface::shared_ptr &transceiverFunction)
 {
 	// Check that no previous TF has not been processed
 	assert(this->_newTFIt == this->_transceiverFunctions.end());
 
-	auto newTFIt = this->_transceiverFunctions.emplace(linkedEngine, TransceiverFunctionData("", transceiverFunction, {}, boost::python::dict())).first;
+	auto newTFIt = this->_transceiverFunctions.emplace(linkedEngine, TransceiverFunctionData("", transceiverFunction, {}, boost::python::dict()));
 	this->_newTFIt = newTFIt;
 
 	return &(newTFIt->second.TransceiverFunction);
@@ -26,11 +26,14 @@
 #include "nrp_general_library/device_interface/device.h"
 #include "nrp_general_library/engine_interfaces/engine_interface.h"
 #include "nrp_general_library/transceiver_function/transceiver_device_interface.h"
+#include "nrp_general_library/utils/nrp_metrics.h"
 
+#include <filesystem>
 #include <vector>
 #include <map>
 #include <memory>
 #include <list>
+#include <unordered_map>
 #include <boost/python.hpp>
 
 /*!
@@ -63,16 +66,32 @@ class TransceiverFunctionInterpreter
 			 */
 			boost::python::object LocalVariables;
 
+			/*!
+			 * \brief Positional arguments passed to the TF. Created once and reused for every execution
+			 */
+			boost::python::tuple Args;
+
+			/*!
+			 * \brief Keyword arguments passed to the TF. Created once, decorators update their entries in place on every execution and reset them to None afterwards
+			 */
+			boost::python::dict Kwargs;
+
+			/*!
+			 * \brief Execution time metric of this TF
+			 */
+			MetricHistogram *ExecutionTime = nullptr;
+
 			TransceiverFunctionData() = default;
 			TransceiverFunctionData(const std::string &_name, const TransceiverDeviceInterface::shared_ptr &_transceiverFunction, const EngineInterface::device_identifiers_t &_deviceIDs, const boost::python::object &_localVariables);
 		};
 
 		using local_dict_objects_t = std::map<std::string, boost::python::dict>;
-		using transceiver_function_datas_t = std::map<std::string, TransceiverFunctionData>;
+		using transceiver_function_datas_t = std::multimap<std::string, TransceiverFunctionData>;
 
 	public:
 		using device_list_t = boost::python::list;
 		using engines_devices_t = std::map<std::string, const EngineInterface::device_outputs_t*>;
+		using engines_device_histories_t = std::map<std::string, const EngineInterface::device_histories_t*>;
 
 		/*!
 		 * \brief Result of a single TF run
@@ -119,6 +138,11 @@ class TransceiverFunctionInterpreter
 		 */
 		EngineInterface::device_identifiers_t updateRequestedDeviceIDs() const;
 
+		/*!
+		 * \brief Get device history capacities requested by TFs
+		 */
+		EngineInterface::device_history_capacities_t updateRequestedDeviceHistories() const;
+
 		/*!
 		 * \brief Set EngineInterface pointers. Used by TransceiverFunctions to access devices
 		 * \param engines Mapping from engine name to engine ptr
@@ -131,6 +155,18 @@ class TransceiverFunctionInterpreter
 		constexpr const engines_devices_t &engineDevices() const
 		{	return this->_engineDevices;	}
 
+		/*!
+		 * \brief Set EngineInterface device history pointers. Used by TransceiverFunctions to access device histories
+		 * \param engineDeviceHistories Mapping from engine name to engine device histories
+		 */
+		void setEngineDeviceHistories(engines_device_histories_t &&engineDeviceHistories);
+
+		/*!
+		 * \brief Access engine device history map
+		 */
+		constexpr const engines_device_histories_t &engineDeviceHistories() const
+		{	return this->_engineDeviceHistories;	}
+
 		/*!
 		 * \brief Execute one transfer function.
 		 * \param tfName Name of function to execute
@@ -176,6 +212,22 @@ class TransceiverFunctionInterpreter
 		 */
 		transceiver_function_datas_t::iterator updateTransceiverFunction(const TransceiverFunctionConfig &transceiverFunction);
 
+		/*!
+		 * \brief Directory in which compiled TF bytecode is cached
+		 */
+		const std::filesystem::path &bytecodeCacheDir() const;
+
+		/*!
+		 * \brief Set directory in which compiled TF bytecode is cached. An empty path disables the on-disk cache.
+		 * The directory is created with mode 0700 when the next TF is loaded. Cached code is only loaded if the directory and file are owned by the current user and not writable by others
+		 */
+		void setBytecodeCacheDir(const std::filesystem::path &cacheDir);
+
+		/*!
+		 * \brief Default bytecode cache directory. Located in $XDG_CACHE_HOME, or ~/.cache if unset. Empty if neither can be determined
+		 */
+		static std::filesystem::path defaultBytecodeCacheDir();
+
 	protected:
 		/*!
 		 * \brief Registers a new transfer function. Used by TransceiverFunction to automatically register itself with the interpreter upon creation
@@ -191,21 +243,72 @@ class TransceiverFunctionInterpreter
 		 */
 		boost::python::dict _globalDict;
 
+		/*!
+		 * \brief Compiled TF code objects, mapped to the hash of their source
+		 */
+		std::map<std::string, boost::python::object> _codeCache;
+
+		/*!
+		 * \brief Directory in which compiled TF bytecode is cached
+		 */
+		std::filesystem::path _bytecodeCacheDir = TransceiverFunctionInterpreter::defaultBytecodeCacheDir();
+
+		/*!
+		 * \brief Has _bytecodeCacheDir been created and checked since it was last set
+		 */
+		bool _bytecodeCacheDirChecked = false;
+
+		/*!
+		 * \brief Result of the last check of _bytecodeCacheDir
+		 */
+		bool _bytecodeCacheDirUsable = false;
+
 		/*!
 		 * \brief All loaded transceiver functions, mapped to linked engines
 		 */
 		transceiver_function_datas_t _transceiverFunctions;
 
+		/*!
+		 * \brief Loaded transceiver functions, mapped by TF name
+		 */
+		std::unordered_map<std::string, transceiver_function_datas_t::iterator> _tfNameIndex;
+
 		/*!
 		 * \brief Engine Map. From engine name to devices
 		 */
 		engines_devices_t _engineDevices;
 
+		/*!
+		 * \brief Engine History Map. From engine name to device histories
+		 */
+		engines_device_histories_t _engineDeviceHistories;
+
 		/*!
 		 * \brief Pointer to newly created TransceiverFunction
 		 */
 		transceiver_function_datas_t::iterator _newTFIt = this->_transceiverFunctions.end();
 
+		/*!
+		 * \brief Get the compiled code object of a TF file. Code is compiled only once per source content and
+		 * reused from memory or from the bytecode cache directory afterwards
+		 * \param fileName TF file name
+		 * \return Returns Python code object
+		 */
+		boost::python::object compileTransceiverFunction(const std::string &fileName);
+
+		/*!
+		 * \brief Create a new module namespace for a TF. Starts as a copy of the global dictionary
+		 * \param tfName TF name
+		 * \param fileName TF file name
+		 */
+		boost::python::dict createTFNamespace(const std::string &tfName, const std::string &fileName) const;
+
+		/*!
+		 * \brief Get execution time metric of a TF
+		 * \param tfName TF name
+		 */
+		static MetricHistogram *getExecutionTimeMetric(const std::string &tfName);
+
 		// Give TransceiverFunction access to TransceiverFunctionInterpreter::registerNewTF()
 		friend class TransceiverFunction;
 };
@@ -25,6 +25,7 @@
 
 #include "nrp_general_library/utils/nrp_exceptions.h"
 
+#include <algorithm>
 #include <iostream>
 
 TransceiverFunctionManager::TransceiverFunctionSettings::TransceiverFunctionSettings(const TransceiverFunctionConfigSharedPtr &config)
@@ -36,26 +37,40 @@ bool TransceiverFunctionManager::TransceiverFunctionSettings::operator<(const Tr
 	return (*this)->name() < rhs->name();
 }
 
-EngineInterface::device_identifiers_t TransceiverFunctionManager::updateRequestedDeviceIDs() const
+const EngineInterface::device_identifiers_t &TransceiverFunctionManager::updateRequestedDeviceIDs() const
 {
-	return this->_tfInterpreter.updateRequestedDeviceIDs();
+	this->refreshRequestedDevices();
+	return this->_requestedDeviceIDs;
+}
+
+const EngineInterface::device_history_capacities_t &TransceiverFunctionManager::updateRequestedDeviceHistories() const
+{
+	this->refreshRequestedDevices();
+	return this->_requestedDeviceHistories;
 }
 
 void TransceiverFunctionManager::loadTF(const TransceiverFunctionConfigSharedPtr &tfConfig)
 {
-	auto storedConfigIterator = this->_tfSettings.find(tfConfig);
 	auto loadedTF = this->_tfInterpreter.findTF(tfConfig->name());
-	if(loadedTF != this->_tfInterpreter.loadedTFs().end() || storedConfigIterator != this->_tfSettings.end())
+	if(loadedTF != this->_tfInterpreter.loadedTFs().end() || this->_tfSettingsIndex.count(tfConfig->name()) > 0)
 		throw NRPException::logCreate("TF with name " + tfConfig->name() + "already loaded");
 
 	this->_tfSettings.insert(tfConfig);
+	this->_tfSettingsIndex.emplace(tfConfig->name(), tfConfig);
+	this->_requestedDevicesOutdated = true;
+
 	this->_tfInterpreter.loadTransceiverFunction(*tfConfig);
 }
 
 void TransceiverFunctionManager::updateTF(const TransceiverFunctionConfigSharedPtr &tfConfig)
 {
+	this->_requestedDevicesOutdated = true;
 	this->_tfInterpreter.updateTransceiverFunction(*tfConfig);
+
+	// Replace any previously stored configuration
+	this->_tfSettings.erase(tfConfig);
 	this->_tfSettings.insert(tfConfig);
+	this->_tfSettingsIndex[tfConfig->name()] = tfConfig;
 }
 
 TransceiverFunctionManager::tf_results_t TransceiverFunctionManager::executeActiveTFs()
@@ -104,15 +119,133 @@ TransceiverFunctionManager::tf_results_t TransceiverFunctionManager::executeActi
 	return tfResults;
 }
 
+TransceiverFunctionManager::tf_results_t TransceiverFunctionManager::executeActiveLinkedTFs(const std::string &engineName, SimulationTime simTime, const engine_times_t &engineUpdateTimes)
+{
+	tf_results_t tfResults;
+
+	const auto linkedTFRange = this->_tfInterpreter.getLinkedTFs(engineName);
+
+	for(auto curTFIt = linkedTFRange.first; curTFIt != linkedTFRange.second; ++curTFIt)
+	{
+		const auto &tfData = curTFIt->second;
+
+		const auto *const settings = this->findSettings(tfData.Name);
+		if(settings == nullptr || !settings->isActive())
+			continue;
+
+		// TFs without a period run whenever their linked engine completes a step
+		const auto period = toSimulationTime<float, std::ratio<1>>(settings->period());
+
+		auto execTimeIt = this->_tfExecutionTimes.find(tfData.Name);
+		if(period > SimulationTime::zero() && execTimeIt != this->_tfExecutionTimes.end())
+		{
+			const auto lastExecTime = execTimeIt->second;
+
+			// Skip TF if its period hasn't elapsed yet
+			if(simTime - lastExecTime < period)
+				continue;
+
+			// Skip TF if none of its input engines advanced since the last execution
+			if(!tfData.DeviceIDs.empty())
+			{
+				const auto inputAdvanced = std::any_of(tfData.DeviceIDs.begin(), tfData.DeviceIDs.end(), [&](const DeviceIdentifier &devID)
+				{
+					const auto updateTimeIt = engineUpdateTimes.find(devID.EngineName);
+					return updateTimeIt == engineUpdateTimes.end() || updateTimeIt->second > lastExecTime;
+				});
+
+				if(!inputAdvanced)
+					continue;
+			}
+		}
+
+		// Get device outputs from transceiver function
+		TransceiverFunctionInterpreter::device_list_t pyResult(this->_tfInterpreter.runSingleTransceiverFunction(tfData));
+		TransceiverFunctionInterpreter::TFExecutionResult result(std::move(pyResult));
+
+		// Extract pointers to retrieved devices
+		result.extractDevices();
+
+		tfResults.push_back(result);
+
+		this->_tfExecutionTimes[tfData.Name] = simTime;
+	}
+
+	return tfResults;
+}
+
+void TransceiverFunctionManager::resetExecutionTimes()
+{
+	this->_tfExecutionTimes.clear();
+}
+
+SimulationTime TransceiverFunctionManager::engineLookahead(const std::string &engineName) const
+{
+	this->refreshRequestedDevices();
+
+	const auto lookaheadIt = this->_engineLookaheads.find(engineName);
+	return lookaheadIt != this->_engineLookaheads.end() ? lookaheadIt->second : SimulationTime::zero();
+}
+
+const TransceiverFunctionConfig *TransceiverFunctionManager::findSettings(const std::string &tfName) const
+{
+	const auto settingIt = this->_tfSettingsIndex.find(tfName);
+	return settingIt != this->_tfSettingsIndex.end() ? settingIt->second.get() : nullptr;
+}
+
 bool TransceiverFunctionManager::isActive(const std::string &tfName)
 {
-	for(const auto &curSetting : this->_tfSettings)
+	const auto *const settings = this->findSettings(tfName);
+	return settings != nullptr && settings->isActive();
+}
+
+void TransceiverFunctionManager::setActive(const std::string &tfName, bool active)
+{
+	const auto settingIt = this->_tfSettingsIndex.find(tfName);
+	if(settingIt == this->_tfSettingsIndex.end())
+		throw NRPException::logCreate("TF with name " + tfName + " not loaded");
+
+	if(settingIt->second->isActive() != active)
 	{
-		if(curSetting->name() == tfName)
-			return curSetting->isActive();
+		settingIt->second->setIsActive(active);
+		this->_requestedDevicesOutdated = true;
+	}
+}
+
+void TransceiverFunctionManager::refreshRequestedDevices() const
+{
+	if(!this->_requestedDevicesOutdated)
+		return;
+
+	this->_requestedDeviceIDs.clear();
+	this->_requestedDeviceHistories.clear();
+	this->_engineLookaheads.clear();
+
+	const auto updateLookahead = [this](const std::string &engineName, SimulationTime period)
+	{
+		auto lookaheadIt = this->_engineLookaheads.emplace(engineName, period).first;
+		lookaheadIt->second = std::min(lookaheadIt->second, period);
+	};
+
+	for(const auto &curTF : this->_tfInterpreter.loadedTFs())
+	{
+		const auto &tfData = curTF.second;
+
+		const auto *const settings = this->findSettings(tfData.Name);
+		if(settings == nullptr || !settings->isActive())
+			continue;
+
+		this->_requestedDeviceIDs.insert(tfData.DeviceIDs.begin(), tfData.DeviceIDs.end());
+		this->_requestedDeviceHistories = tfData.TransceiverFunction->updateRequestedDeviceHistories(std::move(this->_requestedDeviceHistories));
+
+		// An engine is involved in a TF if the TF is linked to it or requests devices from it
+		const auto period = toSimulationTime<float, std::ratio<1>>(settings->period());
+		updateLookahead(curTF.first, period);
+		for(const auto &devID : tfData.DeviceIDs)
+			updateLookahead(devID.EngineName, period);
 	}
 
-	return false;
+	this->_requestedDevicesOutdated = false;
 }
 
 TransceiverFunctionInterpreter &TransceiverFunctionManager::getInterpreter()
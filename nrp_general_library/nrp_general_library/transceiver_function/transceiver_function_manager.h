@@ -27,8 +27,10 @@
 
 #include "nrp_general_library/utils/ptr_templates.h"
 
-#include <set>
 #include <list>
+#include <map>
+#include <set>
+#include <unordered_map>
 
 /*!
  * \brief Manages all available/active transfer functions
@@ -54,15 +56,24 @@ class TransceiverFunctionManager
 	public:
 		using tf_settings_t = std::set<TransceiverFunctionSettings>;
 		using tf_results_t = std::list<TransceiverFunctionInterpreter::TFExecutionResult>;
+		using engine_times_t = std::map<std::string, SimulationTime>;
 
 		TransceiverFunctionManager() = default;
 		TransceiverFunctionManager(boost::python::dict tfGlobals);
 
 		/*!
-		 * \brief Return list of devices that the TFs request
+		 * \brief Return list of devices that the active TFs request.
+		 * Only recomputed after TFs were loaded, updated or toggled
 		 * \return Returns container with all requested device IDs
 		 */
-		EngineInterface::device_identifiers_t updateRequestedDeviceIDs() const;
+		const EngineInterface::device_identifiers_t &updateRequestedDeviceIDs() const;
+
+		/*!
+		 * \brief Return history capacities of devices that the active TFs request.
+		 * Only recomputed after TFs were loaded, updated or toggled
+		 * \return Returns container with all requested device history capacities
+		 */
+		const EngineInterface::device_history_capacities_t &updateRequestedDeviceHistories() const;
 
 		/*!
 		 * \brief Load TF from given configuration
@@ -92,6 +103,30 @@ class TransceiverFunctionManager
 		 */
 		tf_results_t executeActiveLinkedTFs(const std::string &engineName);
 
+		/*!
+		 * \brief Execute all TFs linked to an engine that are due at simTime.
+		 * A TF with a positive period is skipped if its period has not yet elapsed since its last execution,
+		 * or if none of the engines it requests devices from has advanced since then. TFs with a period of zero are always executed
+		 * \param engineName Name of engine
+		 * \param simTime Current simulation time
+		 * \param engineUpdateTimes Last time each engine completed a step, mapped by engine name
+		 * \return Returns results of executed TFs
+		 */
+		tf_results_t executeActiveLinkedTFs(const std::string &engineName, SimulationTime simTime, const engine_times_t &engineUpdateTimes);
+
+		/*!
+		 * \brief Get the time an engine may run without interruption before a TF requires its devices.
+		 * Considers all active TFs linked to the engine or requesting devices from it
+		 * \param engineName Name of engine
+		 * \return Returns smallest period of the considered TFs. Returns zero if no TF is considered
+		 */
+		SimulationTime engineLookahead(const std::string &engineName) const;
+
+		/*!
+		 * \brief Forget when TFs were last executed. Used when the simulation time is reset
+		 */
+		void resetExecutionTimes();
+
 		/*!
 		 * \brief Is TF active
 		 * \param tfName Name of TF
@@ -100,6 +135,15 @@ class TransceiverFunctionManager
 		 */
 		bool isActive(const std::string &tfName);
 
+		/*!
+		 * \brief Activate or deactivate a TF. Use this instead of changing the TF configuration directly,
+		 * so that the requested devices are updated accordingly
+		 * \param tfName Name of TF
+		 * \param active Whether the TF should be active
+		 * \exception Throws an exception if no TF with the given name is stored
+		 */
+		void setActive(const std::string &tfName, bool active);
+
 		/*!
 		 * \brief Get TF Interpreter
 		 */
@@ -111,10 +155,52 @@ class TransceiverFunctionManager
 		 */
 		tf_settings_t _tfSettings;
 
+		/*!
+		 * \brief TF configurations, mapped by TF name
+		 */
+		std::unordered_map<std::string, TransceiverFunctionConfigSharedPtr> _tfSettingsIndex;
+
 		/*!
 		 * \brief Python Interpreter for TFs
 		 */
 		TransceiverFunctionInterpreter _tfInterpreter;
+
+		/*!
+		 * \brief Last execution time of each TF, mapped by TF name
+		 */
+		std::map<std::string, SimulationTime> _tfExecutionTimes;
+
+		/*!
+		 * \brief Whether the cached requested devices and engine lookaheads must be recomputed
+		 */
+		mutable bool _requestedDevicesOutdated = true;
+
+		/*!
+		 * \brief Devices requested by active TFs
+		 */
+		mutable EngineInterface::device_identifiers_t _requestedDeviceIDs;
+
+		/*!
+		 * \brief Device history capacities requested by active TFs
+		 */
+		mutable EngineInterface::device_history_capacities_t _requestedDeviceHistories;
+
+		/*!
+		 * \brief Smallest period of the active TFs involving an engine, mapped by engine name
+		 */
+		mutable std::map<std::string, SimulationTime> _engineLookaheads;
+
+		/*!
+		 * \brief Recompute requested devices and engine lookaheads if TFs changed since the last call
+		 */
+		void refreshRequestedDevices() const;
+
+		/*!
+		 * \brief Get settings of TF
+		 * \param tfName Name of TF
+		 * \return Returns pointer to TF settings, nullptr if no TF with the given name is stored
+		 */
+		const TransceiverFunctionConfig *findSettings(const std::string &tfName) const;
 };
 
 using TransceiverFunctionManagerSharedPtr = std::shared_ptr<TransceiverFunctionManager>;
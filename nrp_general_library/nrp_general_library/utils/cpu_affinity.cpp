@@ -0,0 +1,174 @@
+//
+// NRP Core - Backend infrastructure to synchronize simulations
+//
+// Copyright 2020 Michael Zechmair
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This project has received funding from the European Union’s Horizon 2020
+// Framework Programme for Research and Innovation under the Specific Grant
+// Agreement No. 945539 (Human Brain Project SGA3).
+
+#include "nrp_general_library/utils/cpu_affinity.h"
+
+#include <climits>
+#include <fstream>
+#include <sched.h>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/*!
+ * \brief Placement of the process at startup
+ */
+struct InitialPlacement
+{
+	cpu_set_t CPUs;
+	bool ValidCPUs = false;
+
+	int MemPolicy = MPOL_DEFAULT;
+	std::vector<unsigned long> NodeMask;
+};
+
+/*!
+ * \brief Max number of NUMA nodes stored in InitialPlacement::NodeMask. Matches the kernel's largest MAX_NUMNODES
+ */
+static constexpr size_t MaxNUMANodes = 1024;
+
+static constexpr size_t BitsPerMask = sizeof(unsigned long)*CHAR_BIT;
+
+/*!
+ * \brief Read the placement of the calling thread. Runs during static initialization, before any thread could be pinned
+ */
+static InitialPlacement readInitialPlacement()
+{
+	InitialPlacement placement;
+
+	CPU_ZERO(&placement.CPUs);
+	placement.ValidCPUs = sched_getaffinity(0, sizeof(placement.CPUs), &placement.CPUs) == 0;
+
+	// The kernel ignores the last bit of maxnode
+	placement.NodeMask.resize(MaxNUMANodes/BitsPerMask, 0);
+	if(syscall(SYS_get_mempolicy, &placement.MemPolicy, placement.NodeMask.data(), MaxNUMANodes + 1, nullptr, 0) != 0)
+	{
+		placement.MemPolicy = MPOL_DEFAULT;
+		placement.NodeMask.clear();
+	}
+
+	return placement;
+}
+
+static const InitialPlacement initialPlacement = readInitialPlacement();
+
+CPUAffinity::cpu_list_t CPUAffinity::parseCPUList(const std::string &cpuList)
+{
+	cpu_list_t cpus;
+
+	std::stringstream listStream(cpuList);
+	std::string range;
+	while(std::getline(listStream, range, ','))
+	{
+		if(range.empty() || range == "\n")
+			continue;
+
+		try
+		{
+			const auto sepPos = range.find('-');
+			const int first = std::stoi(range.substr(0, sepPos));
+			const int last = sepPos == std::string::npos ? first : std::stoi(range.substr(sepPos+1));
+
+			if(first < 0 || last < first)
+				throw std::invalid_argument(range);
+
+			for(int cpu = first; cpu <= last; ++cpu)
+				cpus.push_back(cpu);
+		}
+		catch(std::exception &)
+		{
+			throw std::invalid_argument("Invalid CPU range \"" + range + "\" in CPU list \"" + cpuList + "\"");
+		}
+	}
+
+	return cpus;
+}
+
+CPUAffinity::cpu_list_t CPUAffinity::numaNodeCPUs(int numaNode)
+{
+	const std::string fileName = "/sys/devices/system/node/node" + std::to_string(numaNode) + "/cpulist";
+
+	std::ifstream cpuListFile(fileName);
+	if(numaNode < 0 || !cpuListFile.good())
+		throw std::invalid_argument("NUMA node " + std::to_string(numaNode) + " does not exist");
+
+	std::string cpuList;
+	std::getline(cpuListFile, cpuList);
+
+	return CPUAffinity::parseCPUList(cpuList);
+}
+
+void CPUAffinity::setCPUAffinity(const cpu_list_t &cpus)
+{
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+
+	for(const auto cpu : cpus)
+	{
+		if(cpu < 0 || cpu >= CPU_SETSIZE)
+			throw std::invalid_argument("Invalid CPU ID " + std::to_string(cpu));
+
+		CPU_SET(cpu, &cpuSet);
+	}
+
+	if(sched_setaffinity(0, sizeof(cpuSet), &cpuSet) != 0)
+		throw std::system_error(errno, std::generic_category(), "Failed to set CPU affinity");
+}
+
+void CPUAffinity::setPreferredNUMANode(int numaNode)
+{
+	if(numaNode < 0)
+		throw std::invalid_argument("Invalid NUMA node " + std::to_string(numaNode));
+
+	std::vector<unsigned long> nodeMask(static_cast<size_t>(numaNode)/BitsPerMask + 1, 0);
+	nodeMask[static_cast<size_t>(numaNode)/BitsPerMask] |= 1ul << (static_cast<size_t>(numaNode) % BitsPerMask);
+
+	// Use syscall directly to avoid a dependency on libnuma. The kernel ignores the last bit of maxnode
+	const unsigned long maxNode = nodeMask.size()*BitsPerMask + 1;
+	if(syscall(SYS_set_mempolicy, MPOL_PREFERRED, nodeMask.data(), maxNode) != 0)
+		throw std::system_error(errno, std::generic_category(), "Failed to set preferred NUMA node " + std::to_string(numaNode));
+}
+
+void CPUAffinity::applyPlacement(const cpu_list_t &cpus, int numaNode)
+{
+	if(!cpus.empty())
+		CPUAffinity::setCPUAffinity(cpus);
+	else if(numaNode != CPUAffinity::NoNUMANode)
+		CPUAffinity::setCPUAffinity(CPUAffinity::numaNodeCPUs(numaNode));
+
+	if(numaNode != CPUAffinity::NoNUMANode)
+		CPUAffinity::setPreferredNUMANode(numaNode);
+}
+
+void CPUAffinity::restoreInitialPlacement()
+{
+	if(initialPlacement.ValidCPUs && sched_setaffinity(0, sizeof(initialPlacement.CPUs), &initialPlacement.CPUs) != 0)
+		throw std::system_error(errno, std::generic_category(), "Failed to restore initial CPU affinity");
+
+	// MPOL_DEFAULT doesn't accept a node mask
+	const bool useNodeMask = initialPlacement.MemPolicy != MPOL_DEFAULT && !initialPlacement.NodeMask.empty();
+	if(syscall(SYS_set_mempolicy, initialPlacement.MemPolicy, useNodeMask ? initialPlacement.NodeMask.data() : nullptr,
+	           useNodeMask ? initialPlacement.NodeMask.size()*BitsPerMask + 1 : 0) != 0)
+		throw std::system_error(errno, std::generic_category(), "Failed to restore initial memory policy");
+}
@@ -0,0 +1,85 @@
+/* * NRP Core - Backend infrastructure to synchronize simulations
+ *
+ * Copyright 2020 Michael Zechmair
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This project has received funding from the European Union’s Horizon 2020
+ * Framework Programme for Research and Innovation under the Specific Grant
+ * Agreement No. 945539 (Human Brain Project SGA3).
+ */
+
+#ifndef CPU_AFFINITY_H
+#define CPU_AFFINITY_H
+
+#include <string>
+#include <vector>
+
+/*!
+ * \brief Functions to place threads and processes on specific CPUs and NUMA nodes.
+ * All placements only affect the calling thread. Threads and processes it creates afterwards inherit them.
+ * Errors are reported via std::system_error or std::invalid_argument, so that they can be used in forked child processes without the logger
+ */
+class CPUAffinity
+{
+	public:
+		using cpu_list_t = std::vector<int>;
+
+		/*!
+		 * \brief Value indicating that no NUMA node was selected
+		 */
+		static constexpr int NoNUMANode = -1;
+
+		/*!
+		 * \brief Parse a CPU list in Linux cpulist format, e.g. "0-3,8,10-11"
+		 * \param cpuList String to parse
+		 * \return Returns list of CPU IDs
+		 */
+		static cpu_list_t parseCPUList(const std::string &cpuList);
+
+		/*!
+		 * \brief Get CPUs belonging to a NUMA node. Reads /sys/devices/system/node/node<numaNode>/cpulist
+		 * \param numaNode NUMA node ID
+		 * \return Returns list of CPU IDs
+		 */
+		static cpu_list_t numaNodeCPUs(int numaNode);
+
+		/*!
+		 * \brief Restrict the calling thread to the given CPUs
+		 * \param cpus CPU IDs
+		 */
+		static void setCPUAffinity(const cpu_list_t &cpus);
+
+		/*!
+		 * \brief Prefer memory allocations of the calling thread on the given NUMA node.
+		 * Allocations fall back to other nodes if the preferred node runs out of memory
+		 * \param numaNode NUMA node ID
+		 */
+		static void setPreferredNUMANode(int numaNode);
+
+		/*!
+		 * \brief Place the calling thread on the given CPUs and NUMA node.
+		 * If cpus is empty and a NUMA node is given, the thread is restricted to the CPUs of that node
+		 * \param cpus CPU IDs. Empty to keep the current affinity
+		 * \param numaNode NUMA node ID. CPUAffinity::NoNUMANode to keep the current memory policy
+		 */
+		static void applyPlacement(const cpu_list_t &cpus, int numaNode);
+
+		/*!
+		 * \brief Reset CPU affinity and memory policy of the calling thread to the ones the process started with.
+		 * Forked processes inherit the placement of the forking thread, which may have been pinned in the meantime
+		 */
+		static void restoreInitialPlacement();
+};
+
+#endif // CPU_AFFINITY_H
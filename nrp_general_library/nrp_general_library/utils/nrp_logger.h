@@ -56,4 +56,14 @@ class NRPLogger
 		static constexpr spdlog_out_fcn_t SPDDebugLogDefault = spdlog::debug<std::string>;
 };
 
+/*!
+ * \brief Logging macros for frequently executed code. Messages use fmt format strings, which are only formatted if the message is emitted.
+ * Calls below SPDLOG_ACTIVE_LEVEL are removed at compile time. The level is set via the NRP_LOG_ACTIVE_LEVEL CMake option
+ */
+#define NRP_LOG_TRACE(...) SPDLOG_TRACE(__VA_ARGS__)
+#define NRP_LOG_DEBUG(...) SPDLOG_DEBUG(__VA_ARGS__)
+#define NRP_LOG_INFO(...) SPDLOG_INFO(__VA_ARGS__)
+#define NRP_LOG_WARN(...) SPDLOG_WARN(__VA_ARGS__)
+#define NRP_LOG_ERROR(...) SPDLOG_ERROR(__VA_ARGS__)
+
 #endif // NRP_LOGGER_H
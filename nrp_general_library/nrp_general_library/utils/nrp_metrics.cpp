@@ -0,0 +1,261 @@
+//
+// NRP Core - Backend infrastructure to synchronize simulations
+//
+// Copyright 2020 Michael Zechmair
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This project has received funding from the European Union’s Horizon 2020
+// Framework Programme for Research and Innovation under the Specific Grant
+// Agreement No. 945539 (Human Brain Project SGA3).
+//
+
+#include "nrp_general_library/utils/nrp_metrics.h"
+
+#include "nrp_general_library/utils/nrp_exceptions.h"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+
+/*!
+ * \brief Format a floating point value in its shortest representation, using exponents only for very large or small values
+ */
+static std::string formatValue(double value)
+{
+	char buffer[32];
+	const auto res = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general);
+	return std::string(buffer, res.ptr);
+}
+
+/*!
+ * \brief Format labels as a Prometheus label set. Appends an "le" label if le is not empty
+ */
+static std::string formatLabels(const NRPMetrics::labels_t &labels, const std::string &le = "")
+{
+	if(labels.empty() && le.empty())
+		return "";
+
+	std::string out = "{";
+	const auto appendLabel = [&out](const std::string &name, const std::string &value)
+	{
+		if(out.size() > 1)
+			out += ",";
+
+		out += name + "=\"";
+		for(const char c : value)
+		{
+			if(c == '\\' || c == '"')
+				out += '\\';
+
+			if(c == '\n')
+				out += "\\n";
+			else
+				out += c;
+		}
+		out += "\"";
+	};
+
+	for(const auto &label : labels)
+		appendLabel(label.first, label.second);
+
+	if(!le.empty())
+		appendLabel("le", le);
+
+	return out + "}";
+}
+
+MetricHistogram::MetricHistogram(const std::vector<double> &bucketBounds)
+    : _bucketBounds(bucketBounds),
+      _bucketCounts(new std::atomic<uint64_t>[bucketBounds.size() + 1])
+{
+	std::sort(this->_bucketBounds.begin(), this->_bucketBounds.end());
+	for(size_t i = 0; i <= this->_bucketBounds.size(); ++i)
+		this->_bucketCounts[i] = 0;
+}
+
+void MetricHistogram::observe(double value)
+{
+	const auto bucket = std::lower_bound(this->_bucketBounds.begin(), this->_bucketBounds.end(), value) - this->_bucketBounds.begin();
+
+	this->_bucketCounts[bucket].fetch_add(1, std::memory_order_relaxed);
+	this->_count.fetch_add(1, std::memory_order_relaxed);
+	this->_sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+const std::vector<double> &MetricHistogram::bucketBounds() const
+{
+	return this->_bucketBounds;
+}
+
+std::vector<uint64_t> MetricHistogram::cumulativeCounts() const
+{
+	std::vector<uint64_t> counts(this->_bucketBounds.size() + 1);
+
+	uint64_t total = 0;
+	for(size_t i = 0; i < counts.size(); ++i)
+	{
+		total += this->_bucketCounts[i].load(std::memory_order_relaxed);
+		counts[i] = total;
+	}
+
+	return counts;
+}
+
+uint64_t MetricHistogram::count() const
+{
+	return this->_count.load(std::memory_order_relaxed);
+}
+
+double MetricHistogram::sum() const
+{
+	return this->_sum.load(std::memory_order_relaxed);
+}
+
+const std::vector<double> NRPMetrics::DefaultDurationBuckets = {0.0001, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10};
+
+NRPMetrics &NRPMetrics::instance()
+{
+	static NRPMetrics metrics;
+	return metrics;
+}
+
+MetricCounter &NRPMetrics::counter(const std::string &name, const std::string &help, const labels_t &labels)
+{
+	std::lock_guard lock(this->_lock);
+
+	auto &counter = this->getFamily(name, help, false).Counters[labels];
+	if(counter == nullptr)
+		counter.reset(new MetricCounter());
+
+	return *counter;
+}
+
+MetricHistogram &NRPMetrics::histogram(const std::string &name, const std::string &help, const labels_t &labels, const std::vector<double> &bucketBounds)
+{
+	std::lock_guard lock(this->_lock);
+
+	auto &histogram = this->getFamily(name, help, true).Histograms[labels];
+	if(histogram == nullptr)
+		histogram.reset(new MetricHistogram(bucketBounds));
+
+	return *histogram;
+}
+
+std::string NRPMetrics::toPrometheusText() const
+{
+	std::lock_guard lock(this->_lock);
+
+	std::string out;
+	for(const auto &[name, family] : this->_families)
+	{
+		out += "# HELP " + name + " " + family.Help + "\n";
+		out += "# TYPE " + name + (family.IsHistogram ? " histogram\n" : " counter\n");
+
+		for(const auto &[labels, counter] : family.Counters)
+			out += name + formatLabels(labels) + " " + std::to_string(counter->value()) + "\n";
+
+		for(const auto &[labels, histogram] : family.Histograms)
+		{
+			const auto counts = histogram->cumulativeCounts();
+			const auto &bounds = histogram->bucketBounds();
+			for(size_t i = 0; i < bounds.size(); ++i)
+				out += name + "_bucket" + formatLabels(labels, formatValue(bounds[i])) + " " + std::to_string(counts[i]) + "\n";
+
+			out += name + "_bucket" + formatLabels(labels, "+Inf") + " " + std::to_string(counts.back()) + "\n";
+			out += name + "_sum" + formatLabels(labels) + " " + formatValue(histogram->sum()) + "\n";
+			out += name + "_count" + formatLabels(labels) + " " + std::to_string(histogram->count()) + "\n";
+		}
+	}
+
+	return out;
+}
+
+void NRPMetrics::writePrometheusFile(const std::filesystem::path &fileName) const
+{
+	// Write to a temporary file first, so that readers never see a partially written file
+	auto tmpFileName = fileName;
+	tmpFileName += ".tmp";
+
+	{
+		std::ofstream metricsFile(tmpFileName, std::ios::trunc);
+		metricsFile << this->toPrometheusText();
+		if(!metricsFile.good())
+			throw NRPException::logCreate("Failed to write metrics to file \"" + tmpFileName.string() + "\"");
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(tmpFileName, fileName, ec);
+	if(ec)
+		throw NRPException::logCreate("Failed to write metrics to file \"" + fileName.string() + "\": " + ec.message());
+}
+
+MetricsFileWriter::MetricsFileWriter(std::filesystem::path fileName, std::chrono::milliseconds interval)
+    : _fileName(std::move(fileName)),
+      _interval(interval),
+      _writerThread(&MetricsFileWriter::writeLoop, this)
+{}
+
+MetricsFileWriter::~MetricsFileWriter()
+{
+	{
+		std::lock_guard lock(this->_lock);
+		this->_stop = true;
+	}
+
+	this->_stopCondition.notify_all();
+	this->_writerThread.join();
+
+	this->writeFile();
+}
+
+void MetricsFileWriter::writeLoop()
+{
+	std::unique_lock lock(this->_lock);
+	if(this->_interval <= std::chrono::milliseconds::zero())
+		return this->_stopCondition.wait(lock, [this] { return this->_stop; });
+
+	while(!this->_stopCondition.wait_for(lock, this->_interval, [this] { return this->_stop; }))
+	{
+		lock.unlock();
+		this->writeFile();
+		lock.lock();
+	}
+}
+
+void MetricsFileWriter::writeFile() const
+{
+	try
+	{
+		NRPMetrics::instance().writePrometheusFile(this->_fileName);
+	}
+	catch(std::exception&)
+	{
+		// Already logged by writePrometheusFile
+	}
+}
+
+NRPMetrics::MetricFamily &NRPMetrics::getFamily(const std::string &name, const std::string &help, bool isHistogram)
+{
+	auto familyIt = this->_families.find(name);
+	if(familyIt == this->_families.end())
+	{
+		familyIt = this->_families.emplace(name, MetricFamily()).first;
+		familyIt->second.Help = help;
+		familyIt->second.IsHistogram = isHistogram;
+	}
+	else if(familyIt->second.IsHistogram != isHistogram)
+		throw NRPException::logCreate("Metric \"" + name + "\" is already registered with a different type");
+
+	return familyIt->second;
+}
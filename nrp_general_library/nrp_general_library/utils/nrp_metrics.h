@@ -0,0 +1,225 @@
+/* * NRP Core - Backend infrastructure to synchronize simulations
+ *
+ * Copyright 2020 Michael Zechmair
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This project has received funding from the European Union’s Horizon 2020
+ * Framework Programme for Research and Innovation under the Specific Grant
+ * Agreement No. 945539 (Human Brain Project SGA3).
+ */
+
+
+#ifndef NRP_METRICS_H
+#define NRP_METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*!
+ * \brief Monotonically increasing counter. Updates are lock-free
+ */
+class MetricCounter
+{
+	public:
+		/*!
+		 * \brief Increase counter
+		 * \param value Value to add
+		 */
+		void increment(uint64_t value = 1)
+		{	this->_value.fetch_add(value, std::memory_order_relaxed);	}
+
+		/*!
+		 * \brief Current counter value
+		 */
+		uint64_t value() const
+		{	return this->_value.load(std::memory_order_relaxed);	}
+
+	private:
+		std::atomic<uint64_t> _value = 0;
+};
+
+/*!
+ * \brief Histogram with fixed bucket bounds. Updates are lock-free
+ */
+class MetricHistogram
+{
+	public:
+		/*!
+		 * \brief Constructor
+		 * \param bucketBounds Upper bounds of buckets, in ascending order. A +Inf bucket is always appended
+		 */
+		MetricHistogram(const std::vector<double> &bucketBounds);
+
+		/*!
+		 * \brief Record a value
+		 */
+		void observe(double value);
+
+		/*!
+		 * \brief Record a duration in seconds
+		 */
+		template<class REP, class PERIOD>
+		void observeDuration(const std::chrono::duration<REP, PERIOD> &duration)
+		{	this->observe(std::chrono::duration_cast<std::chrono::duration<double> >(duration).count());	}
+
+		/*!
+		 * \brief Upper bounds of buckets, excluding +Inf
+		 */
+		const std::vector<double> &bucketBounds() const;
+
+		/*!
+		 * \brief Cumulative number of observations per bucket. The last element is the +Inf bucket
+		 */
+		std::vector<uint64_t> cumulativeCounts() const;
+
+		/*!
+		 * \brief Number of observations
+		 */
+		uint64_t count() const;
+
+		/*!
+		 * \brief Sum of all observed values
+		 */
+		double sum() const;
+
+	private:
+		std::vector<double> _bucketBounds;
+		std::unique_ptr<std::atomic<uint64_t>[]> _bucketCounts;
+		std::atomic<uint64_t> _count = 0;
+		std::atomic<double> _sum = 0;
+};
+
+/*!
+ * \brief Process-wide registry of performance metrics. Can be exported in the Prometheus text format.
+ * Registering a metric locks the registry, so callers should store the returned reference instead of looking it up on every update
+ */
+class NRPMetrics
+{
+	public:
+		using labels_t = std::map<std::string, std::string>;
+
+		/*!
+		 * \brief Default histogram bucket bounds for durations, in seconds
+		 */
+		static const std::vector<double> DefaultDurationBuckets;
+
+		/*!
+		 * \brief Content type of Prometheus text format
+		 */
+		static constexpr std::string_view PrometheusContentType = "text/plain; version=0.0.4";
+
+		/*!
+		 * \brief Get process-wide registry
+		 */
+		static NRPMetrics &instance();
+
+		/*!
+		 * \brief Get counter with the given name and labels. Creates it if it doesn't exist yet
+		 * \param name Metric name
+		 * \param help Metric description. Only used when the first metric with this name is created
+		 * \param labels Metric labels
+		 * \exception Throws an exception if a histogram with the same name exists
+		 */
+		MetricCounter &counter(const std::string &name, const std::string &help, const labels_t &labels = labels_t());
+
+		/*!
+		 * \brief Get histogram with the given name and labels. Creates it if it doesn't exist yet
+		 * \param name Metric name
+		 * \param help Metric description. Only used when the first metric with this name is created
+		 * \param labels Metric labels
+		 * \param bucketBounds Bucket bounds. Only used when the histogram is created
+		 * \exception Throws an exception if a counter with the same name exists
+		 */
+		MetricHistogram &histogram(const std::string &name, const std::string &help, const labels_t &labels = labels_t(),
+		                           const std::vector<double> &bucketBounds = DefaultDurationBuckets);
+
+		/*!
+		 * \brief Write all metrics in the Prometheus text exposition format
+		 */
+		std::string toPrometheusText() const;
+
+		/*!
+		 * \brief Write all metrics in the Prometheus text exposition format to a file.
+		 * The file is replaced atomically, so it can be picked up by a node exporter textfile collector
+		 * \param fileName Name of file
+		 * \exception Throws an exception if the file can't be written
+		 */
+		void writePrometheusFile(const std::filesystem::path &fileName) const;
+
+	private:
+		/*!
+		 * \brief All metrics sharing one name
+		 */
+		struct MetricFamily
+		{
+			std::string Help;
+			bool IsHistogram = false;
+			std::map<labels_t, std::unique_ptr<MetricCounter> > Counters;
+			std::map<labels_t, std::unique_ptr<MetricHistogram> > Histograms;
+		};
+
+		mutable std::mutex _lock;
+		std::map<std::string, MetricFamily> _families;
+
+		MetricFamily &getFamily(const std::string &name, const std::string &help, bool isHistogram);
+};
+
+/*!
+ * \brief Periodically rewrites a Prometheus textfile with the metrics of NRPMetrics::instance(), so that they can be scraped while the
+ * process runs. The file is written one final time on destruction
+ */
+class MetricsFileWriter
+{
+	public:
+		/*!
+		 * \brief Constructor. Starts the writer thread
+		 * \param fileName Name of file. Replaced atomically on each write
+		 * \param interval Time between writes. If not positive, the file is only written on destruction
+		 */
+		MetricsFileWriter(std::filesystem::path fileName, std::chrono::milliseconds interval);
+		~MetricsFileWriter();
+
+		MetricsFileWriter(const MetricsFileWriter&) = delete;
+		MetricsFileWriter &operator=(const MetricsFileWriter&) = delete;
+
+	private:
+		const std::filesystem::path _fileName;
+		const std::chrono::milliseconds _interval;
+
+		std::mutex _lock;
+		std::condition_variable _stopCondition;
+		bool _stop = false;
+
+		std::thread _writerThread;
+
+		/*!
+		 * \brief Write metrics file every _interval until stopped. Write errors are logged, and the next write is attempted as usual
+		 */
+		void writeLoop();
+
+		/*!
+		 * \brief Write metrics file, log errors
+		 */
+		void writeFile() const;
+};
+
+#endif // NRP_METRICS_H
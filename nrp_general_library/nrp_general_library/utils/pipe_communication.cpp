@@ -41,6 +41,24 @@ PipeCommunication::PipeCommunication()
 	fcntl(this->_pipe[1], F_SETFL, flags | O_NONBLOCK);
 }
 
+PipeCommunication::PipeCommunication(PipeCommunication &&other)
+    : _pipe{other._pipe[0], other._pipe[1]}
+{
+	other._pipe[0] = -1;
+	other._pipe[1] = -1;
+}
+
+PipeCommunication::PipeCommunication(PipeCommunication &&readComm, PipeCommunication &&writeComm)
+    : _pipe{readComm._pipe[0], writeComm._pipe[1]}
+{
+	readComm._pipe[0] = -1;
+	writeComm._pipe[1] = -1;
+}
+
+PipeCommunication::PipeCommunication(int readFd, int writeFd)
+    : _pipe{readFd, writeFd}
+{}
+
 PipeCommunication::~PipeCommunication()
 {
 	this->closeRead();
@@ -34,6 +34,30 @@ class PipeCommunication
 		PipeCommunication();
 		~PipeCommunication();
 
+		/*!
+		 * \brief Move constructor. Takes ownership of other's file descriptors
+		 */
+		PipeCommunication(PipeCommunication &&other);
+
+		/*!
+		 * \brief Combine the read end of one pipe with the write end of another. Used for bidirectional communication between two processes.
+		 * The unused ends remain with readComm and writeComm and are closed once those are destroyed
+		 * \param readComm Pipe to take the read end from
+		 * \param writeComm Pipe to take the write end from
+		 */
+		PipeCommunication(PipeCommunication &&readComm, PipeCommunication &&writeComm);
+
+		/*!
+		 * \brief Take ownership of already opened pipe descriptors, e.g. ones inherited from a parent process
+		 * \param readFd Descriptor to read from
+		 * \param writeFd Descriptor to write to
+		 */
+		PipeCommunication(int readFd, int writeFd);
+
+		// Copying would close the same descriptors twice
+		PipeCommunication(const PipeCommunication &) = delete;
+		PipeCommunication &operator=(const PipeCommunication &) = delete;
+
 		/*!
 		 * \brief Read from pipe
 		 * \param buf buffer to read to
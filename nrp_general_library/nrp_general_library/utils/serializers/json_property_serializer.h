@@ -27,6 +27,7 @@
 #include "nrp_general_library/utils/serializers/property_serializer.h"
 
 #include <nlohmann/json.hpp>
+#include <vector>
 
 
 /*!
@@ -59,6 +60,42 @@ class ObjectPropertySerializerMethods<nlohmann::json>
 			data.emplace(name.data(), std::move(singleObject));
 			//data[name.data()] = std::move(singleObject);
 		}
+
+		/*!
+		 * \brief Deserialize a single property into an existing property. Vectors are resized and filled element-wise,
+		 * so their buffers are reused if the size did not change
+		 * \param data All serialized data
+		 * \param name Name under which the property is stored
+		 * \param property Property to update
+		 */
+		template<class PROPERTY>
+		static void updateSingleProperty(const nlohmann::json &data, const std::string_view &name, PROPERTY &property)
+		{
+			const auto dataIterator(data.find(name.data()));
+			if(dataIterator != data.end())
+				ObjectPropertySerializerMethods::updateValue(*dataIterator, property);
+			else
+				throw NRPExceptionMissingProperty(std::string("Couldn't find JSON attribute \"") + name.data() + "\" during deserialization");
+		}
+
+	private:
+		template<class T>
+		static void updateValue(const nlohmann::json &data, T &value)
+		{
+			if constexpr (std::is_arithmetic_v<T> || std::is_same_v<T, std::string>)
+				data.get_to(value);
+			else if constexpr (requires { typename T::value_type; requires std::same_as<T, std::vector<typename T::value_type> >; })
+			{
+				value.resize(data.size());
+				for(size_t i = 0; i < value.size(); ++i)
+					ObjectPropertySerializerMethods::updateValue(data[i], value[i]);
+			}
+			else
+			{
+				T newValue = data;
+				value = std::move(newValue);
+			}
+		}
 };
 
 using JSONPropertySerializerMethods = ObjectPropertySerializerMethods<nlohmann::json>;
@@ -25,6 +25,8 @@
 #include "nrp_general_library/utils/nrp_exceptions.h"
 #include "nrp_general_library/utils/property_template.h"
 
+#include <utility>
+
 
 template<class OBJECT>
 class ObjectPropertySerializerMethods;
@@ -75,7 +77,11 @@ class PropertySerializerGeneral
 		 */
 		template<class OBJECT, class PROPERTY_TEMPLATE, class PROPERTY_TEMPLATE_T, class OBJECT_T>
 		static OBJECT serializeObject(PROPERTY_TEMPLATE_T &&properties, OBJECT_T &&data = OBJECT())
-		{	return PropertySerializerGeneral::serializeSingleProperty<OBJECT, PROPERTY_TEMPLATE, 0>(std::forward<OBJECT_T>(data), std::forward<PROPERTY_TEMPLATE_T>(properties));	}
+		{
+			OBJECT retVal(std::forward<OBJECT_T>(data));
+			PropertySerializerGeneral::serializeProperties<OBJECT, PROPERTY_TEMPLATE>(retVal, properties, std::make_index_sequence<PROPERTY_TEMPLATE::NumProperties>());
+			return retVal;
+		}
 
 		/*!
 		 * \brief Update a PropertyTemplate with new data
@@ -87,7 +93,7 @@ class PropertySerializerGeneral
 		 */
 		template<class OBJECT, class PROPERTY_TEMPLATE, class OBJECT_T>
 		static void updateProperties(PROPERTY_TEMPLATE &properties, OBJECT_T &&data)
-		{	return PropertySerializerGeneral::updateProperties<OBJECT, PROPERTY_TEMPLATE, 0>(properties, std::forward<OBJECT_T>(data));	}
+		{	PropertySerializerGeneral::updateProperties<OBJECT, PROPERTY_TEMPLATE>(properties, data, std::make_index_sequence<PROPERTY_TEMPLATE::NumProperties>());	}
 
 		/*!
 		 * \brief Read out data from an OBJECT class into a PROPERTY_TEMPLATE class
@@ -131,74 +137,83 @@ class PropertySerializerGeneral
 
 	private:
 		/*!
-		 * \brief Write a single property. Continue until end of PropertyTemplate has been reached
+		 * \brief Write all properties. Expands to one serializeProperty() call per property ID
+		 * \tparam OBJECT Type to serialize PropertyTemplate to
+		 * \tparam PROPERTY_TEMPLATE PropertyTemplate<...> to serialize
+		 * \param data Data structure to write to
+		 * \param properties PropertyTemplate from which to read data
+		 */
+		template<class OBJECT, class PROPERTY_TEMPLATE, class PROPERTY_TEMPLATE_T, size_t ...IDS>
+		static void serializeProperties(OBJECT &data, PROPERTY_TEMPLATE_T &properties, std::index_sequence<IDS...>)
+		{	(PropertySerializerGeneral::serializeProperty<OBJECT, PROPERTY_TEMPLATE, IDS>(data, properties), ...);	}
+
+		/*!
+		 * \brief Write a single property
 		 * \tparam OBJECT Type to serialize PropertyTemplate to
 		 * \tparam PROPERTY_TEMPLATE PropertyTemplate<...> to serialize
 		 * \tparam ID ID of property to write
 		 * \param data Data structure to write to
 		 * \param properties PropertyTemplate from which to read data
-		 * \return Returns data, with property appended to it
 		 */
-		template<class OBJECT, class PROPERTY_TEMPLATE, int ID, class PROPERTY_TEMPLATE_T>
-		static OBJECT serializeSingleProperty(OBJECT &&data, PROPERTY_TEMPLATE_T &&properties)
+		template<class OBJECT, class PROPERTY_TEMPLATE, size_t ID, class PROPERTY_TEMPLATE_T>
+		static void serializeProperty(OBJECT &data, PROPERTY_TEMPLATE_T &properties)
 		{
 			using property_t = typename PROPERTY_TEMPLATE::template property_t<ID>;
-			if constexpr (ID < PROPERTY_TEMPLATE::NumProperties)
+			constexpr std::string_view name = PROPERTY_TEMPLATE::template getName<ID>();
+
+			// Check if default value should be serialized
+			if constexpr (PROPERTY_TEMPLATE::template isDefaultWritable<ID>())
 			{
-				// Check if default value should be serialized
-				if constexpr (PROPERTY_TEMPLATE::template isDefaultWritable<ID>())
-				{
-					ObjectPropertySerializerMethods<OBJECT>::emplaceSingleObject(data, properties.template getName<ID>(), PropertySerializerGeneral::serializeSingleProperty<OBJECT, typename PROPERTY_TEMPLATE::template property_t<ID> >(properties.template getProperty<ID>()));
-				}
-				else
-				{
-					// Only write this property if it does not correspond to the default
-					const auto &defValue = properties.template getDefaultValue<ID>();
-					const auto &value = properties.template getProperty<ID, property_t>();
-					if(value != defValue)
-						ObjectPropertySerializerMethods<OBJECT>::emplaceSingleObject(data, properties.template getName<ID>(), PropertySerializerGeneral::serializeSingleProperty<OBJECT, typename PROPERTY_TEMPLATE::template property_t<ID> >(value));
-				}
-
-				// Continue with next property
-				return PropertySerializerGeneral::template serializeSingleProperty<OBJECT, PROPERTY_TEMPLATE, ID+1>(std::move(data), std::forward<PROPERTY_TEMPLATE_T>(properties));
+				ObjectPropertySerializerMethods<OBJECT>::emplaceSingleObject(data, name, PropertySerializerGeneral::serializeSingleProperty<OBJECT, property_t>(properties.template getProperty<ID>()));
 			}
 			else
 			{
-				// Stop at end of PropertyTemplate
-				return std::move(data);
-				//return data;
+				// Only write this property if it does not correspond to the default
+				const auto &defValue = properties.template getDefaultValue<ID>();
+				const auto &value = properties.template getProperty<ID, property_t>();
+				if(value != defValue)
+					ObjectPropertySerializerMethods<OBJECT>::emplaceSingleObject(data, name, PropertySerializerGeneral::serializeSingleProperty<OBJECT, property_t>(value));
 			}
 		}
 
 		/*!
-		 * \brief Update a given PropertyTemplate
+		 * \brief Update a given PropertyTemplate. Expands to one updateProperty() call per property ID
 		 * \tparam OBJECT Deserialization type
 		 * \tparam PROPERTY_TEMPLATE PropertyTemplate<...>
-		 * \tparam OBJECT_T Deserialization type. Used for std::forward
+		 * \tparam OBJECT_T Deserialization type
 		 * \param properties Property Structure to update
 		 * \param data Data to read from
 		 */
-		template<class OBJECT, class PROPERTY_TEMPLATE, int ID, class OBJECT_T>
-		static void updateProperties(PROPERTY_TEMPLATE &properties, OBJECT_T &&data)
+		template<class OBJECT, class PROPERTY_TEMPLATE, class OBJECT_T, size_t ...IDS>
+		static void updateProperties(PROPERTY_TEMPLATE &properties, OBJECT_T &data, std::index_sequence<IDS...>)
+		{	(PropertySerializerGeneral::updateProperty<OBJECT, PROPERTY_TEMPLATE, IDS>(properties, data), ...);	}
+
+		/*!
+		 * \brief Update a single property. If no update is available, the property is left unchanged.
+		 * If ObjectPropertySerializerMethods<OBJECT> provides updateSingleProperty(), the data is deserialized directly into the existing property
+		 * \tparam OBJECT Deserialization type
+		 * \tparam PROPERTY_TEMPLATE PropertyTemplate<...>
+		 * \tparam ID ID of property to update
+		 * \param properties Property Structure to update
+		 * \param data Data to read from
+		 */
+		template<class OBJECT, class PROPERTY_TEMPLATE, size_t ID, class OBJECT_T>
+		static void updateProperty(PROPERTY_TEMPLATE &properties, OBJECT_T &data)
 		{
-			// Continue until end of Properties reached
-			if constexpr (ID < PROPERTY_TEMPLATE::NumProperties)
+			try
+			{
+				using property_t = typename PROPERTY_TEMPLATE::template property_t<ID>;
+				constexpr std::string_view name = PROPERTY_TEMPLATE::template getName<ID>();
+				auto &property = properties.template getProperty<ID, property_t>();
+
+				if constexpr (requires { ObjectPropertySerializerMethods<OBJECT>::template updateSingleProperty<property_t>(data, name, property); })
+					ObjectPropertySerializerMethods<OBJECT>::template updateSingleProperty<property_t>(data, name, property);
+				else
+					property = ObjectPropertySerializerMethods<OBJECT>::template deserializeSingleProperty<property_t>(data, name);
+			}
+			catch(std::exception &)
 			{
-				// Try to update. If no update available, continue
-				try
-				{
-					using property_t = typename PROPERTY_TEMPLATE::template property_t<ID>;
-					properties.template getProperty<ID, property_t>() =
-					        ObjectPropertySerializerMethods<OBJECT>::template deserializeSingleProperty<property_t>(std::forward<OBJECT_T>(data),
-					                                                                                                properties.template getName<ID>());
-				}
-				catch(std::exception &)
-				{
-					// TODO: Create specific exception to throw on deserialization failure
-				}
-
-				// Return Updated properties
-				return PropertySerializerGeneral::template updateProperties<OBJECT, PROPERTY_TEMPLATE, ID+1, OBJECT_T>(properties, std::forward<OBJECT_T>(data));
+				// TODO: Create specific exception to throw on deserialization failure
 			}
 		}
 };
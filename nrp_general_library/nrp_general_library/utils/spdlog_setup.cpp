@@ -35,7 +35,20 @@ void SPDLogSetup::shutdownDefault()
 	spdlog::shutdown();
 }
 
-SPDLogSetup::SPDLogSetup(std::filesystem::path &&baseFilename, FILE *consoleOut, spdlog::level::level_enum logLevel)
+void SPDLogSetup::setAsyncDefault(size_t queueSize, spdlog::async_overflow_policy overflowPolicy)
+{
+	const auto defaultLogger = spdlog::default_logger();
+
+	auto asyncLogger = SPDLogSetup::createLogger(defaultLogger->sinks(), queueSize, overflowPolicy);
+	asyncLogger->set_level(defaultLogger->level());
+	asyncLogger->flush_on(defaultLogger->flush_level());
+
+	spdlog::drop(defaultLogger->name());
+	spdlog::register_logger(asyncLogger);
+	spdlog::set_default_logger(asyncLogger);
+}
+
+SPDLogSetup::SPDLogSetup(std::filesystem::path &&baseFilename, FILE *consoleOut, spdlog::level::level_enum logLevel, size_t asyncQueueSize, spdlog::async_overflow_policy overflowPolicy)
 {
 	// Append current date and time to filename
 	try
@@ -72,7 +85,7 @@ SPDLogSetup::SPDLogSetup(std::filesystem::path &&baseFilename, FILE *consoleOut,
 	// Create logger
 	try
 	{
-		std::shared_ptr<spdlog::logger> nrpLoggerPtr(new spdlog::logger(SPDLogSetup::LoggerName.data(), sinks.begin(), sinks.end()));
+		std::shared_ptr<spdlog::logger> nrpLoggerPtr = SPDLogSetup::createLogger(sinks, asyncQueueSize, overflowPolicy);
 		nrpLoggerPtr->set_level(logLevel);
 
 		// Set new logger as default
@@ -97,3 +110,13 @@ spdlog::logger &SPDLogSetup::nrpLogger() const
 	return *(spdlog::get(SPDLogSetup::LoggerName.data()));
 }
 
+std::shared_ptr<spdlog::logger> SPDLogSetup::createLogger(const std::vector<spdlog::sink_ptr> &sinks, size_t asyncQueueSize, spdlog::async_overflow_policy overflowPolicy)
+{
+	if(asyncQueueSize == 0)
+		return std::make_shared<spdlog::logger>(SPDLogSetup::LoggerName.data(), sinks.begin(), sinks.end());
+
+	// A single worker thread writes to the sinks, so single-threaded sinks remain safe to use
+	spdlog::init_thread_pool(asyncQueueSize, 1);
+	return std::make_shared<spdlog::async_logger>(SPDLogSetup::LoggerName.data(), sinks.begin(), sinks.end(), spdlog::thread_pool(), overflowPolicy);
+}
+
@@ -24,7 +24,9 @@
 
 #include <filesystem>
 #include <stdio.h>
+#include <vector>
 #include <spdlog/spdlog.h>
+#include <spdlog/async.h>
 
 /*!
  * \brief Sets up spdlog, creates sinks and sets the logger level
@@ -42,14 +44,25 @@ class SPDLogSetup
 		 */
 		static void shutdownDefault();
 
+		/*!
+		 * \brief Replace the default logger with an asynchronous logger writing to the same sinks.
+		 * Messages are formatted by the caller and written to the sinks by a background thread
+		 * \param queueSize Maximum number of queued messages
+		 * \param overflowPolicy Action to take if the queue is full. overrun_oldest drops the oldest queued message, block waits for free space
+		 */
+		static void setAsyncDefault(size_t queueSize, spdlog::async_overflow_policy overflowPolicy = spdlog::async_overflow_policy::overrun_oldest);
+
 		/*!
 		 * \brief Constructor. Creates a logger with outputs to both the given filename as well as the console
 		 * \param baseFilename Base Log Output filename.
 		 * The constructor will append the current date, time, and pid to the name. The format is baseFilename + "-%Y-%m-%d-%H:%M:%S-%pid.log"
 		 * \param consoleOut Console Output File
 		 * \param logLevel Log Level
+		 * \param asyncQueueSize If larger than 0, messages are written to the sinks asynchronously, with up to asyncQueueSize messages queued
+		 * \param overflowPolicy Action to take if the asynchronous queue is full
 		 */
-		SPDLogSetup(std::filesystem::path &&baseFilename, FILE *consoleOut = stderr, spdlog::level::level_enum logLevel = spdlog::level::info);
+		SPDLogSetup(std::filesystem::path &&baseFilename, FILE *consoleOut = stderr, spdlog::level::level_enum logLevel = spdlog::level::info,
+		            size_t asyncQueueSize = 0, spdlog::async_overflow_policy overflowPolicy = spdlog::async_overflow_policy::overrun_oldest);
 		~SPDLogSetup();
 
 		/*!
@@ -58,6 +71,10 @@ class SPDLogSetup
 		spdlog::logger &nrpLogger() const;
 
 	private:
+		/*!
+		 * \brief Create a logger with the given sinks. The logger is asynchronous if asyncQueueSize is larger than 0
+		 */
+		static std::shared_ptr<spdlog::logger> createLogger(const std::vector<spdlog::sink_ptr> &sinks, size_t asyncQueueSize, spdlog::async_overflow_policy overflowPolicy);
 };
 
 #endif // SPDLOG_SETUP_H
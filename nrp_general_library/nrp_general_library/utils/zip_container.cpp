@@ -24,12 +24,20 @@
 
 #include "nrp_general_library/utils/nrp_exceptions.h"
 
+#include <algorithm>
 #include <assert.h>
+#include <atomic>
 #include <exception>
+#include <fcntl.h>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
 
 struct ZipSourceWrapper
 {
@@ -81,6 +89,75 @@ struct ZipWrapper
 	    zip_t *_zip;
 };
 
+struct ZipContainer::ArchiveBuffer
+{
+	const void *Data = nullptr;
+	size_t Size = 0;
+
+	std::string StrData;
+	std::vector<uint8_t> VecData;
+	void *MappedData = nullptr;
+
+	~ArchiveBuffer()
+	{
+		if(this->MappedData != nullptr)
+			munmap(this->MappedData, this->Size);
+	}
+
+	static std::shared_ptr<const ArchiveBuffer> fromString(std::string &&data)
+	{
+		auto buffer = std::make_shared<ArchiveBuffer>();
+		buffer->StrData = std::move(data);
+		buffer->Data = buffer->StrData.data();
+		buffer->Size = buffer->StrData.size();
+
+		return buffer;
+	}
+
+	static std::shared_ptr<const ArchiveBuffer> fromVector(std::vector<uint8_t> &&data)
+	{
+		auto buffer = std::make_shared<ArchiveBuffer>();
+		buffer->VecData = std::move(data);
+		buffer->Data = buffer->VecData.data();
+		buffer->Size = buffer->VecData.size();
+
+		return buffer;
+	}
+
+	/*!
+	 * \brief Map archive file into memory
+	 * \return Returns nullptr if the file couldn't be mapped
+	 */
+	static std::shared_ptr<const ArchiveBuffer> mapFile(const std::string &path)
+	{
+		const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if(fd < 0)
+			return nullptr;
+
+		struct stat fStat;
+		if(fstat(fd, &fStat) != 0 || fStat.st_size <= 0)
+		{
+			close(fd);
+			return nullptr;
+		}
+
+		void *const mem = mmap(nullptr, fStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+
+		if(mem == MAP_FAILED)
+			return nullptr;
+
+		madvise(mem, fStat.st_size, MADV_WILLNEED);
+
+		auto buffer = std::make_shared<ArchiveBuffer>();
+		buffer->MappedData = mem;
+		buffer->Data = mem;
+		buffer->Size = fStat.st_size;
+
+		return buffer;
+	}
+};
+
 ZipContainer::ZipErrorT::ZipErrorT()
 {	zip_error_init(this);	}
 
@@ -113,17 +190,35 @@ ZipContainer::ZipFileWrapper::operator zip_file_t *()
 
 
 ZipContainer::ZipContainer(std::string &&data)
-    : _data(ZipContainer::createZip(data.data(), data.capacity()))
+    : ZipContainer(ArchiveBuffer::fromString(std::move(data)))
 {}
 
 ZipContainer::ZipContainer(std::vector<uint8_t> &&data)
-    : _data(ZipContainer::createZip(data.data(), data.size()))
+    : ZipContainer(ArchiveBuffer::fromVector(std::move(data)))
 {}
 
 ZipContainer::ZipContainer(const std::string &path, bool readOnly, bool saveOnDestruct)
-    : _data(ZipContainer::openZipArchive(path, readOnly)),
+    : _data(nullptr),
       _saveOnDesctruct(saveOnDestruct)
-{}
+{
+	// Archives that are only read don't need to go through libzip's file source. Fall back to it if mapping fails
+	if(readOnly && !saveOnDestruct)
+		this->_buffer = ArchiveBuffer::mapFile(path);
+
+	if(this->_buffer != nullptr)
+		this->_data = ZipContainer::createZip(this->_buffer->Data, this->_buffer->Size, ZIP_RDONLY);
+	else
+		this->_data = ZipContainer::openZipArchive(path, readOnly);
+}
+
+ZipContainer ZipContainer::fromBufferView(const void *data, size_t size)
+{
+	auto buffer = std::make_shared<ArchiveBuffer>();
+	buffer->Data = data;
+	buffer->Size = size;
+
+	return ZipContainer(std::move(buffer));
+}
 
 ZipContainer::~ZipContainer() noexcept
 {
@@ -214,7 +309,7 @@ std::vector<uint8_t> ZipContainer::getCompressedData() const
 	return retVal;
 }
 
-void ZipContainer::extractZipFiles(std::string path) const
+void ZipContainer::extractZipFiles(std::string path, unsigned int numThreads) const
 {
 	if(path.back() != '/')
 		path += '/';
@@ -225,9 +320,9 @@ void ZipContainer::extractZipFiles(std::string path) const
 	if(numIndices <= 0)
 		return;
 
-	uint8_t buffer[ZipContainer::BuffCopySize];
-
-	// Iterate over all files in archive
+	// Create all directories first, so that extraction threads only need to write files
+	std::vector<zip_uint64_t> fileIndices;
+	fileIndices.reserve(numIndices);
 	for(zip_int64_t cI = 0; cI < numIndices; ++cI)
 	{
 		// Get File Stats
@@ -237,40 +332,77 @@ void ZipContainer::extractZipFiles(std::string path) const
 
 		const auto nLen = strlen(zStat.name);
 		if(zStat.name[nLen-1] == '/')
+			std::filesystem::create_directories(path+zStat.name);
+		else
 		{
-			// Create directory
-			std::filesystem::create_directory(path+zStat.name);
+			std::filesystem::create_directories(std::filesystem::path(path+zStat.name).parent_path());
+			fileIndices.push_back(cI);
 		}
-		else
+	}
+
+	if(numThreads == 0)
+		numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+	numThreads = static_cast<unsigned int>(std::min<size_t>(numThreads, fileIndices.size()));
+
+	// libzip archives can't be shared between threads. Without a buffer to reopen the archive from, extract sequentially
+	if(this->_buffer == nullptr || numThreads <= 1)
+	{
+		std::vector<uint8_t> buffer;
+		for(const auto fileIndex : fileIndices)
 		{
-			// Create file
-			// Get File Descriptor for reading file
-			ZipFileWrapper zFile = zip_fopen_index(pZip, cI, 0);
-			if(zFile == nullptr)
-				throw NRPException::logCreate(std::string("Failed to read file from Zip Archive: ") + zip_strerror(pZip));
-
-			// Create File
-			std::fstream file(path+zStat.name, std::ios::out | std::ios::binary | std::ios::trunc);
-
-			// Extract file data from archive
-			zip_uint64_t remSize = zStat.size;
-			while(remSize > 0)
-			{
-				const auto copySize = std::min(remSize, ZipContainer::BuffCopySize);
+			struct zip_stat zStat;
+			if(zip_stat_index(pZip, fileIndex, 0, &zStat) != 0)
+				throw NRPException::logCreate(std::string("Failed to read file stats from Zip Archive: ") + zip_strerror(pZip));
+
+			ZipContainer::extractZipFile(pZip, fileIndex, zStat, path, buffer);
+		}
 
-				// Extract file data
-				if(zip_fread(zFile, buffer, copySize) != 0)
-					throw NRPException::logCreate(std::string("Failure while reading zip file: ") + zStat.name);
+		return;
+	}
 
-				// Write file data
-				file.write(reinterpret_cast<const char*>(buffer), copySize);
-				if(file.fail())
-					throw NRPException::logCreate(std::string("Failure while extracting zip file: ") + zStat.name);
+	std::atomic<size_t> nextFile = 0;
+	std::mutex errLock;
+	std::exception_ptr extractErr = nullptr;
+
+	const auto extractFcn = [&]() {
+		try
+		{
+			ZipWrapper pThreadZip = ZipContainer::createZip(this->_buffer->Data, this->_buffer->Size, ZIP_RDONLY);
+			std::vector<uint8_t> buffer;
 
-				remSize -= copySize;
+			for(size_t fileNum = nextFile++; fileNum < fileIndices.size(); fileNum = nextFile++)
+			{
+				struct zip_stat zStat;
+				if(zip_stat_index(pThreadZip, fileIndices[fileNum], 0, &zStat) != 0)
+					throw NRPException::logCreate(std::string("Failed to read file stats from Zip Archive: ") + zip_strerror(pThreadZip));
+
+				ZipContainer::extractZipFile(pThreadZip, fileIndices[fileNum], zStat, path, buffer);
 			}
 		}
-	}
+		catch(...)
+		{
+			// Stop remaining threads after their current file
+			nextFile = fileIndices.size();
+
+			std::lock_guard<std::mutex> lock(errLock);
+			if(extractErr == nullptr)
+				extractErr = std::current_exception();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(numThreads-1);
+	for(unsigned int i = 1; i < numThreads; ++i)
+		threads.emplace_back(extractFcn);
+
+	extractFcn();
+
+	for(auto &thread : threads)
+		thread.join();
+
+	if(extractErr != nullptr)
+		std::rethrow_exception(extractErr);
 }
 
 void ZipContainer::saveToDestination(const std::string &dest) const
@@ -291,32 +423,62 @@ void ZipContainer::saveToDestination(const std::string &dest) const
 	pZArch.closeAndSaveZip();
 }
 
-zip_t *ZipContainer::createZip(const void *data, zip_uint64_t length)
+zip_t *ZipContainer::createZip(const void *data, zip_uint64_t length, int flags)
 {
 	ZipErrorT zErr;
-	zip_source_t *pZipSource = zip_source_buffer_create(0, 0, 0, &zErr);
+
+	// Reference data directly. libzip copies modified data on write
+	zip_source_t *pZipSource = zip_source_buffer_create(data, length, 0, &zErr);
 	if(pZipSource == nullptr)
 		throw NRPException::logCreate(std::string("Failed to create Zip buffer from data: ") + zip_error_strerror(&zErr));
 
-	// Copy data to buffer managed by ZipContainer
-	if(int cErr = zip_source_begin_write(pZipSource) < 0 ||
-	        zip_source_write(pZipSource, data, length) < 0 ||
-	        zip_source_commit_write(pZipSource) < 0)
-	{
-		zErr = ZipErrorT(cErr);
-		const std::string zErrMsg = cErr == 0 ? zip_error_strerror(zip_source_error(pZipSource)) : zip_error_strerror(&zErr);
-
-		throw NRPException::logCreate("Failed to copy Zip data to buffer: " + zErrMsg);
-	}
-
 	// Create zip struct. Will take ownership of pZipSource and delete on close
-	zip_t *pZip = zip_open_from_source(pZipSource, 0, &zErr);
+	zip_t *pZip = zip_open_from_source(pZipSource, flags, &zErr);
 	if(pZip == nullptr)
+	{
+		zip_source_free(pZipSource);
 		throw NRPException::logCreate(std::string("Error while reading Zip buffer data: ") + zip_error_strerror(&zErr));
+	}
 
 	return pZip;
 }
 
+void ZipContainer::extractZipFile(zip_t *pZip, zip_uint64_t index, const struct zip_stat &zStat, const std::string &path, std::vector<uint8_t> &buffer)
+{
+	// Get File Descriptor for reading file
+	ZipFileWrapper zFile = zip_fopen_index(pZip, index, 0);
+	if(zFile == nullptr)
+		throw NRPException::logCreate(std::string("Failed to read file from Zip Archive: ") + zip_strerror(pZip));
+
+	// Create File
+	std::ofstream file(path+zStat.name, std::ios::out | std::ios::binary | std::ios::trunc);
+	if(!file.is_open())
+		throw NRPException::logCreate(std::string("Failed to create file while extracting zip archive: ") + zStat.name);
+
+	// Size copy buffer to entry, so that small and medium files are copied with a single read
+	const auto buffSize = std::clamp(zStat.size, ZipContainer::MinBuffCopySize, ZipContainer::MaxBuffCopySize);
+	if(buffer.size() < buffSize)
+		buffer.resize(buffSize);
+
+	// Extract file data from archive
+	zip_uint64_t remSize = zStat.size;
+	while(remSize > 0)
+	{
+		const auto copySize = std::min<zip_uint64_t>(remSize, buffer.size());
+
+		// Extract file data
+		if(zip_fread(zFile, buffer.data(), copySize) != static_cast<zip_int64_t>(copySize))
+			throw NRPException::logCreate(std::string("Failure while reading zip file: ") + zStat.name);
+
+		// Write file data
+		file.write(reinterpret_cast<const char*>(buffer.data()), copySize);
+		if(file.fail())
+			throw NRPException::logCreate(std::string("Failure while extracting zip file: ") + zStat.name);
+
+		remSize -= copySize;
+	}
+}
+
 zip_t *ZipContainer::openZipArchive(const std::string &path, bool readOnly)
 {
 	int cErr;
@@ -356,3 +518,8 @@ ZipContainer::ZipContainer(zip_t *data, bool saveOnDestruct)
     : _data(data),
       _saveOnDesctruct(saveOnDestruct)
 {}
+
+ZipContainer::ZipContainer(const std::shared_ptr<const ArchiveBuffer> &buffer)
+    : _data(ZipContainer::createZip(buffer->Data, buffer->Size)),
+      _buffer(buffer)
+{}
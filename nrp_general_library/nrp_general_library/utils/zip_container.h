@@ -23,6 +23,7 @@
 #define ZIP_CONTAINER_H
 
 #include <filesystem>
+#include <memory>
 #include <string>
 #include <vector>
 #include <zip.h>
@@ -70,33 +71,55 @@ class ZipContainer
 		};
 
 		/*!
-		 * \brief Buffer size for zip file extraction
+		 * \brief Compressed archive data shared between the container and extraction threads.
+		 * Either owns a buffer, an mmap-ed archive file or references external data
 		 */
-		static constexpr zip_uint64_t BuffCopySize = 1024;
+		struct ArchiveBuffer;
+
+		/*!
+		 * \brief Minimum buffer size for zip file extraction
+		 */
+		static constexpr zip_uint64_t MinBuffCopySize = 64*1024;
+
+		/*!
+		 * \brief Maximum buffer size for zip file extraction. Entries smaller than this are copied in one go
+		 */
+		static constexpr zip_uint64_t MaxBuffCopySize = 4*1024*1024;
 
 	public:
 		/*!
-		 * \brief Constructor. Takes a string argument. This is mainly used for Pistache data receiving
-		 * \param data Zip File Data. Note: Will use entire data.capacity() as ZIP file array, not just data.size()
+		 * \brief Constructor. Takes a string argument. This is mainly used for Pistache data receiving.
+		 * The string is kept by the container and not copied
+		 * \param data Zip File Data
 		 * \exception Throws std::logic_error on failure
 		 */
 		ZipContainer(std::string &&data);
 
 		/*!
-		 * \brief Constructor. Initializes zip_t
+		 * \brief Constructor. Initializes zip_t. The buffer is kept by the container and not copied
 		 * \param data Zip data buffer
 		 * \exception Throws std::logic_error on failure
 		 */
 		ZipContainer(std::vector<uint8_t> &&data);
 
 		/*!
-		 * \brief Constructor. Loads data from file at path
+		 * \brief Constructor. Loads data from file at path.
+		 * Archives opened read-only without saveOnDestruct are mmap-ed instead of read into memory
 		 * \param path Path to Zip Archive
 		 * \param readOnly Should archive be opened in read-only mode
 		 * \param saveOnDestruct Should the archive be saved automatically on destruct
 		 */
 		ZipContainer(const std::string &path, bool readOnly, bool saveOnDestruct);
 
+		/*!
+		 * \brief Create a container referencing external data without copying it. Used for request bodies that can't be moved.
+		 * data must outlive the returned container
+		 * \param data Zip File Data
+		 * \param size Size of data
+		 * \exception Throws std::logic_error on failure
+		 */
+		static ZipContainer fromBufferView(const void *data, size_t size);
+
 		/*!
 		 * \brief Destructor. Will save zip archive if requested
 		 */
@@ -119,11 +142,13 @@ class ZipContainer
 		std::vector<uint8_t> getCompressedData() const;
 
 		/*!
-		 * \brief Extract Zip Files and store them under path
+		 * \brief Extract Zip Files and store them under path.
+		 * Archives backed by a buffer or a read-only file are extracted by multiple threads, each reading from its own zip_t
 		 * \param path Path to extraction directory
+		 * \param numThreads Number of extraction threads. If 0, uses the number of available cores
 		 * \exception Throws std::logic_error on fail
 		 */
-		void extractZipFiles(std::string path) const;
+		void extractZipFiles(std::string path, unsigned int numThreads = 0) const;
 
 		/*!
 		 * \brief Save Archive to storage
@@ -144,13 +169,30 @@ class ZipContainer
 		bool _saveOnDesctruct = false;
 
 		/*!
-		 * \brief Create zip_t* from buffer
+		 * \brief Compressed data _data was opened from. nullptr if the archive can't be reopened by extraction threads
+		 */
+		std::shared_ptr<const ArchiveBuffer> _buffer;
+
+		/*!
+		 * \brief Create zip_t* from buffer. The data is not copied and must outlive the returned archive
 		 * \param data Data Buffer
 		 * \param length Size of buffer
+		 * \param flags Flags passed to zip_open_from_source
 		 * \return Returns zip_t pointer
 		 * \exception Throws std::logic_error on failure
 		 */
-		static zip_t *createZip(const void *data, zip_uint64_t length);
+		static zip_t *createZip(const void *data, zip_uint64_t length, int flags = 0);
+
+		/*!
+		 * \brief Extract a single file entry
+		 * \param pZip Archive to read from
+		 * \param index Entry index
+		 * \param zStat Entry stats
+		 * \param path Extraction directory, ending with '/'
+		 * \param buffer Copy buffer. Grown up to MaxBuffCopySize if the entry is large enough
+		 * \exception Throws std::logic_error on failure
+		 */
+		static void extractZipFile(zip_t *pZip, zip_uint64_t index, const struct zip_stat &zStat, const std::string &path, std::vector<uint8_t> &buffer);
 
 		/*!
 		 * \brief Open a zip archive
@@ -170,6 +212,7 @@ class ZipContainer
 		static void addZipToZip(zip_t *dest, zip_t *src);
 
 		ZipContainer(zip_t *data, bool saveOnDestruct);
+		ZipContainer(const std::shared_ptr<const ArchiveBuffer> &buffer);
 };
 
 #endif // ZIP_CONTAINER_H
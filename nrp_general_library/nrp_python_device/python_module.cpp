@@ -30,6 +30,7 @@
 #include "nrp_general_library/transceiver_function/transceiver_device_interface.h"
 #include "nrp_general_library/transceiver_function/single_transceiver_device.h"
 
+#include "nrp_general_library/device_interface/device_history.h"
 #include "nrp_general_library/device_interface/python_device.h"
 
 #include <boost/python.hpp>
@@ -121,6 +122,14 @@ BOOST_PYTHON_MODULE(PYTHON_MODULE_NAME)
 	register_ptr_to_python<DeviceInterfaceConstSharedPtr>();
 
 
+	// DeviceHistory
+	// Non-copyable, histories are only passed to python by reference
+	class_<DeviceHistory, boost::noncopyable>("DeviceHistory", no_init)
+	        .def("__len__", &DeviceHistory::size)
+	        .def("__getitem__", &DeviceHistory::at, return_value_policy<copy_const_reference>())
+	        .add_property("capacity", &DeviceHistory::capacity);
+
+
 	// TransceiverDeviceInterface
 	class_<TransceiverDeviceInterfaceWrapper, boost::noncopyable>("TransceiverDeviceInterface", init<>())
 	        .def("__call__", &TransceiverDeviceInterface::pySetup<TransceiverDeviceInterface>)
@@ -132,7 +141,7 @@ BOOST_PYTHON_MODULE(PYTHON_MODULE_NAME)
 
 
 	// SingleTransceiverDevice
-	class_<SingleTransceiverDevice, bases<TransceiverDeviceInterface> >("SingleTransceiverDevice", init<const std::string&, const DeviceIdentifier&>(args("keyword", "id")))
+	class_<SingleTransceiverDevice, bases<TransceiverDeviceInterface> >("SingleTransceiverDevice", init<const std::string&, const DeviceIdentifier&, size_t>((arg("keyword"), arg("id"), arg("history") = 0)))
 	        .def("__call__", &TransceiverDeviceInterface::pySetup<SingleTransceiverDevice>);
 
 
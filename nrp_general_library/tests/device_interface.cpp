@@ -23,6 +23,8 @@
 #include <gtest/gtest.h>
 
 #include "nrp_general_library/device_interface/device.h"
+#include "nrp_general_library/device_interface/device_history.h"
+#include "nrp_general_library/device_interface/device_type_dispatch.h"
 
 using namespace testing;
 
@@ -100,3 +102,79 @@ TEST(DeviceInterfaceTest, Constructor)
 
 	ASSERT_EQ(interface.id(), id1);
 }
+
+struct TestDispatchDevice1
+        : public Device<TestDispatchDevice1, "dispatch_type1", PropNames<"data">, int>
+{
+	TestDispatchDevice1(DeviceIdentifier &&devID, property_template_t &&props = property_template_t(0))
+	    : Device(std::move(devID), std::move(props))
+	{}
+};
+
+struct TestDispatchDevice2
+        : public Device<TestDispatchDevice2, "dispatch_type2", PropNames<"data">, int>
+{
+	TestDispatchDevice2(DeviceIdentifier &&devID, property_template_t &&props = property_template_t(0))
+	    : Device(std::move(devID), std::move(props))
+	{}
+};
+
+TEST(DeviceTypeDispatchTest, Dispatch)
+{
+	using dispatch_t = DeviceTypeDispatch<TestDispatchDevice1, TestDispatchDevice2>;
+
+	static_assert(dispatch_t::findType("dispatch_type1") == 0);
+	static_assert(dispatch_t::findType("dispatch_type2") == 1);
+	static_assert(dispatch_t::findType("dispatch_type3") == dispatch_t::NotFound);
+	static_assert(dispatch_t::findTag(dispatch_t::DeviceTag<TestDispatchDevice2>) == 1);
+
+	const auto getTypeName = []<class DEVICE>() { return std::string(DEVICE::TypeName); };
+	const auto notFound = []() { return std::string("not_found"); };
+
+	ASSERT_EQ(dispatch_t::dispatchType(std::string("dispatch_type1"), getTypeName, notFound), "dispatch_type1");
+	ASSERT_EQ(dispatch_t::dispatchType(std::string("dispatch_type2"), getTypeName, notFound), "dispatch_type2");
+	ASSERT_EQ(dispatch_t::dispatchType(std::string("dispatch_type"), getTypeName, notFound), "not_found");
+}
+
+TEST(DeviceHistoryTest, RingBuffer)
+{
+	DeviceHistory history(2);
+	ASSERT_EQ(history.capacity(), 2);
+	ASSERT_EQ(history.size(), 0);
+	ASSERT_THROW(history.at(0), std::out_of_range);
+
+	auto dev1 = std::make_shared<DeviceInterface>("dev", "engine", "type");
+	auto dev2 = std::make_shared<DeviceInterface>("dev", "engine", "type");
+	auto dev3 = std::make_shared<DeviceInterface>("dev", "engine", "type");
+
+	history.push(dev1);
+	history.push(dev2);
+	ASSERT_EQ(history.size(), 2);
+	ASSERT_EQ(history.at(0), dev2);
+	ASSERT_EQ(history.at(1), dev1);
+
+	// Oldest device is overwritten
+	history.push(dev3);
+	ASSERT_EQ(history.size(), 2);
+	ASSERT_EQ(history.at(0), dev3);
+	ASSERT_EQ(history.at(1), dev2);
+	ASSERT_EQ(dev1.use_count(), 1);
+
+	// Newest devices are kept when resizing
+	history.setCapacity(3);
+	ASSERT_EQ(history.size(), 2);
+	ASSERT_EQ(history.at(0), dev3);
+	ASSERT_EQ(history.at(1), dev2);
+
+	history.push(dev1);
+	ASSERT_EQ(history.size(), 3);
+	ASSERT_EQ(history.at(2), dev2);
+
+	history.setCapacity(1);
+	ASSERT_EQ(history.size(), 1);
+	ASSERT_EQ(history.at(0), dev1);
+
+	history.clear();
+	ASSERT_EQ(history.size(), 0);
+	ASSERT_EQ(history.capacity(), 1);
+}
@@ -56,6 +56,15 @@ struct TestJSONPropertySerializerDefaults
 	{}
 };
 
+struct TestJSONPropertySerializerVector
+        : public PropertyTemplate<TestJSONPropertySerializerVector, PropNames<"values", "int">, std::vector<float>, int>
+{
+	template<class ...T>
+	TestJSONPropertySerializerVector(T &&...properties)
+	    : PropertyTemplate(std::forward<T>(properties)...)
+	{}
+};
+
 
 TEST(JSONPropertySerializerTest, Serialization)
 {
@@ -121,3 +130,30 @@ TEST(JSONPropertySerializerTest, NoSerializeDefaults)
 
 	ASSERT_EQ(serializedData.size(), 1);
 }
+
+TEST(JSONPropertySerializerTest, UpdateInPlace)
+{
+	static constexpr FixedString valuesName = "values";
+	static constexpr FixedString intName = "int";
+
+	TestJSONPropertySerializerVector props(std::vector<float>({1, 2, 3}), 4);
+	const float *valuesBuffer = props.getPropertyByName<valuesName, std::vector<float> >().data();
+
+	nlohmann::json data;
+	data[valuesName.m_data] = std::vector<float>({5, 6, 7});
+	data[intName.m_data] = 8;
+	JSONPropertySerializer<TestJSONPropertySerializerVector>::updateProperties(props, (const nlohmann::json&)data);
+
+	// Vector of the same size should be filled in its existing buffer
+	const auto &values = props.getPropertyByName<valuesName, std::vector<float> >();
+	ASSERT_EQ(values, std::vector<float>({5, 6, 7}));
+	ASSERT_EQ(values.data(), valuesBuffer);
+	ASSERT_EQ((props.getPropertyByName<intName, int>()), 8);
+
+	// Missing properties are left unchanged
+	data.erase(intName.m_data);
+	data[valuesName.m_data] = std::vector<float>({9});
+	JSONPropertySerializer<TestJSONPropertySerializerVector>::updateProperties(props, (const nlohmann::json&)data);
+	ASSERT_EQ(values, std::vector<float>({9}));
+	ASSERT_EQ((props.getPropertyByName<intName, int>()), 8);
+}
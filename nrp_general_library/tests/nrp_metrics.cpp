@@ -0,0 +1,119 @@
+//
+// NRP Core - Backend infrastructure to synchronize simulations
+//
+// Copyright 2020 Michael Zechmair
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This project has received funding from the European Union’s Horizon 2020
+// Framework Programme for Research and Innovation under the Specific Grant
+// Agreement No. 945539 (Human Brain Project SGA3).
+//
+
+#include <gtest/gtest.h>
+
+#include "nrp_general_library/utils/nrp_metrics.h"
+#include "nrp_general_library/utils/nrp_exceptions.h"
+
+#include <fstream>
+#include <unistd.h>
+
+TEST(NRPMetricsTest, Histogram)
+{
+	MetricHistogram histogram({0.1, 1});
+
+	histogram.observe(0.05);
+	histogram.observe(0.1);
+	histogram.observe(0.5);
+	histogram.observe(2);
+
+	ASSERT_EQ(histogram.count(), 4);
+	ASSERT_DOUBLE_EQ(histogram.sum(), 2.65);
+	ASSERT_EQ(histogram.cumulativeCounts(), std::vector<uint64_t>({2, 3, 4}));
+}
+
+TEST(NRPMetricsTest, PrometheusText)
+{
+	NRPMetrics &metrics = NRPMetrics::instance();
+
+	auto &counter = metrics.counter("test_bytes_total", "Test bytes", {{"engine", "eng\"1"}});
+	counter.increment(5);
+
+	// Same name and labels return the same counter
+	ASSERT_EQ(&counter, &metrics.counter("test_bytes_total", "Test bytes", {{"engine", "eng\"1"}}));
+
+	metrics.histogram("test_duration_seconds", "Test duration", {}, {0.5}).observe(0.25);
+
+	ASSERT_THROW(metrics.histogram("test_bytes_total", "Test bytes"), NRPExceptionNonRecoverable);
+
+	const auto text = metrics.toPrometheusText();
+	ASSERT_NE(text.find("# TYPE test_bytes_total counter\n"), std::string::npos);
+	ASSERT_NE(text.find("test_bytes_total{engine=\"eng\\\"1\"} 5\n"), std::string::npos);
+	ASSERT_NE(text.find("# TYPE test_duration_seconds histogram\n"), std::string::npos);
+	ASSERT_NE(text.find("test_duration_seconds_bucket{le=\"0.5\"} 1\n"), std::string::npos);
+	ASSERT_NE(text.find("test_duration_seconds_bucket{le=\"+Inf\"} 1\n"), std::string::npos);
+	ASSERT_NE(text.find("test_duration_seconds_sum 0.25\n"), std::string::npos);
+	ASSERT_NE(text.find("test_duration_seconds_count 1\n"), std::string::npos);
+}
+
+TEST(NRPMetricsTest, PrometheusFile)
+{
+	NRPMetrics &metrics = NRPMetrics::instance();
+	metrics.histogram("test_file_duration_seconds", "Test duration", {}, {0.0001, 10}).observe(0.00005);
+
+	const auto fileName = std::filesystem::temp_directory_path() / ("nrp_metrics_test_" + std::to_string(getpid()) + ".prom");
+	metrics.writePrometheusFile(fileName);
+
+	std::ifstream metricsFile(fileName);
+	const std::string text((std::istreambuf_iterator<char>(metricsFile)), std::istreambuf_iterator<char>());
+	std::filesystem::remove(fileName);
+
+	ASSERT_EQ(text, metrics.toPrometheusText());
+
+	// Bucket bounds are written without exponents
+	ASSERT_NE(text.find("test_file_duration_seconds_bucket{le=\"0.0001\"} 1\n"), std::string::npos);
+	ASSERT_NE(text.find("test_file_duration_seconds_bucket{le=\"10\"} 1\n"), std::string::npos);
+
+	ASSERT_THROW(metrics.writePrometheusFile(fileName.parent_path() / "nonexistent_dir" / "metrics.prom"), NRPExceptionNonRecoverable);
+}
+
+TEST(NRPMetricsTest, PeriodicPrometheusFile)
+{
+	MetricCounter &counter = NRPMetrics::instance().counter("test_periodic_file_total", "Test counter");
+	const auto fileName = std::filesystem::temp_directory_path() / ("nrp_metrics_periodic_test_" + std::to_string(getpid()) + ".prom");
+
+	const auto readFile = [&fileName]() {
+		std::ifstream metricsFile(fileName);
+		return std::string((std::istreambuf_iterator<char>(metricsFile)), std::istreambuf_iterator<char>());
+	};
+
+	{
+		MetricsFileWriter writer(fileName, std::chrono::milliseconds(10));
+
+		// The file must be updated while the writer runs
+		counter.increment(5);
+		const auto endTime = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while(readFile().find("test_periodic_file_total 5\n") == std::string::npos && std::chrono::steady_clock::now() < endTime)
+			usleep(10000);
+
+		ASSERT_NE(readFile().find("test_periodic_file_total 5\n"), std::string::npos);
+
+		counter.increment(2);
+	}
+
+	// Final values are written on destruction
+	const auto text = readFile();
+	std::filesystem::remove(fileName);
+
+	ASSERT_NE(text.find("test_periodic_file_total 7\n"), std::string::npos);
+}
@@ -26,6 +26,8 @@
 #include <string.h>
 #include <unistd.h>
 
+#include "nrp_general_library/process_launchers/launch_commands/pooled_fork.h"
+
 #include "tests/test_env_cmake.h"
 
 // Set to true after 10s, prevents race condition
@@ -54,13 +56,16 @@ void signalHandle(int sig)
 
 int main(int argc, char *argv[])
 {
+	// Wait for start parameters if launched as a warm pool process
+	const auto params = PooledFork::waitForLaunchParams(argc, argv);
+
 	printf("Starting test child process\n");
 
-	if(argc < 3)
+	if(params.size() < 3)
 		return -1;
 
-	const int fdRead = atoi(argv[1]);
-	const int fdWrite = atoi(argv[2]);
+	const int fdRead = atoi(params[1].data());
+	const int fdWrite = atoi(params[2].data());
 
 	pRead = fdopen(fdRead, "r");
 	pWrite = fdopen(fdWrite, "w");
@@ -23,10 +23,14 @@
 #include <gtest/gtest.h>
 
 #include "nrp_general_library/process_launchers/process_launcher_basic.h"
+#include "nrp_general_library/process_launchers/process_launcher_pool.h"
+#include "nrp_general_library/utils/cpu_affinity.h"
 #include "nrp_general_library/utils/pipe_communication.h"
 
 #include "tests/test_env_cmake.h"
 
+#include <sched.h>
+
 struct TestEngineConfig
         : public EngineConfig<TestEngineConfig, PropNames<> >
 {
@@ -78,3 +82,112 @@ TEST(ProcessLauncherBasicTest, TestLaunch)
 	ASSERT_EQ(pCommCtP.readP(readDat, sizeof(TEST_PROC_STR_SIGTERM), 5, 1), sizeof(TEST_PROC_STR_SIGTERM));
 	ASSERT_STREQ(readDat, TEST_PROC_STR_SIGTERM);
 }
+
+TEST(ProcessLauncherBasicTest, TestPooledLaunch)
+{
+	ProcessLauncherPool launcher;
+	PipeCommunication pCommPtC;
+	PipeCommunication pCommCtP;
+
+	std::vector<std::string> additionalParams;
+	additionalParams.push_back(std::to_string(pCommPtC.readFd()));
+	additionalParams.push_back(std::to_string(pCommCtP.writeFd()));
+
+	std::vector<std::string> additionalEnvVars;
+	additionalEnvVars.push_back(TEST_PROC_ENV_VAR_NAME "=" TEST_PROC_ENV_VAR_VAL);
+
+	TestEngineConfig testCfg;
+	testCfg.EngineConfigGeneral::engineProcCmd() = TEST_NRP_PROCESS_EXEC;
+	testCfg.engineLaunchCmd() = std::string(PooledFork::LaunchType);
+
+	// Cold launch, no warm process is waiting. The launch doesn't start additional processes
+	PooledFork::clearPool();
+	ASSERT_GE(launcher.launchEngineProcess(testCfg, additionalEnvVars, additionalParams), 0);
+	ASSERT_EQ(PooledFork::numWarmProcesses(), 0);
+
+	pCommCtP.closeWrite();
+	pCommPtC.closeRead();
+
+	// Start parameters and environment must have been passed to the process
+	char readDat[50] = "";
+	pCommCtP.readP(readDat, sizeof(TEST_PROC_STR_START), 5, 1);
+	ASSERT_STREQ(readDat, TEST_PROC_STR_START);
+
+	pCommPtC.writeP(TEST_PROC_STR_START, sizeof(TEST_PROC_STR_START), 5, 1);
+
+	ASSERT_EQ(pCommCtP.readP(readDat, sizeof(TEST_PROC_ENV_VAR_VAL), 5, 1), sizeof(TEST_PROC_ENV_VAR_VAL));
+	ASSERT_STREQ(readDat, TEST_PROC_ENV_VAR_VAL);
+
+	ASSERT_LE(launcher.stopEngineProcess(5), 0);
+
+	ASSERT_EQ(pCommCtP.readP(readDat, sizeof(TEST_PROC_STR_SIGTERM), 5, 1), sizeof(TEST_PROC_STR_SIGTERM));
+	ASSERT_STREQ(readDat, TEST_PROC_STR_SIGTERM);
+
+	// A warm process started ahead of time must be used by the next launch. It inherits the pipes at startup
+	PipeCommunication pCommPtC2;
+	PipeCommunication pCommCtP2;
+
+	const pid_t warmPID = PooledFork::prestartProcess(testCfg, additionalEnvVars);
+	ASSERT_GT(warmPID, 0);
+	ASSERT_EQ(PooledFork::numWarmProcesses(), 1);
+
+	additionalParams = {std::to_string(pCommPtC2.readFd()), std::to_string(pCommCtP2.writeFd())};
+
+	ASSERT_EQ(launcher.launchEngineProcess(testCfg, additionalEnvVars, additionalParams), warmPID);
+	ASSERT_EQ(PooledFork::numWarmProcesses(), 0);
+
+	pCommCtP2.closeWrite();
+	pCommPtC2.closeRead();
+
+	std::fill(std::begin(readDat), std::end(readDat), '\0');
+	pCommCtP2.readP(readDat, sizeof(TEST_PROC_STR_START), 5, 1);
+	ASSERT_STREQ(readDat, TEST_PROC_STR_START);
+
+	pCommPtC2.writeP(TEST_PROC_STR_START, sizeof(TEST_PROC_STR_START), 5, 1);
+
+	ASSERT_EQ(pCommCtP2.readP(readDat, sizeof(TEST_PROC_ENV_VAR_VAL), 5, 1), sizeof(TEST_PROC_ENV_VAR_VAL));
+	ASSERT_STREQ(readDat, TEST_PROC_ENV_VAR_VAL);
+
+	ASSERT_LE(launcher.stopEngineProcess(5), 0);
+
+	ASSERT_EQ(pCommCtP2.readP(readDat, sizeof(TEST_PROC_STR_SIGTERM), 5, 1), sizeof(TEST_PROC_STR_SIGTERM));
+	ASSERT_STREQ(readDat, TEST_PROC_STR_SIGTERM);
+
+	PooledFork::clearPool();
+	ASSERT_EQ(PooledFork::numWarmProcesses(), 0);
+}
+
+TEST(ProcessLauncherBasicTest, TestCPUList)
+{
+	ASSERT_EQ(CPUAffinity::parseCPUList("0-3,8"), CPUAffinity::cpu_list_t({0, 1, 2, 3, 8}));
+	ASSERT_EQ(CPUAffinity::parseCPUList("5\n"), CPUAffinity::cpu_list_t({5}));
+	ASSERT_TRUE(CPUAffinity::parseCPUList("").empty());
+
+	ASSERT_THROW(CPUAffinity::parseCPUList("3-1"), std::invalid_argument);
+	ASSERT_THROW(CPUAffinity::parseCPUList("a"), std::invalid_argument);
+
+	// Empty placement must leave the process untouched
+	ASSERT_NO_THROW(CPUAffinity::applyPlacement({}, CPUAffinity::NoNUMANode));
+}
+
+TEST(ProcessLauncherBasicTest, TestRestoreInitialPlacement)
+{
+	cpu_set_t initialCPUs;
+	ASSERT_EQ(sched_getaffinity(0, sizeof(initialCPUs), &initialCPUs), 0);
+
+	int firstCPU = 0;
+	while(!CPU_ISSET(firstCPU, &initialCPUs))
+		++firstCPU;
+
+	// Pin thread to a single CPU, then reset it
+	CPUAffinity::setCPUAffinity({firstCPU});
+
+	cpu_set_t curCPUs;
+	ASSERT_EQ(sched_getaffinity(0, sizeof(curCPUs), &curCPUs), 0);
+	ASSERT_EQ(CPU_COUNT(&curCPUs), 1);
+
+	CPUAffinity::restoreInitialPlacement();
+
+	ASSERT_EQ(sched_getaffinity(0, sizeof(curCPUs), &curCPUs), 0);
+	ASSERT_TRUE(CPU_EQUAL(&curCPUs, &initialCPUs));
+}
@@ -26,6 +26,9 @@
 #include "tests/test_transceiver_function_interpreter.h"
 #include "tests/test_env_cmake.h"
 
+#include <fstream>
+#include <unistd.h>
+
 using namespace boost;
 
 void appendPythonPath(const std::string &path)
@@ -154,9 +157,20 @@ TEST(TransceiverFunctionInterpreterTest, TestTransceiverFunction)
 	EngineInterface::device_outputs_t devs({dev});
 	interpreter->setEngineDevices({{dev->engineName(), &devs}});
 
+	const auto cacheDir = std::filesystem::temp_directory_path() / ("nrp_tf_bytecode_test_" + std::to_string(getpid()));
+	std::filesystem::remove_all(cacheDir);
+	interpreter->setBytecodeCacheDir(cacheDir);
+
 	// Load and execute simple python function
 	interpreter->loadTransceiverFunction(tfCfg);
 
+	// Compiled code was cached in a private directory, TF definitions stay in the TF's own namespace
+	ASSERT_FALSE(std::filesystem::is_empty(cacheDir));
+	ASSERT_EQ(std::filesystem::status(cacheDir).permissions() & (std::filesystem::perms::group_all | std::filesystem::perms::others_all), std::filesystem::perms::none);
+	std::filesystem::remove_all(cacheDir);
+	ASSERT_FALSE(globals.has_key("transceiver_function"));
+	ASSERT_TRUE(boost::python::dict(interpreter->findTF(tfName)->second.LocalVariables).has_key("transceiver_function"));
+
 	const auto &reqIDs = interpreter->updateRequestedDeviceIDs();
 	ASSERT_EQ(reqIDs.size(), 1);
 	ASSERT_EQ(*(reqIDs.begin()), TestOutputDevice::ID());
@@ -169,6 +183,115 @@ TEST(TransceiverFunctionInterpreterTest, TestTransceiverFunction)
 	ASSERT_EQ(inDevice.id(), TestInputDevice::ID());
 	ASSERT_EQ(dev->TestValue, std::stoi(inDevice.TestValue));
 
+	// TF arguments must not keep the device alive, otherwise the engine can't update it in place
+	ASSERT_EQ(dev.use_count(), 2);
+
+	// Arguments are reused between executions, make sure updated devices are passed on
+	std::shared_ptr<TestOutputDevice> newDev(new TestOutputDevice(TestOutputDevice::ID()));
+	newDev->TestValue = 7;
+	devs = EngineInterface::device_outputs_t({newDev});
+
+	res = boost::python::list(interpreter->runSingleTransceiverFunction(tfName));
+	ASSERT_EQ(boost::python::len(res), 1);
+
+	const TestInputDevice &newInDevice = boost::python::extract<TestInputDevice>(res[0]);
+	ASSERT_EQ(newDev->TestValue, std::stoi(newInDevice.TestValue));
+	ASSERT_EQ(newDev.use_count(), 2);
+	ASSERT_EQ(dev.use_count(), 1);
+
+	TransceiverDeviceInterface::setTFInterpreter(nullptr);
+}
+
+TEST(TransceiverFunctionInterpreterTest, TestBytecodeCacheReuse)
+{
+	Py_Initialize();
+	python::object main(python::import("__main__"));
+	python::object nrpModule(python::import(PYTHON_MODULE_NAME_STR));
+
+	appendPythonPath(TEST_PYTHON_MODULE_PATH);
+	python::object testModule(python::import(TEST_PYTHON_MODULE_NAME_STR));
+
+	python::dict globals(main.attr("__dict__"));
+	globals.update(nrpModule.attr("__dict__"));
+	globals.update(testModule.attr("__dict__"));
+
+	const auto cacheDir = std::filesystem::temp_directory_path() / ("nrp_tf_bytecode_reuse_test_" + std::to_string(getpid()));
+	std::filesystem::remove_all(cacheDir);
+
+	TransceiverFunctionConfig tfCfg;
+	tfCfg.setName("testTF");
+	tfCfg.setFileName(TEST_TRANSCEIVER_FCN_FILE_NAME);
+	tfCfg.setIsActive(true);
+
+	// First interpreter compiles the TF and writes its bytecode to disk
+	{
+		TransceiverFunctionInterpreterSharedPtr interpreter(new TransceiverFunctionInterpreter(globals));
+		TransceiverDeviceInterface::setTFInterpreter(interpreter.get());
+		interpreter->setBytecodeCacheDir(cacheDir);
+		interpreter->loadTransceiverFunction(tfCfg);
+		TransceiverDeviceInterface::setTFInterpreter(nullptr);
+	}
+
+	std::vector<std::filesystem::path> cacheFiles;
+	for(const auto &entry : std::filesystem::directory_iterator(cacheDir))
+		cacheFiles.push_back(entry.path());
+
+	ASSERT_EQ(cacheFiles.size(), 1);
+
+	// Replace the cached code with a marked variant. It is only executed if the cache file is loaded instead of the source
+	std::ifstream tfFile(TEST_TRANSCEIVER_FCN_FILE_NAME);
+	const std::string source((std::istreambuf_iterator<char>(tfFile)), std::istreambuf_iterator<char>());
+
+	const python::object code = python::import("builtins").attr("compile")(source + "\nloaded_from_bytecode_cache = True\n", TEST_TRANSCEIVER_FCN_FILE_NAME, "exec");
+	const python::object data = python::import("marshal").attr("dumps")(code);
+	std::ofstream(cacheFiles.front(), std::ios::binary | std::ios::trunc).write(PyBytes_AS_STRING(data.ptr()), PyBytes_GET_SIZE(data.ptr()));
+
+	// A fresh interpreter has no compiled code in memory and must load it from disk
+	TransceiverFunctionInterpreterSharedPtr interpreter(new TransceiverFunctionInterpreter(globals));
+	TransceiverDeviceInterface::setTFInterpreter(interpreter.get());
+	interpreter->setBytecodeCacheDir(cacheDir);
+	interpreter->loadTransceiverFunction(tfCfg);
+
+	const boost::python::dict tfNamespace(interpreter->findTF(tfCfg.name())->second.LocalVariables);
+	ASSERT_TRUE(tfNamespace.has_key("loaded_from_bytecode_cache"));
+	ASSERT_TRUE(tfNamespace.has_key("transceiver_function"));
+
+	std::filesystem::remove_all(cacheDir);
+	TransceiverDeviceInterface::setTFInterpreter(nullptr);
+}
+
+TEST(TransceiverFunctionInterpreterTest, TestUntrustedBytecodeCache)
+{
+	Py_Initialize();
+	python::object main(python::import("__main__"));
+	python::object nrpModule(python::import(PYTHON_MODULE_NAME_STR));
+
+	appendPythonPath(TEST_PYTHON_MODULE_PATH);
+	python::object testModule(python::import(TEST_PYTHON_MODULE_NAME_STR));
+
+	python::dict globals(main.attr("__dict__"));
+	globals.update(nrpModule.attr("__dict__"));
+	globals.update(testModule.attr("__dict__"));
+
+	TransceiverFunctionInterpreterSharedPtr interpreter(new TransceiverFunctionInterpreter(globals));
+	TransceiverDeviceInterface::setTFInterpreter(interpreter.get());
+
+	// Cache directories writable by other users must not be used, they could contain planted bytecode
+	const auto cacheDir = std::filesystem::temp_directory_path() / ("nrp_tf_bytecode_untrusted_test_" + std::to_string(getpid()));
+	std::filesystem::remove_all(cacheDir);
+	std::filesystem::create_directory(cacheDir);
+	std::filesystem::permissions(cacheDir, std::filesystem::perms::all);
+	interpreter->setBytecodeCacheDir(cacheDir);
+
+	TransceiverFunctionConfig tfCfg;
+	tfCfg.setName("testTF");
+	tfCfg.setFileName(TEST_TRANSCEIVER_FCN_FILE_NAME);
+	tfCfg.setIsActive(true);
+
+	interpreter->loadTransceiverFunction(tfCfg);
+	ASSERT_TRUE(std::filesystem::is_empty(cacheDir));
+
+	std::filesystem::remove_all(cacheDir);
 	TransceiverDeviceInterface::setTFInterpreter(nullptr);
 }
 
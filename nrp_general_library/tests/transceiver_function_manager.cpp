@@ -0,0 +1,237 @@
+//
+// NRP Core - Backend infrastructure to synchronize simulations
+//
+// Copyright 2020 Michael Zechmair
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This project has received funding from the European Union’s Horizon 2020
+// Framework Programme for Research and Innovation under the Specific Grant
+// Agreement No. 945539 (Human Brain Project SGA3).
+//
+
+#include <gtest/gtest.h>
+
+#include "nrp_general_library/config/cmake_constants.h"
+#include "nrp_general_library/transceiver_function/transceiver_function_manager.h"
+#include "nrp_general_library/utils/nrp_exceptions.h"
+#include "tests/test_transceiver_function_interpreter.h"
+#include "tests/test_env_cmake.h"
+
+using namespace boost;
+
+void appendPythonPath(const std::string &path);
+
+/*!
+ * \brief Add NRP and test python modules to the globals used by the TF Manager
+ */
+static void setupTFGlobals()
+{
+	Py_Initialize();
+	python::object main(python::import("__main__"));
+	python::object nrpModule(python::import(PYTHON_MODULE_NAME_STR));
+
+	appendPythonPath(TEST_PYTHON_MODULE_PATH);
+	python::object testModule(python::import(TEST_PYTHON_MODULE_NAME_STR));
+
+	python::dict globals(main.attr("__dict__"));
+	globals.update(nrpModule.attr("__dict__"));
+	globals.update(testModule.attr("__dict__"));
+}
+
+/*!
+ * \brief Create configuration of a TF linked to "engine", which requests a TestOutputDevice from "engine"
+ * \param name Name of TF
+ * \param period TF period (in seconds)
+ * \return Returns TF configuration
+ */
+static TransceiverFunctionConfigSharedPtr createTFConfig(const std::string &name, float period)
+{
+	TransceiverFunctionConfigSharedPtr tfCfg(new TransceiverFunctionConfig());
+	tfCfg->setName(name);
+	tfCfg->setFileName(TEST_TRANSCEIVER_FCN_FILE_NAME);
+	tfCfg->setIsActive(true);
+	tfCfg->setPeriod(period);
+
+	return tfCfg;
+}
+
+TEST(TransceiverFunctionManagerTest, TestPeriodScheduling)
+{
+	setupTFGlobals();
+
+	TransceiverFunctionManager manager;
+	TransceiverDeviceInterface::setTFInterpreter(&manager.getInterpreter());
+
+	std::shared_ptr<TestOutputDevice> dev(new TestOutputDevice(TestOutputDevice::ID()));
+	EngineInterface::device_outputs_t devs({dev});
+	manager.getInterpreter().setEngineDevices({{dev->engineName(), &devs}});
+
+	manager.loadTF(createTFConfig("testTF", 0.1f));
+
+	const auto t = [](float seconds) { return toSimulationTime<float, std::ratio<1>>(seconds); };
+	TransceiverFunctionManager::engine_times_t updateTimes;
+
+	// First execution is never skipped
+	updateTimes["engine"] = t(0.0f);
+	ASSERT_EQ(manager.executeActiveLinkedTFs("engine", t(0.0f), updateTimes).size(), 1);
+
+	// Skip TF until its period elapsed
+	updateTimes["engine"] = t(0.05f);
+	ASSERT_EQ(manager.executeActiveLinkedTFs("engine", t(0.05f), updateTimes).size(), 0);
+
+	updateTimes["engine"] = t(0.1f);
+	ASSERT_EQ(manager.executeActiveLinkedTFs("engine", t(0.1f), updateTimes).size(), 1);
+
+	// Skip TF if its input engine didn't advance since the last execution
+	ASSERT_EQ(manager.executeActiveLinkedTFs("engine", t(0.2f), updateTimes).size(), 0);
+
+	updateTimes["engine"] = t(0.2f);
+	ASSERT_EQ(manager.executeActiveLinkedTFs("engine", t(0.2f), updateTimes).size(), 1);
+
+	// Execute TF again once execution times were reset
+	manager.resetExecutionTimes();
+	ASSERT_EQ(manager.executeActiveLinkedTFs("engine", t(0.2f), updateTimes).size(), 1);
+
+	TransceiverDeviceInterface::setTFInterpreter(nullptr);
+}
+
+TEST(TransceiverFunctionManagerTest, TestZeroPeriod)
+{
+	setupTFGlobals();
+
+	TransceiverFunctionManager manager;
+	TransceiverDeviceInterface::setTFInterpreter(&manager.getInterpreter());
+
+	std::shared_ptr<TestOutputDevice> dev(new TestOutputDevice(TestOutputDevice::ID()));
+	EngineInterface::device_outputs_t devs({dev});
+	manager.getInterpreter().setEngineDevices({{dev->engineName(), &devs}});
+
+	manager.loadTF(createTFConfig("testTF", 0.0f));
+
+	const auto simTime = toSimulationTime<float, std::ratio<1>>(0.1f);
+	const TransceiverFunctionManager::engine_times_t updateTimes({{"engine", SimulationTime::zero()}});
+
+	// TFs without a period run on every call, even if their input engine didn't advance
+	for(unsigned int i = 0; i < 3; ++i)
+		ASSERT_EQ(manager.executeActiveLinkedTFs("engine", simTime, updateTimes).size(), 1);
+
+	TransceiverDeviceInterface::setTFInterpreter(nullptr);
+}
+
+TEST(TransceiverFunctionManagerTest, TestEngineLookahead)
+{
+	setupTFGlobals();
+
+	TransceiverFunctionManager manager;
+	TransceiverDeviceInterface::setTFInterpreter(&manager.getInterpreter());
+
+	const auto t = [](float seconds) { return toSimulationTime<float, std::ratio<1>>(seconds); };
+
+	// No TF involves the engine
+	ASSERT_EQ(manager.engineLookahead("engine"), SimulationTime::zero());
+
+	manager.loadTF(createTFConfig("slowTF", 0.5f));
+	ASSERT_EQ(manager.engineLookahead("engine"), t(0.5f));
+
+	// Lookahead is limited by the TF with the smallest period
+	manager.loadTF(createTFConfig("fastTF", 0.2f));
+	ASSERT_EQ(manager.engineLookahead("engine"), t(0.2f));
+	ASSERT_EQ(manager.engineLookahead("otherEngine"), SimulationTime::zero());
+
+	// Inactive TFs are not considered
+	manager.setActive("fastTF", false);
+	ASSERT_EQ(manager.engineLookahead("engine"), t(0.5f));
+
+	manager.setActive("slowTF", false);
+	ASSERT_EQ(manager.engineLookahead("engine"), SimulationTime::zero());
+
+	TransceiverDeviceInterface::setTFInterpreter(nullptr);
+}
+
+TEST(TransceiverFunctionManagerTest, TestMultipleTFsPerEngine)
+{
+	setupTFGlobals();
+
+	TransceiverFunctionManager manager;
+	TransceiverDeviceInterface::setTFInterpreter(&manager.getInterpreter());
+
+	std::shared_ptr<TestOutputDevice> dev(new TestOutputDevice(TestOutputDevice::ID()));
+	dev->TestValue = 5;
+	EngineInterface::device_outputs_t devs({dev});
+	manager.getInterpreter().setEngineDevices({{dev->engineName(), &devs}});
+
+	// All TFs are linked to the same engine
+	for(const auto &tfName : {"testTF1", "testTF2", "testTF3"})
+		manager.loadTF(createTFConfig(tfName, 0.0f));
+
+	auto results = manager.executeActiveLinkedTFs("engine");
+	ASSERT_EQ(results.size(), 3);
+	for(const auto &result : results)
+	{
+		ASSERT_EQ(result.Devices.size(), 1);
+		ASSERT_EQ(std::stoi(dynamic_cast<const TestInputDevice*>(result.Devices.front())->TestValue), dev->TestValue);
+	}
+
+	manager.setActive("testTF2", false);
+	ASSERT_EQ(manager.executeActiveLinkedTFs("engine").size(), 2);
+	ASSERT_EQ(manager.executeActiveLinkedTFs("engine", SimulationTime::zero(), {}).size(), 2);
+	ASSERT_EQ(manager.executeActiveTFs().size(), 2);
+
+	// Updating one TF must keep the others linked to the engine
+	manager.updateTF(createTFConfig("testTF1", 0.0f));
+	ASSERT_EQ(manager.executeActiveLinkedTFs("engine").size(), 2);
+
+	ASSERT_EQ(manager.executeActiveLinkedTFs("otherEngine").size(), 0);
+
+	TransceiverDeviceInterface::setTFInterpreter(nullptr);
+}
+
+TEST(TransceiverFunctionManagerTest, TestRequestedDeviceCache)
+{
+	setupTFGlobals();
+
+	TransceiverFunctionManager manager;
+	TransceiverDeviceInterface::setTFInterpreter(&manager.getInterpreter());
+
+	const auto t = [](float seconds) { return toSimulationTime<float, std::ratio<1>>(seconds); };
+
+	ASSERT_TRUE(manager.updateRequestedDeviceIDs().empty());
+
+	// Loading a TF invalidates the cache
+	manager.loadTF(createTFConfig("testTF", 0.1f));
+	ASSERT_EQ(manager.updateRequestedDeviceIDs(), EngineInterface::device_identifiers_t({TestOutputDevice::ID()}));
+	ASSERT_EQ(manager.engineLookahead("engine"), t(0.1f));
+
+	// Toggling a TF invalidates the cache
+	manager.setActive("testTF", false);
+	ASSERT_TRUE(manager.updateRequestedDeviceIDs().empty());
+	ASSERT_EQ(manager.engineLookahead("engine"), SimulationTime::zero());
+
+	manager.setActive("testTF", true);
+	ASSERT_EQ(manager.updateRequestedDeviceIDs(), EngineInterface::device_identifiers_t({TestOutputDevice::ID()}));
+
+	// Updating a TF invalidates the cache
+	manager.updateTF(createTFConfig("testTF", 0.3f));
+	ASSERT_EQ(manager.engineLookahead("engine"), t(0.3f));
+
+	auto inactiveCfg = createTFConfig("testTF", 0.3f);
+	inactiveCfg->setIsActive(false);
+	manager.updateTF(inactiveCfg);
+	ASSERT_TRUE(manager.updateRequestedDeviceIDs().empty());
+	ASSERT_FALSE(manager.isActive("testTF"));
+
+	ASSERT_THROW(manager.setActive("missingTF", true), NRPExceptionNonRecoverable);
+
+	TransceiverDeviceInterface::setTFInterpreter(nullptr);
+}
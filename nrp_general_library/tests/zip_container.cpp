@@ -0,0 +1,104 @@
+//
+// NRP Core - Backend infrastructure to synchronize simulations
+//
+// Copyright 2020 Michael Zechmair
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This project has received funding from the European Union’s Horizon 2020
+// Framework Programme for Research and Innovation under the Specific Grant
+// Agreement No. 945539 (Human Brain Project SGA3).
+//
+
+#include <gtest/gtest.h>
+
+#include "nrp_general_library/utils/zip_container.h"
+
+#include <fstream>
+#include <map>
+#include <unistd.h>
+
+/*!
+ * \brief Read all files and directories under dir. Directory names end with '/' and map to an empty string
+ * \param dir Directory to read
+ * \return Returns file contents, mapped by path relative to dir
+ */
+static std::map<std::string, std::string> readDirectory(const std::filesystem::path &dir)
+{
+	std::map<std::string, std::string> contents;
+	for(const auto &f : std::filesystem::recursive_directory_iterator(dir))
+	{
+		const std::string relPath = std::filesystem::relative(f.path(), dir);
+		if(f.is_directory())
+			contents.emplace(relPath + "/", "");
+		else
+		{
+			std::ifstream file(f.path(), std::ios::binary);
+			contents.emplace(relPath, std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>()));
+		}
+	}
+
+	return contents;
+}
+
+/*!
+ * \brief Write a file
+ */
+static void writeFile(const std::filesystem::path &fileName, const std::string &data)
+{
+	std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+	file << data;
+}
+
+TEST(ZipContainerTest, RoundTrip)
+{
+	const auto testDir = std::filesystem::temp_directory_path() / ("nrp_zip_container_test_" + std::to_string(getpid()));
+	const auto srcDir = testDir / "src";
+	std::filesystem::remove_all(testDir);
+
+	// Create test directory, including an empty directory and a file larger than the extraction copy buffer
+	std::filesystem::create_directories(srcDir / "sub" / "nested");
+	std::filesystem::create_directories(srcDir / "empty");
+
+	std::string largeData(5*1024*1024 + 123, '\0');
+	for(size_t i = 0; i < largeData.size(); ++i)
+		largeData[i] = static_cast<char>((i * 31) ^ (i >> 7));
+
+	writeFile(srcDir / "large.bin", largeData);
+	writeFile(srcDir / "empty.txt", "");
+	for(unsigned int i = 0; i < 16; ++i)
+		writeFile(srcDir / (i % 2 ? "sub" : "sub/nested") / ("file" + std::to_string(i) + ".txt"), "content " + std::to_string(i));
+
+	const auto srcContents = readDirectory(srcDir);
+
+	// Compressed archive without a buffer to reopen from, extracted single-threaded
+	const ZipContainer compressed = ZipContainer::compressPath(srcDir);
+	compressed.extractZipFiles(testDir / "single", 1);
+	ASSERT_EQ(readDirectory(testDir / "single"), srcContents);
+
+	// Archive backed by a buffer, extracted by multiple threads
+	const ZipContainer bufferZip(compressed.getCompressedData());
+	bufferZip.extractZipFiles(testDir / "multi", 4);
+	ASSERT_EQ(readDirectory(testDir / "multi"), srcContents);
+
+	// mmap-ed archive file, extracted by multiple threads
+	const auto archiveFile = testDir / "archive.zip";
+	compressed.saveToDestination(archiveFile);
+	{
+		const ZipContainer fileZip(archiveFile.string(), true, false);
+		fileZip.extractZipFiles(testDir / "file", 3);
+	}
+	ASSERT_EQ(readDirectory(testDir / "file"), srcContents);
+
+	std::filesystem::remove_all(testDir);
+}
@@ -22,12 +22,23 @@
 
 #include "nest_server_executable/nest_server_executable.h"
 
+#include "nrp_general_library/process_launchers/launch_commands/pooled_fork.h"
+
 #include <boost/python.hpp>
 
 int main(int argc, char *argv[])
 {
+	// Processes started by a PooledFork preload their modules, then wait for the actual start parameters
+	auto startParams = PooledFork::waitForLaunchParams(argc, argv, &NestServerExecutable::preloadModules);
+
+	std::vector<char*> startParamPtrs;
+	for(auto &startParam : startParams)
+		startParamPtrs.push_back(startParam.data());
+
+	startParamPtrs.push_back(nullptr);
+
 	// Load the Nest server
-	auto &server = NestServerExecutable::resetInstance(argc, argv);
+	auto &server = NestServerExecutable::resetInstance(static_cast<int>(startParams.size()), startParamPtrs.data());
 
 	// Start the server in separate thread
 	server.startServerAsync();
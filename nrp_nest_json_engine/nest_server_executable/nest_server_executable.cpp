@@ -22,6 +22,7 @@
 
 #include "nest_server_executable/nest_server_executable.h"
 
+#include "nrp_general_library/process_launchers/launch_commands/pooled_fork.h"
 #include "nrp_general_library/utils/spdlog_setup.h"
 
 #include <boost/python.hpp>
@@ -69,6 +70,24 @@ void NestServerExecutable::shutdown()
 	NestServerExecutable::_instance.reset();
 }
 
+void NestServerExecutable::preloadModules()
+{
+	Py_Initialize();
+
+	for(const auto &module : PooledFork::preloadModules())
+	{
+		try
+		{
+			python::import(module.data());
+		}
+		catch(python::error_already_set &)
+		{
+			// Engine can still start, the module will be imported later if required
+			PyErr_Print();
+		}
+	}
+}
+
 void NestServerExecutable::startServerAsync()
 {
 	// Allow threads after starting server
@@ -142,6 +142,7 @@ nlohmann::json NestJSONServer::initialize(const nlohmann::json &data, EngineJSON
 
 	// Read received configuration
 	const NestConfig config(data.at(NestConfig::ConfigType.m_data));
+	this->_initData = data;
 
 	// Empty device mapping
 	this->_devMap.clear();
@@ -237,6 +238,68 @@ nlohmann::json NestJSONServer::shutdown(const nlohmann::json &)
 	return nlohmann::json();
 }
 
+nlohmann::json NestJSONServer::saveSnapshot(const nlohmann::json &)
+{
+	if(!this->_initRunFlag)
+		throw NRPException::logCreate("Cannot save a NEST snapshot before initialization");
+
+	PythonGILLock lock(this->_pyGILState, true);
+
+	try
+	{
+		const auto kernelTime = python::extract<double>(this->_pyNest["GetKernelStatus"]("time"));
+		if(kernelTime != 0)
+			throw NRPException::logCreate("NEST kernel time cannot be rewound. Snapshots can only be saved before the first simulation step");
+	}
+	catch(python::error_already_set &)
+	{
+		throw NRPException::logCreate("Failed to read NEST kernel status: " + handle_pyerror());
+	}
+
+	this->_snapshotFlag = true;
+
+	return nlohmann::json();
+}
+
+SimulationTime NestJSONServer::restoreSnapshot(const nlohmann::json &, EngineJSONServer::lock_t &deviceLock)
+{
+	if(!this->_snapshotFlag)
+		throw NRPException::logCreate("No NEST snapshot has been saved");
+
+	{
+		PythonGILLock lock(this->_pyGILState, true);
+
+		try
+		{
+			if(this->_nestPreparedFlag)
+			{
+				this->_nestPreparedFlag = false;
+				this->_pyNest["Cleanup"]();
+			}
+
+			// Remove all nodes and return kernel time to 0
+			this->_pyNest["ResetKernel"]();
+
+			// Remove devices registered by the previous network
+			python::dict(this->_pyNRPNest["GetDevMap"]()).clear();
+		}
+		catch(python::error_already_set &)
+		{
+			throw NRPException::logCreate("Failed to reset NEST kernel: " + handle_pyerror());
+		}
+
+		this->clearRegisteredDevices();
+		this->_deviceControllerPtrs.clear();
+	}
+
+	// Rebuild network
+	const auto initRes = this->initialize(this->_initData, deviceLock);
+	if(initRes.at(NestConfig::InitFileExecStatus.data()) == 0)
+		throw NRPException::logCreate("Failed to rebuild NEST network: " + initRes.at(NestConfig::InitFileErrorMsg.data()).get<std::string>());
+
+	return SimulationTime::zero();
+}
+
 nlohmann::json NestJSONServer::formatInitErrorMessage(const std::string &errMsg)
 {
 	return nlohmann::json({{NestConfig::InitFileExecStatus, 0}, {NestConfig::InitFileErrorMsg, errMsg}});
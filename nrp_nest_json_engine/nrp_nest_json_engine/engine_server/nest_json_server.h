@@ -59,6 +59,17 @@ class NestJSONServer
 		virtual nlohmann::json initialize(const nlohmann::json &data, EngineJSONServer::lock_t &deviceLock) override;
 		virtual nlohmann::json shutdown(const nlohmann::json &data) override;
 
+		/*!
+		 * \brief Mark the current network for restoring. As the NEST kernel time cannot be rewound,
+		 * only the freshly initialized network (kernel time 0) can be stored
+		 */
+		virtual nlohmann::json saveSnapshot(const nlohmann::json &data) override;
+
+		/*!
+		 * \brief Reset the NEST kernel and rebuild the network by re-running the initialization with the stored configuration
+		 */
+		virtual SimulationTime restoreSnapshot(const nlohmann::json &data, EngineJSONServer::lock_t &deviceLock) override;
+
 	private:
 		/*!
 		 * \brief Init Flag. Set to true once the server has executed the initialize function
@@ -75,6 +86,16 @@ class NestJSONServer
 		 */
 		bool _nestPreparedFlag = false;
 
+		/*!
+		 * \brief Snapshot Flag. Set to true once saveSnapshot() stored the initial network
+		 */
+		bool _snapshotFlag = false;
+
+		/*!
+		 * \brief Initialization data received by initialize(). Used to rebuild the network on restoreSnapshot()
+		 */
+		nlohmann::json _initData;
+
 		/*!
 		 * \brief Global Python variables
 		 */
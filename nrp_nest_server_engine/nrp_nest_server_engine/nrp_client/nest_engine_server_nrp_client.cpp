@@ -35,6 +35,21 @@
 #include <sys/wait.h>
 #include <sys/prctl.h>
 
+// The Nest server removes lines starting with "import" before executing code, so json is loaded via __import__()
+const std::string_view NestEngineServerNRPClient::BatchExecSource =
+        "__nrp_calls = __import__('json').loads(__nrp_batch)\n"
+        "for __nrp_call in __nrp_calls['inputs']:\n"
+        "    __nrp_kwargs = dict(__nrp_call[1])\n"
+        "    __nrp_args = __nrp_kwargs.pop('args', [])\n"
+        "    getattr(nest, __nrp_call[0])(*__nrp_args, **__nrp_kwargs)\n"
+        "if __nrp_calls['run'] is not None:\n"
+        "    nest.Run(__nrp_calls['run'])\n"
+        "__nrp_out = []\n"
+        "for __nrp_call in __nrp_calls['outputs']:\n"
+        "    __nrp_kwargs = dict(__nrp_call[1])\n"
+        "    __nrp_args = __nrp_kwargs.pop('args', [])\n"
+        "    __nrp_out.append(getattr(nest, __nrp_call[0])(*__nrp_args, **__nrp_kwargs))\n"
+        "__nrp_result = {'out': __nrp_out, 'time': nest.GetKernelStatus('time')}\n";
 
 NestEngineServerNRPClient::NestEngineServerNRPClient(EngineConfigConst::config_storage_t &config, ProcessLauncherInterface::unique_ptr &&launcher)
     : Engine(config, std::move(launcher))
@@ -66,57 +81,24 @@ void NestEngineServerNRPClient::initialize()
 		NRPException::logCreate("Couldn't load param parse fcn: " + handle_pyerror());
 	}
 
-	auto timeout = SimulationTime::max();
-	if(this->engineConfigGeneral()->engineCommandTimeout() > 0.f)
-		timeout = toSimulationTime<float, std::ratio<1,1> >(this->engineConfigGeneral()->engineCommandTimeout());
+	// Wait for server to start, then send init file exactly once
+	this->waitForServerReady(this->engineConfigGeneral()->engineCommandTimeout());
 
-	// Try sending data to given address. Continue until timeout
-	const auto startTime = std::chrono::system_clock::now();
-	bool initSuccess = false;
-	do
-	{
-		// Check that process is still running
-		if(this->_process->getProcessStatus() == ProcessLauncherInterface::ENGINE_RUNNING_STATUS::STOPPED)
-			throw NRPException::logCreate("Nest Engine process stopped unexpectedly before the init file could be sent");
-
-		// Try sending and executing initFile contents
-		RestClient::Response resp;
-		try
-		{
-			resp = RestClient::post(servAddr + "/exec", "application/json", nlohmann::json({{"source", initCode}}).dump());
-		}
-		catch(std::exception &)
-		{
-			// Server unreachable
-			resp.code = 7;
-		}
-
-		// Retry if server still starting up
-		if(resp.code == 7)
-		{
-			std::this_thread::sleep_for(std::chrono::milliseconds(10));
-			continue;
-		}
-
-		// Check received status
-		if(resp.code != 200)
-			throw NRPException::logCreate("Failed to execute init file \"" + this->engineConfig()->nestInitFileName() + "\": " + resp.body);
-		else
-		{
-			initSuccess = true;
-			break;
-		}
-	}
-	while(std::chrono::system_clock::now() - startTime > timeout);
-
-	// Check if timeout reached
-	if(!initSuccess)
-		throw NRPException::logCreate("Failed to initialize Nest server. Received no response before timeout reached");
+	const auto initResp = RestClient::post(servAddr + "/exec", "application/json", nlohmann::json({{"source", initCode}}).dump());
+	if(initResp.code != 200)
+		throw NRPException::logCreate("Failed to execute init file \"" + this->engineConfig()->nestInitFileName() + "\": " + initResp.body);
 
 	// Run Prepare(). runLoopStep() can now use Run() for stepping
 	const auto resp = RestClient::post(servAddr + "/api/Prepare", "text/plain", "");
 	if(resp.code != 200)
 		throw NRPException::logCreate("Failed to run nest.Prepare()");
+
+	// Get initial kernel time. Afterwards, it is updated with every batch
+	const auto timeResp = RestClient::post(servAddr + "/api/GetKernelStatus", "application/json", "[\"time\"]");
+	if(timeResp.code != 200)
+		throw NRPException::logCreate("Failed to get Nest Kernel Status");
+
+	this->_engineTime = toSimulationTime<float, std::milli>(std::stof(timeResp.body));
 }
 
 void NestEngineServerNRPClient::shutdown()
@@ -129,17 +111,18 @@ void NestEngineServerNRPClient::shutdown()
 
 SimulationTime NestEngineServerNRPClient::getEngineTime() const
 {
-	// Get Engine Time from Nest Kernel
-	auto resp = RestClient::post(this->serverAddress() + "/api/GetKernelStatus", "application/json", "[\"time\"]");
-	if(resp.code != 200)
-		throw NRPException::logCreate("Failed to get Nest Kernel Status");
-
-	return toSimulationTime<float, std::milli>(std::stof(resp.body));
+	// Kernel time is reported by every batch, no need to query Nest
+	return this->_engineTime;
 }
 
 void NestEngineServerNRPClient::runLoopStep(SimulationTime timeStep)
 {
-	this->_runStepThread = std::async(std::launch::async, &NestEngineServerNRPClient::runStepFcn, this, timeStep);
+	// Send all inputs received since the last step and fetch the last requested outputs in the same request as the step
+	std::vector<nest_call_t> inputs;
+	inputs.swap(this->_pendingInputs);
+
+	this->_prefetchValid = false;
+	this->_runStepThread = std::async(std::launch::async, &NestEngineServerNRPClient::runStepFcn, this, timeStep, std::move(inputs), this->_outputCalls);
 }
 
 void NestEngineServerNRPClient::waitForStepCompletion(float timeOut)
@@ -157,32 +140,50 @@ void NestEngineServerNRPClient::waitForStepCompletion(float timeOut)
 
 EngineInterface::device_outputs_set_t NestEngineServerNRPClient::requestOutputDeviceCallback(const EngineInterface::device_identifiers_t &deviceIdentifiers)
 {
-	const auto serverAddr = this->serverAddress();
-
-	EngineInterface::device_outputs_set_t retVals;
-	//retVals.reserve(deviceIdentifiers.size());
-
+	std::vector<DeviceIdentifier> outputIDs;
 	for(const auto &devID : deviceIdentifiers)
 	{
 		if(devID.EngineName == this->engineName())
+			outputIDs.push_back(devID);
+	}
+
+	// Check whether the last step already fetched the requested devices
+	const bool usePrefetch = this->_prefetchValid && !this->_runStepThread.valid() && this->_pendingInputs.empty() && outputIDs == this->_outputDeviceIDs;
+	this->_prefetchValid = false;
+
+	std::vector<std::string> outputData;
+	if(usePrefetch)
+		outputData = std::move(this->_prefetchedOutputs);
+	else
+	{
+		// Requested devices changed, or inputs are pending. Fetch all devices in a single request
+		if(outputIDs != this->_outputDeviceIDs)
 		{
-			const auto [call, params] = this->parseName(devID.Name);
+			std::vector<nest_call_t> outputCalls;
+			outputCalls.reserve(outputIDs.size());
+			for(const auto &devID : outputIDs)
+				outputCalls.push_back(this->parseCall(devID.Name));
 
-			auto resp = RestClient::post(serverAddr + "/api/" + call, "application/json", params);
-			if(resp.code != 200)
-			    throw std::runtime_error("Failed to get data for device \"" + devID.Name + "\"");
+			this->_outputDeviceIDs = outputIDs;
+			this->_outputCalls = std::move(outputCalls);
+		}
 
-			retVals.emplace(new NestServerDevice(DeviceIdentifier(devID), resp.body));
+		if(!this->_outputCalls.empty() || !this->_pendingInputs.empty())
+		{
+			outputData = this->execBatch(this->_pendingInputs, std::nullopt, this->_outputCalls);
+			this->_pendingInputs.clear();
 		}
 	}
 
+	EngineInterface::device_outputs_set_t retVals;
+	for(size_t i = 0; i < outputData.size(); ++i)
+		retVals.emplace(new NestServerDevice(DeviceIdentifier(this->_outputDeviceIDs[i]), outputData[i]));
+
 	return retVals;
 }
 
 void NestEngineServerNRPClient::handleInputDevices(const EngineInterface::device_inputs_t &inputDevices)
 {
-	const auto serverAddr = this->serverAddress();
-
 	for(DeviceInterface *const inDev : inputDevices)
 	{
 		// If type cannot be processed, skip it
@@ -193,34 +194,117 @@ void NestEngineServerNRPClient::handleInputDevices(const EngineInterface::device
 		if(inDev->engineName() != this->engineName())
 			continue;
 
-		// Send command along with parameters to nest
-		const auto [call, params] = this->parseName(inDev->name());
-
-		auto resp = RestClient::post(serverAddr + "/api/" + call, "application/json", params);
-		if(resp.code != 200)
-		    throw std::runtime_error("Failed to get data for device \"" + inDev->name() + "\"");
+		// Queue command along with parameters. It is sent with the next step or output request
+		this->_pendingInputs.push_back(this->parseCall(inDev->name()));
 	}
 }
 
-bool NestEngineServerNRPClient::runStepFcn(SimulationTime timestep)
+bool NestEngineServerNRPClient::runStepFcn(SimulationTime timestep, std::vector<nest_call_t> inputs, std::vector<nest_call_t> outputs)
 {
 	// According to the NEST API documentation, Run accepts time to simulate in milliseconds and floating-point format
+	const auto timestepFloatMs = fromSimulationTime<float, std::milli>(timestep);
 
-	auto timestepFloatMs = fromSimulationTime<float, std::milli>(timestep);
-
-	auto resp = RestClient::post(this->serverAddress() + "/api/Run", "application/json", "[" + std::to_string(timestepFloatMs) + "]");
-	if(resp.code != 200)
+	try
+	{
+		this->_prefetchedOutputs = this->execBatch(inputs, timestepFloatMs, outputs);
+		this->_prefetchValid = true;
+	}
+	catch(std::exception &e)
+	{
+		NRPException::logOnce(e);
 		return false;
+	}
 
 	return true;
 }
 
+std::vector<std::string> NestEngineServerNRPClient::execBatch(const std::vector<nest_call_t> &inputs, const std::optional<float> &runTimeMs, const std::vector<nest_call_t> &outputs)
+{
+	nlohmann::json batch;
+	batch["inputs"] = nlohmann::json::array();
+	for(const auto &call : inputs)
+		batch["inputs"].push_back({call.first, call.second});
+
+	batch["run"] = runTimeMs.has_value() ? nlohmann::json(runTimeMs.value()) : nlohmann::json();
+
+	batch["outputs"] = nlohmann::json::array();
+	for(const auto &call : outputs)
+		batch["outputs"].push_back({call.first, call.second});
+
+	// A JSON string literal is also a valid Python string literal
+	const std::string source = "__nrp_batch = " + nlohmann::json(batch.dump()).dump() + "\n" + std::string(BatchExecSource);
+
+	const auto resp = RestClient::post(this->serverAddress() + "/exec", "application/json",
+	                                   nlohmann::json({{"source", source}, {"return", "__nrp_result"}}).dump());
+	if(resp.code != 200)
+		throw NRPException::logCreate("Failed to exchange data with Nest server: " + resp.body);
+
+	const auto result = nlohmann::json::parse(resp.body).at("data");
+
+	this->_engineTime = toSimulationTime<float, std::milli>(result.at("time").get<float>());
+
+	const auto &outData = result.at("out");
+	if(outData.size() != outputs.size())
+		throw NRPException::logCreate("Nest server returned " + std::to_string(outData.size()) + " results for " + std::to_string(outputs.size()) + " devices");
+
+	std::vector<std::string> outputStrs;
+	outputStrs.reserve(outData.size());
+	for(const auto &data : outData)
+		outputStrs.push_back(data.dump());
+
+	return outputStrs;
+}
+
+void NestEngineServerNRPClient::waitForServerReady(float timeout) const
+{
+	const auto probeAddr = this->serverAddress() + "/";
+
+	const auto startTime = std::chrono::steady_clock::now();
+	const auto timeoutDuration = std::chrono::duration<float>(timeout);
+
+	auto probeWait = std::chrono::duration_cast<std::chrono::steady_clock::duration>(_initProbeWait);
+	while(true)
+	{
+		// Check that process is still running
+		if(this->_process->getProcessStatus() == ProcessLauncherInterface::ENGINE_RUNNING_STATUS::STOPPED)
+			throw NRPException::logCreate("Nest Engine process stopped unexpectedly before the server became available");
+
+		// Any HTTP response means the server is up. Codes below 100 are connection errors reported by curl
+		RestClient::Response resp;
+		try
+		{
+			resp = RestClient::get(probeAddr);
+		}
+		catch(std::exception &)
+		{
+			resp.code = -1;
+		}
+
+		if(resp.code >= 100)
+			return;
+
+		// Check if timeout reached
+		const auto elapsed = std::chrono::steady_clock::now() - startTime;
+		if(timeout > 0.f && elapsed >= timeoutDuration)
+			throw NRPException::logCreate("Failed to initialize Nest server. Server did not respond before timeout reached");
+
+		// Wait with exponential backoff, but don't overshoot timeout
+		auto wait = probeWait;
+		if(timeout > 0.f)
+			wait = std::min(wait, std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeoutDuration - elapsed));
+
+		std::this_thread::sleep_for(wait);
+
+		probeWait = std::min(probeWait*2, std::chrono::duration_cast<std::chrono::steady_clock::duration>(_maxProbeWait));
+	}
+}
+
 std::string NestEngineServerNRPClient::serverAddress() const
 {
 	return this->engineConfig()->nestServerHost() + ":" + std::to_string(this->engineConfig()->nestServerPort());
 }
 
-std::tuple<std::string, std::string> NestEngineServerNRPClient::parseName(const std::string &devName) const
+NestEngineServerNRPClient::nest_call_t NestEngineServerNRPClient::parseCall(const std::string &devName) const
 {
 	// The Nest command to execute is stored in the DeviceIdentifier's name
 	// in the format Command(arg1, arg2, ..., kwarg1=dat1, kwarg2=dat2, ...). Extract the command
@@ -230,5 +314,5 @@ std::tuple<std::string, std::string> NestEngineServerNRPClient::parseName(const
 		throw NRPException::logCreate("Invalid device Name. Misconfigured parentheses in device \"" + devName + "\"");
 
 	boost::python::str pyArgJson(this->_parseFcn(devName));
-	return std::make_tuple(devName.substr(0, cmdPos), (std::string)boost::python::extract<std::string>(pyArgJson));
+	return nest_call_t(devName.substr(0, cmdPos), nlohmann::json::parse((std::string)boost::python::extract<std::string>(pyArgJson)));
 }
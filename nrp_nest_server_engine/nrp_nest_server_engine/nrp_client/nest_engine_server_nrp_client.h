@@ -29,7 +29,10 @@
 
 #include "nrp_nest_server_engine/config/nest_server_config.h"
 
+#include <chrono>
 #include <future>
+#include <nlohmann/json.hpp>
+#include <optional>
 #include <unistd.h>
 
 /*!
@@ -63,6 +66,27 @@ class NestEngineServerNRPClient
 		 */
 		static constexpr size_t _killWait = 10;
 
+		/*!
+		 * \brief Initial wait between two server readiness probes. Doubled after each failed probe, up to _maxProbeWait
+		 */
+		static constexpr std::chrono::milliseconds _initProbeWait = std::chrono::milliseconds(10);
+
+		/*!
+		 * \brief Maximum wait between two server readiness probes
+		 */
+		static constexpr std::chrono::milliseconds _maxProbeWait = std::chrono::milliseconds(1000);
+
+		/*!
+		 * \brief A single Nest API call, consisting of the function name and its JSON encoded parameters
+		 */
+		using nest_call_t = std::pair<std::string, nlohmann::json>;
+
+		/*!
+		 * \brief Python code executed by the Nest server's /exec route to process a batch of calls.
+		 * Runs all input calls, an optional simulation step and all output calls, then reports the results along with the kernel time
+		 */
+		static const std::string_view BatchExecSource;
+
 	public:
 		NestEngineServerNRPClient(EngineConfigConst::config_storage_t &config, ProcessLauncherInterface::unique_ptr &&launcher);
 		virtual ~NestEngineServerNRPClient() override;
@@ -84,12 +108,60 @@ class NestEngineServerNRPClient
 		std::future<bool> _runStepThread;
 		nest_devices_t _nestDevs;
 
-		bool runStepFcn(SimulationTime timestep);
+		/*!
+		 * \brief Input calls received since the last batch was sent. Sent along with the next step or output request
+		 */
+		std::vector<nest_call_t> _pendingInputs;
+
+		/*!
+		 * \brief Names of the output devices requested last. Their data is fetched at the end of each step
+		 */
+		std::vector<DeviceIdentifier> _outputDeviceIDs;
+
+		/*!
+		 * \brief Calls to retrieve the data of _outputDeviceIDs
+		 */
+		std::vector<nest_call_t> _outputCalls;
+
+		/*!
+		 * \brief Output device data fetched by the last step, in the order of _outputDeviceIDs
+		 */
+		std::vector<std::string> _prefetchedOutputs;
+
+		/*!
+		 * \brief Is _prefetchedOutputs up to date
+		 */
+		bool _prefetchValid = false;
+
+		/*!
+		 * \brief Nest kernel time, as reported by the last batch
+		 */
+		SimulationTime _engineTime = SimulationTime::zero();
+
+		bool runStepFcn(SimulationTime timestep, std::vector<nest_call_t> inputs, std::vector<nest_call_t> outputs);
 		std::string serverAddress() const;
 
-		boost::python::object _parseFcn;
+		/*!
+		 * \brief Wait until the Nest server accepts requests. Probes the server with exponential backoff
+		 * \param timeout Maximum time to wait (in seconds). If <= 0, wait indefinitely
+		 */
+		void waitForServerReady(float timeout) const;
+
+		/*!
+		 * \brief Send a batch of calls to the Nest server in a single request
+		 * \param inputs Calls to execute first
+		 * \param runTimeMs If set, run the simulation for this amount of milliseconds after the inputs were processed
+		 * \param outputs Calls whose results should be returned
+		 * \return Returns JSON encoded results of outputs, in the same order
+		 */
+		std::vector<std::string> execBatch(const std::vector<nest_call_t> &inputs, const std::optional<float> &runTimeMs, const std::vector<nest_call_t> &outputs);
 
-		std::tuple<std::string, std::string> parseName(const std::string &devName) const;
+		/*!
+		 * \brief Convert a device name into a Nest call
+		 */
+		nest_call_t parseCall(const std::string &devName) const;
+
+		boost::python::object _parseFcn;
 };
 
 using NestEngineServerNRPClientLauncher = NestEngineServerNRPClient::EngineLauncher<NestServerConfig::DefEngineType>;
@@ -59,12 +59,24 @@ bool PythonJSONServer::shutdownFlag() const
 
 SimulationTime PythonJSONServer::runLoopStep(SimulationTime timestep)
 {
+	// Take device data received since the last step before acquiring the GIL
+	nlohmann::json deviceData = nlohmann::json::object();
+	{
+		std::lock_guard<std::mutex> storeLock(this->_deviceStoreLock);
+		deviceData.swap(this->_pendingDeviceData);
+	}
+
 	PythonGILLock lock(this->_pyGILState, true);
 
 	try
 	{
 		PyEngineScript &script = python::extract<PyEngineScript&>(this->_pyEngineScript);
-		return script.runLoop(timestep);
+		script.handleDeviceData(deviceData);
+
+		const auto simTime = script.runLoop(timestep);
+
+		this->publishDevices(script);
+		return simTime;
 	}
 	catch(python::error_already_set &)
 	{
@@ -136,6 +148,8 @@ nlohmann::json PythonJSONServer::initialize(const nlohmann::json &data, EngineJS
 	{
 		PyEngineScript &script = python::extract<PyEngineScript&>(this->_pyEngineScript);
 		script.initialize();
+
+		this->publishDevices(script);
 	}
 	catch(python::error_already_set &)
 	{
@@ -178,9 +192,59 @@ nlohmann::json PythonJSONServer::shutdown(const nlohmann::json &)
 	this->clearRegisteredDevices();
 	this->_deviceControllerPtrs.clear();
 
+	{
+		std::lock_guard<std::mutex> storeLock(this->_deviceStoreLock);
+		this->_deviceStore = nlohmann::json::object();
+		this->_pendingDeviceData = nlohmann::json::object();
+	}
+
+	return nlohmann::json();
+}
+
+nlohmann::json PythonJSONServer::saveSnapshot(const nlohmann::json &)
+{
+	if(!this->_initRunFlag)
+		throw NRPException::logCreate("Cannot save a python script snapshot before initialization");
+
+	PythonGILLock lock(this->_pyGILState, true);
+
+	try
+	{
+		PyEngineScript &script = python::extract<PyEngineScript&>(this->_pyEngineScript);
+		script.saveSnapshot(this->_pyEngineScript);
+	}
+	catch(python::error_already_set &)
+	{
+		throw NRPException::logCreate("Failed to save python script snapshot: " + handle_pyerror());
+	}
+
 	return nlohmann::json();
 }
 
+SimulationTime PythonJSONServer::restoreSnapshot(const nlohmann::json &, EngineJSONServer::lock_t &)
+{
+	PythonGILLock lock(this->_pyGILState, true);
+
+	try
+	{
+		PyEngineScript &script = python::extract<PyEngineScript&>(this->_pyEngineScript);
+		const auto simTime = script.restoreSnapshot(this->_pyEngineScript);
+
+		// Data received before the restore refers to the discarded state
+		{
+			std::lock_guard<std::mutex> storeLock(this->_deviceStoreLock);
+			this->_pendingDeviceData = nlohmann::json::object();
+		}
+
+		this->publishDevices(script);
+		return simTime;
+	}
+	catch(python::error_already_set &)
+	{
+		throw NRPException::logCreate("Failed to restore python script snapshot: " + handle_pyerror());
+	}
+}
+
 PyEngineScript *PythonJSONServer::registerScript(const boost::python::object &pythonScript)
 {
 	assert(PythonJSONServer::_registrationPyServer != nullptr);
@@ -202,14 +266,52 @@ nlohmann::json PythonJSONServer::formatInitErrorMessage(const std::string &errMs
 	return nlohmann::json({{PythonConfig::InitFileExecStatus, 0}, {PythonConfig::InitFileErrorMsg, errMsg}});
 }
 
+void PythonJSONServer::publishDevices(PyEngineScript &script)
+{
+	// Serialize outside of the store lock, so that device reads only wait for the swap
+	nlohmann::json devices = script.serializeDevices();
+
+	std::lock_guard<std::mutex> storeLock(this->_deviceStoreLock);
+	this->_deviceStore.swap(devices);
+}
+
 nlohmann::json PythonJSONServer::getDeviceData(const nlohmann::json &reqData)
 {
-	PythonGILLock lock(this->_pyGILState, true);
-	return this->EngineJSONServer::getDeviceData(reqData);
+	std::lock_guard<std::mutex> storeLock(this->_deviceStoreLock);
+
+	nlohmann::json jres;
+	for(auto curRequest = reqData.begin(); curRequest != reqData.end(); ++curRequest)
+	{
+		const auto &devName = curRequest.key();
+		const auto devData = this->_deviceStore.find(devName);
+
+		// If device not found, return empty data
+		if(devData != this->_deviceStore.end())
+			jres[devName] = *devData;
+		else
+			jres[devName] = nlohmann::json();
+	}
+
+	return jres;
 }
 
 nlohmann::json PythonJSONServer::setDeviceData(const nlohmann::json &reqData)
 {
-	PythonGILLock lock(this->_pyGILState, true);
-	return this->EngineJSONServer::setDeviceData(reqData);
+	std::lock_guard<std::mutex> storeLock(this->_deviceStoreLock);
+
+	nlohmann::json jres;
+	for(auto devData = reqData.begin(); devData != reqData.end(); ++devData)
+	{
+		const auto &devName = devData.key();
+		this->_pendingDeviceData[devName] = devData.value();
+
+		// Received data is visible to readers right away, as it was when devices were set directly
+		const auto storedData = this->_deviceStore.find(devName);
+		if(storedData != this->_deviceStore.end())
+			*storedData = devData.value();
+
+		jres[devName] = "";
+	}
+
+	return jres;
 }
@@ -30,6 +30,8 @@
 #include "nrp_python_json_engine/engine_server/python_engine_json_device_controller.h"
 
 #include <boost/python.hpp>
+#include <list>
+#include <mutex>
 
 class PyEngineScript;
 
@@ -56,6 +58,8 @@ class PythonJSONServer
 		virtual SimulationTime runLoopStep(SimulationTime timeStep) override;
 		virtual nlohmann::json initialize(const nlohmann::json &data, EngineJSONServer::lock_t &deviceLock) override;
 		virtual nlohmann::json shutdown(const nlohmann::json &data) override;
+		virtual nlohmann::json saveSnapshot(const nlohmann::json &data) override;
+		virtual SimulationTime restoreSnapshot(const nlohmann::json &data, EngineJSONServer::lock_t &deviceLock) override;
 
 		/*!
 		 * \brief Register pointer to python script
@@ -106,6 +110,29 @@ class PythonJSONServer
 		 */
 		PyGILState_STATE _pyGILState;
 
+		/*!
+		 * \brief Protects _deviceStore and _pendingDeviceData. Only held while copying JSON data.
+		 * May be acquired while holding the GIL, but the GIL must never be acquired while holding it
+		 */
+		std::mutex _deviceStoreLock;
+
+		/*!
+		 * \brief Device data published by the script after initialization and after every loop step.
+		 * getDeviceData() reads from here without acquiring the GIL
+		 */
+		nlohmann::json _deviceStore = nlohmann::json::object();
+
+		/*!
+		 * \brief Device data received by setDeviceData(). Passed on to the script at the start of the next loop step
+		 */
+		nlohmann::json _pendingDeviceData = nlohmann::json::object();
+
+		/*!
+		 * \brief Replace _deviceStore with the current state of all script devices. Must be called with the GIL held
+		 * \param script Script whose devices to publish
+		 */
+		void publishDevices(PyEngineScript &script);
+
 		/*!
 		 * \brief Creates an error message to be returned to the main NRP process
 		 * \param errMsg Error text
@@ -113,8 +140,18 @@ class PythonJSONServer
 		 */
 		static nlohmann::json formatInitErrorMessage(const std::string &errMsg);
 
+		/*!
+		 * \brief Retrieves the device data published at the end of the last loop step. Does not acquire the GIL
+		 * \param reqData A JSON object containing device names
+		 * \return Device data, formatted as a JSON object
+		 */
 		nlohmann::json getDeviceData(const nlohmann::json &reqData) override;
 
+		/*!
+		 * \brief Queues device data for the next loop step. Does not acquire the GIL
+		 * \param reqData A JSON object containing device names linked to the individual device's data
+		 * \return Execution result
+		 */
 		nlohmann::json setDeviceData(const nlohmann::json &reqData) override;
 
 };
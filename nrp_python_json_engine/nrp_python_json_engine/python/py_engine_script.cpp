@@ -50,7 +50,7 @@ void PyEngineScript::registerDevice(std::string deviceName)
 	        newController(new PythonEngineJSONDeviceController<PyObjectDevice>(DeviceIdentifier(deviceName, "", PyObjectDevice::TypeName.data())));
 
 	//std::cout << "Adding device controller for \"" + deviceName + "\"\n";
-	this->_deviceControllers.push_back(newController);
+	this->_deviceControllers.emplace(deviceName, newController);
 	this->_nameDeviceMap.emplace(deviceName, &(newController->data()));
 
 	//std::cout << "Adding device \"" + deviceName + "\" to server\n";
@@ -75,3 +75,71 @@ void PyEngineScript::setPythonJSONServer(PythonJSONServer *pServer)
 {
 	this->_pServer = pServer;
 }
+
+void PyEngineScript::handleDeviceData(const nlohmann::json &deviceData)
+{
+	for(auto devData = deviceData.begin(); devData != deviceData.end(); ++devData)
+	{
+		auto controllerIt = this->_deviceControllers.find(devData.key());
+		if(controllerIt == this->_deviceControllers.end())
+			continue;
+
+		try
+		{
+			controllerIt->second->handleDeviceData(devData);
+		}
+		catch(std::exception &e)
+		{
+			throw NRPException::logCreate(e, "Couldn't handle device " + devData.key());
+		}
+	}
+}
+
+nlohmann::json PyEngineScript::serializeDevices()
+{
+	nlohmann::json devices = nlohmann::json::object();
+	for(auto &controller : this->_deviceControllers)
+	{
+		auto devData = controller.second->getDeviceInformation();
+		for(auto devIt = devData.begin(); devIt != devData.end(); ++devIt)
+			devices[devIt.key()] = std::move(devIt.value());
+	}
+
+	return devices;
+}
+
+void PyEngineScript::saveSnapshot(const boost::python::object &self)
+{
+	boost::python::object deepcopy = boost::python::import("copy").attr("deepcopy");
+
+	this->_snapshotAttrs = deepcopy(self.attr("__dict__"));
+
+	this->_snapshotDevices = boost::python::dict();
+	for(const auto &device : this->_nameDeviceMap)
+		this->_snapshotDevices[device.first] = deepcopy(*(device.second));
+
+	this->_snapshotTime = this->_time;
+}
+
+SimulationTime PyEngineScript::restoreSnapshot(const boost::python::object &self)
+{
+	if(this->_snapshotAttrs.is_none())
+		throw NRPException::logCreate("No snapshot of the python script has been saved");
+
+	// Copy stored state again, so that the snapshot can be restored multiple times
+	boost::python::object deepcopy = boost::python::import("copy").attr("deepcopy");
+
+	boost::python::object attrs = self.attr("__dict__");
+	attrs.attr("clear")();
+	attrs.attr("update")(deepcopy(this->_snapshotAttrs));
+
+	for(auto &device : this->_nameDeviceMap)
+	{
+		if(this->_snapshotDevices.has_key(device.first))
+			*(device.second) = deepcopy(this->_snapshotDevices[device.first]);
+	}
+
+	this->_time = this->_snapshotTime;
+
+	return this->_time;
+}
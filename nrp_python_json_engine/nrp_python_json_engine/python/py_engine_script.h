@@ -93,6 +93,31 @@ class PyEngineScript
 		 */
 		void setPythonJSONServer(PythonJSONServer *pServer);
 
+		/*!
+		 * \brief Pass device data received by the server on to the registered devices. Must be called with the GIL held
+		 * \param deviceData JSON object mapping device names to their serialized data. Unknown devices are ignored
+		 */
+		void handleDeviceData(const nlohmann::json &deviceData);
+
+		/*!
+		 * \brief Serialize all registered devices. Must be called with the GIL held
+		 * \return Returns a JSON object mapping device names to their serialized data
+		 */
+		nlohmann::json serializeDevices();
+
+		/*!
+		 * \brief Store a deep copy of the script attributes, device data and engine time. Overwrites any previous snapshot
+		 * \param self Python object of this script
+		 */
+		void saveSnapshot(const boost::python::object &self);
+
+		/*!
+		 * \brief Return to the state stored by saveSnapshot()
+		 * \param self Python object of this script
+		 * \return Returns the engine time of the restored state
+		 */
+		SimulationTime restoreSnapshot(const boost::python::object &self);
+
 	protected:
 		/*!
 		 * \brief Main script loop. Will run for timestep seconds
@@ -112,14 +137,29 @@ class PyEngineScript
 		PythonJSONServer *_pServer = nullptr;
 
 		/*!
-		 * \brief Device Controllers
+		 * \brief Device Controllers, mapped by device name
 		 */
-		std::list<EngineJSONDeviceControllerInterface::shared_ptr> _deviceControllers;
+		std::map<std::string, EngineJSONDeviceControllerInterface::shared_ptr> _deviceControllers;
 
 		/*!
 		 * \brief Map from keyword to device data
 		 */
 		std::map<std::string, boost::python::object*> _nameDeviceMap;
+
+		/*!
+		 * \brief Script attributes stored by saveSnapshot(). None if no snapshot was saved
+		 */
+		boost::python::object _snapshotAttrs;
+
+		/*!
+		 * \brief Device data stored by saveSnapshot()
+		 */
+		boost::python::dict _snapshotDevices;
+
+		/*!
+		 * \brief Engine time stored by saveSnapshot()
+		 */
+		SimulationTime _snapshotTime = SimulationTime::zero();
 };
 
 using PyEngineScriptSharedPtr = PyEngineScript::shared_ptr;
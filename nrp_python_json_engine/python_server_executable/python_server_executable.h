@@ -56,6 +56,12 @@ class PythonServerExecutable
 		 */
 		static PythonServerExecutable &resetInstance(int argc, char *argv[]);
 
+		/*!
+		 * \brief Initialize Python and import the modules listed in PooledFork::PreloadModulesEnvVar.
+		 * Used by warm pool processes while they wait for their start parameters
+		 */
+		static void preloadModules();
+
 		/*!
 		 * \brief Shutdown the server. Must be executed before the Python Environment is finalized to prevent segfaults
 		 */
@@ -0,0 +1,243 @@
+//
+// NRP Core - Backend infrastructure to synchronize simulations
+//
+// Copyright 2020 Michael Zechmair
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This project has received funding from the European Union’s Horizon 2020
+// Framework Programme for Research and Innovation under the Specific Grant
+// Agreement No. 945539 (Human Brain Project SGA3).
+//
+
+
+#include "nrp_server/experiment_admission_control.h"
+
+#include "nrp_general_library/config/engine_config.h"
+#include "nrp_general_library/config/simulation_config.h"
+
+#include <algorithm>
+#include <thread>
+#include <unistd.h>
+
+static uint32_t limitToCapacity(int32_t limit)
+{	return limit < 0 ? ExperimentResources::Unlimited : static_cast<uint32_t>(limit);	}
+
+ExperimentResources ExperimentResources::fromSimulationConfig(const nlohmann::json &simConfig, uint32_t engineMemoryMB)
+{
+	// The simulation loop itself occupies one core
+	ExperimentResources resources;
+	resources.Cores = 1;
+
+	const auto engineCfgsIt = simConfig.find(SimulationConfigConst::EngineSimulatorsConfig.m_data);
+	if(engineCfgsIt == simConfig.end())
+		return resources;
+
+	for(const auto &engineCfg : *engineCfgsIt)
+	{
+		++resources.Engines;
+		resources.MemoryMB += engineMemoryMB;
+
+		const auto affinityIt = engineCfg.find(EngineConfigConst::EngineCPUAffinity.m_data);
+		const size_t numCPUs = affinityIt != engineCfg.end() && affinityIt->is_array() ? affinityIt->size() : 0;
+		resources.Cores += std::max<uint32_t>(static_cast<uint32_t>(numCPUs), 1);
+	}
+
+	return resources;
+}
+
+ExperimentResources ExperimentResources::serverCapacity(const ServerConfig &config)
+{
+	ExperimentResources capacity;
+
+	capacity.Cores = limitToCapacity(config.serverMaxCores());
+	if(config.serverMaxCores() < 0)
+		capacity.Cores = std::max(std::thread::hardware_concurrency(), 1u);
+
+	capacity.MemoryMB = limitToCapacity(config.serverMaxMemory());
+	if(config.serverMaxMemory() < 0)
+	{
+		const long pages = sysconf(_SC_PHYS_PAGES);
+		const long pageSize = sysconf(_SC_PAGE_SIZE);
+		if(pages > 0 && pageSize > 0)
+			capacity.MemoryMB = static_cast<uint32_t>(std::min<uint64_t>(static_cast<uint64_t>(pages) * pageSize / (1024*1024), Unlimited - 1));
+	}
+
+	capacity.Engines = limitToCapacity(config.serverMaxEngines());
+
+	return capacity;
+}
+
+nlohmann::json ExperimentResources::toJSON() const
+{
+	return nlohmann::json({{"cores", this->Cores}, {"memory_mb", this->MemoryMB}, {"engines", this->Engines}});
+}
+
+ExperimentAdmissionControl::ExperimentAdmissionControl(const ExperimentResources &capacity, int32_t maxExperiments, int32_t maxQueued)
+    : _capacity(capacity),
+      _maxExperiments(maxExperiments < 0 ? std::numeric_limits<size_t>::max() : static_cast<size_t>(maxExperiments)),
+      _maxQueued(maxQueued < 0 ? std::numeric_limits<size_t>::max() : static_cast<size_t>(maxQueued))
+{}
+
+ExperimentAdmissionControl::ADMISSION_STATE ExperimentAdmissionControl::requestAdmission(const std::string &expName, const ExperimentResources &resources)
+{
+	// Experiments that could never run would block the queue indefinitely
+	if(resources.Cores > this->_capacity.Cores || resources.MemoryMB > this->_capacity.MemoryMB || resources.Engines > this->_capacity.Engines
+	        || this->_maxExperiments == 0)
+		return REJECTED;
+
+	lock_t lock(this->_lock);
+
+	if(this->_admitted.find(expName) != this->_admitted.end())
+		return REJECTED;
+
+	const auto queueIt = std::find_if(this->_queue.begin(), this->_queue.end(), [&expName](const auto &queued) { return queued.first == expName; });
+	if(queueIt != this->_queue.end())
+		return REJECTED;
+
+	// Only skip the queue if no other experiment is waiting
+	if(this->_queue.empty() && this->fitsAvailable(resources, lock))
+	{
+		this->admit(expName, resources, lock);
+		return ADMITTED;
+	}
+
+	if(this->_queue.size() >= this->_maxQueued)
+		return REJECTED;
+
+	this->_queue.emplace_back(expName, resources);
+	return QUEUED;
+}
+
+std::vector<std::string> ExperimentAdmissionControl::releaseExperiment(const std::string &expName)
+{
+	std::vector<std::string> admitted;
+	lock_t lock(this->_lock);
+
+	const auto expIt = this->_admitted.find(expName);
+	if(expIt != this->_admitted.end())
+	{
+		this->_reserved.Cores    -= expIt->second.Cores;
+		this->_reserved.MemoryMB -= expIt->second.MemoryMB;
+		this->_reserved.Engines  -= expIt->second.Engines;
+
+		this->_admitted.erase(expIt);
+	}
+	else
+	{
+		this->_queue.remove_if([&expName](const auto &queued) { return queued.first == expName; });
+	}
+
+	// Admit waiting experiments in order until the next one doesn't fit
+	while(!this->_queue.empty() && this->fitsAvailable(this->_queue.front().second, lock))
+	{
+		auto &next = this->_queue.front();
+		this->admit(next.first, next.second, lock);
+		admitted.push_back(std::move(next.first));
+
+		this->_queue.pop_front();
+	}
+
+	return admitted;
+}
+
+bool ExperimentAdmissionControl::isAdmitted(const std::string &expName) const
+{
+	lock_t lock(this->_lock);
+	return this->_admitted.find(expName) != this->_admitted.end();
+}
+
+int32_t ExperimentAdmissionControl::queuePosition(const std::string &expName) const
+{
+	lock_t lock(this->_lock);
+
+	int32_t pos = 0;
+	for(const auto &queued : this->_queue)
+	{
+		if(queued.first == expName)
+			return pos;
+
+		++pos;
+	}
+
+	return -1;
+}
+
+ExperimentResources ExperimentAdmissionControl::experimentResources(const std::string &expName) const
+{
+	lock_t lock(this->_lock);
+
+	const auto expIt = this->_admitted.find(expName);
+	if(expIt != this->_admitted.end())
+		return expIt->second;
+
+	for(const auto &queued : this->_queue)
+	{
+		if(queued.first == expName)
+			return queued.second;
+	}
+
+	return ExperimentResources();
+}
+
+const ExperimentResources &ExperimentAdmissionControl::capacity() const
+{
+	return this->_capacity;
+}
+
+ExperimentResources ExperimentAdmissionControl::availableResources() const
+{
+	lock_t lock(this->_lock);
+
+	ExperimentResources available;
+	available.Cores    = this->_capacity.Cores - this->_reserved.Cores;
+	available.MemoryMB = this->_capacity.MemoryMB - this->_reserved.MemoryMB;
+	available.Engines  = this->_capacity.Engines - this->_reserved.Engines;
+
+	return available;
+}
+
+std::vector<std::string> ExperimentAdmissionControl::admittedExperiments() const
+{
+	lock_t lock(this->_lock);
+
+	std::vector<std::string> names;
+	names.reserve(this->_admitted.size());
+	for(const auto &exp : this->_admitted)
+		names.push_back(exp.first);
+
+	return names;
+}
+
+size_t ExperimentAdmissionControl::numQueued() const
+{
+	lock_t lock(this->_lock);
+	return this->_queue.size();
+}
+
+bool ExperimentAdmissionControl::fitsAvailable(const ExperimentResources &resources, const lock_t&) const
+{
+	return this->_admitted.size() < this->_maxExperiments
+	        && resources.Cores <= this->_capacity.Cores - this->_reserved.Cores
+	        && resources.MemoryMB <= this->_capacity.MemoryMB - this->_reserved.MemoryMB
+	        && resources.Engines <= this->_capacity.Engines - this->_reserved.Engines;
+}
+
+void ExperimentAdmissionControl::admit(const std::string &expName, const ExperimentResources &resources, const lock_t&)
+{
+	this->_reserved.Cores    += resources.Cores;
+	this->_reserved.MemoryMB += resources.MemoryMB;
+	this->_reserved.Engines  += resources.Engines;
+
+	this->_admitted.emplace(expName, resources);
+}
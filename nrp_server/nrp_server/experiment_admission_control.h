@@ -0,0 +1,189 @@
+/* * NRP Core - Backend infrastructure to synchronize simulations
+ *
+ * Copyright 2020 Michael Zechmair
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This project has received funding from the European Union’s Horizon 2020
+ * Framework Programme for Research and Innovation under the Specific Grant
+ * Agreement No. 945539 (Human Brain Project SGA3).
+ */
+
+
+#ifndef EXPERIMENT_ADMISSION_CONTROL_H
+#define EXPERIMENT_ADMISSION_CONTROL_H
+
+#include "nrp_simulation/config/server_config.h"
+
+#include <limits>
+#include <list>
+#include <map>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+/*!
+ * \brief Resources occupied by a single experiment
+ */
+struct ExperimentResources
+{
+	/*!
+	 * \brief Value used for capacities without a limit
+	 */
+	static constexpr uint32_t Unlimited = std::numeric_limits<uint32_t>::max();
+
+	uint32_t Cores = 0;
+	uint32_t MemoryMB = 0;
+	uint32_t Engines = 0;
+
+	/*!
+	 * \brief Estimate an experiment's requirements from its simulation configuration.
+	 * Each engine occupies the CPUs listed in its EngineCPUAffinity, or a single core if none are set.
+	 * The simulation loop occupies one additional core
+	 * \param simConfig Simulation configuration JSON
+	 * \param engineMemoryMB Estimated memory of a single engine
+	 */
+	static ExperimentResources fromSimulationConfig(const nlohmann::json &simConfig, uint32_t engineMemoryMB);
+
+	/*!
+	 * \brief Get the resources the server may hand out to experiments
+	 */
+	static ExperimentResources serverCapacity(const ServerConfig &config);
+
+	nlohmann::json toJSON() const;
+};
+
+/*!
+ * \brief Decides which experiments may run concurrently without oversubscribing the server.
+ * Requests that don't fit into the remaining resources are queued and admitted in FIFO order once resources are released.
+ * The queue is strictly ordered so that large experiments are not starved by smaller ones
+ */
+class ExperimentAdmissionControl
+{
+		using mutex_t = std::mutex;
+		using lock_t = std::unique_lock<mutex_t>;
+
+	public:
+		enum ADMISSION_STATE
+		{	ADMITTED, QUEUED, REJECTED	};
+
+		/*!
+		 * \brief Constructor
+		 * \param capacity Resources available to all experiments
+		 * \param maxExperiments Maximum number of concurrently running experiments. -1 if unlimited
+		 * \param maxQueued Maximum number of waiting experiments. -1 if unlimited
+		 */
+		ExperimentAdmissionControl(const ExperimentResources &capacity, int32_t maxExperiments, int32_t maxQueued);
+
+		/*!
+		 * \brief Request resources for an experiment.
+		 * Requests are rejected if the experiment is already known, if it could never fit into the server's capacity, or if the queue is full
+		 * \param expName Experiment name
+		 * \param resources Resources required by experiment
+		 * \return Returns ADMITTED if the experiment may start immediately, QUEUED if it must wait, REJECTED otherwise
+		 */
+		ADMISSION_STATE requestAdmission(const std::string &expName, const ExperimentResources &resources);
+
+		/*!
+		 * \brief Release an experiment's resources, or remove it from the queue
+		 * \param expName Experiment name
+		 * \return Returns queued experiments that were admitted with the released resources, in admission order
+		 */
+		std::vector<std::string> releaseExperiment(const std::string &expName);
+
+		/*!
+		 * \brief Check whether an experiment is currently admitted
+		 */
+		bool isAdmitted(const std::string &expName) const;
+
+		/*!
+		 * \brief Get position of experiment in queue
+		 * \return Returns position starting at 0, or -1 if the experiment is not queued
+		 */
+		int32_t queuePosition(const std::string &expName) const;
+
+		/*!
+		 * \brief Get resources requested by an admitted or queued experiment
+		 * \return Returns empty resources if the experiment is unknown
+		 */
+		ExperimentResources experimentResources(const std::string &expName) const;
+
+		/*!
+		 * \brief Get resources available to all experiments
+		 */
+		const ExperimentResources &capacity() const;
+
+		/*!
+		 * \brief Get resources not yet occupied by admitted experiments
+		 */
+		ExperimentResources availableResources() const;
+
+		/*!
+		 * \brief Get names of admitted experiments
+		 */
+		std::vector<std::string> admittedExperiments() const;
+
+		/*!
+		 * \brief Get number of waiting experiments
+		 */
+		size_t numQueued() const;
+
+	private:
+		/*!
+		 * \brief Total resources
+		 */
+		const ExperimentResources _capacity;
+
+		/*!
+		 * \brief Maximum number of running experiments
+		 */
+		const size_t _maxExperiments;
+
+		/*!
+		 * \brief Maximum number of waiting experiments
+		 */
+		const size_t _maxQueued;
+
+		/*!
+		 * \brief Lock for all containers below. Only held for bookkeeping, never while launching or stopping experiments
+		 */
+		mutable mutex_t _lock;
+
+		/*!
+		 * \brief Resources occupied by admitted experiments
+		 */
+		ExperimentResources _reserved;
+
+		/*!
+		 * \brief Admitted experiments
+		 */
+		std::map<std::string, ExperimentResources> _admitted;
+
+		/*!
+		 * \brief Waiting experiments, in request order
+		 */
+		std::list<std::pair<std::string, ExperimentResources>> _queue;
+
+		/*!
+		 * \brief Check whether the given resources fit into the unreserved capacity
+		 */
+		bool fitsAvailable(const ExperimentResources &resources, const lock_t &lock) const;
+
+		/*!
+		 * \brief Reserve resources for an experiment
+		 */
+		void admit(const std::string &expName, const ExperimentResources &resources, const lock_t &lock);
+};
+
+#endif // EXPERIMENT_ADMISSION_CONTROL_H
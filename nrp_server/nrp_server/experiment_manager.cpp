@@ -22,14 +22,34 @@
 
 #include "nrp_server/experiment_manager.h"
 
+#include "nrp_general_library/process_launchers/launch_commands/basic_fork.h"
+#include "nrp_general_library/utils/nrp_metrics.h"
 #include "nrp_general_library/utils/zip_container.h"
 #include "nrp_simulation/server/simulation_server.h"
 
-ExperimentManager::ExperimentManager(const ServerConfigConstSharedPtr &config)
+#include <fstream>
+#include <limits>
+#include <spdlog/spdlog.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+ExperimentManager::RunningExperimentData::RunningExperimentData(pid_t pid, PipeCommunication &&comm)
+    : PID(pid),
+      PComm(std::move(comm))
+{}
+
+ExperimentManager::ExperimentManager(const ServerConfigConstSharedPtr &config, const MainProcessLauncherManagerConstSharedPtr &processLaunchers, const EngineLauncherManagerSharedPtr &engineLaunchers)
     : _config(config),
+      _processLaunchers(processLaunchers),
+      _engineLaunchers(engineLaunchers),
+      _admission(ExperimentResources::serverCapacity(*config), config->maxNumExperiments(), config->maxQueuedExperiments()),
       _router(ExperimentManager::setupServerRoutes(this)),
       _server(Pistache::Address(config->serverAddress()))
 {
+	this->_monitorRunning = true;
+	this->_monitorThread = std::thread(&ExperimentManager::monitorExperiments, this);
+
 	this->_server.setHandler(this->_router.handler());
 	this->startServerAsync();
 }
@@ -37,6 +57,16 @@ ExperimentManager::ExperimentManager(const ServerConfigConstSharedPtr &config)
 ExperimentManager::~ExperimentManager()
 {
 	this->shutdownServer();
+
+	this->_monitorRunning = false;
+	if(this->_monitorThread.joinable())
+		this->_monitorThread.join();
+
+	// Stop remaining experiments. No other threads access _experiments anymore
+	for(const auto &exp : this->_experiments)
+		ExperimentManager::stopExperimentProcess(exp.second);
+
+	this->_experiments.clear();
 }
 
 void ExperimentManager::startServerAsync()
@@ -62,15 +92,181 @@ bool ExperimentManager::isServerRunning() const
 	return this->_serverRunning;
 }
 
-void ExperimentManager::shutdownExperiment(const exp_map_t::iterator &expIt, const lock_t &expLock)
+ExperimentManager::lock_t ExperimentManager::acquireExperimentLock()
+{
+	return lock_t(this->_experimentLock);
+}
+
+void ExperimentManager::shutdownExperiment(const std::string &experimentName, const lock_t &expLock)
+{
+	const auto expIt = this->_experiments.find(experimentName);
+	if(expIt != this->_experiments.end())
+		return this->shutdownExperiment(expIt, expLock);
+
+	// Experiment is still waiting for resources. Removing it may admit the ones queued behind it
+	auto admitted = this->_admission.releaseExperiment(experimentName);
+	this->_pendingLaunches.insert(this->_pendingLaunches.end(), std::make_move_iterator(admitted.begin()), std::make_move_iterator(admitted.end()));
+}
+
+const ExperimentAdmissionControl &ExperimentManager::admissionControl() const
+{
+	return this->_admission;
+}
+
+void ExperimentManager::shutdownExperiment(const exp_map_t::iterator &expIt, const lock_t &)
 {
 	PipeCommPacket pack;
 	pack.ID = -1;
 	pack.Command = SimulationServerConst::ShutdownCommand.data();
 
-	const auto packID = expIt->second.PComm.sendPacket(std::move(pack));
+	// The monitor thread releases the experiment's resources once the process has quit
+	expIt->second.PComm.sendPacket(std::move(pack));
+}
 
+/*!
+ * \brief Close all file descriptors above stderr, except keepFDs. Only uses async-signal-safe calls, may be run between fork and exec
+ * \param keepFDs Two descriptors to keep open, in ascending order
+ * \param maxFD Upper bound of open descriptors, determined before forking
+ */
+static void closeInheritedFDs(const int (&keepFDs)[2], int maxFD)
+{
+	int nextFD = STDERR_FILENO + 1;
+	for(const int keepFD : keepFDs)
+	{
+#ifdef SYS_close_range
+		if(nextFD < keepFD && syscall(SYS_close_range, nextFD, keepFD - 1, 0) == 0)
+			nextFD = keepFD;
+#endif
+		for(; nextFD < keepFD; ++nextFD)
+			close(nextFD);
 
+		nextFD = keepFD + 1;
+	}
+
+#ifdef SYS_close_range
+	if(syscall(SYS_close_range, nextFD, ~0U, 0) == 0)
+		return;
+#endif
+	for(; nextFD < maxFD; ++nextFD)
+		close(nextFD);
+}
+
+void ExperimentManager::launchExperiment(const std::string &expKey)
+{
+	const auto expPath = this->_config->serverExperimentDirectory() / expKey;
+	const auto simCfgFile = expPath / ServerConfigConst::ExperimentSimConfigFile;
+
+	// Parse configuration before launching so that errors can be reported to the client
+	const SimulationConfig simConfig(SimulationParams::parseJSONFile(simCfgFile));
+
+	// Pass this server's configuration on to the experiment process
+	const auto servCfgFile = expPath / ServerConfigConst::ExperimentServerConfigFile;
+	{
+		std::ofstream servCfgStream(servCfgFile);
+		servCfgStream << this->_config->writeConfig().dump(1, '\t');
+		if(!servCfgStream)
+			throw NRPException::logCreate("Failed to write server config for experiment \"" + expKey + "\" to " + servCfgFile.string());
+	}
+
+	PipeCommunication toExp, fromExp;
+
+	// The experiment runs in a new NRPSimulation process. This process is multithreaded, so the child may only make async-signal-safe
+	// calls between fork and exec. Prepare everything it needs beforehand
+	int childFDs[2] = {toExp.readFd(), fromExp.writeFd()};
+	const std::string pipeParam = std::to_string(childFDs[0]) + "," + std::to_string(childFDs[1]);
+	if(childFDs[0] > childFDs[1])
+		std::swap(childFDs[0], childFDs[1]);
+
+	const std::string expDir = expPath.string();
+	const std::string simCfgParam = simCfgFile.string();
+	const std::string servCfgParam = servCfgFile.string();
+	const std::string simCfgFlag = std::string("-") + SimulationParams::ParamSimCfgFile.data();
+	const std::string servCfgFlag = std::string("-") + SimulationParams::ParamServCfgFile.data();
+	const std::string pipeFlag = std::string("-") + SimulationParams::ParamExpManPipe.data();
+	const char *const execArgs[] = {NRP_SIMULATION_EXECUTABLE,
+	                                simCfgFlag.c_str(), simCfgParam.c_str(),
+	                                servCfgFlag.c_str(), servCfgParam.c_str(),
+	                                pipeFlag.c_str(), pipeParam.c_str(),
+	                                nullptr};
+
+	const long openMax = sysconf(_SC_OPEN_MAX);
+	const int maxFD = openMax > 0 && openMax < std::numeric_limits<int>::max() ? static_cast<int>(openMax) : 1024;
+
+	static constexpr std::string_view execErrMsg = "Failed to execute " NRP_SIMULATION_EXECUTABLE " for experiment\n";
+
+	const pid_t pid = fork();
+	if(pid < 0)
+		throw NRPException::logCreate("Failed to fork process for experiment \"" + expKey + "\"");
+	else if(pid == 0)
+	{
+		// Child process. Don't leak the server's sockets or other experiments' pipes into the experiment
+		closeInheritedFDs(childFDs, maxFD);
+
+		if(chdir(expDir.c_str()) == 0)
+			execv(NRP_SIMULATION_EXECUTABLE, const_cast<char *const *>(execArgs));
+
+		[[maybe_unused]] const auto res = write(STDERR_FILENO, execErrMsg.data(), execErrMsg.size());
+		_exit(127);
+	}
+
+	lock_t lock(this->_experimentLock);
+	this->_experiments.emplace(std::piecewise_construct, std::forward_as_tuple(expKey),
+	                           std::forward_as_tuple(pid, PipeCommunication(std::move(fromExp), std::move(toExp))));
+}
+
+void ExperimentManager::launchAdmittedExperiments(std::vector<std::string> &&expKeys)
+{
+	for(size_t i = 0; i < expKeys.size(); ++i)
+	{
+		const auto expKey = expKeys[i];
+		try
+		{
+			this->launchExperiment(expKey);
+		}
+		catch(std::exception &e)
+		{
+			spdlog::error("Failed to launch experiment \"" + expKey + "\": " + e.what());
+
+			auto admitted = this->_admission.releaseExperiment(expKey);
+			expKeys.insert(expKeys.end(), std::make_move_iterator(admitted.begin()), std::make_move_iterator(admitted.end()));
+		}
+	}
+}
+
+void ExperimentManager::monitorExperiments()
+{
+	while(this->_monitorRunning)
+	{
+		std::vector<std::string> stoppedExps, launchExps;
+		{
+			lock_t lock(this->_experimentLock);
+
+			for(auto expIt = this->_experiments.begin(); expIt != this->_experiments.end();)
+			{
+				int status;
+				if(waitpid(expIt->second.PID, &status, WNOHANG) == expIt->second.PID)
+				{
+					stoppedExps.push_back(expIt->first);
+					expIt = this->_experiments.erase(expIt);
+				}
+				else
+					++expIt;
+			}
+
+			launchExps.swap(this->_pendingLaunches);
+		}
+
+		// Launch admitted experiments in request order
+		for(const auto &stoppedExp : stoppedExps)
+		{
+			auto admitted = this->_admission.releaseExperiment(stoppedExp);
+			launchExps.insert(launchExps.end(), std::make_move_iterator(admitted.begin()), std::make_move_iterator(admitted.end()));
+		}
+
+		this->launchAdmittedExperiments(std::move(launchExps));
+
+		usleep(ExperimentManager::MonitorInterval);
+	}
 }
 
 Pistache::Rest::Router ExperimentManager::setupServerRoutes(ExperimentManager *expManager)
@@ -81,10 +277,37 @@ Pistache::Rest::Router ExperimentManager::setupServerRoutes(ExperimentManager *e
 	Pistache::Rest::Routes::Post(router, ExperimentManager::GetServerStatusRoute.data(), Pistache::Rest::Routes::bind(&ExperimentManager::getServerStatusHandler, expManager));
 	Pistache::Rest::Routes::Post(router, ExperimentManager::UploadExperimentRoute.data(), Pistache::Rest::Routes::bind(&ExperimentManager::uploadExperimentHandler, expManager));
 	Pistache::Rest::Routes::Post(router, ExperimentManager::StartExperimentRoute.data(), Pistache::Rest::Routes::bind(&ExperimentManager::startExperimentHandler, expManager));
+	Pistache::Rest::Routes::Post(router, ExperimentManager::GetExperimentStatusRoute.data(), Pistache::Rest::Routes::bind(&ExperimentManager::getExperimentStatusHandler, expManager));
+	Pistache::Rest::Routes::Get(router, ExperimentManager::MetricsRoute.data(), Pistache::Rest::Routes::bind(&ExperimentManager::getMetricsHandler, expManager));
 
 	return router;
 }
 
+/*!
+ * \brief Count an experiment start request by its admission result
+ * \param result Admission result label
+ */
+static void countStartRequest(const std::string &result)
+{
+	NRPMetrics::instance().counter("nrp_server_experiment_start_requests_total", "Experiment start requests, by admission result", {{"result", result}}).increment();
+}
+
+void ExperimentManager::getRunningExperimentsHandler(const Pistache::Rest::Request &, Pistache::Http::ResponseWriter res)
+{
+	const nlohmann::json running = this->_admission.admittedExperiments();
+	res.send(Pistache::Http::Code::Ok, running.dump(), MIME(Application, Json));
+}
+
+void ExperimentManager::getServerStatusHandler(const Pistache::Rest::Request &, Pistache::Http::ResponseWriter res)
+{
+	const nlohmann::json status({{"capacity", this->_admission.capacity().toJSON()},
+	                             {"available", this->_admission.availableResources().toJSON()},
+	                             {"running", this->_admission.admittedExperiments().size()},
+	                             {"queued", this->_admission.numQueued()}});
+
+	res.send(Pistache::Http::Code::Ok, status.dump(), MIME(Application, Json));
+}
+
 void ExperimentManager::uploadExperimentHandler(const Pistache::Rest::Request &req, Pistache::Http::ResponseWriter res)
 {
 	try
@@ -92,7 +315,9 @@ void ExperimentManager::uploadExperimentHandler(const Pistache::Rest::Request &r
 		const std::string expName  = ExperimentManager::getExperimentName(req);
 		const std::string userName = ExperimentManager::getUsername(req);
 
-		ZipContainer zipDat(req.body());
+		// Pistache hands over the complete body. Extract from it directly instead of copying it into libzip's buffer
+		const auto &body = req.body();
+		const auto zipDat = ZipContainer::fromBufferView(body.data(), body.size());
 
 		const auto expPath = this->_config->serverExperimentDirectory() / userName / expName;
 		try
@@ -120,7 +345,107 @@ void ExperimentManager::uploadExperimentHandler(const Pistache::Rest::Request &r
 
 void ExperimentManager::startExperimentHandler(const Pistache::Rest::Request &req, Pistache::Http::ResponseWriter res)
 {
+	const auto expKey = ExperimentManager::getExperimentKey(req);
+
+	ExperimentResources resources;
+	try
+	{
+		const auto simCfgFile = this->_config->serverExperimentDirectory() / expKey / ServerConfigConst::ExperimentSimConfigFile;
+		resources = ExperimentResources::fromSimulationConfig(SimulationParams::parseJSONFile(simCfgFile), this->_config->engineMemoryEstimate());
+	}
+	catch(std::exception &e)
+	{
+		res.send(Pistache::Http::Code::Bad_Request, e.what());
+		return;
+	}
+
+	nlohmann::json status({{"experiment", expKey}, {"resources", resources.toJSON()}});
+	switch(this->_admission.requestAdmission(expKey, resources))
+	{
+		case ExperimentAdmissionControl::ADMITTED:
+			try
+			{
+				this->launchExperiment(expKey);
+			}
+			catch(std::exception &e)
+			{
+				auto admitted = this->_admission.releaseExperiment(expKey);
+				{
+					lock_t lock(this->_experimentLock);
+					this->_pendingLaunches.insert(this->_pendingLaunches.end(), std::make_move_iterator(admitted.begin()), std::make_move_iterator(admitted.end()));
+				}
+
+				res.send(Pistache::Http::Code::Internal_Server_Error, e.what());
+				return;
+			}
+
+			countStartRequest("admitted");
+
+			status["state"] = "running";
+			res.send(Pistache::Http::Code::Ok, status.dump(), MIME(Application, Json));
+			return;
+
+		case ExperimentAdmissionControl::QUEUED:
+			countStartRequest("queued");
+
+			status["state"] = "queued";
+			status["queue_position"] = this->_admission.queuePosition(expKey);
+			res.send(Pistache::Http::Code::Accepted, status.dump(), MIME(Application, Json));
+			return;
+
+		case ExperimentAdmissionControl::REJECTED:
+			countStartRequest("rejected");
+
+			status["state"] = "rejected";
+			status["available"] = this->_admission.availableResources().toJSON();
+			res.send(Pistache::Http::Code::Service_Unavailable, status.dump(), MIME(Application, Json));
+			return;
+	}
+}
+
+void ExperimentManager::getExperimentStatusHandler(const Pistache::Rest::Request &req, Pistache::Http::ResponseWriter res)
+{
+	// Only query admission control, so that status requests don't wait on experiment launches
+	const auto expKey = ExperimentManager::getExperimentKey(req);
+
+	nlohmann::json status({{"experiment", expKey}});
+	if(this->_admission.isAdmitted(expKey))
+		status["state"] = "running";
+	else if(const auto queuePos = this->_admission.queuePosition(expKey); queuePos >= 0)
+	{
+		status["state"] = "queued";
+		status["queue_position"] = queuePos;
+	}
+	else
+	{
+		status["state"] = "unknown";
+		res.send(Pistache::Http::Code::Not_Found, status.dump(), MIME(Application, Json));
+		return;
+	}
+
+	status["resources"] = this->_admission.experimentResources(expKey).toJSON();
+	res.send(Pistache::Http::Code::Ok, status.dump(), MIME(Application, Json));
+}
+
+void ExperimentManager::getMetricsHandler(const Pistache::Rest::Request &, Pistache::Http::ResponseWriter res)
+{
+	// Experiment counts are read from admission control on each scrape. Each experiment's NRPSimulation process answers
+	// SimulationServer::GetMetricsCommand with its own metrics, and can write them to a textfile with --metrics_file
+	std::string metrics = NRPMetrics::instance().toPrometheusText();
+	metrics += "# HELP nrp_server_running_experiments Number of running experiments\n"
+	           "# TYPE nrp_server_running_experiments gauge\n"
+	           "nrp_server_running_experiments " + std::to_string(this->_admission.admittedExperiments().size()) + "\n";
+	metrics += "# HELP nrp_server_queued_experiments Number of experiments waiting for resources\n"
+	           "# TYPE nrp_server_queued_experiments gauge\n"
+	           "nrp_server_queued_experiments " + std::to_string(this->_admission.numQueued()) + "\n";
+
+	res.send(Pistache::Http::Code::Ok, metrics, Pistache::Http::Mime::MediaType::fromString(NRPMetrics::PrometheusContentType.data()));
+}
 
+void ExperimentManager::stopExperimentProcess(const RunningExperimentData &data)
+{
+	pid_t pid = data.PID;
+	BasicFork::stopChildProcess(pid, ExperimentManager::ExperimentStopTimeout);
 }
 
 std::string ExperimentManager::getUsername(const Pistache::Rest::Request &req)
@@ -136,9 +461,14 @@ std::string ExperimentManager::getExperimentName(const Pistache::Rest::Request &
 {
 	std::string expName;
 	try
-	{	auto expName = req.param(UploadExperimentNameParam.data()).as<std::string>();	}
+	{	expName = req.param(UploadExperimentNameParam.data()).as<std::string>();	}
 	catch(std::exception&)
 	{	expName = ServerConfigConst::DefaultExperimentName.data();	}
 
 	return expName;
 }
+
+std::string ExperimentManager::getExperimentKey(const Pistache::Rest::Request &req)
+{
+	return ExperimentManager::getUsername(req) + "/" + ExperimentManager::getExperimentName(req);
+}
@@ -26,7 +26,11 @@
 #include "nrp_simulation/config/server_config.h"
 #include "nrp_simulation/simulation/simulation_manager.h"
 #include "nrp_simulation/utils/pipe_packet_communication.h"
+#include "nrp_server/experiment_admission_control.h"
 
+#include <atomic>
+#include <map>
+#include <thread>
 #include <pistache/endpoint.h>
 #include <pistache/http.h>
 #include <pistache/router.h>
@@ -43,13 +47,27 @@ class ExperimentManager
 		{
 			pid_t PID;
 			PipePacketCommunication PComm;
+
+			RunningExperimentData(pid_t pid, PipeCommunication &&comm);
 		};
 
+		/*!
+		 * \brief Time (in us) between checks for stopped experiment processes
+		 */
+		static constexpr useconds_t MonitorInterval = 100000;
+
+		/*!
+		 * \brief Time (in s) to wait for an experiment process to quit before killing it
+		 */
+		static constexpr unsigned int ExperimentStopTimeout = 60;
+
 	public:
 		static constexpr std::string_view GetRunningExperimentsRoute = "/get_running_experiments";
 		static constexpr std::string_view GetServerStatusRoute       = "/get_server_status";
 		static constexpr std::string_view UploadExperimentRoute      = "/upload_experiment";
 		static constexpr std::string_view StartExperimentRoute       = "/start_experiment";
+		static constexpr std::string_view GetExperimentStatusRoute   = "/get_experiment_status";
+		static constexpr std::string_view MetricsRoute               = "/metrics";
 
 		/*!
 		 * \brief Experiment Upload parameter name
@@ -59,11 +77,13 @@ class ExperimentManager
 		/*!
 		 * \brief Constructor. Starts REST server
 		 * \param config Configuration
+		 * \param processLaunchers Process Launchers. Passed on to experiment processes
+		 * \param engineLaunchers Engine Launchers. Passed on to experiment processes
 		 */
-		ExperimentManager(const ServerConfigConstSharedPtr &config);
+		ExperimentManager(const ServerConfigConstSharedPtr &config, const MainProcessLauncherManagerConstSharedPtr &processLaunchers, const EngineLauncherManagerSharedPtr &engineLaunchers);
 
 		/*!
-		 *	\brief Destructor. Stops REST server
+		 *	\brief Destructor. Stops REST server and all experiment processes
 		 */
 		~ExperimentManager();
 
@@ -89,18 +109,38 @@ class ExperimentManager
 		lock_t acquireExperimentLock();
 
 		/*!
-		 * \brief Stop an experiment's process
+		 * \brief Stop an experiment's process. If the experiment is still waiting for resources, it is removed from the queue instead
 		 * \param experimentName Name of experiment
 		 * \param expLock Experiment Lock
 		 */
 		void shutdownExperiment(const std::string &experimentName, const lock_t &expLock);
 
+		/*!
+		 * \brief Get admission control. Tracks resources of running and queued experiments
+		 */
+		const ExperimentAdmissionControl &admissionControl() const;
+
 	private:
 		/*!
 		 * \brief Configuration data
 		 */
 		ServerConfigConstSharedPtr _config;
 
+		/*!
+		 * \brief Process Launchers
+		 */
+		MainProcessLauncherManagerConstSharedPtr _processLaunchers;
+
+		/*!
+		 * \brief Engine Launchers
+		 */
+		EngineLauncherManagerSharedPtr _engineLaunchers;
+
+		/*!
+		 * \brief Decides which experiments may run with the server's resources
+		 */
+		ExperimentAdmissionControl _admission;
+
 		/*!
 		 * \brief REST Routes
 		 */
@@ -128,6 +168,21 @@ class ExperimentManager
 		 */
 		std::map<std::string, RunningExperimentData> _experiments;
 
+		/*!
+		 * \brief Queued experiments which were admitted, but not yet launched. Protected by _experimentLock
+		 */
+		std::vector<std::string> _pendingLaunches;
+
+		/*!
+		 * \brief Thread reaping stopped experiments and launching admitted ones
+		 */
+		std::thread _monitorThread;
+
+		/*!
+		 * \brief Monitor Thread Status Flag
+		 */
+		std::atomic<bool> _monitorRunning = false;
+
 		using pack_callback_fcn_t = std::function<void(PipeCommPacket&&)>;
 
 		/*!
@@ -142,6 +197,23 @@ class ExperimentManager
 		 */
 		void shutdownExperiment(const exp_map_t::iterator &expIt, const lock_t &expLock);
 
+		/*!
+		 * \brief Fork an experiment process running a SimulationServer. The experiment must already be admitted
+		 * \param expKey Experiment key, consisting of user and experiment name
+		 */
+		void launchExperiment(const std::string &expKey);
+
+		/*!
+		 * \brief Launch admitted experiments. Experiments that fail to launch release their resources again
+		 * \param expKeys Experiment keys
+		 */
+		void launchAdmittedExperiments(std::vector<std::string> &&expKeys);
+
+		/*!
+		 * \brief Monitor thread function. Reaps stopped experiment processes, releases their resources and launches pending experiments
+		 */
+		void monitorExperiments();
+
 		/*!
 		 * \brief Setup Routes
 		 */
@@ -151,6 +223,8 @@ class ExperimentManager
 		void getServerStatusHandler(const Pistache::Rest::Request &req, Pistache::Http::ResponseWriter res);
 		void uploadExperimentHandler(const Pistache::Rest::Request &req, Pistache::Http::ResponseWriter res);
 		void startExperimentHandler(const Pistache::Rest::Request &req, Pistache::Http::ResponseWriter res);
+		void getExperimentStatusHandler(const Pistache::Rest::Request &req, Pistache::Http::ResponseWriter res);
+		void getMetricsHandler(const Pistache::Rest::Request &req, Pistache::Http::ResponseWriter res);
 
 		/*!
 		 * \brief Kills experiment process and waits for it to quit
@@ -172,6 +246,13 @@ class ExperimentManager
 		 * \return Returns Experiment name
 		 */
 		static std::string getExperimentName(const Pistache::Rest::Request &req);
+
+		/*!
+		 * \brief Get key under which an experiment is managed
+		 * \param req HTTP REST request
+		 * \return Returns "<Username>/<Experiment name>"
+		 */
+		static std::string getExperimentKey(const Pistache::Rest::Request &req);
 };
 
 #endif // EXPERIMENT_MANAGER_H
@@ -0,0 +1,140 @@
+//
+// NRP Core - Backend infrastructure to synchronize simulations
+//
+// Copyright 2020 Michael Zechmair
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This project has received funding from the European Union’s Horizon 2020
+// Framework Programme for Research and Innovation under the Specific Grant
+// Agreement No. 945539 (Human Brain Project SGA3).
+//
+
+#include <gtest/gtest.h>
+
+#include "nrp_general_library/utils/nrp_exceptions.h"
+#include "nrp_server/experiment_admission_control.h"
+
+using namespace testing;
+
+static ExperimentResources makeResources(uint32_t cores, uint32_t memoryMB, uint32_t engines)
+{
+	ExperimentResources resources;
+	resources.Cores = cores;
+	resources.MemoryMB = memoryMB;
+	resources.Engines = engines;
+
+	return resources;
+}
+
+TEST(ExperimentAdmissionControlTest, FromSimulationConfig)
+{
+	const nlohmann::json simConfig({{"EngineConfigs", {{{"EngineName", "engine1"}, {"EngineCPUAffinity", {0, 1, 2}}},
+	                                                   {{"EngineName", "engine2"}}}}});
+
+	const auto resources = ExperimentResources::fromSimulationConfig(simConfig, 100);
+
+	// One core for the simulation loop, three for engine1 and at least one for engine2
+	ASSERT_EQ(resources.Cores, 5);
+	ASSERT_EQ(resources.MemoryMB, 200);
+	ASSERT_EQ(resources.Engines, 2);
+
+	const auto noEngines = ExperimentResources::fromSimulationConfig(nlohmann::json::object(), 100);
+	ASSERT_EQ(noEngines.Cores, 1);
+	ASSERT_EQ(noEngines.MemoryMB, 0);
+	ASSERT_EQ(noEngines.Engines, 0);
+}
+
+TEST(ExperimentAdmissionControlTest, ServerCapacity)
+{
+	ServerConfig config(nlohmann::json({{"ServerMaxCores", 8}, {"ServerMaxMemory", 4096}}));
+
+	const auto capacity = ExperimentResources::serverCapacity(config);
+	ASSERT_EQ(capacity.Cores, 8);
+	ASSERT_EQ(capacity.MemoryMB, 4096);
+	ASSERT_EQ(capacity.Engines, ExperimentResources::Unlimited);
+
+	// Negative memory estimates would wrap around when reserving memory
+	ASSERT_THROW(ServerConfig(nlohmann::json({{"EngineMemoryEstimate", -1}})), NRPException);
+}
+
+TEST(ExperimentAdmissionControlTest, AdmitAndQueue)
+{
+	ExperimentAdmissionControl admission(makeResources(4, 1000, 10), -1, -1);
+
+	ASSERT_EQ(admission.requestAdmission("exp1", makeResources(2, 500, 1)), ExperimentAdmissionControl::ADMITTED);
+	ASSERT_EQ(admission.requestAdmission("exp2", makeResources(2, 500, 1)), ExperimentAdmissionControl::ADMITTED);
+	ASSERT_EQ(admission.availableResources().Cores, 0);
+
+	// No resources left, further requests wait in order
+	ASSERT_EQ(admission.requestAdmission("exp3", makeResources(3, 100, 1)), ExperimentAdmissionControl::QUEUED);
+	ASSERT_EQ(admission.requestAdmission("exp4", makeResources(1, 100, 1)), ExperimentAdmissionControl::QUEUED);
+	ASSERT_EQ(admission.queuePosition("exp3"), 0);
+	ASSERT_EQ(admission.queuePosition("exp4"), 1);
+	ASSERT_EQ(admission.numQueued(), 2);
+
+	// exp4 would fit into the resources released by exp1, but must not overtake exp3
+	ASSERT_TRUE(admission.releaseExperiment("exp1").empty());
+	ASSERT_EQ(admission.queuePosition("exp3"), 0);
+
+	// Once exp2 is released, both exp3 and exp4 fit
+	ASSERT_EQ(admission.releaseExperiment("exp2"), std::vector<std::string>({"exp3", "exp4"}));
+	ASSERT_TRUE(admission.isAdmitted("exp3"));
+	ASSERT_TRUE(admission.isAdmitted("exp4"));
+	ASSERT_EQ(admission.numQueued(), 0);
+	ASSERT_EQ(admission.availableResources().Cores, 0);
+	ASSERT_EQ(admission.availableResources().MemoryMB, 800);
+	ASSERT_EQ(admission.availableResources().Engines, 8);
+}
+
+TEST(ExperimentAdmissionControlTest, Reject)
+{
+	ExperimentAdmissionControl admission(makeResources(4, 1000, 2), 2, 1);
+
+	// Experiments that can never fit are rejected instead of blocking the queue
+	ASSERT_EQ(admission.requestAdmission("tooLarge", makeResources(5, 100, 1)), ExperimentAdmissionControl::REJECTED);
+	ASSERT_EQ(admission.requestAdmission("tooManyEngines", makeResources(1, 100, 3)), ExperimentAdmissionControl::REJECTED);
+
+	// Duplicates are rejected, whether admitted or queued
+	ASSERT_EQ(admission.requestAdmission("exp1", makeResources(1, 100, 1)), ExperimentAdmissionControl::ADMITTED);
+	ASSERT_EQ(admission.requestAdmission("exp1", makeResources(1, 100, 1)), ExperimentAdmissionControl::REJECTED);
+
+	// Maximum number of experiments limits admissions even if resources are left
+	ASSERT_EQ(admission.requestAdmission("exp2", makeResources(1, 100, 1)), ExperimentAdmissionControl::ADMITTED);
+	ASSERT_EQ(admission.requestAdmission("exp3", makeResources(1, 100, 0)), ExperimentAdmissionControl::QUEUED);
+	ASSERT_EQ(admission.requestAdmission("exp3", makeResources(1, 100, 0)), ExperimentAdmissionControl::REJECTED);
+
+	// Queue is full
+	ASSERT_EQ(admission.requestAdmission("exp4", makeResources(1, 100, 0)), ExperimentAdmissionControl::REJECTED);
+
+	ExperimentAdmissionControl noExperiments(makeResources(4, 1000, 2), 0, -1);
+	ASSERT_EQ(noExperiments.requestAdmission("exp1", makeResources(1, 100, 1)), ExperimentAdmissionControl::REJECTED);
+}
+
+TEST(ExperimentAdmissionControlTest, ReleaseQueued)
+{
+	ExperimentAdmissionControl admission(makeResources(2, 1000, 10), -1, -1);
+
+	ASSERT_EQ(admission.requestAdmission("exp1", makeResources(1, 100, 1)), ExperimentAdmissionControl::ADMITTED);
+	ASSERT_EQ(admission.requestAdmission("exp2", makeResources(2, 100, 1)), ExperimentAdmissionControl::QUEUED);
+	ASSERT_EQ(admission.requestAdmission("exp3", makeResources(1, 100, 1)), ExperimentAdmissionControl::QUEUED);
+	ASSERT_EQ(admission.experimentResources("exp2").Cores, 2);
+
+	// Removing a waiting experiment admits those behind it that fit
+	ASSERT_EQ(admission.releaseExperiment("exp2"), std::vector<std::string>({"exp3"}));
+	ASSERT_EQ(admission.queuePosition("exp2"), -1);
+	ASSERT_EQ(admission.experimentResources("exp2").Cores, 0);
+
+	const auto admitted = admission.admittedExperiments();
+	ASSERT_EQ(admitted, std::vector<std::string>({"exp1", "exp3"}));
+}
@@ -22,12 +22,20 @@
 
 #include "nrp_simulation/config/server_config.h"
 
+#include "nrp_general_library/utils/nrp_exceptions.h"
+
 ServerConfig::ServerConfig(const nlohmann::json &config)
     : JSONConfigProperties(config,
                            DefProcessLauncherType.data(), DefServerAddress.data(),
                            DefServerWorkingDirectory, DefMaxNumExperiments,
-                           DefServerTimestep)
-{}
+                           DefServerTimestep,
+                           DefServerMaxCores, DefServerMaxMemory, DefServerMaxEngines,
+                           DefEngineMemoryEstimate, DefMaxQueuedExperiments)
+{
+	// Used as an unsigned per-engine reservation, a negative estimate would wrap around
+	if(this->engineMemoryEstimate() < 0)
+		throw NRPException::logCreate(std::string(EngineMemoryEstimate.m_data) + " must not be negative, got " + std::to_string(this->engineMemoryEstimate()));
+}
 
 std::string &ServerConfig::processLauncherType()
 {	return this->getPropertyByName<ProcessLauncherType>();	}
@@ -63,3 +71,33 @@ float &ServerConfig::serverTimestep()
 
 float ServerConfig::serverTimestep() const
 {	return this->getPropertyByName<ServerTimestep>();	}
+
+int32_t &ServerConfig::serverMaxCores()
+{	return this->getPropertyByName<ServerMaxCores>();	}
+
+int32_t ServerConfig::serverMaxCores() const
+{	return this->getPropertyByName<ServerMaxCores>();	}
+
+int32_t &ServerConfig::serverMaxMemory()
+{	return this->getPropertyByName<ServerMaxMemory>();	}
+
+int32_t ServerConfig::serverMaxMemory() const
+{	return this->getPropertyByName<ServerMaxMemory>();	}
+
+int32_t &ServerConfig::serverMaxEngines()
+{	return this->getPropertyByName<ServerMaxEngines>();	}
+
+int32_t ServerConfig::serverMaxEngines() const
+{	return this->getPropertyByName<ServerMaxEngines>();	}
+
+int32_t &ServerConfig::engineMemoryEstimate()
+{	return this->getPropertyByName<EngineMemoryEstimate>();	}
+
+int32_t ServerConfig::engineMemoryEstimate() const
+{	return this->getPropertyByName<EngineMemoryEstimate>();	}
+
+int32_t &ServerConfig::maxQueuedExperiments()
+{	return this->getPropertyByName<MaxQueuedExperiments>();	}
+
+int32_t ServerConfig::maxQueuedExperiments() const
+{	return this->getPropertyByName<MaxQueuedExperiments>();	}
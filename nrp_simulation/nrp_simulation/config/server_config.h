@@ -68,6 +68,36 @@ struct ServerConfigConst
 	static constexpr FixedString ServerTimestep = "ServerTimestep";
 	static constexpr float DefServerTimestep = 0.01f;
 
+	/*!
+	 * \brief Number of cores experiments may occupy in total. Set to -1 to use all available cores
+	 */
+	static constexpr FixedString ServerMaxCores = "ServerMaxCores";
+	static constexpr int32_t DefServerMaxCores = -1;
+
+	/*!
+	 * \brief Memory (in MB) experiments may occupy in total. Set to -1 to use all physical memory
+	 */
+	static constexpr FixedString ServerMaxMemory = "ServerMaxMemory";
+	static constexpr int32_t DefServerMaxMemory = -1;
+
+	/*!
+	 * \brief Maximum number of engines running across all experiments. Set to -1 if unlimited
+	 */
+	static constexpr FixedString ServerMaxEngines = "ServerMaxEngines";
+	static constexpr int32_t DefServerMaxEngines = -1;
+
+	/*!
+	 * \brief Estimated memory (in MB) used by a single engine. Used to compute an experiment's memory requirements. Must not be negative
+	 */
+	static constexpr FixedString EngineMemoryEstimate = "EngineMemoryEstimate";
+	static constexpr int32_t DefEngineMemoryEstimate = 1024;
+
+	/*!
+	 * \brief Maximum number of start requests waiting for resources. Set to -1 if unlimited
+	 */
+	static constexpr FixedString MaxQueuedExperiments = "MaxQueuedExperiments";
+	static constexpr int32_t DefMaxQueuedExperiments = 16;
+
 	/*!
 	 * \brief Number of threads that handle requests from NRPServer
 	 */
@@ -78,6 +108,16 @@ struct ServerConfigConst
 	 */
 	static constexpr std::string_view ServerExperimentDir = "experiments";
 
+	/*!
+	 * \brief Simulation configuration file inside an uploaded experiment's directory
+	 */
+	static constexpr std::string_view ExperimentSimConfigFile = "simulation_config.json";
+
+	/*!
+	 * \brief Server configuration file written into an experiment's directory before its NRPSimulation process is launched
+	 */
+	static constexpr std::string_view ExperimentServerConfigFile = "server_config.json";
+
 	/*!
 	 * \brief Default Username. Used when no user is supplied by a REST request
 	 */
@@ -88,8 +128,10 @@ struct ServerConfigConst
 	 */
 	static constexpr std::string_view DefaultExperimentName = "default";
 
-	using SPropNames = PropNames<ProcessLauncherType, ServerAddress, ServerWorkingDirectory, MaxNumExperiments, ServerTimestep>;
-	using SPropConfig = JSONConfigProperties<ServerConfig, SPropNames, std::string, std::string, std::filesystem::path, int32_t, float>;
+	using SPropNames = PropNames<ProcessLauncherType, ServerAddress, ServerWorkingDirectory, MaxNumExperiments, ServerTimestep,
+	                             ServerMaxCores, ServerMaxMemory, ServerMaxEngines, EngineMemoryEstimate, MaxQueuedExperiments>;
+	using SPropConfig = JSONConfigProperties<ServerConfig, SPropNames, std::string, std::string, std::filesystem::path, int32_t, float,
+	                                         int32_t, int32_t, int32_t, int32_t, int32_t>;
 };
 
 /*!
@@ -120,6 +162,21 @@ class ServerConfig
 		float &serverTimestep();
 		float serverTimestep() const;
 
+		int32_t &serverMaxCores();
+		int32_t serverMaxCores() const;
+
+		int32_t &serverMaxMemory();
+		int32_t serverMaxMemory() const;
+
+		int32_t &serverMaxEngines();
+		int32_t serverMaxEngines() const;
+
+		int32_t &engineMemoryEstimate();
+		int32_t engineMemoryEstimate() const;
+
+		int32_t &maxQueuedExperiments();
+		int32_t maxQueuedExperiments() const;
+
 	private:
 };
 
@@ -22,17 +22,18 @@
 
 #include "nrp_simulation/server/simulation_server.h"
 
+#include "nrp_general_library/utils/nrp_metrics.h"
+
 #include <assert.h>
-#include <iostream>
+#include <cmath>
+#include <spdlog/spdlog.h>
+#include <string.h>
 #include <unistd.h>
 
 
-SimulationServer::SimulationServer(const ServerConfigConstSharedPtr &config, MainProcessLauncherManagerConstSharedPtr &processLaunchers, EngineLauncherManagerSharedPtr &engineLaunchers,
-                                   PipeCommunication &&comm, pid_t commPID, uint16_t confirmSignalOffsetNum)
-    : _comm(PipePacketCommunication(std::move(comm), commPID, confirmSignalOffsetNum)),
-      _config(config),
-      _processLaunchers(processLaunchers),
-      _engineLaunchers(engineLaunchers),
+SimulationServer::SimulationServer(SimulationManager &sim, PipeCommunication &&comm)
+    : _comm(std::move(comm)),
+      _sim(sim),
       _handlers(SimulationServer::setHandlers())
 {
 	this->startServerAsync();
@@ -41,15 +42,6 @@ SimulationServer::SimulationServer(const ServerConfigConstSharedPtr &config, Mai
 SimulationServer::~SimulationServer()
 {
 	this->shutdownServer();
-
-	this->_sim = nullptr;
-
-	PipeCommPacket packet;
-	packet.ID = -1;
-	packet.Command = SimulationServer::ShutdownInfoCommand;
-	packet.Data.clear();
-
-	this->_comm.sendPacketImmediately(std::move(packet));
 }
 
 void SimulationServer::startServerAsync()
@@ -67,12 +59,16 @@ void SimulationServer::startServerAsync()
 
 void SimulationServer::shutdownServer()
 {
+	this->joinSimThread();
+
 	this->_comm.shutdownServer();
 
 	// Make sure all threads have completed
-	this->_simRunningThread.join();
 	for(auto &curThread : this->_threads)
-		curThread.join();
+	{
+		if(curThread.joinable())
+			curThread.join();
+	}
 }
 
 bool SimulationServer::isServerRunning() const
@@ -80,62 +76,53 @@ bool SimulationServer::isServerRunning() const
 	return this->_comm.isRunning();
 }
 
-void SimulationServer::resetSimulation(SimulationConfigSharedPtr simConfig)
+void SimulationServer::waitForShutdown()
 {
-	{
-		SimulationManager::sim_lock_t lock;
-		if(simConfig == nullptr)
-		{
-			if(this->_sim != nullptr)
-				simConfig = this->_sim->simulationConfig(lock);
-			else
-				simConfig = nullptr;
-		}
-
-		this->_sim->shutdownLoop(lock);
-	}
-
-	this->_sim.reset(new SimulationManager(this->_config, simConfig));
+	std::unique_lock lock(this->_shutdownLock);
+	this->_shutdownCondition.wait(lock, [this] { return this->_shutdownRequested; });
 }
 
-nlohmann::json SimulationServer::getSimStatus() const
+nlohmann::json SimulationServer::getSimStatus()
 {
 	using SIM_STATE = SimulationStatus::SIM_STATE;
 
 	const auto simState = this->getSimState();
-	const auto simTime = simState >= SIM_STATE::SIMULATION_LOADED ? this->_sim->simulationLoop()->getSimTime() : 0.f;
-	const auto &simConf = const_cast<const SimulationManager&>(*this->_sim).simulationConfig();
+	const auto simLoop = this->_sim.simulationLoop();
+	const float simTime = simState >= SIM_STATE::SIMULATION_LOADED && simLoop != nullptr ? fromSimulationTime<float, std::ratio<1>>(simLoop->getSimTime()) : 0.f;
 
-	return SimulationStatus(simState, simTime, *simConf).serializeProperties(nlohmann::json());
+	const auto simConf = this->_sim.simulationConfig();
+	return SimulationStatus(simState, simTime, simConf != nullptr ? simConf->writeConfig() : nlohmann::json()).serializeProperties();
 }
 
-SimulationStatusConst::SIM_STATE SimulationServer::getSimState() const
+SimulationStatusConst::SIM_STATE SimulationServer::getSimState()
 {
 	using SIM_STATE = SimulationStatus::SIM_STATE;
 	// First, perform checks that don't require locking the simulation
 
 	// Check if simulation is initializing
-	if(this->_sim->isSimInitializing())
+	if(this->_sim.isSimInitializing())
 		return SIM_STATE::ENGINE_SETUP;
 
 	// Check if simulation is running
-	if(this->_sim->isRunning())
+	if(this->_sim.isRunning())
 		return SIM_STATE::RUNNING;
 
 	// Now, check rest of states
-	SimulationManager::sim_lock_t lock = this->_sim->acquireSimLock();
+	SimulationManager::sim_lock_t lock = this->_sim.acquireSimLock();
 
-	if(this->_sim->simulationConfig(lock) == nullptr)
+	if(this->_sim.simulationConfig(lock) == nullptr)
 		return SIM_STATE::STARTUP;
-	else if(this->_sim->simulationLoop() == nullptr)
+	else if(this->_sim.simulationLoop() == nullptr)
 		return SIM_STATE::CONFIG_LOADED;
-	else if(this->_sim->isRunning())
+	else if(this->_sim.isRunning())
 		return SIM_STATE::RUNNING;
-	else if(this->_sim->simulationLoop()->getSimTime() <= 0.f)
+	else if(this->_sim.simulationLoop()->getSimTime() <= SimulationTime::zero())
 		return SIM_STATE::SIMULATION_LOADED;
+	else
+		return SIM_STATE::PAUSED;
 }
 
-bool SimulationServer::isSimRunning() const
+bool SimulationServer::isSimRunning()
 {
 	using SIM_STATE = SimulationStatus::SIM_STATE;
 
@@ -150,54 +137,61 @@ bool SimulationServer::setSimRunning(const SimulationRunningData &state)
 		return false;
 
 	// Set simulation timeout
-	if(state.TimeOut != SimulationRunningData::IgnoreTimeout && state.TimeOut >= 0)
+	if(!std::isnan(state.TimeOut) && state.TimeOut >= 0)
 	{
-		auto lock = this->_sim->acquireSimLock();
-		this->_sim->simulationConfig(lock)->simulationTimeOut() = state.TimeOut;
+		auto lock = this->_sim.acquireSimLock();
+		this->_sim.simulationConfig(lock)->simulationTimeOut() = static_cast<unsigned int>(state.TimeOut);
 	}
 
 	if(!state.SetRunning)
 	{
-		// Pause simulation if currently running
-		if(this->_simRunningThread.joinable())
-		{
-			// Wait for current timeStep to complete
-			this->_sim->stopSimulation(this->_sim->acquireSimLock());
-			this->_simRunningThread.join();
-		}
+		// Pause simulation if currently running. Waits for current timeStep to complete
+		this->joinSimThread();
+		return true;
 	}
-	else
-	{
-		// Check whether simulation is already running
-		if(!this->_simRunningThread.joinable())
-		{
-			auto simLock = this->_sim->acquireSimLock();
-			auto *simManager = this->_sim.get();
 
-			// Start running thread in a way that passes lock
-			this->_simRunningThread = std::thread([simManager](SimulationManager::sim_lock_t &&lock) { simManager->runSimulationUntilTimeout(lock); }, std::move(simLock));
-		}
-	}
+	std::lock_guard simRunningLock(this->_simRunningLock);
+
+	// Check whether simulation is already running
+	if(this->_sim.isRunning())
+		return true;
+
+	// A previous run may have completed by itself
+	if(this->_simRunningThread.joinable())
+		this->_simRunningThread.join();
+
+	this->_simRunningThread = std::thread([this]() {
+		auto simLock = this->_sim.acquireSimLock();
+		const bool hasTimedOut = this->_sim.runSimulationUntilTimeout(simLock);
+
+		// The simulation process has completed its task once the timeout is reached
+		if(hasTimedOut)
+			this->requestShutdown();
+	});
+
+	return true;
+}
+
+bool SimulationServer::resetSimulation()
+{
+	this->joinSimThread();
+
+	auto simLock = this->_sim.acquireSimLock();
+	return this->_sim.resetSimulation(simLock);
 }
 
 void SimulationServer::handleThreadCallback()
 {
 	while(this->isServerRunning())
 	{
-		const auto curPacket = this->_comm.retrievePacket();
-
-		// Check if a packet was received
-		if(curPacket.ID <= 0)
+		PipeCommPacket curPacket;
+		try
 		{
-			usleep(SimulationServer::SleepTime);
-			continue;
+			curPacket = this->_comm.retrievePacket();
 		}
-
-		// Check that command has an associated handler
-		const auto handlersIt = this->_handlers.find(curPacket.Command);
-		if(handlersIt == this->_handlers.end())
+		catch(PipePacketCommunication::no_packets&)
 		{
-			std::cerr << "Received unknown packet command: " << curPacket.Command << std::endl;
+			usleep(SimulationServer::SleepTime);
 			continue;
 		}
 
@@ -205,70 +199,116 @@ void SimulationServer::handleThreadCallback()
 		PipeCommPacket retPacket;
 		try
 		{
+			// Check that command has an associated handler
+			const auto handlersIt = this->_handlers.find(curPacket.Command);
+			if(handlersIt == this->_handlers.end())
+				throw std::invalid_argument("Received unknown packet command: " + curPacket.Command);
+
 			retPacket = std::invoke(handlersIt->second, this, curPacket);
 		}
 		catch(std::exception &e)
 		{
 			// In case of error, inform parent
-			retPacket.ID = curPacket.ID;
-			retPacket.Command = SimulationServer::ErrorCommand;
-
 			const std::string errMsg = std::string("Failed to process package: ") + e.what();
-			std::cerr << errMsg << std::endl;
+			spdlog::error(errMsg);
 
-			retPacket.Data.resize(errMsg.size()+1);
-			memcpy(retPacket.Data.data(), errMsg.data(), errMsg.size()+1);
+			retPacket = SimulationServer::createReturnPacket(curPacket, errMsg.c_str(), errMsg.size()+1);
+			retPacket.Command = SimulationServer::ErrorCommand.data();
+		}
 
-			this->_comm.shutdownServer();
+		this->_comm.sendPacket(std::move(retPacket));
+	}
+}
 
-			if(this->_comm.sendPacketImmediately(std::move(retPacket)) < 0)
-				std::cerr << "Failed to inform parent process of failure!";
+void SimulationServer::requestShutdown()
+{
+	{
+		std::lock_guard lock(this->_shutdownLock);
+		this->_shutdownRequested = true;
+	}
 
-			// Escalate exception
-			throw;
-		}
+	this->_shutdownCondition.notify_all();
+}
 
-		this->_comm.sendPacket(std::move(retPacket));
+void SimulationServer::joinSimThread()
+{
+	std::lock_guard simRunningLock(this->_simRunningLock);
+
+	if(this->_simRunningThread.joinable())
+	{
+		this->_sim.stopSimulation(this->_sim.acquireSimLock());
+		this->_simRunningThread.join();
 	}
 }
 
 SimulationServer::handler_map_t SimulationServer::setHandlers()
 {
 	handler_map_t handlers;
-	handlers.clear();
 
 	handlers.emplace(GetSimStatusCommand.data(), &SimulationServer::getSimStatusHandler);
 	handlers.emplace(GetSimRunningCommand.data(), &SimulationServer::getSimRunningHandler);
 	handlers.emplace(PostSimRunningCommand.data(), &SimulationServer::postSimRunningHandler);
-	handlers.emplace(GetEngineDataCommand.data(), &SimulationServer::getEngineStatusHandler);
+	handlers.emplace(ResetSimCommand.data(), &SimulationServer::resetSimHandler);
+	handlers.emplace(GetMetricsCommand.data(), &SimulationServer::getMetricsHandler);
+	handlers.emplace(ShutdownCommand.data(), &SimulationServer::shutdownHandler);
 
 	return handlers;
 }
 
-PipeCommPacket SimulationServer::getSimStatusHandler(const PipeCommPacket &req)
+PipeCommPacket SimulationServer::createReturnPacket(const PipeCommPacket &req, const void *data, size_t dataSize)
 {
-	const auto status = this->getSimStatus().dump();
-
 	PipeCommPacket retPack;
 	retPack.ID = req.ID;
-	retPack.Command = SimulationServer::ReturnCommand;
+	retPack.Command = SimulationServer::ReturnCommand.data();
 
-	retPack.Data.resize(status.size()+1);
-	memcpy(retPack.Data.data(), status.data(), status.size()+1);
+	retPack.Data.resize(dataSize);
+	if(dataSize > 0)
+		memcpy(retPack.Data.data(), data, dataSize);
 
 	return retPack;
 }
 
+PipeCommPacket SimulationServer::getSimStatusHandler(const PipeCommPacket &req)
+{
+	const auto status = this->getSimStatus().dump();
+	return SimulationServer::createReturnPacket(req, status.c_str(), status.size()+1);
+}
+
 PipeCommPacket SimulationServer::getSimRunningHandler(const PipeCommPacket &req)
 {
-	const auto isRunning = this->isSimRunning();
+	const bool isRunning = this->isSimRunning();
+	return SimulationServer::createReturnPacket(req, &isRunning, sizeof(isRunning));
+}
 
-	PipeCommPacket retPack;
-	retPack.ID = req.ID;
-	retPack.Command = SimulationServer::ReturnCommand;
+PipeCommPacket SimulationServer::postSimRunningHandler(const PipeCommPacket &req)
+{
+	if(req.Data.size() != sizeof(SimulationRunningData))
+		throw std::invalid_argument("Received malformed " + std::string(PostSimRunningCommand) + " packet");
 
-	retPack.Data.resize(sizeof(isRunning));
-	memcpy(retPack.Data.data(), &isRunning, sizeof(isRunning));
+	SimulationRunningData state;
+	memcpy(&state, req.Data.data(), sizeof(state));
 
-	return retPack;
+	const bool stateSet = this->setSimRunning(state);
+	return SimulationServer::createReturnPacket(req, &stateSet, sizeof(stateSet));
+}
+
+PipeCommPacket SimulationServer::resetSimHandler(const PipeCommPacket &req)
+{
+	const bool simReset = this->resetSimulation();
+	return SimulationServer::createReturnPacket(req, &simReset, sizeof(simReset));
+}
+
+PipeCommPacket SimulationServer::getMetricsHandler(const PipeCommPacket &req)
+{
+	const auto metrics = NRPMetrics::instance().toPrometheusText();
+	return SimulationServer::createReturnPacket(req, metrics.c_str(), metrics.size()+1);
+}
+
+PipeCommPacket SimulationServer::shutdownHandler(const PipeCommPacket &req)
+{
+	// Stop the simulation after the current time step. The owner of this server tears down the engines
+	this->_sim.stopSimulation(this->_sim.acquireSimLock());
+	this->requestShutdown();
+
+	return SimulationServer::createReturnPacket(req, nullptr, 0);
 }
@@ -22,11 +22,11 @@
 #ifndef SIMULATION_SERVER_H
 #define SIMULATION_SERVER_H
 
-#include "nrp_simulation/config/server_config.h"
 #include "nrp_simulation/server/simulation_status.h"
 #include "nrp_simulation/simulation/simulation_manager.h"
 #include "nrp_simulation/utils/pipe_packet_communication.h"
 
+#include <condition_variable>
 #include <thread>
 #include <unistd.h>
 
@@ -38,6 +38,8 @@ struct SimulationServerConst
 	// Commands
 	/*!
 	 * \brief PComm Command. Retrieves SimulationStatus struct as JSON blob
+	 * Outgoing:
+	 * - Null-terminated JSON string
 	 */
 	static constexpr std::string_view GetSimStatusCommand    = "get_sim_status";
 
@@ -50,48 +52,45 @@ struct SimulationServerConst
 	 * \brief PComm Command. Sets simulation running status
 	 * Incoming:
 	 * - struct SimulationRunningData
+	 * Outgoing:
+	 * - bool Whether the state was set
 	 */
 	static constexpr std::string_view PostSimRunningCommand  = "post_sim_running";
 
 	/*!
-	 * \brief PComm Command. Get data from engine.
-	 * Setup:
-	 * - int32_t Engine Name Length
-	 * - Engine Name String. Length is same as above value
-	 * - Rest of packet data will be passed to engine
+	 * \brief PComm Command. Pauses the simulation and returns all engines to the snapshot taken after initialization
 	 * Outgoing:
-	 * - Engine data
+	 * - bool Whether the simulation was reset. Fails if not all engines store snapshots
 	 */
-	static constexpr std::string_view GetEngineDataCommand = "get_engine_data";
+	static constexpr std::string_view ResetSimCommand = "reset_sim";
 
 	/*!
-	 * \brief PComm Command. Set engine data.
-	 * Incoming:
-	 * - int32_t Engine Name Length
-	 * - Engine Name String. Length is same as above value
-	 * - Rest of packet data will be passed to engine
+	 * \brief PComm Command. Retrieves performance metrics of this process
 	 * Outgoing:
-	 * - Engine data
+	 * - Null-terminated string in Prometheus text exposition format
 	 */
-	static constexpr std::string_view SetEngineDataCommand = "set_engine_data";
+	static constexpr std::string_view GetMetricsCommand = "get_metrics";
 
 	/*!
-	 * \brief PComm Command. Shuts engine down and kills process
+	 * \brief PComm Command. Stops the simulation. The simulation process quits afterwards
 	 */
 	static constexpr std::string_view ShutdownCommand = "shutdown";
 
+	/*!
+	 * \brief PComm Command. Answer to a request. The packet ID is the same as the request's
+	 */
+	static constexpr std::string_view ReturnCommand = "return";
+
 	/*!
 	 * \brief PComm Command. Used to indicate an error on the simulation's side.
 	 * Outgoing:
-	 * - int32_t Error Code
-	 * - int32_t Error String Length
-	 * - Error String
+	 * - Null-terminated error string
 	 */
 	static constexpr std::string_view ErrorCommand = "error";
 };
 
 /*!
- * \brief Simulation Server. User by NRP clients for communication with running experiments
+ * \brief Simulation Server. Answers requests sent by the NRPServer's ExperimentManager to a running NRPSimulation process
  */
 class SimulationServer
         : public SimulationServerConst
@@ -102,25 +101,20 @@ class SimulationServer
 		static constexpr uint8_t HandlingThreads = 5;
 
 		/*!
-		 * \brief Time (in ms) between packet retrieval attempts
+		 * \brief Time (in us) between packet retrieval attempts
 		 */
 		static constexpr useconds_t SleepTime = 200;
 
 	public:
 		/*!
 		 * \brief Constructor. Starts the server asynchronously
-		 * \param config Server configuration
-		 * \param processLaunchers Process Launchers
-		 * \param engineLaunchers Engine Launchers
+		 * \param sim Simulation to control. Must outlive this server
 		 * \param comm Pipe Communication
-		 * \param commPID Communication partner PID
-		 * \param confirmSignalOffsetNum Communication Confirmation Signal
 		 */
-		SimulationServer(const ServerConfigConstSharedPtr &config, MainProcessLauncherManagerConstSharedPtr &processLaunchers, EngineLauncherManagerSharedPtr &engineLaunchers,
-		                 PipeCommunication &&comm, pid_t commPID, uint16_t confirmSignalOffsetNum = 0);
+		SimulationServer(SimulationManager &sim, PipeCommunication &&comm);
 
 		/*!
-		 * \brief Destructor. Stops handler threads, sends a shutdown message, then stops pipe communication
+		 * \brief Destructor. Stops the simulation, then stops handler threads and pipe communication
 		 */
 		~SimulationServer();
 
@@ -130,7 +124,7 @@ class SimulationServer
 		void startServerAsync();
 
 		/*!
-		 * \brief Shutdown the server
+		 * \brief Stop the simulation and shutdown the server
 		 */
 		void shutdownServer();
 
@@ -140,25 +134,24 @@ class SimulationServer
 		bool isServerRunning() const;
 
 		/*!
-		 * \brief Stop any currently running experiments and set config for new one
-		 * \param simConfig Simulation Config Data. If nullptr, reuse old simulation config
+		 * \brief Block until a ShutdownCommand was received or the simulation ran until its timeout
 		 */
-		void resetSimulation(SimulationConfigSharedPtr simConfig = nullptr);
+		void waitForShutdown();
 
 		/*!
 		 * \brief Get Simulation Status
 		 */
-		nlohmann::json getSimStatus() const;
+		nlohmann::json getSimStatus();
 
 		/*!
 		 * \brief Get simulation state
 		 */
-		SimulationStatus::SIM_STATE getSimState() const;
+		SimulationStatus::SIM_STATE getSimState();
 
 		/*!
-		 * \brief Returns true if server is currently running running, false otherwise
+		 * \brief Returns true if the simulation is currently running, false otherwise
 		 */
-		bool isSimRunning() const;
+		bool isSimRunning();
 
 		/*!
 		 * \brief Set simulation's running status. Will adjust _simRunningThread according to state
@@ -168,6 +161,12 @@ class SimulationServer
 		 */
 		bool setSimRunning(const SimulationRunningData &state);
 
+		/*!
+		 * \brief Pause the simulation and return it to its initial state. Uses engine snapshots instead of relaunching the engines
+		 * \return Returns true if the simulation was reset, false if no snapshot is available
+		 */
+		bool resetSimulation();
+
 	private:
 		/*!
 		 * \brief Threads that handle incoming requests
@@ -180,29 +179,26 @@ class SimulationServer
 		std::thread _simRunningThread;
 
 		/*!
-		 * \brief Pipe Communication
+		 * \brief Serializes changes to _simRunningThread
 		 */
-		PipePacketCommunication _comm;
+		std::mutex _simRunningLock;
 
 		/*!
-		 * \brief Server Config
-		 */
-		ServerConfigConstSharedPtr _config;
-
-		/*!
-		 * \brief Process Launchers
+		 * \brief Pipe Communication
 		 */
-		MainProcessLauncherManagerConstSharedPtr _processLaunchers;
+		PipePacketCommunication _comm;
 
 		/*!
-		 * \brief Engine Launchers
+		 * \brief Controlled simulation
 		 */
-		EngineLauncherManagerSharedPtr _engineLaunchers;
+		SimulationManager &_sim;
 
 		/*!
-		 * \brief Currently running simulation
+		 * \brief Set once the server should quit. Guarded by _shutdownLock
 		 */
-		SimulationManagerSharedPtr _sim;
+		bool _shutdownRequested = false;
+		std::mutex _shutdownLock;
+		std::condition_variable _shutdownCondition;
 
 		using pack_handler_t = PipeCommPacket(SimulationServer::*)(const PipeCommPacket&);
 		using handler_map_t = std::map<std::string, pack_handler_t>;
@@ -217,16 +213,36 @@ class SimulationServer
 		 */
 		void handleThreadCallback();
 
+		/*!
+		 * \brief Wake threads waiting in waitForShutdown
+		 */
+		void requestShutdown();
+
+		/*!
+		 * \brief Stop the simulation thread and wait for it to complete
+		 */
+		void joinSimThread();
+
 		/*!
 		 * \brief Setup handlers
 		 */
 		static handler_map_t setHandlers();
 
-		// REST Route Handlers
+		/*!
+		 * \brief Create a reply to req
+		 * \param req Request packet
+		 * \param data Data to reply with
+		 * \param dataSize Size of data
+		 */
+		static PipeCommPacket createReturnPacket(const PipeCommPacket &req, const void *data, size_t dataSize);
+
+		// Packet Handlers
 		PipeCommPacket getSimStatusHandler(const PipeCommPacket &req);
 		PipeCommPacket getSimRunningHandler(const PipeCommPacket &req);
 		PipeCommPacket postSimRunningHandler(const PipeCommPacket &req);
-		PipeCommPacket getEngineStatusHandler(const PipeCommPacket &req);
+		PipeCommPacket resetSimHandler(const PipeCommPacket &req);
+		PipeCommPacket getMetricsHandler(const PipeCommPacket &req);
+		PipeCommPacket shutdownHandler(const PipeCommPacket &req);
 };
 
 #endif // SIMULATION_SERVER_H
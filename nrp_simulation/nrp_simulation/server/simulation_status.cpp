@@ -24,13 +24,18 @@
 
 
 SimulationStatus::SimulationStatus(const nlohmann::json &json)
-    : json_property_template_t(json)
+    : status_properties_t(JSONPropertySerializer<status_properties_t>::readProperties(json))
 {}
 
-SimulationStatus::SimulationStatus(SimulationStatusConst::SIM_STATE status, float time, SimulationConfig config)
-    : json_property_template_t(status, time, config)
+SimulationStatus::SimulationStatus(SimulationStatusConst::SIM_STATE status, float time, nlohmann::json config)
+    : status_properties_t(status, time, std::move(config))
 {}
 
+nlohmann::json SimulationStatus::serializeProperties() const
+{
+	return JSONPropertySerializer<status_properties_t>::serializeProperties(*this, nlohmann::json());
+}
+
 SimulationStatusConst::SIM_STATE SimulationStatus::status() const
 {
 	return this->getPropertyByName<Status>();
@@ -51,12 +56,12 @@ float &SimulationStatus::time()
 	return this->getPropertyByName<Time>();
 }
 
-const SimulationConfig &SimulationStatus::config() const
+const nlohmann::json &SimulationStatus::config() const
 {
 	return this->getPropertyByName<Config>();
 }
 
-SimulationConfig &SimulationStatus::config()
+nlohmann::json &SimulationStatus::config()
 {
 	return this->getPropertyByName<Config>();
 }
@@ -22,7 +22,6 @@
 #ifndef SIMULATION_STATUS_H
 #define SIMULATION_STATUS_H
 
-#include "nrp_general_library/config/simulation_config.h"
 #include "nrp_general_library/utils/serializers/json_property_serializer.h"
 
 class SimulationStatus;
@@ -63,7 +62,7 @@ struct SimulationStatusConst
 
 	using SPropNames = PropNames<Status, Time, Config>;
 
-	using json_property_template_t = JSONConfigProperties<SimulationStatus, SPropNames, SIM_STATE, float, SimulationConfig>;
+	using status_properties_t = PropertyTemplate<SimulationStatus, SPropNames, SIM_STATE, float, nlohmann::json>;
 };
 
 /*!
@@ -71,11 +70,16 @@ struct SimulationStatusConst
  */
 class SimulationStatus
         : public SimulationStatusConst,
-          public SimulationStatusConst::json_property_template_t
+          public SimulationStatusConst::status_properties_t
 {
 	public:
 		SimulationStatus(const nlohmann::json &json);
-		SimulationStatus(SIM_STATE status, float time, SimulationConfig config);
+		SimulationStatus(SIM_STATE status, float time, nlohmann::json config);
+
+		/*!
+		 * \brief Convert status to JSON
+		 */
+		nlohmann::json serializeProperties() const;
 
 		SIM_STATE status() const;
 		SIM_STATE &status();
@@ -83,8 +87,8 @@ class SimulationStatus
 		float time() const;
 		float &time();
 
-		const SimulationConfig &config() const;
-		SimulationConfig &config();
+		const nlohmann::json &config() const;
+		nlohmann::json &config();
 };
 
 /*!
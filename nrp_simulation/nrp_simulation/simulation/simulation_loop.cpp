@@ -25,6 +25,9 @@
 #include "nrp_general_library/config/engine_config.h"
 #include "nrp_general_library/config/transceiver_function_config.h"
 #include "nrp_general_library/utils/nrp_exceptions.h"
+#include "nrp_general_library/utils/nrp_logger.h"
+
+#include <future>
 
 #include <iostream>
 
@@ -36,7 +39,12 @@ SimulationLoop::SimulationLoop(SimulationConfigSharedPtr config, engine_interfac
 	TransceiverDeviceInterface::setTFInterpreter(&(this->_tfManager.getInterpreter()));
 
 	for(const auto &curEnginePtr : this->_engines)
-	{	this->_engineQueue.emplace(0, curEnginePtr);	}
+	{
+		this->_engineQueue.emplace(0, curEnginePtr);
+		this->_engineStepMetrics[curEnginePtr.get()].StepDuration = &NRPMetrics::instance().histogram("nrp_engine_step_duration_seconds",
+		                                                                                              "Wall-clock time from starting an engine step until its completion",
+		                                                                                              {{"engine", curEnginePtr->engineName()}});
+	}
 }
 
 void SimulationLoop::initLoop()
@@ -52,6 +60,98 @@ void SimulationLoop::initLoop()
 			throw NRPException::logCreate(e, "Failed to initialize engine \"" + engine->engineName() + "\"");
 		}
 	}
+
+	// Store initial state so that the simulation can be reset without relaunching engines
+	this->saveSnapshot();
+}
+
+bool SimulationLoop::saveSnapshot()
+{
+	this->_hasSnapshot = false;
+
+	for(const auto &engine : this->_engines)
+	{
+		if(!engine->supportsSnapshots())
+		{
+			NRPLogger::SPDInfoLogDefault("Engine \"" + engine->engineName() + "\" does not support snapshots, simulation reset is unavailable");
+			return false;
+		}
+	}
+
+	for(const auto &engine : this->_engines)
+	{
+		try
+		{
+			engine->saveSnapshot();
+		}
+		catch(std::exception &e)
+		{
+			NRPLogger::SPDInfoLogDefault("Engine \"" + engine->engineName() + "\" could not store its state, simulation reset is unavailable: " + e.what());
+			return false;
+		}
+	}
+
+	this->_snapshotSimTime = this->_simTime;
+	this->_hasSnapshot = true;
+
+	return true;
+}
+
+void SimulationLoop::restoreSnapshot()
+{
+	if(!this->_hasSnapshot)
+		throw NRPException::logCreate("No simulation snapshot available. Not all engines support snapshots");
+
+	// Engines restart their next step at the end of each runLoop() call. Wait for it to complete before restoring
+	for(const auto &engine : this->_engines)
+	{
+		try
+		{
+			engine->waitForStepCompletion(this->engineStepTimeout(engine));
+			engine->restoreSnapshot();
+		}
+		catch(std::exception &e)
+		{
+			throw NRPException::logCreate(e, "Failed to restore state of engine \"" + engine->engineName() + "\"");
+		}
+	}
+
+	this->_simTime = this->_snapshotSimTime;
+
+	this->_engineQueue.clear();
+	for(const auto &engine : this->_engines)
+		this->_engineQueue.emplace(this->_simTime, engine);
+
+	this->_engineUpdateTimes.clear();
+	this->_tfManager.resetExecutionTimes();
+
+	// Steps that were waited on above are not timed
+	for(auto &stepMetrics : this->_engineStepMetrics)
+	{
+		stepMetrics.second.StepRunning = false;
+		stepMetrics.second.NumSteps = 1;
+	}
+}
+
+void SimulationLoop::stopEngineProcesses(unsigned int killWait)
+{
+	std::vector<std::future<pid_t> > stopThreads;
+	stopThreads.reserve(this->_engines.size());
+
+	for(const auto &engine : this->_engines)
+		stopThreads.push_back(std::async(std::launch::async, &EngineInterface::stopEngineProcess, engine.get(), killWait));
+
+	for(size_t i = 0; i < stopThreads.size(); ++i)
+	{
+		try
+		{
+			stopThreads[i].get();
+		}
+		catch(std::exception &e)
+		{
+			NRPException::logCreate(e, "Failed to stop process of engine \"" + this->_engines[i]->engineName() + "\"");
+		}
+	}
 }
 
 void SimulationLoop::runLoop(SimulationTime runLoopTime)
@@ -81,24 +181,39 @@ void SimulationLoop::runLoop(SimulationTime runLoopTime)
 		// Wait for engines to complete execution
 		for(const auto &engine : processedEngines)
 		{
+			const auto timeout = this->engineStepTimeout(engine);
 			try
 			{
-				engine->waitForStepCompletion(engine->engineConfigGeneral()->engineCommandTimeout());
+				engine->waitForStepCompletion(timeout);
 			}
 			catch(std::exception &e)
 			{
 				throw NRPException::logCreate(e, "Engine \"" + engine->engineName() +"\" loop exceeded timeout of " +
-				                              std::to_string(engine->engineConfigGeneral()->engineCommandTimeout()) + "s");
+				                              std::to_string(timeout) + "s");
 			}
+
+			// Engines are waited for one after another. Use each engine's own completion time, not the time the wait returned
+			auto &stepMetrics = this->_engineStepMetrics[engine.get()];
+			if(stepMetrics.StepRunning && stepMetrics.StepDuration != nullptr)
+				stepMetrics.StepDuration->observeDuration(engine->stepCompletionTime() - stepMetrics.StepStart);
+
+			stepMetrics.StepRunning = false;
 		}
 
+		for(const auto &engine : processedEngines)
+			this->_engineUpdateTimes[engine->engineName()] = this->_simTime;
+
+		this->_loopStepCounter->increment();
+
 		// Retrive devices from processed engines
-		const auto requestedDeviceIDs = this->_tfManager.updateRequestedDeviceIDs();
+		const auto &requestedDeviceIDs = this->_tfManager.updateRequestedDeviceIDs();
+		const auto &requestedDeviceHistories = this->_tfManager.updateRequestedDeviceHistories();
 		EngineInterface::device_outputs_t outputDevices;
 		try
 		{
 			for(auto &engine : processedEngines)
 			{
+				engine->setDeviceHistoryCapacities(requestedDeviceHistories);
 				engine->requestOutputDevices(requestedDeviceIDs);
 			}
 		}
@@ -112,7 +227,7 @@ void SimulationLoop::runLoop(SimulationTime runLoopTime)
 		TransceiverFunctionSortedResults results;
 		for(const auto &engine : processedEngines)
 		{
-			auto curResults = this->_tfManager.executeActiveLinkedTFs(engine->engineName());
+			auto curResults = this->_tfManager.executeActiveLinkedTFs(engine->engineName(), this->_simTime, this->_engineUpdateTimes);
 			results.addResults(curResults);
 		}
 
@@ -132,10 +247,21 @@ void SimulationLoop::runLoop(SimulationTime runLoopTime)
 		// Restart engines loops
 		for(auto &engine : processedEngines)
 		{
-			const auto trueRunTime = this->_simTime - engine->getEngineTime() + engine->getEngineTimestep();
+			const auto runTime = this->engineRunTime(engine, loopStopTime);
+			const auto trueRunTime = this->_simTime - engine->getEngineTime() + runTime;
 
 			if(trueRunTime >= SimulationTime::zero())
 			{
+				auto &stepMetrics = this->_engineStepMetrics[engine.get()];
+				stepMetrics.StepStart = std::chrono::steady_clock::now();
+				stepMetrics.StepRunning = true;
+
+				// Catching up to the simulation time may add timesteps on top of the planned run time
+				const auto timestep = engine->getEngineTimestep();
+				stepMetrics.NumSteps = timestep > SimulationTime::zero()
+				        ? std::max<SimulationTime::rep>((trueRunTime + timestep - SimulationTime(1)) / timestep, 1)
+				        : 1;
+
 				try
 				{
 					engine->runLoopStep(trueRunTime);
@@ -146,14 +272,12 @@ void SimulationLoop::runLoop(SimulationTime runLoopTime)
 				}
 
 				// Reinsert engines into queue
-				this->_engineQueue.emplace(this->_simTime + engine->getEngineTimestep(), engine);
+				this->_engineQueue.emplace(this->_simTime + runTime, engine);
 			}
 			else
 			{
-				const auto timeDiff = fromSimulationTime<float, std::ratio<1>>(engine->getEngineTime() - this->_simTime);
-
-				NRPLogger::SPDWarnLogDefault("Engine \"" + engine->engineName() + "\" is ahead of simulation time by " +
-				                             std::to_string(timeDiff) + "s\n");
+				NRP_LOG_WARN("Engine \"{}\" is ahead of simulation time by {}s", engine->engineName(),
+				             fromSimulationTime<float, std::ratio<1>>(engine->getEngineTime() - this->_simTime));
 
 				// Wait for rest of simulation to catch up to engine
 				this->_engineQueue.emplace(engine->getEngineTime(), engine);
@@ -174,10 +298,15 @@ TransceiverFunctionManager SimulationLoop::initTFManager(const SimulationConfigS
 
 	{
 		TransceiverFunctionInterpreter::engines_devices_t engineDevs;
+		TransceiverFunctionInterpreter::engines_device_histories_t engineDevHistories;
 		for(const auto &engine : engines)
+		{
 			engineDevs.emplace(engine->engineName(), &(engine->getOutputDevices()));
+			engineDevHistories.emplace(engine->engineName(), &(engine->getDeviceHistories()));
+		}
 
 		newManager.getInterpreter().setEngineDevices(std::move(engineDevs));
+		newManager.getInterpreter().setEngineDeviceHistories(std::move(engineDevHistories));
 	}
 
 	TransceiverDeviceInterface::setTFInterpreter(&newManager.getInterpreter());
@@ -189,6 +318,28 @@ TransceiverFunctionManager SimulationLoop::initTFManager(const SimulationConfigS
 	return newManager;
 }
 
+SimulationTime SimulationLoop::engineRunTime(const EngineInterfaceSharedPtr &engine, SimulationTime loopStopTime) const
+{
+	const auto timestep = engine->getEngineTimestep();
+	if(timestep <= SimulationTime::zero())
+		return timestep;
+
+	// Run as many timesteps as possible without missing a TF execution or overshooting the end of the loop.
+	// Always run at least one timestep
+	const auto lookahead = std::min(this->_tfManager.engineLookahead(engine->engineName()), loopStopTime - this->_simTime);
+	const auto numSteps = std::max<SimulationTime::rep>(lookahead / timestep, 1);
+
+	return numSteps * timestep;
+}
+
+float SimulationLoop::engineStepTimeout(const EngineInterfaceSharedPtr &engine) const
+{
+	const auto stepMetricsIt = this->_engineStepMetrics.find(engine.get());
+	const auto numSteps = stepMetricsIt != this->_engineStepMetrics.end() ? stepMetricsIt->second.NumSteps : 1;
+
+	return engine->engineConfigGeneral()->engineCommandTimeout() * static_cast<float>(numSteps);
+}
+
 void SimulationLoop::handleInputDevices(const EngineInterfaceSharedPtr &engine, const TransceiverFunctionSortedResults &results)
 {
 	// Find corresponding device inputs
@@ -219,5 +370,8 @@ During the simulation, several components are managed by the SimulationLoop:
 
 On shutdown, each engine is issued a shutdown command to close gracefully.
 
+After initialization, the SimulationLoop asks each engine to store a snapshot of its state. If all engines support this, SimulationLoop::restoreSnapshot() returns the
+simulation to its initial state without relaunching any engine processes. Engines that do not support snapshots only disable this reset.
+
 The entire loop is executed within one function, SimulationLoop::runLoop. Should any of the above steps fail, an exception is thrown.
  */
@@ -28,6 +28,9 @@
 #include "nrp_general_library/transceiver_function/transceiver_function_sorted_results.h"
 
 #include "nrp_general_library/engine_interfaces/engine_interface.h"
+#include "nrp_general_library/utils/nrp_metrics.h"
+
+#include <chrono>
 
 /*!
  * \brief Manages simulation loop. Runs physics and brain interface, and synchronizes them via Transfer Functions
@@ -46,6 +49,32 @@ class SimulationLoop
 		 */
 		void initLoop();
 
+		/*!
+		 * \brief Store the state of all engines. Called by initLoop(), so that the simulation can be reset without relaunching engines.
+		 * Must only be called while no engine step is running
+		 * \return Returns true if all engines stored their state, false otherwise
+		 */
+		bool saveSnapshot();
+
+		/*!
+		 * \brief Return all engines to the state stored by saveSnapshot(), and reset the simulation time.
+		 * Waits for running engine steps to complete before restoring
+		 * \throw Throws if no snapshot is available
+		 */
+		void restoreSnapshot();
+
+		/*!
+		 * \brief Stop all engine processes concurrently, so that teardown takes as long as the slowest engine instead of the sum of all
+		 * \param killWait Time (in seconds) to wait for each process to quit by itself before force killing it
+		 */
+		void stopEngineProcesses(unsigned int killWait);
+
+		/*!
+		 * \brief Is a snapshot of all engines available?
+		 */
+		inline bool hasSnapshot() const
+		{	return this->_hasSnapshot;	}
+
 		/*!
 		 * \brief Runs a single loop step
 		 * \param timeStep How long the single components should run (in seconds)
@@ -83,6 +112,11 @@ class SimulationLoop
 		 */
 		engine_queue_t _engineQueue;
 
+		/*!
+		 * \brief Time at which each engine last completed a step, mapped by engine name
+		 */
+		TransceiverFunctionManager::engine_times_t _engineUpdateTimes;
+
 		/*!
 		 * \brief TF Manager containing all TFs associated with this simulation
 		 */
@@ -91,7 +125,53 @@ class SimulationLoop
 		/*!
 		 * \brief Simulated time (in seconds)
 		 */
-		SimulationTime _simTime;
+		SimulationTime _simTime = SimulationTime::zero();
+
+		/*!
+		 * \brief Simulation time at which the engine snapshots were stored
+		 */
+		SimulationTime _snapshotSimTime = SimulationTime::zero();
+
+		/*!
+		 * \brief True if all engines stored a snapshot at _snapshotSimTime
+		 */
+		bool _hasSnapshot = false;
+
+		/*!
+		 * \brief Step timing of a single engine
+		 */
+		struct EngineStepMetrics
+		{
+			/*!
+			 * \brief Wall-clock time from starting an engine step until its completion
+			 */
+			MetricHistogram *StepDuration = nullptr;
+
+			/*!
+			 * \brief Start of the currently running step
+			 */
+			std::chrono::steady_clock::time_point StepStart;
+
+			/*!
+			 * \brief True while a step started by this loop is running
+			 */
+			bool StepRunning = false;
+
+			/*!
+			 * \brief Number of engine timesteps combined in the currently running step
+			 */
+			SimulationTime::rep NumSteps = 1;
+		};
+
+		/*!
+		 * \brief Step timings, mapped by engine
+		 */
+		std::map<const EngineInterface*, EngineStepMetrics> _engineStepMetrics;
+
+		/*!
+		 * \brief Number of synchronization steps performed by runLoop()
+		 */
+		MetricCounter *_loopStepCounter = &NRPMetrics::instance().counter("nrp_simulation_loop_steps_total", "Number of synchronization steps performed by the simulation loop");
 
 		/*!
 		 * \brief Initialize the TF Manager. Reads the TF Configurations from the Simulation Config, and registers the TFs
@@ -101,6 +181,23 @@ class SimulationLoop
 		 */
 		static TransceiverFunctionManager initTFManager(const SimulationConfigSharedPtr &simConfig, const engine_interfaces_t &engines);
 
+		/*!
+		 * \brief Get time an engine should run until its next synchronization.
+		 * Multiple engine timesteps are combined if no TF requires the engine's devices in between
+		 * \param engine Engine to run
+		 * \param loopStopTime End time of current runLoop() call
+		 * \return Returns multiple of the engine timestep
+		 */
+		SimulationTime engineRunTime(const EngineInterfaceSharedPtr &engine, SimulationTime loopStopTime) const;
+
+		/*!
+		 * \brief Get time to wait for an engine to complete its running step.
+		 * The engine's command timeout applies to each timestep combined in the step
+		 * \param engine Engine to wait for
+		 * \return Returns timeout in seconds
+		 */
+		float engineStepTimeout(const EngineInterfaceSharedPtr &engine) const;
+
 		/*!
 		 * \brief Handle device intputs of specified interface
 		 * \param interfacePtr Shared Pointer to interface
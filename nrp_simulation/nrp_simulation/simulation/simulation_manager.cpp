@@ -22,6 +22,7 @@
 
 #include "nrp_simulation/simulation/simulation_manager.h"
 
+#include "nrp_general_library/utils/cpu_affinity.h"
 #include "nrp_general_library/utils/file_finder.h"
 #include "nrp_general_library/utils/nrp_exceptions.h"
 #include "nrp_simulation/config/cmake_conf.h"
@@ -45,7 +46,13 @@ cxxopts::Options SimulationParams::createStartParamParser()
 	        (SimulationParams::ParamPluginsLong.data(), SimulationParams::ParamPluginsDesc.data(),
 	         cxxopts::value<SimulationParams::ParamPluginsT>()->default_value({}))
 	        (SimulationParams::ParamExpManPipeLong.data(), SimulationParams::ParamExpManPipeDesc.data(),
-	         cxxopts::value<SimulationParams::ParamExpManPipeT>()->default_value({}));
+	         cxxopts::value<SimulationParams::ParamExpManPipeT>()->default_value({}))
+	        (SimulationParams::ParamLogQueueLong.data(), SimulationParams::ParamLogQueueDesc.data(),
+	         cxxopts::value<SimulationParams::ParamLogQueueT>()->default_value("0"))
+	        (SimulationParams::ParamMetricsFileLong.data(), SimulationParams::ParamMetricsFileDesc.data(),
+	         cxxopts::value<SimulationParams::ParamMetricsFileT>()->default_value(SimulationParams::ParamMetricsFileDef.data()))
+	        (SimulationParams::ParamMetricsIntervalLong.data(), SimulationParams::ParamMetricsIntervalDesc.data(),
+	         cxxopts::value<SimulationParams::ParamMetricsIntervalT>()->default_value(SimulationParams::ParamMetricsIntervalDef.data()));
 
 	return opts;
 }
@@ -173,6 +180,16 @@ void SimulationManager::initSimulationLoop(const EngineLauncherManagerConstShare
 	spdlog::info("Initializing simulation loop");
 	this->_loop.reset(new SimulationLoop(this->createSimLoop(engineLauncherManager, processLauncherManager)));
 
+	// Pin the thread running the loop. Engines forked later on reset their placement before exec
+	try
+	{
+		CPUAffinity::applyPlacement(this->_simConfig->simulationLoopCPUAffinity(), this->_simConfig->simulationLoopNUMANode());
+	}
+	catch(std::exception &e)
+	{
+		spdlog::warn("Couldn't apply CPU placement for simulation loop: {}", e.what());
+	}
+
 	//sleep(10);
 
 	this->_loop->initLoop();
@@ -256,8 +273,32 @@ bool SimulationManager::runSimulation(const SimulationTime secs, sim_lock_t &sim
 	return endTime <= this->_loop->getSimTime();
 }
 
+bool SimulationManager::resetSimulation(sim_lock_t &simLock)
+{
+	if(this->_loop == nullptr || !this->_loop->hasSnapshot())
+		return false;
+
+	// Stop running simulation. Wait for the current step to complete by acquiring _internalLock, which must be locked before simLock
+	this->_runningSimulation = false;
+
+	if(simLock.owns_lock())
+		simLock.unlock();
+
+	sim_lock_t internalLock(this->_internalLock);
+
+	simLock.lock();
+
+	spdlog::info("Resetting simulation");
+	this->_loop->restoreSnapshot();
+
+	return true;
+}
+
 void SimulationManager::shutdownLoop(const SimulationManager::sim_lock_t&)
 {
+	if(this->_loop != nullptr)
+		this->_loop->stopEngineProcesses(SimulationManager::EngineStopTimeout);
+
 	this->_loop = nullptr;
 	this->_runningSimulation = false;
 }
@@ -267,8 +308,9 @@ bool SimulationManager::isSimInitializing()
 	if(this->_loop != nullptr)
 		return false;
 
+	// initSimulationLoop holds _internalLock until the loop is set up
 	sim_lock_t lock(this->_internalLock, std::defer_lock);
-	return lock.try_lock();
+	return !lock.try_lock();
 }
 
 SimulationLoop SimulationManager::createSimLoop(const EngineLauncherManagerConstSharedPtr &engineManager, const MainProcessLauncherManager::const_shared_ptr &processLauncherManager)
@@ -69,6 +69,23 @@ struct SimulationParams
 	static constexpr std::string_view ParamExpManPipeDesc = "Experiment Manager Pipe File Descriptors (two integers, separated by a comma)";
 	using ParamExpManPipeT = std::vector<int>;
 
+	static constexpr std::string_view ParamLogQueue = "l";
+	static constexpr std::string_view ParamLogQueueLong = "l,log_queue";
+	static constexpr std::string_view ParamLogQueueDesc = "Write log messages asynchronously, queueing up to the given number of messages. Oldest messages are dropped if the queue is full. 0 logs synchronously";
+	using ParamLogQueueT = size_t;
+
+	static constexpr std::string_view ParamMetricsFile = "metrics_file";
+	static constexpr std::string_view ParamMetricsFileLong = "metrics_file";
+	static constexpr std::string_view ParamMetricsFileDesc = "Write performance metrics in the Prometheus text format to the given file while the simulation runs, and once more when it ends";
+	static constexpr std::string_view ParamMetricsFileDef = "";
+	using ParamMetricsFileT = std::string;
+
+	static constexpr std::string_view ParamMetricsInterval = "metrics_interval";
+	static constexpr std::string_view ParamMetricsIntervalLong = "metrics_interval";
+	static constexpr std::string_view ParamMetricsIntervalDesc = "Time (in seconds) between updates of the metrics file. 0 only writes it when the simulation ends";
+	static constexpr std::string_view ParamMetricsIntervalDef = "10";
+	using ParamMetricsIntervalT = float;
+
 	/*!
 	 * \brief Create a parser for start parameters
 	 * \return Returns parser
@@ -94,6 +111,11 @@ class SimulationManager
 		using sim_mutex_t = std::mutex;
 		using sim_lock_t = std::unique_lock<sim_mutex_t>;
 
+		/*!
+		 * \brief Time (in seconds) engine processes are given to quit on shutdown before they are killed
+		 */
+		static constexpr unsigned int EngineStopTimeout = 60;
+
 		/*!
 		 * \brief Constructor
 		 * \param serverConfig Server configuration
@@ -174,6 +196,13 @@ class SimulationManager
 		 */
 		bool runSimulation(const SimulationTime secs, sim_lock_t &simLock);
 
+		/*!
+		 * \brief Return the simulation to its initial state without relaunching engines. Any running simulation is stopped first
+		 * \param simLock Pass simulation lock if already owned
+		 * \return Returns true if the simulation was reset, false if no loop is loaded or the engines do not support snapshots
+		 */
+		bool resetSimulation(sim_lock_t &simLock);
+
 		/*!
 		 * \brief Shuts down simulation loop. Will shutdown any running engines and transceiver functions after any currently running steps are completed
 		 * \param simLock Pass simulation lock if already owned
@@ -24,101 +24,172 @@
 
 #include "nrp_general_library/utils/nrp_exceptions.h"
 
+#include <algorithm>
 #include <assert.h>
 #include <iostream>
 #include <limits>
+#include <poll.h>
 #include <string.h>
-#include <sys/signalfd.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
-PipeCommPacket PipeCommPacket::readPipePacket(PipePacketCommunication &comm, uint16_t numTries, uint16_t waitTime)
+/*!
+ * \brief Wait until fd is ready for the given poll events
+ * \return Returns false on timeout or error
+ */
+static bool waitForFD(int fd, short events, int timeout)
 {
-	PipeCommPacket packet;
+	pollfd fdPoll = {fd, events, 0};
+
+	int res;
+	while((res = poll(&fdPoll, 1, timeout)) < 0 && errno == EINTR)
+	{}
+
+	return res > 0;
+}
 
-	// Read header and data size
-	if(const auto readBytes = comm.readP(&packet, PipeCommPacket::HeaderSize, numTries, waitTime) < (ssize_t)PipeCommPacket::HeaderSize)
+/*!
+ * \brief Transfer all data described by iov. Partial transfers are continued once the non-blocking pipe is ready again
+ * \param fd Pipe file descriptor
+ * \param iov Data buffers. Will be modified
+ * \param iovCount Number of buffers
+ * \param timeout Time (in ms) to wait for the pipe to become ready
+ * \param waitIfEmpty Should we wait if no data has been transferred yet? If false, return immediately if the pipe isn't ready
+ * \return Returns number of transferred bytes
+ */
+template<bool READ>
+static size_t transferAll(int fd, iovec *iov, int iovCount, int timeout, bool waitIfEmpty = true)
+{
+	size_t totalProcessed = 0;
+	size_t processed = 0;
+	while(true)
 	{
-		if(readBytes > 0)
-			NRPLogger::SPDWarnLogDefault("Read only part of a packet's static header");
+		// Skip completely transferred buffers
+		while(iovCount > 0 && processed >= iov->iov_len)
+		{
+			processed -= iov->iov_len;
+			++iov;
+			--iovCount;
+		}
 
-		packet.ID = 0;
-		return packet;
+		if(iovCount <= 0)
+			return totalProcessed;
+
+		iov->iov_base = static_cast<uint8_t*>(iov->iov_base) + processed;
+		iov->iov_len -= processed;
+
+		const auto res = READ ? readv(fd, iov, iovCount) : writev(fd, iov, iovCount);
+		if(res > 0)
+		{
+			processed = static_cast<size_t>(res);
+			totalProcessed += processed;
+			continue;
+		}
+
+		processed = 0;
+
+		// EOF
+		if(res == 0)
+			return totalProcessed;
+
+		if(errno == EINTR)
+			continue;
+
+		// Pipe not ready
+		if((errno != EAGAIN && errno != EWOULDBLOCK) || (!waitIfEmpty && totalProcessed == 0) ||
+		        !waitForFD(fd, READ ? POLLIN : POLLOUT, timeout))
+			return totalProcessed;
 	}
+}
 
-	// Read header command
-	packet.Command.resize(packet.CommandLength);
+PipeCommPacket PipeCommPacket::readPipePacket(PipePacketCommunication &comm, int timeout)
+{
+	PipeCommPacket packet;
 
-	if(const auto readBytes = comm.readP(packet.Command.data(), packet.CommandLength, numTries, waitTime) < (ssize_t)packet.CommandLength)
+	// Read header
+	iovec header[3] = {{&packet.CommandLength, sizeof(packet.CommandLength)},
+	                   {&packet.DataLength, sizeof(packet.DataLength)},
+	                   {&packet.ID, sizeof(packet.ID)}};
+
+	if(const auto readBytes = transferAll<true>(comm.readFd(), header, 3, timeout, false); readBytes < PipeCommPacket::HeaderSize)
 	{
 		if(readBytes > 0)
-			NRPLogger::SPDWarnLogDefault("Read only part of a packet's command");
+			NRPLogger::SPDWarnLogDefault("Read only part of a packet's static header");
 
 		packet.ID = 0;
 		return packet;
 	}
 
-	// Read data
+	// Read command and data in one go
+	packet.Command.resize(packet.CommandLength);
 	packet.Data.resize(packet.DataLength);
 
-	if(const auto readBytes = comm.readP(packet.Data.data(), packet.Data.size(), numTries, waitTime) < (ssize_t)packet.Data.size())
+	iovec body[2] = {{packet.Command.data(), packet.CommandLength},
+	                 {packet.Data.data(), packet.DataLength}};
+
+	if(transferAll<true>(comm.readFd(), body, 2, timeout) < packet.CommandLength + packet.DataLength)
 	{
-		if(readBytes > 0)
-			NRPLogger::SPDWarnLogDefault("Read only part of a packet's data");
+		NRPLogger::SPDWarnLogDefault("Read only part of packet with ID " + std::to_string(packet.ID));
 
 		packet.ID = 0;
 		return packet;
 	}
 
+	// Remove terminating '\0' transferred with the command
+	if(!packet.Command.empty())
+		packet.Command.pop_back();
+
 	return packet;
 }
 
-bool PipeCommPacket::writePipePacket(PipePacketCommunication &comm, PipeCommPacket &packet, uint16_t numTries, uint16_t waitTime)
+bool PipeCommPacket::writePipePacket(PipePacketCommunication &comm, PipeCommPacket &packet, int timeout)
 {
 	packet.CommandLength = packet.Command.size()+1;
 	packet.DataLength = packet.Data.size();
 
-	if(comm.writeP(&packet, PipeCommPacket::HeaderSize, numTries, waitTime) < (ssize_t)PipeCommPacket::HeaderSize)
-	{
-		NRPLogger::SPDErrLogDefault("Failed to write packet header with ID " + std::to_string(packet.ID));
-		return false;
-	}
+	iovec iov[5] = {{&packet.CommandLength, sizeof(packet.CommandLength)},
+	                {&packet.DataLength, sizeof(packet.DataLength)},
+	                {&packet.ID, sizeof(packet.ID)},
+	                {packet.Command.data(), packet.CommandLength},
+	                {packet.Data.data(), packet.DataLength}};
 
-	if(comm.writeP(packet.Command.data(), packet.CommandLength, numTries, waitTime) < (ssize_t)packet.CommandLength)
+	if(transferAll<false>(comm.writeFd(), iov, 5, timeout) < PipeCommPacket::HeaderSize + packet.CommandLength + packet.DataLength)
 	{
-		NRPLogger::SPDErrLogDefault("Failed to write packet command \"" + packet.Command + "\"");
-		return false;
-	}
-
-	if(comm.writeP(packet.Data.data(), packet.DataLength, numTries, waitTime) < (ssize_t)packet.DataLength)
-	{
-		NRPLogger::SPDErrLogDefault("Failed to write packet data");
+		NRPLogger::SPDErrLogDefault("Failed to write packet with ID " + std::to_string(packet.ID) + " and command \"" + packet.Command + "\"");
 		return false;
 	}
 
 	return  true;
 }
 
-PipePacketCommunication::PipePacketCommunication(PipeCommunication &&comm, pid_t commPID, uint16_t confirmSignalOffsetNum)
+bool PipeCommPacket::writeReceipt(PipePacketCommunication &comm, packet_id_t id, int timeout)
+{
+	size_t commandLength = 0;
+	size_t dataLength = 0;
+
+	iovec iov[3] = {{&commandLength, sizeof(commandLength)},
+	                {&dataLength, sizeof(dataLength)},
+	                {&id, sizeof(id)}};
+
+	return transferAll<false>(comm.writeFd(), iov, 3, timeout) == PipeCommPacket::HeaderSize;
+}
+
+PipePacketCommunication::PipePacketCommunication(PipeCommunication &&comm)
     : PipeCommunication(std::move(comm)),
-      _confirmSignalOffsetNum(confirmSignalOffsetNum),
-      _commPID(commPID)
+      _wakeFD(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
 {
+	if(this->_wakeFD < 0)
+		throw NRPException::logCreate(std::string("Could not create eventfd: ") + strerror(errno));
+
 	this->startServerAsync();
 }
 
 PipePacketCommunication::~PipePacketCommunication()
 {
 	this->shutdownServer();
-}
-
-void PipePacketCommunication::blockResetSignal(uint16_t confirmSignalOffsetNum)
-{
-	// Block signal from main thread
-	const auto resetSignal = PipePacketCommunication::getResetSignalNum(confirmSignalOffsetNum);
-	const auto signal = PipePacketCommunication::generateSigset(resetSignal);
 
-	if(sigprocmask(SIG_BLOCK, &signal, nullptr) != 0)
-		throw NRPException::logCreate("Could not block proc communication signal " + std::to_string(resetSignal) + ":" + strerror(errno));
+	close(this->_wakeFD);
 }
 
 void PipePacketCommunication::startServerAsync()
@@ -138,11 +209,10 @@ void PipePacketCommunication::shutdownServer()
 	{
 		assert(this->_commThread.joinable());
 
-		// Block signal from main thread. Will also affect any threads created by this one
-		PipePacketCommunication::blockResetSignal(this->_confirmSignalOffsetNum);
-
 		// Stop communication thread and wait for it to complete
 		this->_commRunning = false;
+		this->wakeCommHandler();
+
 		this->_commThread.join();
 	}
 }
@@ -152,12 +222,6 @@ bool PipePacketCommunication::isRunning() const
 	return this->_commRunning;
 }
 
-uint16_t PipePacketCommunication::confirmSignalOffsetNum() const
-{	return this->_confirmSignalOffsetNum;	}
-
-int PipePacketCommunication::resetSignalNum() const
-{	return getResetSignalNum(this->_confirmSignalOffsetNum);	}
-
 PipeCommPacket::packet_id_t PipePacketCommunication::issuePackID()
 {
 	if(this->_nextPackID <= 0)
@@ -176,38 +240,45 @@ PipeCommPacket::packet_id_t PipePacketCommunication::sendPacket(PipeCommPacket &
 
 	PipeCommPacket::packet_id_t retVal = packet.ID;
 
-	lock_t lock(this->_inPackLock);
-	this->_inPackets.push_back(std::move(packet));
+	{
+		lock_t lock(this->_outPackLock);
+		this->_outPackets.push_back(std::move(packet));
+	}
+
+	this->wakeCommHandler();
 
 	return retVal;
 }
 
 PipeCommPacket::packet_id_t PipePacketCommunication::sendPacketImmediately(PipeCommPacket &&packet)
 {
-	bool restartServer;
+	// Stop server if it's running. Must happen before acquiring _outPackLock, the communication thread takes it on every iteration
+	const bool restartServer = this->isRunning();
+	if(restartServer)
+		this->shutdownServer();
+
+	PipeCommPacket::packet_id_t retVal;
 	{
 		lock_t lock(this->_outPackLock);
 
-		restartServer  = this->isRunning();
-
-		// Stop server if it's running
-		if(restartServer)
-			this->shutdownServer();
-
 		// Assign ID if requested
-		if(packet.ID < 0)
+		if(packet.ID <= 0)
 			packet.ID = this->issuePackID();
 
-		// Send packet
-		if(!PipeCommPacket::writePipePacket(*this, packet, CommWriteTries, CommWriteWaitTime))
-			packet.ID = -1;
+		retVal = packet.ID;
+
+		// Send packet. Track it so that the partner's receipt is matched once the server restarts
+		if(PipeCommPacket::writePipePacket(*this, packet, CommTimeout))
+			this->_sentPackets.push_back(std::move(packet));
+		else
+			retVal = -1;
 	}
 
 	// Restart server if previously running
 	if(restartServer)
 		this->startServerAsync();
 
-	return packet.ID;
+	return retVal;
 }
 
 PipePacketCommunication::lock_t PipePacketCommunication::acquireInPacketLock()
@@ -220,12 +291,12 @@ bool PipePacketCommunication::readPacketReady() const
 	return !this->_inPackets.empty();
 }
 
-PipeCommPacket &&PipePacketCommunication::retrievePacket()
+PipeCommPacket PipePacketCommunication::retrievePacket()
 {
-	return std::get<0>(this->retrievePacket(this->acquireInPacketLock()));
+	return std::move(std::get<0>(this->retrievePacket(this->acquireInPacketLock())));
 }
 
-std::tuple<PipeCommPacket &&, PipePacketCommunication::lock_t> PipePacketCommunication::retrievePacket(PipePacketCommunication::lock_t &&inPacketLock)
+std::tuple<PipeCommPacket, PipePacketCommunication::lock_t> PipePacketCommunication::retrievePacket(PipePacketCommunication::lock_t &&inPacketLock)
 {
 	if(this->_inPackets.empty())
 		throw PipePacketCommunication::no_packets();
@@ -238,92 +309,88 @@ std::tuple<PipeCommPacket &&, PipePacketCommunication::lock_t> PipePacketCommuni
 
 void PipePacketCommunication::commHandler()
 {
-	// Setup signal handler
-	const auto sigNum = PipePacketCommunication::getResetSignalNum(this->_confirmSignalOffsetNum);
-	const auto signal = PipePacketCommunication::generateSigset(sigNum);
-	const auto sigFd = signalfd(-1, &signal, SFD_NONBLOCK);
-	if(sigFd < 0)
-		throw NRPException::logCreate(std::string("Could not create signalfd: ") + strerror(errno));
-
-	auto outIter = this->_outPackets.begin();
+	// Sleep until either the partner sends data or a packet is queued
+	pollfd fdPolls[2] = {{this->readFd(), POLLIN, 0},
+	                     {this->_wakeFD, POLLIN, 0}};
 
 	// Continue handling data until comm is shut down
 	while(this->_commRunning)
 	{
-		// Read available packets
+		if(poll(fdPolls, 2, -1) < 0)
 		{
-			PipeCommPacket recPacket = PipeCommPacket::readPipePacket(*this, CommReadTries, CommReadWaitTime);
-			if(recPacket.ID > 0)
-			{
-				{
-					lock_t lock(this->_inPackLock);
-					this->_inPackets.push_back(std::move(recPacket));
-				}
+			if(errno == EINTR)
+				continue;
 
-				sigqueue(this->_commPID, sigNum, {recPacket.ID});
-			}
+			throw NRPException::logCreate(std::string("Unable to poll communication pipe: ") + strerror(errno));
 		}
 
-		// Send any packets
-		if(!this->_outPackets.empty())
+		if(fdPolls[1].revents & POLLIN)
 		{
-			lock_t lock(this->_outPackLock);
+			uint64_t wakeCount;
+			[[maybe_unused]] const auto res = read(this->_wakeFD, &wakeCount, sizeof(wakeCount));
+		}
 
-			uint16_t sentPackets = 0;
-			while(outIter != this->_outPackets.end() && sentPackets < CommWritePackets)
+		// Read available packets
+		if(fdPolls[0].revents & (POLLIN | POLLHUP))
+		{
+			PipeCommPacket recPacket = PipeCommPacket::readPipePacket(*this, CommTimeout);
+			if(recPacket.ID > 0)
 			{
-				if(!PipeCommPacket::writePipePacket(*this, *outIter, CommWriteTries, CommWriteWaitTime))
-					NRPLogger::SPDErrLogDefault("Unable to send packet with ID " + std::to_string(outIter->ID));
+				if(recPacket.isReceipt())
+				{
+					// Remove confirmed packet
+					const auto sentIt = std::find_if(this->_sentPackets.begin(), this->_sentPackets.end(),
+					                                 [&recPacket](const PipeCommPacket &sentPacket) { return sentPacket.ID == recPacket.ID; });
+					if(sentIt != this->_sentPackets.end())
+						this->_sentPackets.erase(sentIt);
+					else
+						NRPLogger::SPDWarnLogDefault("Received receipt for unsent ID " + std::to_string(recPacket.ID));
+				}
 				else
-					outIter++;
+				{
+					const auto recID = recPacket.ID;
+					{
+						lock_t lock(this->_inPackLock);
+						this->_inPackets.push_back(std::move(recPacket));
+					}
 
-				sentPackets++;
+					if(!PipeCommPacket::writeReceipt(*this, recID, CommTimeout))
+						NRPLogger::SPDErrLogDefault("Unable to confirm receipt of packet with ID " + std::to_string(recID));
+				}
+			}
+			else if(fdPolls[0].revents & POLLHUP)
+			{
+				// Partner closed its end, stop polling it
+				fdPolls[0].fd = -1;
 			}
 		}
 
-		// Check that packets were received
-		constexpr size_t SigSize = sizeof(signalfd_siginfo);
+		// Send any packets
+		lock_t lock(this->_outPackLock);
 
-		// Check signalfd and remove confirmed packets from _outPackets
-		size_t readData;
-		signalfd_siginfo signalDat;
-		while(ssize_t readBytes = read(sigFd, &signalDat, SigSize > 0))
+		uint16_t sentPackets = 0;
+		while(!this->_outPackets.empty() && sentPackets < CommWritePackets)
 		{
-			// Make sure entire signalfd_siginfo struct was read
-			readData = static_cast<size_t>(readBytes);
-			while(readData < SigSize)
+			if(!PipeCommPacket::writePipePacket(*this, this->_outPackets.front(), CommTimeout))
 			{
-				readBytes = read(sigFd, reinterpret_cast<uint8_t*>(&signalDat)+readData, SigSize - readData);
-				if(readBytes < 0)
-					throw NRPException::logCreate(std::string("Unable to read from signalfd: ") + strerror(errno));
-
-				readData += static_cast<size_t>(readBytes);
-			}
-
-			// Handle signal, ignore signals not sent by communication partner
-			if(static_cast<int>(signalDat.ssi_pid) != this->_commPID)
+				// Partner is not reading. Drop the packet instead of retrying it indefinitely
+				NRPLogger::SPDErrLogDefault("Unable to send packet with ID " + std::to_string(this->_outPackets.front().ID));
+				this->_outPackets.pop_front();
 				continue;
-
-			assert(static_cast<int>(signalDat.ssi_signo) == sigNum);
-
-			{
-				// Find packet to erase
-				lock_t lock(this->_outPackLock);
-				bool packFound = false;
-				for(auto curIt = this->_outPackets.begin(); curIt != this->_outPackets.end() && curIt != outIter; ++curIt)
-				{
-					if(signalDat.ssi_int == curIt->ID)
-					{
-						packFound = true;
-						this->_outPackets.erase(curIt);
-
-						break;
-					}
-				}
-
-				if(!packFound)
-					NRPLogger::SPDWarnLogDefault("Received signal receipt for unsent ID " + std::to_string(signalDat.ssi_int));
 			}
+
+			this->_sentPackets.splice(this->_sentPackets.end(), this->_outPackets, this->_outPackets.begin());
+			sentPackets++;
 		}
+
+		// More packets remaining, continue sending them after checking for received data
+		if(!this->_outPackets.empty())
+			this->wakeCommHandler();
 	}
 }
+
+void PipePacketCommunication::wakeCommHandler()
+{
+	const uint64_t wake = 1;
+	[[maybe_unused]] const auto res = write(this->_wakeFD, &wake, sizeof(wake));
+}
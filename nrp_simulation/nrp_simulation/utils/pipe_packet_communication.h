@@ -24,18 +24,18 @@
 
 #include "nrp_general_library/utils/pipe_communication.h"
 
+#include <atomic>
 #include <functional>
 #include <list>
 #include <map>
 #include <mutex>
-#include <signal.h>
 #include <thread>
 #include <vector>
 
 class PipePacketCommunication;
 
 /*!
- * \brief Pipe Packet.
+ * \brief Pipe Packet. Header and data are transferred with a single writev call.
  * Header:
  * - size_t CommandLength
  * - size_t DataLength
@@ -44,6 +44,8 @@ class PipePacketCommunication;
  * Data:
  * - std::string Command
  * - std::vector<uint8_t> Data
+ *
+ * A packet with a CommandLength of 0 confirms receipt of the packet with the same ID
  */
 struct PipeCommPacket
 {
@@ -77,24 +79,37 @@ struct PipeCommPacket
 	 */
 	data_t Data;
 
+	/*!
+	 * \brief Is this a receipt confirmation?
+	 */
+	inline bool isReceipt() const
+	{	return this->CommandLength == 0;	}
+
 	/*!
 	 * \brief Read a packet from comm
 	 * \param comm Pipe to use for communication
-	 * \param numTries How often to retry a read
-	 * \param waitTime Time (in seconds) to wait between read tries
+	 * \param timeout Time (in ms) to wait for the remainder of a partially received packet
 	 * \return Returns read sim packet. If nothing was received, ID will be 0
 	 */
-	static PipeCommPacket readPipePacket(PipePacketCommunication &comm, uint16_t numTries = 1, uint16_t waitTime = 0);
+	static PipeCommPacket readPipePacket(PipePacketCommunication &comm, int timeout = 0);
 
 	/*!
 	 * \brief Write a packet to comm. Will adjust packet::CommandLength and packet::DataLength before sending
 	 * \param comm Pipe to use for communication
 	 * \param packet Packet to send
-	 * \param numTries How often to retry a read
-	 * \param waitTime Time (in seconds) to wait between read tries
+	 * \param timeout Time (in ms) to wait for the pipe to accept all data
 	 * \return Returns true on success, fail otherwise
 	 */
-	static bool writePipePacket(PipePacketCommunication &comm, PipeCommPacket &packet, uint16_t numTries = 1, uint16_t waitTime = 0);
+	static bool writePipePacket(PipePacketCommunication &comm, PipeCommPacket &packet, int timeout = 0);
+
+	/*!
+	 * \brief Write a receipt confirmation for the packet with the given ID
+	 * \param comm Pipe to use for communication
+	 * \param id ID of received packet
+	 * \param timeout Time (in ms) to wait for the pipe to accept all data
+	 * \return Returns true on success, fail otherwise
+	 */
+	static bool writeReceipt(PipePacketCommunication &comm, packet_id_t id, int timeout = 0);
 };
 
 /*!
@@ -103,11 +118,10 @@ struct PipeCommPacket
 class PipePacketCommunication
         : protected PipeCommunication
 {
-		static constexpr uint16_t CommReadTries = 2;
-		static constexpr uint16_t CommReadWaitTime = 1;
-
-		static constexpr uint16_t CommWriteTries = 2;
-		static constexpr uint16_t CommWriteWaitTime = 1;
+		/*!
+		 * \brief Time (in ms) to wait for a partially transferred packet to complete
+		 */
+		static constexpr int CommTimeout = 2000;
 
 		/*!
 		 * \brief How many packets should be written at once
@@ -131,36 +145,17 @@ class PipePacketCommunication
 
 
 		/*!
-		 * \brief Constructor. Starts server and blocks subsequent threads from handling resetSignal
+		 * \brief Constructor. Starts server
 		 * \param comm Communication Pipes
-		 * \param commPID PID of communication partner
-		 * \param confirmSignalOffsetNum reset Signal (will be offset from SIGRTMIN)
 		 */
-		PipePacketCommunication(PipeCommunication &&comm, pid_t commPID, uint16_t confirmSignalOffsetNum);
+		PipePacketCommunication(PipeCommunication &&comm);
 		~PipePacketCommunication();
 
-		/*!
-		 * \brief Block current thread from handling given signal. Will also affect any threads created from this one.
-		 * Should be called at process start, before any other threads are spawned
-		 * \param confirmSignalOffsetNum Reset Signal offset from SIGRTMIN
-		 */
-		static void blockResetSignal(uint16_t confirmSignalOffsetNum);
-
 		void startServerAsync();
 		void shutdownServer();
 
 		bool isRunning() const;
 
-		/*!
-		 * \brief Get confirmSignalOffsetNum
-		 */
-		uint16_t confirmSignalOffsetNum() const;
-
-		/*!
-		 * \brief Get resetSignalNum
-		 */
-		int resetSignalNum() const;
-
 		/*!
 		 * \brief Return a new valid Packet ID. Will iterate from 1 to INT_MAX, then restart at 1
 		 */
@@ -196,25 +191,20 @@ class PipePacketCommunication
 		 * \brief Pops available packet from _inPackets
 		 * \exception Will throw PipePacketCommunication::no_packets if no packet is available
 		 */
-		PipeCommPacket &&retrievePacket();
+		PipeCommPacket retrievePacket();
 
 		/*!
 		 * \brief Pops available packet from _inPackets
 		 * \param inPacketLock Lock for received packets
 		 * \exception Will throw PipePacketCommunication::no_packets if no packet is available
 		 */
-		std::tuple<PipeCommPacket&&, lock_t> retrievePacket(lock_t &&inPacketLock);
+		std::tuple<PipeCommPacket, lock_t> retrievePacket(lock_t &&inPacketLock);
 
 	private:
 		/*!
-		 * \brief Reset Signal Offset (base is SIGRTMIN)
-		 */
-		uint16_t _confirmSignalOffsetNum;
-
-		/*!
-		 * \brief PID of communication partner
+		 * \brief eventfd that wakes the communication thread when packets are queued or the server is shut down
 		 */
-		pid_t _commPID;
+		int _wakeFD = -1;
 
 		/*!
 		 * \brief Packet ID to issue to new packet
@@ -224,7 +214,7 @@ class PipePacketCommunication
 		/*!
 		 * \brief Is the server running?
 		 */
-		bool _commRunning = false;
+		std::atomic<bool> _commRunning = false;
 
 		/*!
 		 * \brief Pipe Communication thread
@@ -256,17 +246,15 @@ class PipePacketCommunication
 		 */
 		std::list<PipeCommPacket> _outPackets;
 
-		static inline int getResetSignalNum(uint16_t confirmSignalOffsetNum)
-		{	return SIGRTMIN+confirmSignalOffsetNum;	}
-
-		static inline sigset_t generateSigset(int signal)
-		{
-			sigset_t signalSet;
-			sigemptyset(&signalSet);
-			sigaddset(&signalSet, signal);
+		/*!
+		 * \brief Packets that were sent, but whose receipt was not yet confirmed. Only accessed by the communication thread
+		 */
+		std::list<PipeCommPacket> _sentPackets;
 
-			return signalSet;
-		}
+		/*!
+		 * \brief Wake communication thread
+		 */
+		void wakeCommHandler();
 
 		friend PipeCommPacket;
 };
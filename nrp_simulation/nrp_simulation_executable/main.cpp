@@ -24,9 +24,12 @@
 #include "nrp_general_library/plugin_system/plugin_manager.h"
 #include "nrp_general_library/process_launchers/process_launcher_manager.h"
 #include "nrp_general_library/utils/nrp_exceptions.h"
+#include "nrp_general_library/utils/nrp_metrics.h"
 #include "nrp_general_library/utils/python_interpreter_state.h"
 #include "nrp_general_library/utils/restclient_setup.h"
+#include "nrp_general_library/utils/spdlog_setup.h"
 #include "nrp_simulation/config/cmake_conf.h"
+#include "nrp_simulation/server/simulation_server.h"
 #include "nrp_simulation/simulation/simulation_manager.h"
 
 #include <spdlog/spdlog.h>
@@ -44,7 +47,10 @@ void loadPlugins(const char *libName, PluginManager &pluginManager, const Engine
 	engines->registerLauncher(EngineLauncherInterfaceSharedPtr(engineLauncher.release()));
 }
 
-int main(int argc, char *argv[])
+/*!
+ * \brief Run NRPSimulation. Logs are flushed by main() afterwards, on both normal and error exits
+ */
+int runNRPSimulation(int argc, char *argv[])
 {	
 	RestClientSetup::ensureInstance();
 
@@ -72,6 +78,11 @@ int main(int argc, char *argv[])
 		return 0;
 	}
 
+	// Move log output off the simulation thread if requested
+	const auto logQueueSize = startParams[SimulationParams::ParamLogQueue.data()].as<SimulationParams::ParamLogQueueT>();
+	if(logQueueSize > 0)
+		SPDLogSetup::setAsyncDefault(logQueueSize);
+
 	// Setup Python
 	PythonInterpreterState pythonInterp(argc, argv);
 
@@ -98,9 +109,29 @@ int main(int argc, char *argv[])
 			loadPlugins(libName.c_str(), pluginManager, engines);
 	}
 
+	// Export performance metrics while the simulation runs if requested
+	std::unique_ptr<MetricsFileWriter> metricsWriter;
+	const auto metricsFile = startParams[SimulationParams::ParamMetricsFile.data()].as<SimulationParams::ParamMetricsFileT>();
+	if(!metricsFile.empty())
+	{
+		const std::chrono::duration<float> metricsInterval(startParams[SimulationParams::ParamMetricsInterval.data()].as<SimulationParams::ParamMetricsIntervalT>());
+		metricsWriter.reset(new MetricsFileWriter(metricsFile, std::chrono::duration_cast<std::chrono::milliseconds>(metricsInterval)));
+	}
+
 	// Load simulation
 	SimulationManager manager = SimulationManager::createFromParams(startParams);
 
+	// If launched by the NRPServer, answer its requests over the inherited pipe descriptors
+	std::unique_ptr<SimulationServer> server;
+	const auto expManPipe = startParams[SimulationParams::ParamExpManPipe.data()].as<SimulationParams::ParamExpManPipeT>();
+	if(!expManPipe.empty())
+	{
+		if(expManPipe.size() != 2)
+			throw NRPException::logCreate("Expected two experiment manager pipe descriptors, got " + std::to_string(expManPipe.size()));
+
+		server.reset(new SimulationServer(manager, PipeCommunication(expManPipe[0], expManPipe[1])));
+	}
+
 	// Check if configuration file was specified
 	if(manager.simulationConfig() != nullptr)
 	{
@@ -109,12 +140,50 @@ int main(int argc, char *argv[])
 		auto simLock = manager.acquireSimLock();
 		manager.initSimulationLoop(engines, processLaunchers, simLock);
 
-		manager.runSimulationUntilTimeout(simLock);
+		if(server == nullptr)
+			manager.runSimulationUntilTimeout(simLock);
+		else
+		{
+			simLock.unlock();
+			server->setSimRunning(SimulationRunningData(true, SimulationRunningData::IgnoreTimeout));
+		}
 	}
 
+	// Serve requests until the simulation times out or the NRPServer shuts it down
+	if(server != nullptr)
+	{
+		server->waitForShutdown();
+		server.reset();
+	}
+
+	// Write final performance metrics
+	metricsWriter.reset();
+
 	return 0;
 }
 
+int main(int argc, char *argv[])
+{
+	int retVal = EXIT_FAILURE;
+	try
+	{
+		retVal = runNRPSimulation(argc, argv);
+	}
+	catch(std::exception &e)
+	{
+		NRPException::logOnce(e);
+	}
+	catch(...)
+	{
+		spdlog::error("NRPSimulation failed with an unknown error");
+	}
+
+	// Write out queued log messages
+	SPDLogSetup::shutdownDefault();
+
+	return retVal;
+}
+
 /*! \page nrp_simulation NRPSimulation
 This is the main NRP executable. It can be used to run an experiment locally. With it, a simulation is configured, a SimulationLoop is initialized, and a simulation is run. The process
 is divided into the following steps:
@@ -129,12 +198,22 @@ is divided into the following steps:
   - Store all engines in an EngineLauncherManager
 - Use input parameters to generate a new instance of SimulationManager. This will also launch all engine processes defined in the SimulationConfig passed to NRPSimulation
 - If a SimulationConfig file was given as an input parameter, initialize a SimulationLoop and run until timeout
-- TODO: If no SimulationConfig was given, wait for communication from the NRPServer
+- If experiment manager pipe descriptors were given ('-m'), the NRPServer launched this process. A SimulationServer answers its requests on these pipes while the
+  simulation runs. The process quits once the simulation times out or the NRPServer sends a shutdown request
+- If a metrics file was given as an input parameter, write the collected performance metrics to it in the Prometheus text format. The file is
+  rewritten every metrics_interval seconds while the simulation runs, and once more when it ends
+- If no SimulationConfig was given, but pipe descriptors were, wait for a shutdown request from the NRPServer
+- If any step fails, the error is logged, queued log messages are written out, and NRPSimulation exits with a non-zero code
 
 To launch an experiment with NRPSimulation, the user must specify the simulation configuration file. The file format is specified under \ref simulation_config "SimulationConfig".
 \code{.sh}
 NRPSimulation -c simulation_config.json
 \endcode
 
+To collect performance metrics of the run, e.g. for a node exporter textfile collector, add a metrics file. Here, it is updated every 5 seconds:
+\code{.sh}
+NRPSimulation -c simulation_config.json --metrics_file nrp_simulation.prom --metrics_interval 5
+\endcode
+
 
  */
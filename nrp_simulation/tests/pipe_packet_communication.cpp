@@ -0,0 +1,98 @@
+//
+// NRP Core - Backend infrastructure to synchronize simulations
+//
+// Copyright 2020 Michael Zechmair
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This project has received funding from the European Union’s Horizon 2020
+// Framework Programme for Research and Innovation under the Specific Grant
+// Agreement No. 945539 (Human Brain Project SGA3).
+//
+
+#include <gtest/gtest.h>
+
+#include "nrp_simulation/utils/pipe_packet_communication.h"
+
+#include <chrono>
+#include <future>
+#include <thread>
+
+using namespace testing;
+
+/*!
+ * \brief Wait until comm has received a packet
+ */
+static bool waitForPacket(PipePacketCommunication &comm, std::chrono::milliseconds timeout)
+{
+	const auto endTime = std::chrono::steady_clock::now() + timeout;
+	while(std::chrono::steady_clock::now() < endTime)
+	{
+		{
+			auto lock = comm.acquireInPacketLock();
+			if(comm.readPacketReady())
+				return true;
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	return false;
+}
+
+TEST(PipePacketCommunicationTest, SendPacket)
+{
+	PipeCommunication toA, toB;
+	PipePacketCommunication commA(PipeCommunication(std::move(toA), std::move(toB)));
+	PipePacketCommunication commB(PipeCommunication(std::move(toB), std::move(toA)));
+
+	PipeCommPacket pack;
+	pack.Command = "test_cmd";
+	pack.Data = {1, 2, 3};
+
+	const auto packID = commA.sendPacket(std::move(pack));
+	ASSERT_GT(packID, 0);
+
+	ASSERT_TRUE(waitForPacket(commB, std::chrono::seconds(5)));
+
+	PipeCommPacket recPack = commB.retrievePacket();
+	ASSERT_EQ(recPack.ID, packID);
+	ASSERT_EQ(recPack.Command, "test_cmd");
+	ASSERT_EQ(recPack.Data, PipeCommPacket::data_t({1, 2, 3}));
+}
+
+TEST(PipePacketCommunicationTest, SendPacketImmediatelyWhileRunning)
+{
+	PipeCommunication toA, toB;
+	PipePacketCommunication commA(PipeCommunication(std::move(toA), std::move(toB)));
+	PipePacketCommunication commB(PipeCommunication(std::move(toB), std::move(toA)));
+
+	ASSERT_TRUE(commA.isRunning());
+
+	PipeCommPacket pack;
+	pack.Command = "test_cmd";
+
+	// The communication thread must be stopped and restarted without deadlocking. Run on a detached thread so that a deadlock fails the test instead of hanging it
+	auto sendResult = std::make_shared<std::promise<PipeCommPacket::packet_id_t> >();
+	auto sendFuture = sendResult->get_future();
+	std::thread([&commA, sendResult, pack = std::move(pack)]() mutable { sendResult->set_value(commA.sendPacketImmediately(std::move(pack))); }).detach();
+
+	ASSERT_EQ(sendFuture.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+	const auto packID = sendFuture.get();
+	ASSERT_GT(packID, 0);
+	ASSERT_TRUE(commA.isRunning());
+
+	ASSERT_TRUE(waitForPacket(commB, std::chrono::seconds(5)));
+	ASSERT_EQ(commB.retrievePacket().ID, packID);
+}
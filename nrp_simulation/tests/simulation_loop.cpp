@@ -23,6 +23,7 @@
 #include <gtest/gtest.h>
 #include <fstream>
 
+#include "nrp_general_library/config/engine_config.h"
 #include "nrp_general_library/process_launchers/process_launcher_basic.h"
 #include "nrp_general_library/utils/python_interpreter_state.h"
 #include "nrp_simulation/simulation/simulation_loop.h"
@@ -35,6 +36,84 @@
 
 using namespace testing;
 
+struct TestSnapshotEngineConfig
+        : public EngineConfig<TestSnapshotEngineConfig, PropNames<> >
+{
+	static constexpr FixedString ConfigType = "TestSnapshotEngineConfig";
+	static constexpr FixedString DefEngineType = "test_snapshot_engine";
+
+	TestSnapshotEngineConfig(EngineConfigConst::config_storage_t &config)
+	    : EngineConfig(config)
+	{}
+};
+
+/*!
+ * \brief Engine without a process. Its state is the number of steps it has run
+ */
+struct TestSnapshotEngine
+        : public Engine<TestSnapshotEngine, TestSnapshotEngineConfig>
+{
+	using engine_base_t = Engine<TestSnapshotEngine, TestSnapshotEngineConfig>;
+
+	TestSnapshotEngine(EngineConfigConst::config_storage_t &config, const std::string &name, bool snapshotSupport)
+	    : engine_base_t(config, ProcessLauncherInterface::unique_ptr(new ProcessLauncherBasic())),
+	      SnapshotSupport(snapshotSupport)
+	{
+		this->engineName() = name;
+		this->engineConfig()->engineTimestep() = 0.01f;
+	}
+
+	void initialize() override
+	{}
+
+	void shutdown() override
+	{}
+
+	SimulationTime getEngineTime() const override
+	{	return this->Time;	}
+
+	void runLoopStep(SimulationTime timeStep) override
+	{
+		this->Time += timeStep;
+		++this->State;
+	}
+
+	void waitForStepCompletion(float) override
+	{}
+
+	void handleInputDevices(const device_inputs_t&) override
+	{}
+
+	bool supportsSnapshots() const override
+	{	return this->SnapshotSupport;	}
+
+	bool SnapshotSupport;
+	int NumSavedSnapshots = 0;
+
+	SimulationTime Time = SimulationTime::zero();
+	int State = 0;
+
+	SimulationTime SavedTime = SimulationTime::zero();
+	int SavedState = 0;
+
+	protected:
+		device_outputs_set_t requestOutputDeviceCallback(const device_identifiers_t&) override
+		{	return device_outputs_set_t();	}
+
+		void saveSnapshotCallback() override
+		{
+			this->SavedTime = this->Time;
+			this->SavedState = this->State;
+			++this->NumSavedSnapshots;
+		}
+
+		void restoreSnapshotCallback() override
+		{
+			this->Time = this->SavedTime;
+			this->State = this->SavedState;
+		}
+};
+
 TEST(SimulationLoopTest, InitTFManager)
 {
 	auto simConfigFile = std::fstream(TEST_SIM_SIMPLE_CONFIG_FILE, std::ios::in);
@@ -109,3 +188,76 @@ TEST(SimulationLoopTest, RunLoop)
 	ASSERT_NO_THROW(simLoop.runLoop(timestep));
 	ASSERT_EQ(simLoop.getSimTime(), timestep+timestep);
 }
+
+TEST(SimulationLoopTest, RestoreSnapshot)
+{
+	auto simConfigFile = std::fstream(TEST_SIM_SIMPLE_CONFIG_FILE, std::ios::in);
+	nlohmann::json simConfig = nlohmann::json::parse(simConfigFile);
+
+	const char *procName = "test";
+	PythonInterpreterState pyState(1, const_cast<char**>(&procName));
+
+	const SimulationTime timestep(toSimulationTime<int, std::milli>(50));
+
+	SimulationConfigSharedPtr config(new SimulationConfig(simConfig));
+	config->engineConfigs().resize(2);
+
+	std::shared_ptr<TestSnapshotEngine> engine1(new TestSnapshotEngine(config->engineConfigs().at(0), "engine1", true));
+	std::shared_ptr<TestSnapshotEngine> engine2(new TestSnapshotEngine(config->engineConfigs().at(1), "engine2", true));
+
+	SimulationLoop simLoop(config, {engine1, engine2});
+
+	ASSERT_NO_THROW(simLoop.initLoop());
+	ASSERT_TRUE(simLoop.hasSnapshot());
+	ASSERT_EQ(engine1->NumSavedSnapshots, 1);
+	ASSERT_EQ(engine2->NumSavedSnapshots, 1);
+
+	ASSERT_NO_THROW(simLoop.runLoop(timestep));
+	const auto engine1State = engine1->State;
+	const auto engine1Time = engine1->getEngineTime();
+	ASSERT_GT(engine1State, 0);
+
+	ASSERT_NO_THROW(simLoop.runLoop(timestep));
+	ASSERT_EQ(simLoop.getSimTime(), timestep+timestep);
+	ASSERT_GT(engine1->State, engine1State);
+
+	// Return to initial state
+	ASSERT_NO_THROW(simLoop.restoreSnapshot());
+	ASSERT_EQ(simLoop.getSimTime(), SimulationTime::zero());
+	ASSERT_EQ(engine1->State, 0);
+	ASSERT_EQ(engine2->State, 0);
+	ASSERT_EQ(engine1->getEngineTime(), SimulationTime::zero());
+	ASSERT_EQ(engine2->getEngineTime(), SimulationTime::zero());
+
+	// Running again must reproduce the first run
+	ASSERT_NO_THROW(simLoop.runLoop(timestep));
+	ASSERT_EQ(simLoop.getSimTime(), timestep);
+	ASSERT_EQ(engine1->State, engine1State);
+	ASSERT_EQ(engine1->getEngineTime(), engine1Time);
+}
+
+TEST(SimulationLoopTest, RestoreSnapshotUnsupported)
+{
+	auto simConfigFile = std::fstream(TEST_SIM_SIMPLE_CONFIG_FILE, std::ios::in);
+	nlohmann::json simConfig = nlohmann::json::parse(simConfigFile);
+
+	const char *procName = "test";
+	PythonInterpreterState pyState(1, const_cast<char**>(&procName));
+
+	SimulationConfigSharedPtr config(new SimulationConfig(simConfig));
+	config->engineConfigs().resize(2);
+
+	std::shared_ptr<TestSnapshotEngine> engine1(new TestSnapshotEngine(config->engineConfigs().at(0), "engine1", true));
+	std::shared_ptr<TestSnapshotEngine> engine2(new TestSnapshotEngine(config->engineConfigs().at(1), "engine2", false));
+
+	SimulationLoop simLoop(config, {engine1, engine2});
+
+	// Engines without snapshot support only disable the reset. No engine is asked to store its state
+	ASSERT_NO_THROW(simLoop.initLoop());
+	ASSERT_FALSE(simLoop.hasSnapshot());
+	ASSERT_EQ(engine1->NumSavedSnapshots, 0);
+	ASSERT_EQ(engine2->NumSavedSnapshots, 0);
+
+	ASSERT_THROW(simLoop.restoreSnapshot(), NRPExceptionNonRecoverable);
+	ASSERT_THROW(engine2->saveSnapshot(), NRPExceptionNonRecoverable);
+}
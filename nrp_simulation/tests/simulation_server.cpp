@@ -0,0 +1,102 @@
+//
+// NRP Core - Backend infrastructure to synchronize simulations
+//
+// Copyright 2020 Michael Zechmair
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This project has received funding from the European Union’s Horizon 2020
+// Framework Programme for Research and Innovation under the Specific Grant
+// Agreement No. 945539 (Human Brain Project SGA3).
+//
+
+#include <gtest/gtest.h>
+
+#include "nrp_simulation/server/simulation_server.h"
+
+#include <chrono>
+#include <future>
+#include <thread>
+
+using namespace testing;
+
+/*!
+ * \brief Send a request to the server and wait for its answer
+ */
+static PipeCommPacket sendRequest(PipePacketCommunication &comm, const std::string_view &command, std::chrono::milliseconds timeout = std::chrono::seconds(5))
+{
+	PipeCommPacket req;
+	req.Command = command.data();
+	const auto reqID = comm.sendPacket(std::move(req));
+
+	const auto endTime = std::chrono::steady_clock::now() + timeout;
+	while(std::chrono::steady_clock::now() < endTime)
+	{
+		try
+		{
+			auto retPack = comm.retrievePacket();
+			if(retPack.ID == reqID)
+				return retPack;
+		}
+		catch(PipePacketCommunication::no_packets&)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+	}
+
+	return PipeCommPacket();
+}
+
+TEST(SimulationServerTest, AnswerRequests)
+{
+	SimulationManager manager(ServerConfigConstSharedPtr(new ServerConfig(nlohmann::json())), nullptr);
+
+	// Pipes as set up by the ExperimentManager. The server side only receives the descriptor numbers
+	PipeCommunication toSim, fromSim;
+	const int simFDs[2] = {toSim.readFd(), fromSim.writeFd()};
+	PipePacketCommunication manComm(PipeCommunication(std::move(fromSim), std::move(toSim)));
+
+	SimulationServer server(manager, PipeCommunication(simFDs[0], simFDs[1]));
+	ASSERT_TRUE(server.isServerRunning());
+
+	// No simulation config was loaded
+	auto retPack = sendRequest(manComm, SimulationServer::GetSimStatusCommand);
+	ASSERT_EQ(retPack.Command, SimulationServer::ReturnCommand);
+	ASSERT_FALSE(retPack.Data.empty());
+
+	const SimulationStatus status(nlohmann::json::parse(reinterpret_cast<const char*>(retPack.Data.data())));
+	ASSERT_EQ(status.status(), SimulationStatus::STARTUP);
+	ASSERT_EQ(status.time(), 0.f);
+
+	// Without a simulation loop, there is no snapshot to return to
+	retPack = sendRequest(manComm, SimulationServer::ResetSimCommand);
+	ASSERT_EQ(retPack.Command, SimulationServer::ReturnCommand);
+	ASSERT_EQ(retPack.Data, PipeCommPacket::data_t({false}));
+
+	retPack = sendRequest(manComm, SimulationServer::GetMetricsCommand);
+	ASSERT_EQ(retPack.Command, SimulationServer::ReturnCommand);
+
+	retPack = sendRequest(manComm, "unknown_command");
+	ASSERT_EQ(retPack.Command, SimulationServer::ErrorCommand);
+
+	// A shutdown request wakes the owner of the server
+	auto shutdownDone = std::async(std::launch::async, [&server]() { server.waitForShutdown(); });
+	ASSERT_EQ(shutdownDone.wait_for(std::chrono::milliseconds(100)), std::future_status::timeout);
+
+	retPack = sendRequest(manComm, SimulationServer::ShutdownCommand);
+	ASSERT_EQ(retPack.Command, SimulationServer::ReturnCommand);
+	ASSERT_EQ(shutdownDone.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+	server.shutdownServer();
+	ASSERT_FALSE(server.isServerRunning());
+}